@@ -0,0 +1,190 @@
+using System.Diagnostics;
+using System.Net;
+using System.Net.Sockets;
+using zerg;
+using zerg.Engine;
+using zerg.Engine.Balancing;
+using zerg.Engine.Configs;
+using zerg.Utils;
+using zerg.Utils.UnmanagedMemoryManager;
+
+namespace Benchmarks.Balancing;
+
+/// <summary>
+/// Measures how evenly each <see cref="IConnectionBalancer"/> spreads a heterogeneous connection mix.
+///
+/// Every <c>HeavyEvery</c>-th connection streams large echoes back to back; the others send small
+/// pings at a fixed interval. Connections are opened one by one (the ramp), then CQEs handled per
+/// reactor are measured over a fixed window. Skew is max/mean of the per-reactor CQE counts:
+/// 1.00 is perfectly even, <c>Reactors</c> means one reactor did all the work.
+/// </summary>
+internal static class BalancerSkewBenchmark
+{
+    public static async Task RunAsync(BalancerSkewOptions options)
+    {
+        Console.WriteLine($"reactors={options.Reactors} connections={options.Connections} " +
+                          $"heavy=1/{options.HeavyEvery} ({options.HeavyPayloadBytes} B) light={options.LightPayloadBytes} B " +
+                          $"every {options.LightIntervalMs} ms, measure={options.MeasureSeconds}s");
+        Console.WriteLine();
+        Console.WriteLine($"{"balancer",-26} {"skew",6} {"MB/s",9}  connections / CQE share per reactor");
+
+        (string Name, Func<IConnectionBalancer> Create)[] balancers =
+        [
+            ("RoundRobin",        () => new RoundRobinBalancer()),
+            ("LeastConnections",  () => new LeastConnectionsBalancer()),
+            ("PowerOfTwoChoices", () => new PowerOfTwoChoicesBalancer(seed: 1)),
+            ("PeerAddressHash",   () => new PeerAddressHashBalancer()),
+        ];
+
+        foreach ((string name, Func<IConnectionBalancer> create) in balancers)
+        {
+            Result result = await RunOnceAsync(options, create());
+            Console.WriteLine($"{name,-26} {result.Skew,6:F2} {result.MegabytesPerSecond,9:F1}  {result.Distribution}");
+        }
+    }
+
+    private readonly record struct Result(double Skew, double MegabytesPerSecond, string Distribution);
+
+    private static async Task<Result> RunOnceAsync(BalancerSkewOptions options, IConnectionBalancer balancer)
+    {
+        int port = GetAvailablePort();
+        Engine engine = new(new EngineOptions
+        {
+            Ip = "127.0.0.1",
+            Port = (ushort)port,
+            ReactorCount = options.Reactors,
+            AcceptorConfig = new AcceptorConfig(IPVersion: IPVersion.IPv4Only, Balancer: balancer),
+        });
+        engine.Listen();
+
+        using CancellationTokenSource serverCts = new();
+        Task acceptLoop = Task.Run(async () =>
+        {
+            try
+            {
+                while (engine.ServerRunning)
+                {
+                    Connection? connection = await engine.AcceptAsync(serverCts.Token);
+                    if (connection is not null)
+                        _ = EchoHandler(connection);
+                }
+            }
+            catch (OperationCanceledException) { }
+        });
+
+        using CancellationTokenSource clientCts = new();
+        long echoedBytes = 0;
+        List<Task> clients = new();
+
+        // Ramp: open connections one by one.
+        for (int i = 0; i < options.Connections; i++)
+        {
+            bool heavy = options.HeavyEvery > 0 && i % options.HeavyEvery == 0;
+            clients.Add(RunClientAsync(port, heavy, options, bytes => Interlocked.Add(ref echoedBytes, bytes), clientCts.Token));
+            await Task.Delay(options.RampDelayMs);
+        }
+
+        // Measure.
+        ReactorLoadTable loads = engine.ReactorLoads;
+        long[] cqesBefore = new long[loads.Count];
+        for (int r = 0; r < loads.Count; r++)
+            cqesBefore[r] = loads.TotalCqes(r);
+        long bytesBefore = Interlocked.Read(ref echoedBytes);
+        Stopwatch sw = Stopwatch.StartNew();
+
+        await Task.Delay(TimeSpan.FromSeconds(options.MeasureSeconds));
+
+        double seconds = sw.Elapsed.TotalSeconds;
+        long bytes = Interlocked.Read(ref echoedBytes) - bytesBefore;
+        long[] cqes = new long[loads.Count];
+        long[] connections = new long[loads.Count];
+        for (int r = 0; r < loads.Count; r++)
+        {
+            cqes[r] = loads.TotalCqes(r) - cqesBefore[r];
+            connections[r] = loads.Connections(r);
+        }
+
+        clientCts.Cancel();
+        try { await Task.WhenAll(clients).WaitAsync(TimeSpan.FromSeconds(5)); } catch { /* cancelled */ }
+        engine.Stop();
+        serverCts.Cancel();
+        try { await acceptLoop.WaitAsync(TimeSpan.FromSeconds(5)); } catch { /* timeout or cancelled */ }
+        await Task.Delay(200); // let reactors observe Stop and release the port
+
+        long total = Math.Max(1, cqes.Sum());
+        double mean = (double)total / cqes.Length;
+        string distribution = string.Join("  ", Enumerable.Range(0, cqes.Length)
+            .Select(r => $"r{r}:{connections[r],3}/{100.0 * cqes[r] / total,5:F1}%"));
+
+        return new Result(cqes.Max() / mean, bytes / seconds / (1024 * 1024), distribution);
+    }
+
+    private static async Task RunClientAsync(int port, bool heavy, BalancerSkewOptions options,
+        Action<long> onEchoed, CancellationToken token)
+    {
+        try
+        {
+            using TcpClient client = new() { NoDelay = true };
+            await client.ConnectAsync(IPAddress.Loopback, port, token);
+            NetworkStream stream = client.GetStream();
+
+            byte[] payload = new byte[heavy ? options.HeavyPayloadBytes : options.LightPayloadBytes];
+            byte[] response = new byte[payload.Length];
+            Random.Shared.NextBytes(payload);
+
+            while (!token.IsCancellationRequested)
+            {
+                await stream.WriteAsync(payload, token);
+                int read = 0;
+                while (read < response.Length)
+                {
+                    int n = await stream.ReadAsync(response.AsMemory(read), token);
+                    if (n == 0) return;
+                    read += n;
+                }
+                onEchoed(read);
+
+                if (!heavy)
+                    await Task.Delay(options.LightIntervalMs, token);
+            }
+        }
+        catch (OperationCanceledException) { }
+        catch (IOException) { }
+        catch (SocketException) { }
+    }
+
+    private static async Task EchoHandler(Connection connection)
+    {
+        try
+        {
+            while (true)
+            {
+                RingSnapshot result = await connection.ReadAsync();
+                if (result.IsClosed) break;
+
+                UnmanagedMemoryManager[] rings = connection.GetAllSnapshotRingsAsUnmanagedMemory(result);
+                unsafe
+                {
+                    foreach (UnmanagedMemoryManager ring in rings)
+                    {
+                        connection.Write(new ReadOnlySpan<byte>(ring.Ptr, ring.Length));
+                        connection.ReturnRing(ring.BufferId);
+                    }
+                }
+
+                await connection.FlushAsync();
+                connection.ResetRead();
+            }
+        }
+        catch { /* connection gone */ }
+    }
+
+    private static int GetAvailablePort()
+    {
+        using TcpListener listener = new(IPAddress.Loopback, 0);
+        listener.Start();
+        int port = ((IPEndPoint)listener.LocalEndpoint).Port;
+        listener.Stop();
+        return port;
+    }
+}
@@ -0,0 +1,40 @@
+namespace Benchmarks.Balancing;
+
+/// <summary>
+/// Workload shape for <see cref="BalancerSkewBenchmark"/>.
+/// </summary>
+internal sealed record BalancerSkewOptions(
+    int Reactors = 4,
+    int Connections = 32,
+    /// <summary>Every N-th connection is heavy (large streaming echoes); the rest are light pings.</summary>
+    int HeavyEvery = 4,
+    /// <summary>Must fit the connection write slab (16 KiB by default), the echo handler writes it back in one flush.</summary>
+    int HeavyPayloadBytes = 8 * 1024,
+    int LightPayloadBytes = 64,
+    int LightIntervalMs = 10,
+    /// <summary>Delay between connection opens, so load-aware balancers see earlier connections' load.</summary>
+    int RampDelayMs = 100,
+    int MeasureSeconds = 5)
+{
+    public static BalancerSkewOptions Parse(string[] args)
+    {
+        BalancerSkewOptions options = new();
+        for (int i = 0; i + 1 < args.Length; i += 2)
+        {
+            int value = int.Parse(args[i + 1]);
+            options = args[i] switch
+            {
+                "--reactors"      => options with { Reactors = value },
+                "--connections"   => options with { Connections = value },
+                "--heavy-every"   => options with { HeavyEvery = value },
+                "--heavy-bytes"   => options with { HeavyPayloadBytes = value },
+                "--light-bytes"   => options with { LightPayloadBytes = value },
+                "--light-interval"=> options with { LightIntervalMs = value },
+                "--ramp"          => options with { RampDelayMs = value },
+                "--seconds"       => options with { MeasureSeconds = value },
+                _ => throw new ArgumentException($"Unknown option {args[i]}")
+            };
+        }
+        return options;
+    }
+}
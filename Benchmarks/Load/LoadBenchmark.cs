@@ -0,0 +1,284 @@
+using System.Diagnostics;
+using System.Net;
+using System.Net.Sockets;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Text.Json;
+using System.Text.Json.Serialization;
+using Playground;
+using zerg;
+using zerg.Engine;
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+using zerg.Utils;
+
+namespace Benchmarks.Load;
+
+/// <summary>
+/// Loopback load generator: drives an in-process engine with closed-loop clients and reports requests/s,
+/// latency percentiles and CPU per request for each workload, reactor loop and connection count.
+///
+/// Workloads:
+/// <list type="bullet">
+/// <item><description>echo: <c>EchoBytes</c> echoed per round trip.</description></item>
+/// <item><description>http: <c>Pipeline</c> GET requests written at once, answered by
+/// <see cref="HttpResponse.HandlePipelinedConnectionAsync"/> (one request per round trip when 1).</description></item>
+/// <item><description>large: <c>LargeBytes</c> echoed per round trip, streaming through many recv buffers and partial sends.</description></item>
+/// </list>
+/// Each client keeps one round trip in flight; after the warmup every client records into its own
+/// histogram, merged once the window closes.
+/// </summary>
+internal static class LoadBenchmark
+{
+    private sealed record Workload(string Name, byte[] Request, int ResponseBytes, int RequestsPerTrip, Func<Connection, Task> Handler);
+
+    /// <summary>Per-client counters, written by that client only.</summary>
+    private sealed class ClientStats
+    {
+        public readonly LatencyHistogram Latency = new();
+        public long Requests;
+        public long Errors;
+    }
+
+    private static volatile bool s_measuring;
+
+    public static async Task RunAsync(LoadOptions options)
+    {
+        Console.WriteLine($"reactors={options.Reactors} connections={options.Connections} echo={options.EchoBytes} B " +
+                          $"pipeline={options.Pipeline} large={options.LargeBytes} B " +
+                          $"warmup={options.WarmupSeconds}s measure={options.MeasureSeconds}s");
+        Console.WriteLine();
+        Console.WriteLine($"{"workload",-8} {"loop",-24} {"conns",5} {"req/s",11} {"p50 us",8} {"p99 us",8} " +
+                          $"{"p99.9 us",9} {"cpu us/req",10} {"reactor us/req",14} {"enters/req",10} {"cqes/batch",10}");
+
+        List<LoadResult> results = new();
+        foreach (string name in options.WorkloadList)
+        {
+            Workload workload = CreateWorkload(name, options);
+            foreach (ReactorLoop loop in options.LoopList)
+            {
+                foreach (int connections in options.ConnectionList)
+                {
+                    LoadResult r = await RunOnceAsync(options, workload, loop, connections);
+                    results.Add(r);
+                    Console.WriteLine($"{r.Workload,-8} {r.Loop,-24} {r.Connections,5} {r.RequestsPerSecond,11:F0} " +
+                                      $"{r.P50Us,8:F1} {r.P99Us,8:F1} {r.P999Us,9:F1} {r.CpuUsPerRequest,10:F2} " +
+                                      $"{r.ReactorCpuUsPerRequest,14:F2} {r.EntersPerRequest,10:F2} {r.CqesPerBatch,10:F2}" +
+                                      (r.Errors != 0 ? $"  errors={r.Errors}" : ""));
+                }
+            }
+        }
+
+        if (options.Json != null)
+        {
+            LoadReport report = new(DateTimeOffset.UtcNow,
+                new LoadEnvironment(KernelRelease(), RuntimeInformation.OSDescription, RuntimeInformation.FrameworkDescription,
+                    Environment.ProcessorCount, KernelCapabilities.Current.ToString()),
+                options, results);
+            JsonSerializerOptions json = new()
+            {
+                WriteIndented = true,
+                PropertyNamingPolicy = JsonNamingPolicy.CamelCase,
+                Converters = { new JsonStringEnumConverter() },
+            };
+            await File.WriteAllTextAsync(options.Json, JsonSerializer.Serialize(report, json));
+            Console.WriteLine();
+            Console.WriteLine($"wrote {options.Json}");
+        }
+    }
+
+    private static Workload CreateWorkload(string name, LoadOptions options)
+    {
+        switch (name)
+        {
+            case "echo":
+                return new Workload(name, Payload(options.EchoBytes), options.EchoBytes, 1, EchoHandler);
+            case "large":
+                return new Workload(name, Payload(options.LargeBytes), options.LargeBytes, 1, EchoHandler);
+            case "http":
+                byte[] request = Encoding.ASCII.GetBytes(string.Concat(Enumerable.Repeat(
+                    "GET /plaintext HTTP/1.1\r\nHost: localhost\r\nAccept: text/plain\r\n\r\n", options.Pipeline)));
+                return new Workload(name, request, HttpResponse.Response.Length * options.Pipeline, options.Pipeline,
+                    HttpResponse.HandlePipelinedConnectionAsync);
+            default:
+                throw new ArgumentException($"Unknown workload '{name}'. Available: echo, http, large");
+        }
+    }
+
+    private static async Task<LoadResult> RunOnceAsync(LoadOptions options, Workload workload, ReactorLoop loop, int connections)
+    {
+        int port = GetAvailablePort();
+        Engine engine = new(new EngineOptions
+        {
+            Ip = "127.0.0.1",
+            Port = (ushort)port,
+            ReactorCount = options.Reactors,
+            AcceptorConfig = new AcceptorConfig(IPVersion: IPVersion.IPv4Only),
+            ReactorConfigs = Enumerable.Range(0, options.Reactors).Select(_ => new ReactorConfig(Loop: loop)).ToArray(),
+            LogLevel = EngineLogLevel.Warning,
+            PublishMetrics = false,
+        });
+        engine.Listen();
+
+        using CancellationTokenSource serverCts = new();
+        Task acceptLoop = Task.Run(async () =>
+        {
+            try
+            {
+                while (engine.ServerRunning)
+                {
+                    Connection? connection = await engine.AcceptAsync(serverCts.Token);
+                    if (connection is not null)
+                        _ = workload.Handler(connection);
+                }
+            }
+            catch (OperationCanceledException) { }
+        });
+
+        s_measuring = false;
+        using CancellationTokenSource clientCts = new();
+        ClientStats[] stats = new ClientStats[connections];
+        Task[] clients = new Task[connections];
+        for (int i = 0; i < connections; i++)
+        {
+            stats[i] = new ClientStats();
+            clients[i] = RunClientAsync(port, workload, stats[i], clientCts.Token);
+        }
+
+        await Task.Delay(TimeSpan.FromSeconds(options.WarmupSeconds));
+
+        ReactorMetrics[] before = new ReactorMetrics[options.Reactors];
+        ReactorMetrics[] after = new ReactorMetrics[options.Reactors];
+        engine.GetMetrics(before);
+        TimeSpan cpuBefore = Process.GetCurrentProcess().TotalProcessorTime;
+        TimeSpan reactorCpuBefore = ThreadCpu.Of("uring-w");
+        Stopwatch sw = Stopwatch.StartNew();
+        s_measuring = true;
+
+        await Task.Delay(TimeSpan.FromSeconds(options.MeasureSeconds));
+
+        s_measuring = false;
+        double seconds = sw.Elapsed.TotalSeconds;
+        TimeSpan cpu = Process.GetCurrentProcess().TotalProcessorTime - cpuBefore;
+        TimeSpan reactorCpu = ThreadCpu.Of("uring-w") - reactorCpuBefore;
+        engine.GetMetrics(after);
+
+        clientCts.Cancel();
+        try { await Task.WhenAll(clients).WaitAsync(TimeSpan.FromSeconds(5)); } catch { /* cancelled */ }
+        engine.Stop();
+        serverCts.Cancel();
+        try { await acceptLoop.WaitAsync(TimeSpan.FromSeconds(5)); } catch { /* timeout or cancelled */ }
+        await Task.Delay(200); // let reactors observe Stop and release the port
+
+        LatencyHistogram latency = new();
+        long requests = 0, errors = 0;
+        foreach (ClientStats s in stats)
+        {
+            latency.Add(s.Latency);
+            requests += s.Requests;
+            errors += s.Errors;
+        }
+
+        long enters = 0, cqes = 0, batches = 0;
+        for (int r = 0; r < options.Reactors; r++)
+        {
+            enters += after[r].Enters - before[r].Enters;
+            cqes += after[r].Cqes - before[r].Cqes;
+            batches += after[r].CqeBatches - before[r].CqeBatches;
+        }
+
+        LatencySummary summary = latency.Summarize();
+        double perRequest = Math.Max(1, requests);
+        return new LoadResult(workload.Name, loop, connections, options.Reactors, requests, seconds,
+            requests / seconds,
+            summary.MeanNs / 1000.0, summary.P50Ns / 1000.0, summary.P99Ns / 1000.0, summary.P999Ns / 1000.0,
+            summary.MaxNs / 1000.0,
+            cpu.TotalMicroseconds / perRequest,
+            reactorCpu.TotalMicroseconds / perRequest,
+            enters / perRequest,
+            batches == 0 ? 0 : (double)cqes / batches,
+            errors);
+    }
+
+    private static async Task RunClientAsync(int port, Workload workload, ClientStats stats, CancellationToken token)
+    {
+        try
+        {
+            using TcpClient client = new() { NoDelay = true };
+            await client.ConnectAsync(IPAddress.Loopback, port, token);
+            NetworkStream stream = client.GetStream();
+            byte[] response = new byte[Math.Min(workload.ResponseBytes, 64 * 1024)];
+
+            while (!token.IsCancellationRequested)
+            {
+                long start = Stopwatch.GetTimestamp();
+                // Large requests are echoed while they are still being written: read concurrently.
+                ValueTask write = stream.WriteAsync(workload.Request, token);
+                int read = 0;
+                while (read < workload.ResponseBytes)
+                {
+                    int n = await stream.ReadAsync(response.AsMemory(0, Math.Min(response.Length, workload.ResponseBytes - read)), token);
+                    if (n == 0)
+                    {
+                        stats.Errors++;
+                        return;
+                    }
+                    read += n;
+                }
+                await write;
+
+                if (s_measuring)
+                {
+                    stats.Latency.Record((long)Stopwatch.GetElapsedTime(start).TotalNanoseconds);
+                    stats.Requests += workload.RequestsPerTrip;
+                }
+            }
+        }
+        catch (OperationCanceledException) { }
+        catch (IOException) { }
+        catch (SocketException) { stats.Errors++; }
+    }
+
+    private static string KernelRelease()
+    {
+        try { return File.ReadAllText("/proc/sys/kernel/osrelease").Trim(); }
+        catch (IOException) { return Environment.OSVersion.VersionString; }
+    }
+
+    private static byte[] Payload(int size)
+    {
+        byte[] payload = new byte[size];
+        Random.Shared.NextBytes(payload);
+        return payload;
+    }
+
+    private static async Task EchoHandler(Connection connection)
+    {
+        try
+        {
+            while (true)
+            {
+                RingSnapshot result = await connection.ReadAsync();
+                if (result.IsClosed) break;
+
+                while (connection.TryGetRing(result.TailSnapshot, out RingItem ring))
+                {
+                    connection.Write(ring.AsSpan());
+                    connection.ReturnRing(ring.BufferId);
+                }
+                await connection.FlushAsync();
+                connection.ResetRead();
+            }
+        }
+        catch { /* connection gone */ }
+    }
+
+    private static int GetAvailablePort()
+    {
+        using TcpListener listener = new(IPAddress.Loopback, 0);
+        listener.Start();
+        int port = ((IPEndPoint)listener.LocalEndpoint).Port;
+        listener.Stop();
+        return port;
+    }
+}
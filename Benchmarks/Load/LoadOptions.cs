@@ -0,0 +1,62 @@
+using System.Text.Json.Serialization;
+using zerg.Engine.Configs;
+
+namespace Benchmarks.Load;
+
+/// <summary>
+/// Workload matrix for <see cref="LoadBenchmark"/>: every workload runs against every reactor loop at every
+/// connection count.
+/// </summary>
+internal sealed record LoadOptions(
+    /// <summary>Comma-separated: echo, http, large.</summary>
+    string Workloads = "echo,http,large",
+    /// <summary>Comma-separated <see cref="ReactorLoop"/> names.</summary>
+    string Loops = "Handle,SubmitAndWaitCqe,SubmitAndWaitSingleCall",
+    /// <summary>Comma-separated connection counts.</summary>
+    string Connections = "64",
+    int Reactors = 1,
+    int EchoBytes = 64,
+    /// <summary>HTTP requests written back to back per round trip.</summary>
+    int Pipeline = 16,
+    int LargeBytes = 256 * 1024,
+    int WarmupSeconds = 1,
+    int MeasureSeconds = 5,
+    /// <summary>Where to write the JSON report; none when null.</summary>
+    string? Json = null)
+{
+    [JsonIgnore]
+    public string[] WorkloadList => Split(Workloads);
+
+    [JsonIgnore]
+    public ReactorLoop[] LoopList => Split(Loops).Select(Enum.Parse<ReactorLoop>).ToArray();
+
+    [JsonIgnore]
+    public int[] ConnectionList => Split(Connections).Select(int.Parse).ToArray();
+
+    private static string[] Split(string list)
+        => list.Split(',', StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries);
+
+    public static LoadOptions Parse(string[] args)
+    {
+        LoadOptions options = new();
+        for (int i = 0; i + 1 < args.Length; i += 2)
+        {
+            string value = args[i + 1];
+            options = args[i] switch
+            {
+                "--workloads"   => options with { Workloads = value },
+                "--loops"       => options with { Loops = value },
+                "--connections" => options with { Connections = value },
+                "--reactors"    => options with { Reactors = int.Parse(value) },
+                "--echo-bytes"  => options with { EchoBytes = int.Parse(value) },
+                "--pipeline"    => options with { Pipeline = int.Parse(value) },
+                "--large-bytes" => options with { LargeBytes = int.Parse(value) },
+                "--warmup"      => options with { WarmupSeconds = int.Parse(value) },
+                "--seconds"     => options with { MeasureSeconds = int.Parse(value) },
+                "--json"        => options with { Json = value },
+                _ => throw new ArgumentException($"Unknown option {args[i]}")
+            };
+        }
+        return options;
+    }
+}
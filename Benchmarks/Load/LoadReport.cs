@@ -0,0 +1,42 @@
+using zerg.Engine.Configs;
+
+namespace Benchmarks.Load;
+
+/// <summary>JSON report of a <see cref="LoadBenchmark"/> run, meant to be diffed between builds.</summary>
+internal sealed record LoadReport(
+    DateTimeOffset Timestamp,
+    LoadEnvironment Environment,
+    LoadOptions Options,
+    IReadOnlyList<LoadResult> Results);
+
+internal sealed record LoadEnvironment(
+    string Kernel,
+    string Os,
+    string Runtime,
+    int ProcessorCount,
+    string KernelCapabilities);
+
+/// <summary>
+/// One workload x loop x connection count. Latencies are per round trip (a whole pipelined batch for http),
+/// from the client writing the request to reading the last response byte, within 12.5% (log-linear
+/// histogram buckets). CPU per request counts the whole process (load generator included) and, separately,
+/// the reactor threads alone.
+/// </summary>
+internal sealed record LoadResult(
+    string Workload,
+    ReactorLoop Loop,
+    int Connections,
+    int Reactors,
+    long Requests,
+    double Seconds,
+    double RequestsPerSecond,
+    double MeanUs,
+    double P50Us,
+    double P99Us,
+    double P999Us,
+    double MaxUs,
+    double CpuUsPerRequest,
+    double ReactorCpuUsPerRequest,
+    double EntersPerRequest,
+    double CqesPerBatch,
+    long Errors);
@@ -0,0 +1,50 @@
+using System.Runtime.InteropServices;
+
+namespace Benchmarks.Load;
+
+/// <summary>
+/// CPU time of the threads whose name starts with a prefix (reactors are named "uring-w{i}"),
+/// read from /proc/self/task/*/stat.
+/// </summary>
+internal static class ThreadCpu
+{
+    private const int c_scClkTck = 2;
+
+    private static readonly long s_ticksPerSecond = Math.Max(1, sysconf(c_scClkTck));
+
+    [DllImport("libc")] private static extern long sysconf(int name);
+
+    /// <summary>User + system CPU time of the matching threads; zero when /proc is unavailable.</summary>
+    public static TimeSpan Of(string namePrefix)
+    {
+        long ticks = 0;
+        try
+        {
+            foreach (string task in Directory.EnumerateDirectories("/proc/self/task"))
+            {
+                string comm;
+                string stat;
+                try
+                {
+                    comm = File.ReadAllText(Path.Combine(task, "comm")).TrimEnd();
+                    if (!comm.StartsWith(namePrefix, StringComparison.Ordinal))
+                        continue;
+                    stat = File.ReadAllText(Path.Combine(task, "stat"));
+                }
+                catch (IOException)
+                {
+                    continue; // thread exited
+                }
+
+                // Fields after the parenthesised comm: state is field 3, utime 14, stime 15.
+                string[] fields = stat[(stat.LastIndexOf(')') + 2)..].Split(' ');
+                ticks += long.Parse(fields[11]) + long.Parse(fields[12]);
+            }
+        }
+        catch (DirectoryNotFoundException)
+        {
+            return TimeSpan.Zero;
+        }
+        return TimeSpan.FromSeconds((double)ticks / s_ticksPerSecond);
+    }
+}
@@ -0,0 +1,83 @@
+using System.Runtime.InteropServices;
+
+namespace Benchmarks.Memory;
+
+/// <summary>
+/// A hardware cache event counter opened with perf_event_open(2) for this process, inherited by
+/// every thread created after it is opened (reactor threads included). Counts user and kernel
+/// mode, so the kernel's copies into recv buffers are part of the total; falls back to user mode
+/// only when perf_event_paranoid forbids kernel profiling.
+/// </summary>
+internal sealed unsafe class PerfCounter : IDisposable
+{
+    private const uint PERF_TYPE_HW_CACHE = 3;
+    private const ulong PERF_COUNT_HW_CACHE_DTLB = 3;
+    private const ulong PERF_COUNT_HW_CACHE_OP_READ = 0;
+    private const ulong PERF_COUNT_HW_CACHE_OP_WRITE = 1;
+    private const ulong PERF_COUNT_HW_CACHE_RESULT_MISS = 1;
+    private const int PERF_ATTR_SIZE = 128;
+    private const ulong FLAG_INHERIT = 1UL << 1;
+    private const ulong FLAG_EXCLUDE_KERNEL = 1UL << 5;
+    private const ulong FLAG_EXCLUDE_HV = 1UL << 6;
+    private const ulong PERF_FLAG_FD_CLOEXEC = 1UL << 3;
+
+    [DllImport("libc", SetLastError = true)] private static extern long syscall(long n, byte* attr, int pid, int cpu, int groupFd, ulong flags);
+    [DllImport("libc")] private static extern nint read(int fd, void* buf, nuint count);
+    [DllImport("libc")] private static extern int close(int fd);
+
+    private readonly int _fd;
+
+    private PerfCounter(int fd, bool userOnly)
+    {
+        _fd = fd;
+        UserOnly = userOnly;
+    }
+
+    /// <summary>True when kernel-mode events could not be counted.</summary>
+    public bool UserOnly { get; }
+
+    /// <summary>dTLB load misses.</summary>
+    public static PerfCounter? DtlbLoadMisses() =>
+        Open(PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+
+    /// <summary>dTLB store misses.</summary>
+    public static PerfCounter? DtlbStoreMisses() =>
+        Open(PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_WRITE << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+
+    /// <summary>Current count (including threads that inherited the counter).</summary>
+    public long Read()
+    {
+        ulong value = 0;
+        return read(_fd, &value, sizeof(ulong)) == sizeof(ulong) ? (long)value : 0;
+    }
+
+    public void Dispose() => close(_fd);
+
+    /// <summary>Opens the event, or returns null when perf events are unavailable (no PMU, seccomp, paranoid level).</summary>
+    private static PerfCounter? Open(ulong config)
+    {
+        long nr = RuntimeInformation.ProcessArchitecture switch
+        {
+            Architecture.X64 => 298, // SYS_perf_event_open
+            Architecture.Arm64 => 241,
+            _ => -1
+        };
+        if (nr < 0)
+            return null;
+
+        byte* attr = stackalloc byte[PERF_ATTR_SIZE];
+        foreach (bool userOnly in new[] { false, true })
+        {
+            new Span<byte>(attr, PERF_ATTR_SIZE).Clear();
+            *(uint*)attr = PERF_TYPE_HW_CACHE;
+            *(uint*)(attr + 4) = PERF_ATTR_SIZE;
+            *(ulong*)(attr + 8) = config;
+            *(ulong*)(attr + 40) = FLAG_INHERIT | FLAG_EXCLUDE_HV | (userOnly ? FLAG_EXCLUDE_KERNEL : 0);
+
+            long fd = syscall(nr, attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+            if (fd >= 0)
+                return new PerfCounter((int)fd, userOnly);
+        }
+        return null;
+    }
+}
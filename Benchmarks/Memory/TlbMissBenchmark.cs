@@ -0,0 +1,181 @@
+using System.Diagnostics;
+using System.Net;
+using System.Net.Sockets;
+using zerg;
+using zerg.Engine;
+using zerg.Engine.Configs;
+using zerg.Utils;
+using zerg.Utils.UnmanagedMemoryManager;
+
+namespace Benchmarks.Memory;
+
+/// <summary>
+/// Compares dTLB misses per echoed request with <see cref="SlabMemory.Default"/> and <see cref="SlabMemory.HugePages"/> slabs.
+///
+/// One reactor with a large, fully published recv slab serves closed-loop echo clients, so the kernel
+/// cycles through every buffer and each recv lands on a page the TLB has likely evicted. Misses are
+/// counted with perf_event_open for the whole process (clients run the same loop in both modes, so
+/// the difference is the server's). Without perf access the suite still reports requests/s.
+/// </summary>
+internal static class TlbMissBenchmark
+{
+    public static async Task RunAsync(TlbMissOptions options)
+    {
+        long slabBytes = (long)options.BufferBytes * options.BufferEntries;
+        Console.WriteLine($"connections={options.Connections} payload={options.PayloadBytes} B " +
+                          $"recv slab={options.BufferEntries}x{options.BufferBytes} B ({slabBytes >> 20} MB), " +
+                          $"warmup={options.WarmupSeconds}s measure={options.MeasureSeconds}s");
+        Console.WriteLine();
+        Console.WriteLine($"{"slabs",-10} {"req/s",10} {"dTLB load miss/req",19} {"dTLB store miss/req",20}");
+
+        foreach (SlabMemory memory in new[] { SlabMemory.Default, SlabMemory.HugePages })
+        {
+            Result result = await RunOnceAsync(options, memory);
+            Console.WriteLine($"{memory,-10} {result.RequestsPerSecond,10:F0} {Format(result.LoadMissesPerRequest),19} " +
+                              $"{Format(result.StoreMissesPerRequest),20}");
+            if (result.Note != null)
+                Console.WriteLine($"           ({result.Note})");
+        }
+    }
+
+    private readonly record struct Result(double RequestsPerSecond, double LoadMissesPerRequest, double StoreMissesPerRequest, string? Note);
+
+    private static string Format(double value) => double.IsNaN(value) ? "n/a" : value.ToString("F2");
+
+    private static async Task<Result> RunOnceAsync(TlbMissOptions options, SlabMemory memory)
+    {
+        // Opened before the engine so reactor threads inherit the counters.
+        using PerfCounter? loadMisses = PerfCounter.DtlbLoadMisses();
+        using PerfCounter? storeMisses = PerfCounter.DtlbStoreMisses();
+
+        int port = GetAvailablePort();
+        Engine engine = new(new EngineOptions
+        {
+            Ip = "127.0.0.1",
+            Port = (ushort)port,
+            ReactorCount = 1,
+            AcceptorConfig = new AcceptorConfig(IPVersion: IPVersion.IPv4Only),
+            ReactorConfigs =
+            [
+                new ReactorConfig(
+                    RecvBufferSize: options.BufferBytes,
+                    BufferRingEntries: options.BufferEntries,
+                    BufferRingInitialEntries: options.BufferEntries,
+                    SlabMemory: memory)
+            ],
+        });
+        engine.Listen();
+
+        using CancellationTokenSource serverCts = new();
+        Task acceptLoop = Task.Run(async () =>
+        {
+            try
+            {
+                while (engine.ServerRunning)
+                {
+                    Connection? connection = await engine.AcceptAsync(serverCts.Token);
+                    if (connection is not null)
+                        _ = EchoHandler(connection);
+                }
+            }
+            catch (OperationCanceledException) { }
+        });
+
+        using CancellationTokenSource clientCts = new();
+        long requests = 0;
+        Task[] clients = Enumerable.Range(0, options.Connections)
+            .Select(_ => RunClientAsync(port, options.PayloadBytes, () => Interlocked.Increment(ref requests), clientCts.Token))
+            .ToArray();
+
+        await Task.Delay(TimeSpan.FromSeconds(options.WarmupSeconds));
+
+        long requestsBefore = Interlocked.Read(ref requests);
+        long loadBefore = loadMisses?.Read() ?? 0;
+        long storeBefore = storeMisses?.Read() ?? 0;
+        Stopwatch sw = Stopwatch.StartNew();
+
+        await Task.Delay(TimeSpan.FromSeconds(options.MeasureSeconds));
+
+        double seconds = sw.Elapsed.TotalSeconds;
+        long measured = Math.Max(1, Interlocked.Read(ref requests) - requestsBefore);
+        double loadPerRequest = loadMisses != null ? (double)(loadMisses.Read() - loadBefore) / measured : double.NaN;
+        double storePerRequest = storeMisses != null ? (double)(storeMisses.Read() - storeBefore) / measured : double.NaN;
+
+        clientCts.Cancel();
+        try { await Task.WhenAll(clients).WaitAsync(TimeSpan.FromSeconds(5)); } catch { /* cancelled */ }
+        engine.Stop();
+        serverCts.Cancel();
+        try { await acceptLoop.WaitAsync(TimeSpan.FromSeconds(5)); } catch { /* timeout or cancelled */ }
+        await Task.Delay(200); // let the reactor observe Stop and release the port
+
+        string? note = loadMisses == null ? "perf_event_open unavailable: no TLB counters"
+            : loadMisses.UserOnly ? "kernel events excluded by perf_event_paranoid: recv copies not counted"
+            : null;
+        return new Result(measured / seconds, loadPerRequest, storePerRequest, note);
+    }
+
+    private static async Task RunClientAsync(int port, int payloadBytes, Action onEchoed, CancellationToken token)
+    {
+        try
+        {
+            using TcpClient client = new() { NoDelay = true };
+            await client.ConnectAsync(IPAddress.Loopback, port, token);
+            NetworkStream stream = client.GetStream();
+
+            byte[] payload = new byte[payloadBytes];
+            byte[] response = new byte[payload.Length];
+            Random.Shared.NextBytes(payload);
+
+            while (!token.IsCancellationRequested)
+            {
+                await stream.WriteAsync(payload, token);
+                int read = 0;
+                while (read < response.Length)
+                {
+                    int n = await stream.ReadAsync(response.AsMemory(read), token);
+                    if (n == 0) return;
+                    read += n;
+                }
+                onEchoed();
+            }
+        }
+        catch (OperationCanceledException) { }
+        catch (IOException) { }
+        catch (SocketException) { }
+    }
+
+    private static async Task EchoHandler(Connection connection)
+    {
+        try
+        {
+            while (true)
+            {
+                RingSnapshot result = await connection.ReadAsync();
+                if (result.IsClosed) break;
+
+                UnmanagedMemoryManager[] rings = connection.GetAllSnapshotRingsAsUnmanagedMemory(result);
+                unsafe
+                {
+                    foreach (UnmanagedMemoryManager ring in rings)
+                    {
+                        connection.Write(new ReadOnlySpan<byte>(ring.Ptr, ring.Length));
+                        connection.ReturnRing(ring.BufferId);
+                    }
+                }
+
+                await connection.FlushAsync();
+                connection.ResetRead();
+            }
+        }
+        catch { /* connection gone */ }
+    }
+
+    private static int GetAvailablePort()
+    {
+        using TcpListener listener = new(IPAddress.Loopback, 0);
+        listener.Start();
+        int port = ((IPEndPoint)listener.LocalEndpoint).Port;
+        listener.Stop();
+        return port;
+    }
+}
@@ -0,0 +1,35 @@
+namespace Benchmarks.Memory;
+
+/// <summary>
+/// Workload shape for <see cref="TlbMissBenchmark"/>.
+/// </summary>
+internal sealed record TlbMissOptions(
+    int Connections = 64,
+    int PayloadBytes = 4 * 1024,
+    /// <summary>Recv buffer size; with <see cref="BufferEntries"/> sets the slab the reactor cycles through.</summary>
+    int BufferBytes = 32 * 1024,
+    /// <summary>All of them are published, so the kernel walks the whole slab.</summary>
+    int BufferEntries = 8 * 1024,
+    int WarmupSeconds = 1,
+    int MeasureSeconds = 5)
+{
+    public static TlbMissOptions Parse(string[] args)
+    {
+        TlbMissOptions options = new();
+        for (int i = 0; i + 1 < args.Length; i += 2)
+        {
+            int value = int.Parse(args[i + 1]);
+            options = args[i] switch
+            {
+                "--connections" => options with { Connections = value },
+                "--payload"     => options with { PayloadBytes = value },
+                "--buffer"      => options with { BufferBytes = value },
+                "--entries"     => options with { BufferEntries = value },
+                "--warmup"      => options with { WarmupSeconds = value },
+                "--seconds"     => options with { MeasureSeconds = value },
+                _ => throw new ArgumentException($"Unknown option {args[i]}")
+            };
+        }
+        return options;
+    }
+}
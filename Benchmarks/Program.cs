@@ -0,0 +1,38 @@
+using BenchmarkDotNet.Running;
+using Benchmarks.Balancing;
+using Benchmarks.Load;
+using Benchmarks.Memory;
+
+namespace Benchmarks;
+
+// dotnet run -c Release --project Benchmarks -- balancer [--reactors 4] [--connections 32] [--heavy-every 4] [--seconds 5]
+// dotnet run -c Release --project Benchmarks -- tlb [--connections 64] [--payload 4096] [--buffer 32768] [--entries 8192] [--seconds 5]
+// dotnet run -c Release --project Benchmarks -- load [--workloads echo,http,large] [--loops Handle,SubmitAndWaitCqe,SubmitAndWaitSingleCall]
+//                                                    [--connections 1,64,256] [--reactors 1] [--pipeline 16] [--seconds 5] [--json results.json]
+// dotnet run -c Release --project Benchmarks -- micro [BenchmarkDotNet args, e.g. --filter *MpscIntQueue*]
+
+internal static class Program
+{
+    public static async Task<int> Main(string[] args)
+    {
+        string suite = args.Length > 0 ? args[0] : "balancer";
+        switch (suite)
+        {
+            case "balancer":
+                await BalancerSkewBenchmark.RunAsync(BalancerSkewOptions.Parse(args.Skip(1).ToArray()));
+                return 0;
+            case "tlb":
+                await TlbMissBenchmark.RunAsync(TlbMissOptions.Parse(args.Skip(1).ToArray()));
+                return 0;
+            case "load":
+                await LoadBenchmark.RunAsync(LoadOptions.Parse(args.Skip(1).ToArray()));
+                return 0;
+            case "micro":
+                BenchmarkSwitcher.FromAssembly(typeof(Program).Assembly).Run(args.Skip(1).ToArray());
+                return 0;
+            default:
+                Console.Error.WriteLine($"Unknown benchmark suite '{suite}'. Available: balancer, tlb, load, micro");
+                return 1;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+using BenchmarkDotNet.Attributes;
+using zerg.Utils.MultiProducerSingleConsumer;
+
+namespace Benchmarks.Queues;
+
+/// <summary>
+/// <see cref="MpscIntQueue"/> (the reactor's flush queue): uncontended enqueue/dequeue, and
+/// <c>Producers</c> handler threads requesting flushes from one reactor.
+/// </summary>
+[MemoryDiagnoser]
+public class MpscIntQueueBenchmarks
+{
+    private const int c_items = 1 << 16;
+    private const int c_crossThreadItems = 1 << 20;
+
+    private MpscIntQueue _queue = null!;
+
+    [Params(1, 2, 4)]
+    public int Producers { get; set; }
+
+    [GlobalSetup]
+    public void Setup() => _queue = new MpscIntQueue(4096);
+
+    [Benchmark(OperationsPerInvoke = c_items)]
+    public long EnqueueDequeue()
+    {
+        MpscIntQueue queue = _queue;
+        long sum = 0;
+        for (int i = 0; i < c_items; i += 16)
+        {
+            for (int j = 0; j < 16; j++)
+                queue.TryEnqueue(j);
+            while (queue.TryDequeue(out int value))
+                sum += value;
+        }
+        return sum;
+    }
+
+    [Benchmark(OperationsPerInvoke = c_crossThreadItems)]
+    public long ProducersConsumer()
+    {
+        MpscIntQueue queue = _queue;
+        int perProducer = c_crossThreadItems / Producers;
+        Thread[] producers = QueueBenchmarkThreads.Start(Producers, () =>
+        {
+            for (int i = 0; i < perProducer; i++)
+            {
+                while (!queue.TryEnqueue(i))
+                    Thread.SpinWait(1);
+            }
+        });
+
+        long received = 0;
+        long expected = (long)perProducer * Producers;
+        while (received < expected)
+        {
+            while (queue.TryDequeue(out _))
+                received++;
+        }
+        QueueBenchmarkThreads.Join(producers);
+        return received;
+    }
+}
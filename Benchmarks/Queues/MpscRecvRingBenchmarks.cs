@@ -0,0 +1,67 @@
+using BenchmarkDotNet.Attributes;
+using zerg.Utils;
+using zerg.Utils.MultiProducerSingleConsumer;
+
+namespace Benchmarks.Queues;
+
+/// <summary>
+/// <see cref="MpscRecvRing"/>: uncontended publish/drain by snapshot, and <c>Producers</c> threads
+/// publishing into one consumer.
+/// </summary>
+[MemoryDiagnoser]
+public unsafe class MpscRecvRingBenchmarks
+{
+    private const int c_items = 1 << 16;
+    private const int c_crossThreadItems = 1 << 20;
+
+    private MpscRecvRing _ring = null!;
+
+    [Params(1, 2, 4)]
+    public int Producers { get; set; }
+
+    [GlobalSetup]
+    public void Setup() => _ring = new MpscRecvRing(4096);
+
+    [Benchmark(OperationsPerInvoke = c_items)]
+    public long EnqueueDrain()
+    {
+        MpscRecvRing ring = _ring;
+        long sum = 0;
+        for (int i = 0; i < c_items; i += 16)
+        {
+            for (int j = 0; j < 16; j++)
+                ring.TryEnqueue(new RingItem(null, j, (ushort)j));
+            long tail = ring.SnapshotTail();
+            while (ring.TryDequeueUntil(tail, out RingItem item))
+                sum += item.Length;
+        }
+        return sum;
+    }
+
+    [Benchmark(OperationsPerInvoke = c_crossThreadItems)]
+    public long ProducersConsumer()
+    {
+        MpscRecvRing ring = _ring;
+        int perProducer = c_crossThreadItems / Producers;
+        Thread[] producers = QueueBenchmarkThreads.Start(Producers, () =>
+        {
+            for (int i = 0; i < perProducer; i++)
+            {
+                RingItem item = new(null, 1, (ushort)i);
+                while (!ring.TryEnqueue(item))
+                    Thread.SpinWait(1);
+            }
+        });
+
+        long received = 0;
+        long expected = (long)perProducer * Producers;
+        while (received < expected)
+        {
+            long tail = ring.SnapshotTail();
+            while (ring.TryDequeueUntil(tail, out _))
+                received++;
+        }
+        QueueBenchmarkThreads.Join(producers);
+        return received;
+    }
+}
@@ -0,0 +1,60 @@
+using BenchmarkDotNet.Attributes;
+using zerg.Utils.MultiProducerSingleConsumer;
+
+namespace Benchmarks.Queues;
+
+/// <summary>
+/// <see cref="MpscUshortQueue"/> (the reactor's buffer return queue): uncontended enqueue/dequeue, and
+/// <c>Producers</c> handler threads returning buffer ids to one reactor.
+/// </summary>
+[MemoryDiagnoser]
+public class MpscUShortQueueBenchmarks
+{
+    private const int c_items = 1 << 16;
+    private const int c_crossThreadItems = 1 << 20;
+
+    private MpscUshortQueue _queue = null!;
+
+    [Params(1, 2, 4)]
+    public int Producers { get; set; }
+
+    [GlobalSetup]
+    public void Setup() => _queue = new MpscUshortQueue(8192);
+
+    [Benchmark(OperationsPerInvoke = c_items)]
+    public long EnqueueDequeue()
+    {
+        MpscUshortQueue queue = _queue;
+        long sum = 0;
+        for (int i = 0; i < c_items; i += 16)
+        {
+            for (int j = 0; j < 16; j++)
+                queue.TryEnqueue((ushort)j);
+            while (queue.TryDequeue(out ushort value))
+                sum += value;
+        }
+        return sum;
+    }
+
+    [Benchmark(OperationsPerInvoke = c_crossThreadItems)]
+    public long ProducersConsumer()
+    {
+        MpscUshortQueue queue = _queue;
+        int perProducer = c_crossThreadItems / Producers;
+        Thread[] producers = QueueBenchmarkThreads.Start(Producers, () =>
+        {
+            for (int i = 0; i < perProducer; i++)
+                queue.EnqueueSpin((ushort)i);
+        });
+
+        long received = 0;
+        long expected = (long)perProducer * Producers;
+        while (received < expected)
+        {
+            while (queue.TryDequeue(out _))
+                received++;
+        }
+        QueueBenchmarkThreads.Join(producers);
+        return received;
+    }
+}
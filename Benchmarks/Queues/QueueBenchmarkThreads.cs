@@ -0,0 +1,22 @@
+namespace Benchmarks.Queues;
+
+/// <summary>Producer threads of the cross-thread queue benchmarks.</summary>
+internal static class QueueBenchmarkThreads
+{
+    public static Thread[] Start(int count, Action produce)
+    {
+        Thread[] threads = new Thread[count];
+        for (int i = 0; i < count; i++)
+        {
+            threads[i] = new Thread(() => produce()) { IsBackground = true };
+            threads[i].Start();
+        }
+        return threads;
+    }
+
+    public static void Join(Thread[] threads)
+    {
+        foreach (Thread thread in threads)
+            thread.Join();
+    }
+}
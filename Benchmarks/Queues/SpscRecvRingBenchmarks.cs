@@ -0,0 +1,66 @@
+using BenchmarkDotNet.Attributes;
+using zerg.Utils;
+using zerg.Utils.SingleProducerSingleConsumer;
+
+namespace Benchmarks.Queues;
+
+/// <summary>
+/// <see cref="SpscRecvRing"/>: the reactor publishes received buffers, the handler drains them up to a tail
+/// snapshot (ReadAsync / TryGetRing). <c>Burst</c> items are published per snapshot.
+/// </summary>
+[MemoryDiagnoser]
+public unsafe class SpscRecvRingBenchmarks
+{
+    private const int c_items = 1 << 16;
+    private const int c_crossThreadItems = 1 << 20;
+
+    private SpscRecvRing _ring = null!;
+
+    [Params(1, 16)]
+    public int Burst { get; set; }
+
+    [GlobalSetup]
+    public void Setup() => _ring = new SpscRecvRing(4096);
+
+    [Benchmark(OperationsPerInvoke = c_items)]
+    public long EnqueueDrain()
+    {
+        SpscRecvRing ring = _ring;
+        long sum = 0;
+        for (int i = 0; i < c_items; i += Burst)
+        {
+            for (int j = 0; j < Burst; j++)
+                ring.TryEnqueue(new RingItem(null, j, (ushort)j));
+            long tail = ring.SnapshotTail();
+            while (ring.TryDequeueUntil(tail, out RingItem item))
+                sum += item.Length;
+        }
+        return sum;
+    }
+
+    [Benchmark(OperationsPerInvoke = c_crossThreadItems)]
+    public long ProducerConsumer()
+    {
+        SpscRecvRing ring = _ring;
+        Thread producer = new(() =>
+        {
+            for (int i = 0; i < c_crossThreadItems; i++)
+            {
+                RingItem item = new(null, 1, (ushort)i);
+                while (!ring.TryEnqueue(item))
+                    Thread.SpinWait(1);
+            }
+        });
+        producer.Start();
+
+        long received = 0;
+        while (received < c_crossThreadItems)
+        {
+            long tail = ring.SnapshotTail();
+            while (ring.TryDequeueUntil(tail, out RingItem item))
+                received += item.Length;
+        }
+        producer.Join();
+        return received;
+    }
+}
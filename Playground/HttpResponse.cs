@@ -73,4 +73,60 @@ public class HttpResponse
 
         Console.WriteLine("HandleConnectionAsync exited.");
     }
+
+    internal static ReadOnlySpan<byte> Response =>
+        "HTTP/1.1 200 OK\r\nContent-Length: 13\r\nContent-Type: text/plain\r\n\r\nHello, World!"u8;
+
+    /// <summary>
+    /// Like <see cref="HandleConnectionAsync"/>, but answers every request of a pipelined batch:
+    /// requests are counted by their "\r\n\r\n" terminator (also across reads) and all responses
+    /// of a read go out in one flush.
+    /// </summary>
+    internal static async Task HandlePipelinedConnectionAsync(Connection connection)
+    {
+        int matched = 0; // bytes of the terminator matched at the end of the previous buffer
+
+        while (true)
+        {
+            RingSnapshot result = await connection.ReadAsync();
+            if (result.IsClosed)
+                break;
+
+            int requests = 0;
+            while (connection.TryGetRing(result.TailSnapshot, out RingItem ring))
+            {
+                requests += CountRequests(ring.AsSpan(), ref matched);
+                connection.ReturnRing(ring.BufferId);
+            }
+
+            for (int i = 0; i < requests; i++)
+                connection.Write(Response);
+            if (requests > 0)
+                await connection.FlushAsync();
+
+            connection.ResetRead();
+        }
+    }
+
+    private static int CountRequests(ReadOnlySpan<byte> data, ref int matched)
+    {
+        ReadOnlySpan<byte> terminator = "\r\n\r\n"u8;
+        int count = 0;
+        foreach (byte b in data)
+        {
+            if (b == terminator[matched])
+            {
+                if (++matched == terminator.Length)
+                {
+                    count++;
+                    matched = 0;
+                }
+            }
+            else
+            {
+                matched = b == (byte)'\r' ? 1 : 0;
+            }
+        }
+        return count;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,93 @@
+using System.Net.Sockets;
+using Xunit;
+using zerg;
+using zerg.Engine;
+using zerg.Engine.Configs;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// Tests kernel capability probing and <see cref="EngineOptions.AutoTune"/>: the probe must be self-consistent,
+/// and auto-tuned reactors must run with exactly what the probe reported while still serving traffic.
+/// </summary>
+public class AutoTuneTests
+{
+    [Fact]
+    public void Probe_ReportsUsableKernel()
+    {
+        KernelCapabilities caps = KernelCapabilities.Current;
+
+        Assert.True(caps.Available, caps.ToString());
+        Assert.Same(caps, KernelCapabilities.Current);
+        Assert.True(caps.LastOpcode > 0);
+        Assert.Equal(caps.SupportsOpcode(47), caps.ZeroCopySend); // IORING_OP_SEND_ZC
+        Assert.False(caps.SupportsOpcode(-1));
+        Assert.False(caps.SupportsOpcode(caps.LastOpcode + 1));
+        if (caps.DeferTaskrun)
+            Assert.True(caps.SingleIssuer);
+    }
+
+    [Fact]
+    public async Task AutoTune_ReactorsRunWithProbedFeatures_EchoIntact()
+    {
+        KernelCapabilities caps = KernelCapabilities.Current;
+        // No ring flags requested: auto-tune adds the taskrun mode itself.
+        var config = new ReactorConfig(RingFlags: 0, RecvBufferSize: 4 * 1024, BufferRingEntries: 256);
+        await using var server = new ZergTestServer(EchoHandler, reactorCount: 2, reactorConfig: config, autoTune: true);
+        await Task.Delay(100);
+
+        foreach (Engine.Reactor reactor in server.Engine.Reactors)
+        {
+            ReactorConfig tuned = reactor.Config;
+            Assert.Equal(caps.DeferTaskrun, (tuned.RingFlags & (1u << 13)) != 0); // IORING_SETUP_DEFER_TASKRUN
+            Assert.Equal(caps.RecvBundles, reactor.RecvBundles);
+            Assert.Equal(caps.ZeroCopySend ? SendMode.ZeroCopy : SendMode.Copy, tuned.SendMode);
+            Assert.Equal(caps.RegisterRingFd, reactor.RingFdRegistered);
+        }
+
+        var tasks = Enumerable.Range(0, 4).Select(async i =>
+        {
+            using var client = new TcpClient();
+            await client.ConnectAsync("127.0.0.1", server.Port);
+            await EchoExactly(client.GetStream(), Payload(200_000 + i * 1000, (byte)i));
+        });
+        await Task.WhenAll(tasks).WaitAsync(TimeSpan.FromSeconds(30));
+    }
+
+    [Fact]
+    public async Task AutoTune_KeepsConfiguredSendMode()
+    {
+        // Only the default Copy is upgraded; a send mode the caller picked is never replaced.
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256,
+            SendMode: SendMode.ZeroCopy, ZeroCopySendThreshold: 4 * 1024);
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: config, autoTune: true);
+        await Task.Delay(100);
+
+        Assert.Equal(SendMode.ZeroCopy, server.Engine.Reactors[0].Config.SendMode);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        await EchoExactly(client.GetStream(), Payload(100_000, 5));
+    }
+
+    [Fact]
+    public async Task AutoTune_SqPoll_DropsTaskrunFlags()
+    {
+        var config = new ReactorConfig(RingFlags: 1u << 1, RecvBufferSize: 4 * 1024, BufferRingEntries: 256,
+            IncrementalBufferConsumption: true); // IORING_SETUP_SQPOLL
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: config, autoTune: true);
+        await Task.Delay(100);
+
+        KernelCapabilities caps = KernelCapabilities.Current;
+        ReactorConfig tuned = server.Engine.Reactors[0].Config;
+        Assert.Equal(0u, tuned.RingFlags & ((1u << 8) | (1u << 9) | (1u << 13))); // COOP/TASKRUN_FLAG/DEFER_TASKRUN
+        Assert.Equal(caps.SqPoll, (tuned.RingFlags & (1u << 1)) != 0);
+        Assert.Equal(caps.IncrementalBuffers, tuned.IncrementalBufferConsumption);
+        Assert.False(server.Engine.Reactors[0].RecvBundles && tuned.IncrementalBufferConsumption);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        await EchoExactly(client.GetStream(), Payload(100_000, 9));
+    }
+}
@@ -0,0 +1,146 @@
+using System.Net.Sockets;
+using System.Text;
+using Xunit;
+using zerg;
+using zerg.Engine.Balancing;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// E2E tests for the acceptor's pluggable connection balancers and the per-reactor
+/// load counters (Engine.ReactorLoads) they read.
+/// </summary>
+public class ConnectionBalancerTests
+{
+    [Fact]
+    public async Task LeastConnections_RefillsReactorsThatLostConnections()
+    {
+        await using var server = new ZergTestServer(EchoHandler, reactorCount: 4, balancer: new LeastConnectionsBalancer());
+        await Task.Delay(100);
+        var loads = server.Engine.ReactorLoads;
+
+        // Equal load: one connection per reactor, in order 0..3.
+        var clients = new List<TcpClient>();
+        for (int i = 0; i < 4; i++)
+            clients.Add(await ConnectAndEcho(server.Port, $"first-{i}"));
+        Assert.Equal(new long[] { 1, 1, 1, 1 }, Snapshot(loads));
+
+        // Drop the connections on reactors 1 and 2.
+        clients[1].Dispose();
+        clients[2].Dispose();
+        await WaitUntil(() => loads.Connections(1) == 0 && loads.Connections(2) == 0);
+
+        // Round-robin would continue at 0 and 1; least-connections refills 1 and 2.
+        clients.Add(await ConnectAndEcho(server.Port, "second-0"));
+        clients.Add(await ConnectAndEcho(server.Port, "second-1"));
+        Assert.Equal(new long[] { 1, 1, 1, 1 }, Snapshot(loads));
+
+        foreach (var client in clients) client.Dispose();
+    }
+
+    [Fact]
+    public async Task PeerAddressHash_SamePeerLandsOnSameReactor()
+    {
+        await using var server = new ZergTestServer(EchoHandler, reactorCount: 4, balancer: new PeerAddressHashBalancer());
+        await Task.Delay(100);
+
+        var clients = new List<TcpClient>();
+        for (int i = 0; i < 8; i++)
+            clients.Add(await ConnectAndEcho(server.Port, $"peer-{i}"));
+
+        long[] connections = Snapshot(server.Engine.ReactorLoads);
+        Assert.Equal(8, connections.Max());
+        Assert.Equal(8, connections.Sum());
+
+        foreach (var client in clients) client.Dispose();
+    }
+
+    [Fact]
+    public async Task PowerOfTwoChoices_ServesAllConnections()
+    {
+        await using var server = new ZergTestServer(EchoHandler, reactorCount: 4, balancer: new PowerOfTwoChoicesBalancer(seed: 42));
+        await Task.Delay(100);
+
+        var tasks = Enumerable.Range(0, 16).Select(async i =>
+        {
+            using var client = await ConnectAndEcho(server.Port, $"p2c-{i}");
+            var stream = client.GetStream();
+            for (int j = 0; j < 5; j++)
+                await Echo(stream, $"p2c-{i}-{j}");
+        });
+        await Task.WhenAll(tasks).WaitAsync(TimeSpan.FromSeconds(10));
+    }
+
+    [Fact]
+    public async Task ReactorLoads_TrackCqesAndDrainInFlightBytes()
+    {
+        await using var server = new ZergTestServer(EchoHandler, reactorCount: 2);
+        await Task.Delay(100);
+        var loads = server.Engine.ReactorLoads;
+
+        using (var client = await ConnectAndEcho(server.Port, "load"))
+        {
+            var stream = client.GetStream();
+            for (int i = 0; i < 10; i++)
+                await Echo(stream, new string('x', 2048));
+
+            Assert.Equal(1, loads.Connections(0) + loads.Connections(1));
+            Assert.True(loads.TotalCqes(0) + loads.TotalCqes(1) > 0);
+        }
+
+        // Every echo completed, so no send bytes remain in flight once the close is processed.
+        await WaitUntil(() => loads.Connections(0) + loads.Connections(1) == 0);
+        Assert.Equal(0, loads.InFlightBytes(0));
+        Assert.Equal(0, loads.InFlightBytes(1));
+    }
+
+    // ========================================================================
+    // Helpers
+    // ========================================================================
+
+    private static long[] Snapshot(ReactorLoadTable loads)
+    {
+        var connections = new long[loads.Count];
+        for (int i = 0; i < loads.Count; i++)
+            connections[i] = loads.Connections(i);
+        return connections;
+    }
+
+    /// <summary>
+    /// Connects and completes one echo, so the connection is registered before the next one is made.
+    /// </summary>
+    private static async Task<TcpClient> ConnectAndEcho(int port, string message)
+    {
+        var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", port);
+        await Echo(client.GetStream(), message);
+        return client;
+    }
+
+    private static async Task Echo(NetworkStream stream, string message)
+    {
+        var sent = Encoding.UTF8.GetBytes(message);
+        await stream.WriteAsync(sent);
+
+        var buf = new byte[sent.Length];
+        int read = 0;
+        while (read < buf.Length)
+        {
+            var n = await stream.ReadAsync(buf.AsMemory(read));
+            if (n == 0) break;
+            read += n;
+        }
+        Assert.Equal(message, Encoding.UTF8.GetString(buf, 0, read));
+    }
+
+    private static async Task WaitUntil(Func<bool> condition)
+    {
+        var deadline = DateTime.UtcNow + TimeSpan.FromSeconds(5);
+        while (!condition())
+        {
+            Assert.True(DateTime.UtcNow < deadline, "condition not reached within 5s");
+            await Task.Delay(10);
+        }
+    }
+}
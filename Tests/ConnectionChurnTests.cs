@@ -0,0 +1,86 @@
+using System.Net.Sockets;
+using System.Text;
+using Xunit;
+using zerg;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// Connection slots and fds are recycled as clients come and go. These tests churn through many
+/// short-lived connections so that late CQEs of closed connections race with new connections
+/// reusing the same slot/fd; every client must still get exactly its own bytes back.
+/// </summary>
+public class ConnectionChurnTests
+{
+    [Fact]
+    public async Task Churn_SequentialShortLivedConnections()
+    {
+        await using var server = new ZergTestServer(EchoHandler);
+        await Task.Delay(100);
+
+        for (int i = 0; i < 200; i++)
+        {
+            using var client = new TcpClient();
+            await client.ConnectAsync("127.0.0.1", server.Port);
+            await Echo(client.GetStream(), $"seq-{i}");
+        }
+    }
+
+    [Fact]
+    public async Task Churn_ConcurrentShortLivedConnections()
+    {
+        await using var server = new ZergTestServer(EchoHandler, reactorCount: 2);
+        await Task.Delay(100);
+
+        var workers = Enumerable.Range(0, 8).Select(async w =>
+        {
+            for (int i = 0; i < 50; i++)
+            {
+                using var client = new TcpClient();
+                await client.ConnectAsync("127.0.0.1", server.Port);
+                var stream = client.GetStream();
+                await Echo(stream, $"w{w}-c{i}-a");
+                await Echo(stream, $"w{w}-c{i}-b");
+            }
+        });
+
+        await Task.WhenAll(workers).WaitAsync(TimeSpan.FromSeconds(20));
+    }
+
+    [Fact]
+    public async Task Churn_ConnectionsCloseWithUnreadResponses()
+    {
+        await using var server = new ZergTestServer(EchoHandler);
+        await Task.Delay(100);
+
+        // Close without reading the echo: sends complete (or fail) after the close.
+        for (int i = 0; i < 100; i++)
+        {
+            using var client = new TcpClient();
+            await client.ConnectAsync("127.0.0.1", server.Port);
+            await client.GetStream().WriteAsync(new byte[4096]);
+        }
+
+        // The server still serves new connections correctly.
+        using var survivor = new TcpClient();
+        await survivor.ConnectAsync("127.0.0.1", server.Port);
+        await Echo(survivor.GetStream(), "still-alive");
+    }
+
+    private static async Task Echo(NetworkStream stream, string message)
+    {
+        var sent = Encoding.UTF8.GetBytes(message);
+        await stream.WriteAsync(sent);
+
+        var buf = new byte[sent.Length];
+        int read = 0;
+        while (read < buf.Length)
+        {
+            var n = await stream.ReadAsync(buf.AsMemory(read));
+            if (n == 0) break;
+            read += n;
+        }
+        Assert.Equal(message, Encoding.UTF8.GetString(buf, 0, read));
+    }
+}
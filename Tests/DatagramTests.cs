@@ -0,0 +1,199 @@
+using System.Net;
+using System.Net.Sockets;
+using Xunit;
+using zerg;
+using zerg.Engine.Configs;
+
+namespace Tests;
+
+/// <summary>
+/// Runs E2E tests of datagram sockets over loopback: echo through the multishot recvmsg path, replies to
+/// several peers, GSO batches arriving as individual datagrams, receiving with GRO-sized buffers, and close.
+/// </summary>
+public class DatagramTests
+{
+    private static readonly IPEndPoint s_loopback = new(IPAddress.Loopback, 0);
+
+    [Fact]
+    public async Task Echo_RoundTripsDatagrams()
+    {
+        await using var server = new ZergTestServer(_ => Task.CompletedTask);
+        using DatagramSocket socket = server.Engine.OpenDatagramSocket(s_loopback);
+        Task echo = EchoAsync(socket);
+
+        using var client = new UdpClient(new IPEndPoint(IPAddress.Loopback, 0));
+        for (int i = 0; i < 50; i++)
+        {
+            byte[] payload = BitConverter.GetBytes(i);
+            await client.SendAsync(payload, socket.LocalEndPoint);
+            UdpReceiveResult reply = await client.ReceiveAsync().WaitAsync(TimeSpan.FromSeconds(5));
+            Assert.Equal(payload, reply.Buffer);
+            Assert.Equal(socket.LocalEndPoint, reply.RemoteEndPoint);
+        }
+
+        Assert.Equal(50, socket.Received);
+        Assert.Equal(0, socket.Dropped);
+        socket.Dispose();
+        await echo.WaitAsync(TimeSpan.FromSeconds(5));
+    }
+
+    [Fact]
+    public async Task Echo_RepliesReachEachPeer()
+    {
+        await using var server = new ZergTestServer(_ => Task.CompletedTask);
+        using DatagramSocket socket = server.Engine.OpenDatagramSocket(s_loopback);
+        _ = EchoAsync(socket);
+
+        UdpClient[] clients = Enumerable.Range(0, 4).Select(_ => new UdpClient(new IPEndPoint(IPAddress.Loopback, 0))).ToArray();
+        try
+        {
+            for (int round = 0; round < 10; round++)
+            {
+                for (int i = 0; i < clients.Length; i++)
+                    await clients[i].SendAsync(new[] { (byte)i, (byte)round }, socket.LocalEndPoint);
+                for (int i = 0; i < clients.Length; i++)
+                {
+                    UdpReceiveResult reply = await clients[i].ReceiveAsync().WaitAsync(TimeSpan.FromSeconds(5));
+                    Assert.Equal(new[] { (byte)i, (byte)round }, reply.Buffer);
+                }
+            }
+        }
+        finally
+        {
+            foreach (UdpClient client in clients)
+                client.Dispose();
+        }
+    }
+
+    [Fact]
+    public async Task Send_SegmentedBatch_ArrivesAsIndividualDatagrams()
+    {
+        await using var server = new ZergTestServer(_ => Task.CompletedTask);
+        using DatagramSocket socket = server.Engine.OpenDatagramSocket(s_loopback);
+        using var client = new UdpClient(new IPEndPoint(IPAddress.Loopback, 0));
+        client.Client.ReceiveBufferSize = 1 << 20;
+        DatagramPeer peer = DatagramPeer.FromEndPoint((IPEndPoint)client.Client.LocalEndPoint!);
+
+        // 20 full segments and a short tail: one segmented sendmsg when the kernel supports UDP_SEGMENT.
+        byte[] payload = new byte[1000];
+        for (int i = 0; i < 20; i++)
+        {
+            Array.Fill(payload, (byte)i);
+            Assert.True(socket.Send(payload, peer));
+        }
+        Assert.True(socket.Send(new byte[] { 0xEE, 0xFF }, peer));
+        Assert.Equal(1, socket.QueuedBatches);
+        await socket.FlushAsync().AsTask().WaitAsync(TimeSpan.FromSeconds(5));
+
+        for (int i = 0; i < 20; i++)
+        {
+            UdpReceiveResult received = await client.ReceiveAsync().WaitAsync(TimeSpan.FromSeconds(5));
+            Assert.Equal(1000, received.Buffer.Length);
+            Assert.True(received.Buffer.All(b => b == (byte)i));
+        }
+        UdpReceiveResult tail = await client.ReceiveAsync().WaitAsync(TimeSpan.FromSeconds(5));
+        Assert.Equal(new byte[] { 0xEE, 0xFF }, tail.Buffer);
+
+        Assert.Equal(21, socket.Sent);
+        Assert.Equal(0, socket.SendErrors);
+        Assert.Equal(0, socket.QueuedBatches);
+    }
+
+    [Fact]
+    public async Task Send_DifferentPeersAndSizes_StartNewBatches()
+    {
+        await using var server = new ZergTestServer(_ => Task.CompletedTask);
+        using DatagramSocket socket = server.Engine.OpenDatagramSocket(s_loopback, new DatagramOptions(MaxSendBatches: 3));
+        using var a = new UdpClient(new IPEndPoint(IPAddress.Loopback, 0));
+        using var b = new UdpClient(new IPEndPoint(IPAddress.Loopback, 0));
+        DatagramPeer peerA = DatagramPeer.FromEndPoint((IPEndPoint)a.Client.LocalEndPoint!);
+        DatagramPeer peerB = DatagramPeer.FromEndPoint((IPEndPoint)b.Client.LocalEndPoint!);
+
+        Assert.True(socket.Send(new byte[100], peerA));
+        Assert.True(socket.Send(new byte[100], peerB));
+        Assert.True(socket.Send(new byte[100], peerA));
+        Assert.True(socket.Send(new byte[200], peerA)); // larger than the segment size: new batch
+        Assert.Equal(3, socket.QueuedBatches);
+        Assert.False(socket.Send(new byte[300], peerB)); // batch table full
+        await socket.FlushAsync();
+
+        for (int i = 0; i < 3; i++)
+            await a.ReceiveAsync().WaitAsync(TimeSpan.FromSeconds(5));
+        await b.ReceiveAsync().WaitAsync(TimeSpan.FromSeconds(5));
+        Assert.Equal(4, socket.Sent);
+    }
+
+    [Fact]
+    public async Task Receive_GroSizedBuffers_SplitsEveryDatagram()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 64 * 1024, BufferRingEntries: 64);
+        await using var server = new ZergTestServer(_ => Task.CompletedTask, reactorConfig: config);
+        using DatagramSocket socket = server.Engine.OpenDatagramSocket(s_loopback);
+        using var client = new UdpClient(new IPEndPoint(IPAddress.Loopback, 0));
+
+        const int count = 64; // stays within the default socket receive buffer
+        byte[] payload = new byte[1200];
+        for (int i = 0; i < count; i++)
+        {
+            BitConverter.TryWriteBytes(payload, i);
+            await client.SendAsync(payload, socket.LocalEndPoint);
+        }
+
+        int received = 0;
+        using var timeout = new CancellationTokenSource(TimeSpan.FromSeconds(5));
+        while (received + socket.Dropped < count && !timeout.IsCancellationRequested)
+        {
+            if (!await socket.ReceiveAsync().AsTask().WaitAsync(timeout.Token))
+                break;
+            received += DrainReceived(socket, 1200, (IPEndPoint)client.Client.LocalEndPoint!);
+        }
+
+        Assert.Equal(count, received + socket.Dropped);
+        Assert.Equal(0, socket.Truncated);
+    }
+
+    [Fact]
+    public async Task Dispose_EndsReceive()
+    {
+        await using var server = new ZergTestServer(_ => Task.CompletedTask);
+        DatagramSocket socket = server.Engine.OpenDatagramSocket(s_loopback);
+        Task<bool> receive = socket.ReceiveAsync().AsTask();
+
+        socket.Dispose();
+
+        Assert.False(await receive.WaitAsync(TimeSpan.FromSeconds(5)));
+    }
+
+    // ========================================================================
+    // Handlers
+    // ========================================================================
+
+    /// <summary>Sends every received datagram back to its sender until the socket closes.</summary>
+    private static async Task EchoAsync(DatagramSocket socket)
+    {
+        while (await socket.ReceiveAsync())
+        {
+            EchoReceived(socket);
+            await socket.FlushAsync();
+        }
+    }
+
+    private static void EchoReceived(DatagramSocket socket)
+    {
+        while (socket.TryReceive(out Datagram datagram))
+            socket.Send(datagram.Payload, datagram.Peer);
+    }
+
+    /// <summary>Takes every queued datagram, checking its size and sender; returns how many there were.</summary>
+    private static int DrainReceived(DatagramSocket socket, int length, IPEndPoint sender)
+    {
+        int count = 0;
+        while (socket.TryReceive(out Datagram datagram))
+        {
+            Assert.Equal(length, datagram.Payload.Length);
+            Assert.Equal(sender, datagram.Peer.ToEndPoint());
+            count++;
+        }
+        return count;
+    }
+}
@@ -0,0 +1,96 @@
+using System.Net.Sockets;
+using Xunit;
+using zerg;
+using zerg.Engine.Configs;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// Runs E2E tests with direct descriptors: client sockets live in each reactor's fixed-file table,
+/// either accepted straight into it (ReusePort) or installed after the acceptor hands them over.
+/// Closing goes through IORING_OP_CLOSE, and slots must be recycled for later connections.
+/// </summary>
+public class DirectDescriptorTests
+{
+    [Fact]
+    public async Task Direct_AcceptorMode_SlotsRecycledAcrossConnections()
+    {
+        // 8 table slots for 40 sequential connections: only works if closed slots come back.
+        var config = new ReactorConfig(MaxConnectionsPerReactor: 8, RecvBufferSize: 4 * 1024, BufferRingEntries: 256,
+            DirectDescriptors: true);
+        int plainFds = 0;
+        await using var server = new ZergTestServer(c =>
+        {
+            if (!c.IsDirectDescriptor)
+                Interlocked.Increment(ref plainFds);
+            return EchoHandler(c);
+        }, reactorConfig: config);
+        await Task.Delay(100);
+
+        Assert.True(server.Engine.Reactors[0].DirectDescriptors);
+        Assert.True(server.Engine.Reactors[0].RingFdRegistered);
+
+        for (int i = 0; i < 40; i++)
+        {
+            using (var client = new TcpClient())
+            {
+                await client.ConnectAsync("127.0.0.1", server.Port);
+                await EchoExactly(client.GetStream(), Payload(10_000 + i, (byte)i));
+            }
+            await WaitForConnections(server, 0);
+        }
+        Assert.Equal(0, plainFds);
+    }
+
+    [Fact]
+    public async Task Direct_ReusePort_AcceptsIntoFixedTable_EchoIntact()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256, DirectDescriptors: true);
+        int plainFds = 0;
+        await using var server = new ZergTestServer(c =>
+        {
+            if (!c.IsDirectDescriptor)
+                Interlocked.Increment(ref plainFds);
+            return EchoHandler(c);
+        }, reactorCount: 2, reactorConfig: config, acceptMode: AcceptMode.ReusePort);
+        await Task.Delay(100);
+
+        foreach (zerg.Engine.Engine.Reactor reactor in server.Engine.Reactors)
+            Assert.True(reactor.DirectDescriptors);
+
+        var tasks = Enumerable.Range(0, 16).Select(async i =>
+        {
+            using var client = new TcpClient();
+            await client.ConnectAsync("127.0.0.1", server.Port);
+            NetworkStream stream = client.GetStream();
+            for (int round = 0; round < 3; round++)
+                await EchoExactly(stream, Payload(64 * 1024 + round, (byte)(i + round)));
+        });
+        await Task.WhenAll(tasks).WaitAsync(TimeSpan.FromSeconds(30));
+        Assert.Equal(0, plainFds);
+    }
+
+    [Fact]
+    public async Task Direct_ZeroCopySend_EchoIntact()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 16 * 1024, BufferRingEntries: 256, SendMode: SendMode.ZeroCopy,
+            DirectDescriptors: true);
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        await EchoExactly(client.GetStream(), Payload(1024 * 1024, 5));
+    }
+
+    // ========================================================================
+    // Helpers
+    // ========================================================================
+
+    private static async Task WaitForConnections(ZergTestServer server, int expected)
+    {
+        for (int i = 0; i < 200 && server.Engine.ReactorLoads.Connections(0) != expected; i++)
+            await Task.Delay(5);
+    }
+}
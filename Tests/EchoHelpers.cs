@@ -0,0 +1,73 @@
+using System.Net.Sockets;
+using Xunit;
+using zerg;
+
+namespace Tests;
+
+/// <summary>
+/// Client and handler halves of the echo round trips the E2E tests use to check that bytes come back
+/// intact and in order. Import with <c>using static Tests.EchoHelpers;</c>.
+/// </summary>
+internal static class EchoHelpers
+{
+    /// <summary>
+    /// Deterministic bytes that differ per <paramref name="seed"/> and do not repeat at power-of-two
+    /// buffer boundaries, so a misplaced or reordered buffer shows up as a mismatch.
+    /// </summary>
+    public static byte[] Payload(int size, byte seed)
+    {
+        var data = new byte[size];
+        for (int i = 0; i < data.Length; i++)
+            data[i] = (byte)(seed + i * 7 + (i >> 9));
+        return data;
+    }
+
+    /// <summary>
+    /// Writes <paramref name="sent"/> while reading the echo back, so payloads larger than the socket
+    /// buffers cannot deadlock, and asserts the echo matches.
+    /// </summary>
+    public static async Task EchoExactly(NetworkStream stream, byte[] sent)
+    {
+        Task write = stream.WriteAsync(sent).AsTask();
+        byte[] received = await ReadExactly(stream, sent.Length);
+        await write;
+        Assert.Equal(sent, received);
+    }
+
+    /// <summary>Reads exactly <paramref name="length"/> bytes, asserting the peer does not close first.</summary>
+    public static async Task<byte[]> ReadExactly(NetworkStream stream, int length)
+    {
+        var received = new byte[length];
+        int read = 0;
+        while (read < received.Length)
+        {
+            int n = await stream.ReadAsync(received.AsMemory(read)).AsTask().WaitAsync(TimeSpan.FromSeconds(20));
+            if (n == 0) break;
+            read += n;
+        }
+        Assert.Equal(length, read);
+        return received;
+    }
+
+    /// <summary>Writes every received buffer back and flushes once per read.</summary>
+    public static async Task EchoHandler(Connection connection)
+    {
+        try
+        {
+            while (true)
+            {
+                var result = await connection.ReadAsync();
+                if (result.IsClosed) break;
+
+                while (connection.TryGetRing(result.TailSnapshot, out var ring))
+                {
+                    connection.Write(ring.AsSpan());
+                    connection.ReturnRing(ring.BufferId);
+                }
+                await connection.FlushAsync();
+                connection.ResetRead();
+            }
+        }
+        catch { /* connection gone */ }
+    }
+}
@@ -0,0 +1,134 @@
+using System.Net.Sockets;
+using Xunit;
+using zerg;
+using zerg.Engine;
+using zerg.Engine.Configs;
+
+namespace Tests;
+
+/// <summary>
+/// Runs E2E tests against elastic buffer rings: groups start with a few published buffers, grow
+/// with occupancy, give idle pages back when load drops, and recvs that run a group dry
+/// (-ENOBUFS) wait for buffers instead of closing their connection.
+/// </summary>
+public class ElasticBufferRingTests
+{
+    [Fact]
+    public async Task Elastic_ExhaustedRing_ConnectionsSurvive()
+    {
+        // 16 buffers, fully published: 32 connections holding buffers must run the group dry.
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 16, BufferRingInitialEntries: 16);
+        await using var server = new ZergTestServer(HoldingEchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        await RunConcurrentEchoes(server.Port, connections: 32, rounds: 3, size: 1024);
+
+        RecvBufferGroupStats stats = server.Engine.Reactors[0].GetRecvBufferStats()[0];
+        Assert.True(stats.Starvations > 0, $"starvations={stats.Starvations}");
+        Assert.Equal(16, stats.HighWater);
+    }
+
+    [Fact]
+    public async Task Elastic_GrowsWithOccupancy_AndReportsHighWater()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 1024, BufferRingInitialEntries: 16);
+        await using var server = new ZergTestServer(HoldingEchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        Assert.Equal(16, server.Engine.Reactors[0].GetRecvBufferStats()[0].Published);
+
+        await RunConcurrentEchoes(server.Port, connections: 64, rounds: 3, size: 1024);
+
+        RecvBufferGroupStats stats = server.Engine.Reactors[0].GetRecvBufferStats()[0];
+        Assert.True(stats.Published > 16, $"published={stats.Published}");
+        Assert.True(stats.HighWater >= 32, $"highWater={stats.HighWater}");
+        Assert.Equal(0, stats.Outstanding);
+    }
+
+    [Fact]
+    public async Task Elastic_IdleGroup_ReleasesPages()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 16 * 1024, BufferRingEntries: 1024, BufferRingInitialEntries: 16);
+        await using var server = new ZergTestServer(HoldingEchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        await RunConcurrentEchoes(server.Port, connections: 128, rounds: 2, size: 10 * 1024);
+        long peak = server.Engine.Reactors[0].RecvBufferResidentBytes();
+
+        // Two trim windows without traffic: the group shrinks back towards its initial entries.
+        await Task.Delay(2500);
+        long idle = server.Engine.Reactors[0].RecvBufferResidentBytes();
+
+        Assert.True(idle * 2 < peak, $"peak={peak}B idle={idle}B");
+    }
+
+    // ========================================================================
+    // Helpers
+    // ========================================================================
+
+    private static async Task RunConcurrentEchoes(int port, int connections, int rounds, int size)
+    {
+        var tasks = Enumerable.Range(0, connections).Select(async i =>
+        {
+            using var client = new TcpClient();
+            await client.ConnectAsync("127.0.0.1", port);
+            var stream = client.GetStream();
+
+            for (int round = 0; round < rounds; round++)
+            {
+                var sent = new byte[size];
+                for (int k = 0; k < sent.Length; k++)
+                    sent[k] = (byte)(i + round + k * 13);
+                await stream.WriteAsync(sent);
+
+                var received = new byte[size];
+                int read = 0;
+                while (read < received.Length)
+                {
+                    var n = await stream.ReadAsync(received.AsMemory(read));
+                    if (n == 0) break;
+                    read += n;
+                }
+                Assert.Equal(sent, received);
+            }
+        });
+
+        await Task.WhenAll(tasks).WaitAsync(TimeSpan.FromSeconds(20));
+    }
+
+    // ========================================================================
+    // Handlers
+    // ========================================================================
+
+    /// <summary>
+    /// Echo that keeps its recv buffers for a while before answering, so concurrent
+    /// connections pile up buffer occupancy.
+    /// </summary>
+    private static async Task HoldingEchoHandler(Connection connection)
+    {
+        try
+        {
+            while (true)
+            {
+                var result = await connection.ReadAsync();
+                if (result.IsClosed) break;
+
+                var rings = connection.GetAllSnapshotRingsAsUnmanagedMemory(result);
+
+                await Task.Delay(50);
+
+                foreach (var ring in rings)
+                {
+                    unsafe
+                    {
+                        connection.Write(new ReadOnlySpan<byte>(ring.Ptr, ring.Length));
+                    }
+                    connection.ReturnRing(ring.BufferId);
+                }
+                await connection.FlushAsync();
+                connection.ResetRead();
+            }
+        }
+        catch { /* connection gone */ }
+    }
+}
@@ -0,0 +1,144 @@
+using System.Buffers.Binary;
+using System.Net.Sockets;
+using System.Text;
+using Xunit;
+using zerg;
+using zerg.Engine.Configs;
+using zerg.Utils.Framing;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// Runs <see cref="ConnectionFramer"/> over loopback with small receive buffers, so most frames straddle
+/// buffers and delimiters get split across them. The handler answers every frame with its length and bytes;
+/// the client checks the answers against the frames it sent.
+/// </summary>
+public class FramerTests
+{
+    [Fact]
+    public async Task Delimiter_FramesSplitAcrossBuffers_ArriveIntact()
+    {
+        var frames = Enumerable.Range(0, 500)
+            .Select(i => Encoding.ASCII.GetBytes($"GET /{new string('a', i * 7 % 600)} HTTP/1.1\r\nHost: zerg\r\r\n\r\n"))
+            .ToArray();
+
+        await RunAsync(FrameDecoder.Delimiter("\r\n\r\n"u8), frames);
+    }
+
+    [Fact]
+    public async Task Delimiter_PartialMatchCarriesOverBufferBoundary()
+    {
+        // "aab" after runs of 'a' needs the match state to fall back, not reset, when a buffer ends mid-match.
+        var frames = Enumerable.Range(0, 500)
+            .Select(i => Encoding.ASCII.GetBytes(new string('b', i % 5) + new string('a', i % 9) + "aab"))
+            .ToArray();
+
+        await RunAsync(FrameDecoder.Delimiter("aab"u8), frames);
+    }
+
+    [Fact]
+    public async Task LengthPrefix_FramesSplitAcrossBuffers_ArriveIntact()
+    {
+        var frames = Enumerable.Range(0, 500).Select(i =>
+        {
+            var frame = new byte[4 + i * 13 % 2000];
+            BinaryPrimitives.WriteUInt32BigEndian(frame, (uint)(frame.Length - 4));
+            for (int j = 4; j < frame.Length; j++)
+                frame[j] = (byte)(i + j);
+            return frame;
+        }).ToArray();
+
+        await RunAsync(FrameDecoder.LengthPrefix(), frames);
+    }
+
+    [Fact]
+    public async Task Predicate_FramesSplitAcrossBuffers_ArriveIntact()
+    {
+        // First byte holds the length of the rest of the frame.
+        var frames = Enumerable.Range(0, 500).Select(i =>
+        {
+            var frame = new byte[1 + i % 250];
+            frame[0] = (byte)(frame.Length - 1);
+            for (int j = 1; j < frame.Length; j++)
+                frame[j] = (byte)(i * j);
+            return frame;
+        }).ToArray();
+
+        await RunAsync(FrameDecoder.FromPredicate(data => data.IsEmpty ? 0 : 1 + data[0]), frames);
+    }
+
+    [Fact]
+    public async Task Delimiter_NoDelimiterWithinLimit_Throws()
+    {
+        var failure = new TaskCompletionSource<Exception>(TaskCreationOptions.RunContinuationsAsynchronously);
+        await using var server = new ZergTestServer(
+            c => FrameEchoHandler(c, FrameDecoder.Delimiter("\n"u8, maxFrameLength: 256), failure),
+            reactorConfig: new ReactorConfig(RecvBufferSize: 128, BufferRingEntries: 256));
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        await client.GetStream().WriteAsync(new byte[1024]);
+
+        Exception error = await failure.Task.WaitAsync(TimeSpan.FromSeconds(10));
+        Assert.IsType<InvalidDataException>(error);
+    }
+
+    // ========================================================================
+    // Helpers
+    // ========================================================================
+
+    /// <summary>
+    /// Sends all frames in one burst over a server with 128-byte receive buffers and checks every echoed frame.
+    /// A buffer the framer failed to return would exhaust the 256-entry ring and stall the test.
+    /// </summary>
+    private static async Task RunAsync(FrameDecoder decoder, byte[][] frames)
+    {
+        await using var server = new ZergTestServer(c => FrameEchoHandler(c, decoder),
+            reactorConfig: new ReactorConfig(RecvBufferSize: 128, BufferRingEntries: 256));
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        NetworkStream stream = client.GetStream();
+
+        byte[] sent = frames.SelectMany(f => f).ToArray();
+        Task write = stream.WriteAsync(sent).AsTask();
+
+        foreach (byte[] frame in frames)
+        {
+            byte[] header = await ReadExactly(stream, 4);
+            Assert.Equal(frame.Length, BinaryPrimitives.ReadInt32BigEndian(header));
+            Assert.Equal(frame, await ReadExactly(stream, frame.Length));
+        }
+        await write;
+    }
+
+    // ========================================================================
+    // Handlers
+    // ========================================================================
+
+    /// <summary>Answers each frame with its 4-byte big-endian length followed by its bytes.</summary>
+    private static async Task FrameEchoHandler(Connection connection, FrameDecoder decoder,
+        TaskCompletionSource<Exception>? failure = null)
+    {
+        var framer = new ConnectionFramer(connection, decoder);
+        var length = new byte[4];
+        try
+        {
+            while (await framer.ReadAsync())
+            {
+                while (framer.TryReadFrame(out ReadOnlySpan<byte> frame))
+                {
+                    BinaryPrimitives.WriteInt32BigEndian(length, frame.Length);
+                    connection.Write(length.AsSpan());
+                    connection.Write(frame);
+                }
+                await connection.FlushAsync();
+            }
+        }
+        catch (Exception e) { failure?.TrySetResult(e); }
+        framer.Dispose();
+    }
+}
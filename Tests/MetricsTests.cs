@@ -0,0 +1,138 @@
+using System.Collections.Concurrent;
+using System.Diagnostics.Metrics;
+using System.Net.Sockets;
+using Xunit;
+using zerg;
+using zerg.Engine;
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// Runs E2E tests against the observability surface: reactor metric snapshots after real traffic,
+/// flush latency percentiles, the level-gated log hook and the "zerg" System.Diagnostics.Metrics meter.
+/// </summary>
+public class MetricsTests
+{
+    [Fact]
+    public async Task Snapshot_CountsLoopCqesAndSends()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256);
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        await PingPong(client.GetStream(), 200);
+
+        Span<ReactorMetrics> metrics = stackalloc ReactorMetrics[4];
+        int count = server.Engine.GetMetrics(metrics);
+        Assert.Equal(1, count);
+
+        ReactorMetrics m = metrics[0];
+        Assert.Equal(0, m.ReactorId);
+        Assert.Equal(1, m.Connections);
+        Assert.True(m.LoopIterations >= m.CqeBatches, $"iterations={m.LoopIterations} batches={m.CqeBatches}");
+        Assert.True(m.Cqes >= 400, $"cqes={m.Cqes}"); // a recv and a send completion per round
+        Assert.True(m.MaxCqeBatch >= 1 && m.MaxCqeBatch <= m.Cqes);
+        Assert.True(m.Sends >= 200, $"sends={m.Sends}");
+        Assert.Equal(0, m.SendErrors);
+        Assert.True(m.FlushQDrained >= 200, $"flushes={m.FlushQDrained}");
+        Assert.True(m.ReturnQDrained >= 200, $"returns={m.ReturnQDrained}");
+        Assert.True(m.RecvBuffersPublished > 0);
+        Assert.True(m.Enters > 0);
+        Assert.True(m.CqesPerBatch >= 1.0);
+    }
+
+    [Fact]
+    public async Task FlushLatency_RecordsEveryCompletedBatch()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256);
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        await PingPong(client.GetStream(), 100);
+
+        // The reactor records a flush at its send completion, which may come after the client read the echo.
+        for (int i = 0; i < 200 && server.Engine.Reactors[0].FlushLatency.Count < 100; i++)
+            await Task.Delay(10);
+
+        LatencySummary latency = server.Engine.Reactors[0].GetMetrics().FlushLatency;
+        Assert.Equal(server.Engine.Reactors[0].FlushLatency.Count, latency.Count);
+        Assert.True(latency.Count >= 100, $"count={latency.Count}");
+        Assert.True(latency.P50Ns > 0);
+        Assert.True(latency.P50Ns <= latency.P90Ns);
+        Assert.True(latency.P90Ns <= latency.P99Ns);
+        Assert.True(latency.P99Ns <= latency.P999Ns);
+        Assert.True(latency.P999Ns <= latency.MaxNs);
+        Assert.InRange(latency.MeanNs, 1.0, latency.MaxNs);
+    }
+
+    [Fact]
+    public async Task LogHandler_ReceivesEventsAtOrAboveLevel()
+    {
+        ConcurrentQueue<EngineLogEvent> debug = new();
+        await using (new ZergTestServer(EchoHandler, logLevel: EngineLogLevel.Debug, logHandler: debug.Enqueue))
+            await Task.Delay(200);
+
+        Assert.True(debug.Any(e => e.Level == EngineLogLevel.Information && e.Source == "engine"));
+        Assert.True(debug.Any(e => e.Level == EngineLogLevel.Debug && e.Source == "w0"));
+        Assert.True(debug.Any(e => e.Level == EngineLogLevel.Debug && e.Source == "acceptor"));
+
+        ConcurrentQueue<EngineLogEvent> warnings = new();
+        await using (new ZergTestServer(EchoHandler, logLevel: EngineLogLevel.Warning, logHandler: warnings.Enqueue))
+            await Task.Delay(200);
+
+        Assert.False(warnings.Any(e => e.Level < EngineLogLevel.Warning));
+    }
+
+    [Fact]
+    public async Task Meter_PublishesReactorInstruments()
+    {
+        ConcurrentDictionary<string, long> seen = new();
+        using MeterListener listener = new();
+        listener.InstrumentPublished = (instrument, l) =>
+        {
+            if (instrument.Meter.Name == "zerg")
+                l.EnableMeasurementEvents(instrument);
+        };
+        listener.SetMeasurementEventCallback<long>((instrument, value, tags, _) =>
+            seen.AddOrUpdate(instrument.Name, value, (_, old) => Math.Max(old, value)));
+        listener.Start();
+
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256);
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        await PingPong(client.GetStream(), 50);
+
+        listener.RecordObservableInstruments();
+        Assert.True(seen.TryGetValue("zerg.reactor.cqes", out long cqes) && cqes > 0, $"cqes={cqes}");
+        Assert.True(seen.TryGetValue("zerg.reactor.sends", out long sends) && sends >= 50, $"sends={sends}");
+        Assert.True(seen.TryGetValue("zerg.reactor.connections", out long connections) && connections == 1);
+        Assert.True(seen.ContainsKey("zerg.reactor.flush_latency"));
+    }
+
+    // ========================================================================
+    // Helpers
+    // ========================================================================
+
+    /// <summary>Sends <paramref name="rounds"/> 64-byte messages, each after the previous echo came back.</summary>
+    private static async Task PingPong(NetworkStream stream, int rounds)
+    {
+        for (int round = 0; round < rounds; round++)
+        {
+            byte[] sent = new byte[64];
+            for (int i = 0; i < sent.Length; i++)
+                sent[i] = (byte)(round + i * 31);
+            await stream.WriteAsync(sent);
+            Assert.Equal(sent, await ReadExactly(stream, sent.Length));
+        }
+    }
+}
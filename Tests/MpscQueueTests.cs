@@ -0,0 +1,72 @@
+using Xunit;
+using zerg.Utils.MultiProducerSingleConsumer;
+
+namespace Tests;
+
+/// <summary>
+/// Tests for the reactor's MPSC queues (buffer returns and flush requests) under full-queue conditions
+/// and concurrent producers.
+/// </summary>
+public class MpscQueueTests
+{
+    [Fact]
+    public void UShortQueue_FullEnqueue_LeavesQueueUsable()
+    {
+        var queue = new MpscUshortQueue(4);
+        for (ushort i = 0; i < 4; i++)
+            Assert.True(queue.TryEnqueue(i));
+
+        // Rejected while full: must not consume a position
+        Assert.False(queue.TryEnqueue(99));
+        Assert.False(queue.TryEnqueue(99));
+
+        for (ushort i = 0; i < 4; i++)
+        {
+            Assert.True(queue.TryDequeue(out ushort value));
+            Assert.Equal(i, value);
+        }
+        Assert.False(queue.TryDequeue(out _));
+
+        Assert.True(queue.TryEnqueue(7));
+        Assert.True(queue.TryDequeue(out ushort next));
+        Assert.Equal((ushort)7, next);
+    }
+
+    [Fact]
+    public void UShortQueue_ConcurrentProducers_DeliverEveryItem()
+    {
+        const int producers = 4;
+        const int perProducer = 20_000;
+        var queue = new MpscUshortQueue(64); // small: producers keep hitting a full queue
+
+        Thread[] threads = new Thread[producers];
+        for (int p = 0; p < producers; p++)
+        {
+            int id = p;
+            threads[p] = new Thread(() =>
+            {
+                for (int i = 0; i < perProducer; i++)
+                    queue.EnqueueSpin((ushort)id);
+            });
+            threads[p].Start();
+        }
+
+        int[] counts = new int[producers];
+        int received = 0;
+        DateTime deadline = DateTime.UtcNow.AddSeconds(30);
+        while (received < producers * perProducer && DateTime.UtcNow < deadline)
+        {
+            while (queue.TryDequeue(out ushort id))
+            {
+                counts[id]++;
+                received++;
+            }
+        }
+        foreach (Thread thread in threads)
+            thread.Join();
+
+        Assert.Equal(producers * perProducer, received);
+        foreach (int count in counts)
+            Assert.Equal(perProducer, count);
+    }
+}
@@ -1,8 +1,10 @@
 using System.Buffers;
+using System.IO.Pipelines;
 using System.Net.Sockets;
 using System.Text;
 using Xunit;
 using zerg;
+using zerg.Engine.Configs;
 
 namespace Tests;
 
@@ -246,4 +248,61 @@ public class PipeReaderTests
         }
         catch { /* connection gone */ }
     }
+
+    [Fact]
+    public async Task PipeReader_SteadyState_AllocatesNothingPerRequest()
+    {
+        // Thread-per-core keeps the handler on the reactor thread, so the thread's allocation counter covers
+        // the reader, the reactor loop and the write path of every measured request.
+        const int warmup = 1000, measured = 2000;
+        var allocated = new TaskCompletionSource<long>(TaskCreationOptions.RunContinuationsAsynchronously);
+
+        async Task Handler(Connection connection)
+        {
+            var reader = new ConnectionPipeReader(connection);
+            int requests = 0;
+            long start = 0;
+            try
+            {
+                while (true)
+                {
+                    if (requests == warmup)
+                        start = GC.GetAllocatedBytesForCurrentThread();
+
+                    ReadResult result = await reader.ReadAsync();
+                    if (result.IsCompleted)
+                        break;
+
+                    foreach (ReadOnlyMemory<byte> segment in result.Buffer)
+                        connection.Write(segment.Span);
+                    reader.AdvanceTo(result.Buffer.End);
+                    await connection.FlushAsync();
+
+                    if (++requests == warmup + measured)
+                        allocated.TrySetResult(GC.GetAllocatedBytesForCurrentThread() - start);
+                }
+            }
+            catch { /* connection gone */ }
+            reader.Complete();
+        }
+
+        await using var server = new ZergTestServer(Handler, executionMode: ExecutionMode.ThreadPerCore);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        var stream = client.GetStream();
+        var request = Encoding.ASCII.GetBytes("GET / HTTP/1.1\r\nHost: zerg\r\n\r\n");
+        var response = new byte[request.Length];
+        for (int i = 0; i < warmup + measured; i++)
+        {
+            await stream.WriteAsync(request);
+            int read = 0;
+            while (read < response.Length)
+                read += await stream.ReadAsync(response.AsMemory(read));
+        }
+
+        long bytes = await allocated.Task.WaitAsync(TimeSpan.FromSeconds(10));
+        Assert.True(bytes == 0, $"{bytes} bytes allocated over {measured} requests");
+    }
 }
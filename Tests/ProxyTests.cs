@@ -0,0 +1,278 @@
+using System.Net;
+using System.Net.Sockets;
+using Xunit;
+using zerg;
+using zerg.Engine;
+using zerg.Engine.Configs;
+using zerg.Utils;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// Outbound connects and relays: the handler connects to an upstream TCP server from its own reactor and
+/// pairs the two connections with <see cref="Connection.ProxyAsync"/>. Bytes must arrive intact and in order
+/// both ways, half-closes must be forwarded, and the relay must report what it moved.
+/// </summary>
+public class ProxyTests
+{
+    [Theory]
+    [InlineData(RelayMode.Buffers)]
+    [InlineData(RelayMode.Splice)]
+    public async Task Proxy_EchoUpstream_LargePayloadIntact(RelayMode mode)
+    {
+        using var upstream = new EchoUpstream();
+        var relayed = new TaskCompletionSource<RelayResult>(TaskCreationOptions.RunContinuationsAsynchronously);
+        var config = new ReactorConfig(RecvBufferSize: 16 * 1024, BufferRingEntries: 256);
+        await using var server = new ZergTestServer(c => ProxyHandler(c, upstream.EndPoint, mode, relayed),
+            reactorConfig: config);
+        await Task.Delay(100);
+
+        byte[] payload = Payload(2 * 1024 * 1024, 3);
+        using (var client = new TcpClient())
+        {
+            await client.ConnectAsync("127.0.0.1", server.Port);
+            NetworkStream stream = client.GetStream();
+            await EchoExactly(stream, payload);
+
+            client.Client.Shutdown(SocketShutdown.Send);
+            Assert.Equal(0, await stream.ReadAsync(new byte[1]).AsTask().WaitAsync(TimeSpan.FromSeconds(10)));
+        }
+
+        RelayResult result = await relayed.Task.WaitAsync(TimeSpan.FromSeconds(10));
+        Assert.Equal(KernelCapabilities.Current.Splice ? mode : RelayMode.Buffers, result.Mode);
+        Assert.Equal(0, result.Error);
+        Assert.Equal(payload.Length, result.BytesToPeer);
+        Assert.Equal(payload.Length, result.BytesFromPeer);
+        await WaitForConnections(server, 0);
+        Assert.Equal(0, server.Engine.ReactorLoads.Connections(0));
+    }
+
+    [Theory]
+    [InlineData(RelayMode.Buffers)]
+    [InlineData(RelayMode.Splice)]
+    public async Task Proxy_HalfClose_ForwardedWhileOtherDirectionFlows(RelayMode mode)
+    {
+        // Upstream reads until EOF, then answers with the byte count: the reply only exists if the
+        // client's shutdown reached upstream while the way back stayed open.
+        using var upstream = new CountingUpstream();
+        var relayed = new TaskCompletionSource<RelayResult>(TaskCreationOptions.RunContinuationsAsynchronously);
+        await using var server = new ZergTestServer(c => ProxyHandler(c, upstream.EndPoint, mode, relayed));
+        await Task.Delay(100);
+
+        byte[] payload = Payload(300_000, 9);
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        NetworkStream stream = client.GetStream();
+        // An EOF that arrives before the relay starts closes the connection like any other,
+        // so wait for upstream's greeting first.
+        Assert.Equal(ReadyByte, (await ReadExactly(stream, 1))[0]);
+        await stream.WriteAsync(payload);
+        client.Client.Shutdown(SocketShutdown.Send);
+
+        string reply = await ReadToEnd(stream);
+        Assert.Equal(payload.Length.ToString(), reply);
+
+        RelayResult result = await relayed.Task.WaitAsync(TimeSpan.FromSeconds(10));
+        Assert.Equal(payload.Length, result.BytesToPeer);
+        Assert.Equal(1 + reply.Length, result.BytesFromPeer);
+    }
+
+    [Fact]
+    public async Task Proxy_UnreadDataAndPendingWrites_GoFirst()
+    {
+        using var upstream = new EchoUpstream();
+        await using var server = new ZergTestServer(async c =>
+        {
+            // Leave the first request in the inbound ring and stage a greeting without flushing it.
+            RingSnapshot read = await c.ReadAsync();
+            if (read.IsClosed)
+                return;
+            Connection peer = await c.Reactor.ConnectAsync(upstream.EndPoint);
+            c.Write("HELLO\n"u8);
+            await c.ProxyAsync(peer);
+        });
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        NetworkStream stream = client.GetStream();
+        await stream.WriteAsync("first;"u8.ToArray());
+
+        byte[] expected = "HELLO\nfirst;"u8.ToArray();
+        byte[] received = await ReadExactly(stream, expected.Length);
+        Assert.Equal(expected, received);
+
+        await EchoExactly(stream, Payload(100_000, 1));
+    }
+
+    [Fact]
+    public async Task Proxy_DirectDescriptors_SpliceEchoIntact()
+    {
+        using var upstream = new EchoUpstream();
+        var relayed = new TaskCompletionSource<RelayResult>(TaskCreationOptions.RunContinuationsAsynchronously);
+        var config = new ReactorConfig(RecvBufferSize: 16 * 1024, BufferRingEntries: 256, DirectDescriptors: true);
+        bool bothDirect = true;
+        await using var server = new ZergTestServer(async c =>
+        {
+            Connection peer = await c.Reactor.ConnectAsync(upstream.EndPoint);
+            bothDirect &= c.IsDirectDescriptor && peer.IsDirectDescriptor;
+            relayed.TrySetResult(await c.ProxyAsync(peer, RelayMode.Splice));
+        }, reactorConfig: config);
+        await Task.Delay(100);
+
+        byte[] payload = Payload(1024 * 1024, 7);
+        using (var client = new TcpClient())
+        {
+            await client.ConnectAsync("127.0.0.1", server.Port);
+            await EchoExactly(client.GetStream(), payload);
+        }
+
+        RelayResult result = await relayed.Task.WaitAsync(TimeSpan.FromSeconds(10));
+        Assert.True(bothDirect);
+        Assert.Equal(payload.Length, result.BytesToPeer);
+    }
+
+    [Fact]
+    public async Task Connect_Refused_ThrowsSocketException()
+    {
+        // Bind and release a port so nothing listens on it.
+        var probe = new TcpListener(IPAddress.Loopback, 0);
+        probe.Start();
+        var closed = (IPEndPoint)probe.LocalEndpoint;
+        probe.Stop();
+
+        var failure = new TaskCompletionSource<SocketError>(TaskCreationOptions.RunContinuationsAsynchronously);
+        await using var server = new ZergTestServer(async c =>
+        {
+            try
+            {
+                await c.Reactor.ConnectAsync(closed);
+                failure.TrySetResult(SocketError.Success);
+            }
+            catch (SocketException ex)
+            {
+                failure.TrySetResult(ex.SocketErrorCode);
+            }
+        });
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        Assert.Equal(SocketError.ConnectionRefused, await failure.Task.WaitAsync(TimeSpan.FromSeconds(10)));
+        Assert.Equal(1, server.Engine.ReactorLoads.Connections(0));
+    }
+
+    // ========================================================================
+    // Helpers
+    // ========================================================================
+
+    private static async Task ProxyHandler(Connection connection, IPEndPoint upstream, RelayMode mode,
+        TaskCompletionSource<RelayResult> relayed)
+    {
+        try
+        {
+            Connection peer = await connection.Reactor.ConnectAsync(upstream);
+            relayed.TrySetResult(await connection.ProxyAsync(peer, mode));
+        }
+        catch (Exception ex)
+        {
+            relayed.TrySetException(ex);
+        }
+    }
+
+    /// <summary>Blocking-socket upstream that echoes every connection until EOF.</summary>
+    private sealed class EchoUpstream : IDisposable
+    {
+        private readonly TcpListener _listener = new(IPAddress.Loopback, 0);
+
+        public EchoUpstream()
+        {
+            _listener.Start();
+            EndPoint = (IPEndPoint)_listener.LocalEndpoint;
+            _ = AcceptLoop();
+        }
+
+        public IPEndPoint EndPoint { get; }
+
+        private async Task AcceptLoop()
+        {
+            try
+            {
+                while (true)
+                {
+                    TcpClient client = await _listener.AcceptTcpClientAsync();
+                    _ = Serve(client);
+                }
+            }
+            catch { /* listener stopped */ }
+        }
+
+        private static async Task Serve(TcpClient client)
+        {
+            using (client)
+            {
+                NetworkStream stream = client.GetStream();
+                var buffer = new byte[64 * 1024];
+                try
+                {
+                    int n;
+                    while ((n = await stream.ReadAsync(buffer)) > 0)
+                        await stream.WriteAsync(buffer.AsMemory(0, n));
+                }
+                catch { /* peer gone */ }
+            }
+        }
+
+        public void Dispose() => _listener.Stop();
+    }
+
+    private const byte ReadyByte = (byte)'R';
+
+    /// <summary>Upstream that greets with <see cref="ReadyByte"/>, reads until EOF, then writes the number of bytes it got and closes.</summary>
+    private sealed class CountingUpstream : IDisposable
+    {
+        private readonly TcpListener _listener = new(IPAddress.Loopback, 0);
+
+        public CountingUpstream()
+        {
+            _listener.Start();
+            EndPoint = (IPEndPoint)_listener.LocalEndpoint;
+            _ = Serve();
+        }
+
+        public IPEndPoint EndPoint { get; }
+
+        private async Task Serve()
+        {
+            try
+            {
+                using TcpClient client = await _listener.AcceptTcpClientAsync();
+                NetworkStream stream = client.GetStream();
+                await stream.WriteAsync(new[] { ReadyByte });
+                var buffer = new byte[64 * 1024];
+                long total = 0;
+                int n;
+                while ((n = await stream.ReadAsync(buffer)) > 0)
+                    total += n;
+                await stream.WriteAsync(System.Text.Encoding.ASCII.GetBytes(total.ToString()));
+            }
+            catch { /* listener stopped */ }
+        }
+
+        public void Dispose() => _listener.Stop();
+    }
+
+    private static async Task<string> ReadToEnd(NetworkStream stream)
+    {
+        var all = new MemoryStream();
+        await stream.CopyToAsync(all).WaitAsync(TimeSpan.FromSeconds(20));
+        return System.Text.Encoding.ASCII.GetString(all.ToArray());
+    }
+
+    private static async Task WaitForConnections(ZergTestServer server, int expected)
+    {
+        for (int i = 0; i < 200 && server.Engine.ReactorLoads.Connections(0) != expected; i++)
+            await Task.Delay(5);
+    }
+}
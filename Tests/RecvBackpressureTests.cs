@@ -0,0 +1,238 @@
+using System.Net.Sockets;
+using Xunit;
+using zerg;
+using zerg.Engine;
+using zerg.Engine.Configs;
+using zerg.Utils;
+
+namespace Tests;
+
+/// <summary>
+/// Runs E2E tests against receive backpressure: a connection whose handler holds on to more than its
+/// recv budget (or lets its inbound ring fill up) is paused instead of closed, resumes once the handler
+/// catches up, and cannot starve the other connections of the reactor's shared buffer ring.
+/// </summary>
+public class RecvBackpressureTests
+{
+    [Fact]
+    public async Task Backpressure_SlowConsumer_PausesAndResumes_NoDataLost()
+    {
+        const int total = 4 * 1024 * 1024;
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 1024, RecvBudgetBuffers: 16);
+        await using var server = new ZergTestServer(c => SlowCountingHandler(c, total), reactorConfig: config);
+        await Task.Delay(100);
+
+        long received = await SendAndReadCount(server.Port, total);
+
+        Assert.Equal(total, received);
+        RecvBackpressureStats stats = server.Engine.Reactors[0].GetRecvBackpressureStats();
+        Assert.True(stats.Pauses > 0, $"pauses={stats.Pauses}");
+        Assert.True(stats.Resumes > 0, $"resumes={stats.Resumes}");
+    }
+
+    [Fact]
+    public async Task Backpressure_HoggingConnection_DoesNotStarveOthers()
+    {
+        // 256 buffers shared by the reactor and a hog flooding far more than that. It may hold 16 of them,
+        // plus whatever its multishot recv took in the burst before the reactor saw its CQEs.
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256, BufferRingInitialEntries: 256,
+            RecvBudgetBuffers: 16);
+        TaskCompletionSource release = new(TaskCreationOptions.RunContinuationsAsynchronously);
+        await using var server = new ZergTestServer(c => HoggingOrEchoHandler(c, release.Task), reactorConfig: config);
+        await Task.Delay(100);
+
+        using var hog = new TcpClient();
+        await hog.ConnectAsync("127.0.0.1", server.Port);
+        NetworkStream hogStream = hog.GetStream();
+        hogStream.WriteByte(1); // marks this connection as the hog
+        Task flood = hogStream.WriteAsync(new byte[8 * 1024 * 1024]).AsTask();
+        await Task.Delay(300);
+
+        // The hog is paused holding its budget; the rest of the ring still serves other clients.
+        for (int i = 0; i < 4; i++)
+        {
+            using var client = new TcpClient();
+            await client.ConnectAsync("127.0.0.1", server.Port);
+            NetworkStream stream = client.GetStream();
+            byte[] sent = new byte[3000];
+            for (int k = 0; k < sent.Length; k++)
+                sent[k] = (byte)(2 + (k + i) % 200);
+            await stream.WriteAsync(sent).AsTask().WaitAsync(TimeSpan.FromSeconds(5));
+
+            byte[] echoed = new byte[sent.Length];
+            int read = 0;
+            while (read < echoed.Length)
+            {
+                int n = await stream.ReadAsync(echoed.AsMemory(read)).AsTask().WaitAsync(TimeSpan.FromSeconds(5));
+                if (n == 0) break;
+                read += n;
+            }
+            Assert.Equal(sent, echoed);
+        }
+
+        RecvBackpressureStats stats = server.Engine.Reactors[0].GetRecvBackpressureStats();
+        Assert.True(stats.Paused >= 1, $"paused={stats.Paused}");
+        RecvBufferGroupStats ring = server.Engine.Reactors[0].GetRecvBufferStats()[0];
+        Assert.True(ring.HighWater < 256, $"highWater={ring.HighWater}");
+
+        release.SetResult();
+        await flood.WaitAsync(TimeSpan.FromSeconds(20));
+    }
+
+    [Fact]
+    public async Task Backpressure_FullInboundRing_KeepsConnectionOpen()
+    {
+        // Budgets off and 1 KB buffers: a handler that stops reading sees far more than the
+        // inbound ring's 1024 items pile up.
+        const int total = 3 * 1024 * 1024;
+        var config = new ReactorConfig(RecvBufferSize: 1024, BufferRingEntries: 8 * 1024, RecvBudgetBuffers: 0,
+            RecvBudgetBytes: 0);
+        await using var server = new ZergTestServer(c => SlowCountingHandler(c, total), reactorConfig: config);
+        await Task.Delay(100);
+
+        long received = await SendAndReadCount(server.Port, total);
+
+        Assert.Equal(total, received);
+        Assert.True(server.Engine.Reactors[0].GetRecvBackpressureStats().Pauses > 0);
+    }
+
+    // ========================================================================
+    // Helpers
+    // ========================================================================
+
+    /// <summary>
+    /// Sends <paramref name="total"/> patterned bytes and reads back the 8-byte count and checksum
+    /// the handler reports once it has seen them all. Returns the count after checking the sum.
+    /// </summary>
+    private static async Task<long> SendAndReadCount(int port, int total)
+    {
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", port);
+        NetworkStream stream = client.GetStream();
+
+        byte[] payload = new byte[total];
+        long expectedSum = 0;
+        for (int i = 0; i < payload.Length; i++)
+        {
+            payload[i] = (byte)(i * 7 + 3);
+            expectedSum += payload[i];
+        }
+        await stream.WriteAsync(payload).AsTask().WaitAsync(TimeSpan.FromSeconds(30));
+
+        byte[] reply = new byte[16];
+        int read = 0;
+        while (read < reply.Length)
+        {
+            int n = await stream.ReadAsync(reply.AsMemory(read)).AsTask().WaitAsync(TimeSpan.FromSeconds(30));
+            if (n == 0) break;
+            read += n;
+        }
+        Assert.Equal(reply.Length, read);
+        Assert.Equal(expectedSum, BitConverter.ToInt64(reply, 8));
+        return BitConverter.ToInt64(reply, 0);
+    }
+
+    private static long Sum(RingItem ring)
+    {
+        long sum = 0;
+        foreach (byte b in ring.AsSpan())
+            sum += b;
+        return sum;
+    }
+
+    // ========================================================================
+    // Handlers
+    // ========================================================================
+
+    /// <summary>
+    /// Sums everything received, pausing on every batch so the client outruns it, and answers
+    /// with the byte count and sum once <paramref name="total"/> bytes have arrived.
+    /// </summary>
+    private static async Task SlowCountingHandler(Connection connection, int total)
+    {
+        long count = 0, sum = 0;
+        try
+        {
+            await Task.Delay(200); // let the backlog build up before the first read
+            while (count < total)
+            {
+                var result = await connection.ReadAsync();
+                if (result.IsClosed) return;
+
+                while (connection.TryGetRing(result.TailSnapshot, out var ring))
+                {
+                    sum += Sum(ring);
+                    count += ring.Length;
+                    connection.ReturnRing(ring.BufferId);
+                }
+                connection.ResetRead();
+                await Task.Delay(1);
+            }
+        }
+        catch { return; } // connection gone
+
+        byte[] reply = new byte[16];
+        BitConverter.TryWriteBytes(reply.AsSpan(0, 8), count);
+        BitConverter.TryWriteBytes(reply.AsSpan(8, 8), sum);
+        try
+        {
+            connection.Write(reply.AsSpan());
+            await connection.FlushAsync();
+        }
+        catch { /* connection gone */ }
+    }
+
+    /// <summary>
+    /// A connection whose first byte is 1 holds every buffer it receives until <paramref name="release"/>
+    /// completes; any other connection is a plain echo.
+    /// </summary>
+    private static async Task HoggingOrEchoHandler(Connection connection, Task release)
+    {
+        var held = new List<ushort>();
+        bool hog = false, first = true;
+        try
+        {
+            while (true)
+            {
+                var result = await connection.ReadAsync();
+                if (result.IsClosed) break;
+
+                while (connection.TryGetRing(result.TailSnapshot, out var ring))
+                {
+                    if (first)
+                    {
+                        hog = ring.AsSpan()[0] == 1;
+                        first = false;
+                    }
+                    if (hog)
+                    {
+                        held.Add(ring.BufferId);
+                        continue;
+                    }
+                    connection.Write(ring.AsSpan());
+                    connection.ReturnRing(ring.BufferId);
+                }
+                connection.ResetRead();
+
+                if (hog && !release.IsCompleted)
+                {
+                    await release;
+                    foreach (ushort bid in held)
+                        connection.ReturnRing(bid);
+                    held.Clear();
+                }
+                else if (hog)
+                {
+                    foreach (ushort bid in held)
+                        connection.ReturnRing(bid);
+                    held.Clear();
+                }
+                else
+                {
+                    await connection.FlushAsync();
+                }
+            }
+        }
+        catch { /* connection gone */ }
+    }
+}
@@ -0,0 +1,152 @@
+using System.Net.Sockets;
+using Xunit;
+using zerg;
+using zerg.Engine.Configs;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// Runs E2E tests with size-classed recv buffer groups. Connections move between classes as their
+/// message sizes change, so payloads must survive the cancel/re-arm of the multishot recv, and a
+/// small-message workload must only touch the small buffers.
+/// </summary>
+public class RecvBufferClassTests
+{
+    private static readonly ReactorConfig ClassedConfig = new(
+        RecvBufferClasses:
+        [
+            new RecvBufferClass(512, 1024),
+            new RecvBufferClass(4 * 1024, 64),
+            new RecvBufferClass(64 * 1024, 16),
+        ]
+    );
+
+    [Fact]
+    public async Task Classes_SmallMessages_TouchFarLessMemoryThanSingleLargeClass()
+    {
+        long single = await MeasureResidentAfterSmallEchoes(new ReactorConfig(RecvBufferSize: 32 * 1024, BufferRingEntries: 1024));
+        long classed = await MeasureResidentAfterSmallEchoes(ClassedConfig);
+
+        Assert.True(classed * 4 < single, $"classed={classed}B single={single}B");
+    }
+
+    [Fact]
+    public async Task Classes_GrowingAndShrinkingMessages_EchoIntact()
+    {
+        await using var server = new ZergTestServer(ChunkedEchoHandler, reactorConfig: ClassedConfig);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        var stream = client.GetStream();
+
+        int[] sizes = [64, 128, 100_000, 200_000, 3_000, 100_000, 64, 32, 16, 64];
+        for (int round = 0; round < 3; round++)
+        {
+            foreach (int size in sizes)
+            {
+                byte[] sent = Payload(size, (byte)(size + round));
+                await EchoExactly(stream, sent);
+            }
+        }
+
+        // Long run of small messages: the connection settles back on the small class.
+        for (int i = 0; i < 40; i++)
+            await EchoExactly(stream, Payload(64, (byte)i));
+    }
+
+    [Fact]
+    public async Task Classes_ConcurrentMixedConnections()
+    {
+        await using var server = new ZergTestServer(ChunkedEchoHandler, reactorCount: 2, reactorConfig: ClassedConfig);
+        await Task.Delay(100);
+
+        var tasks = Enumerable.Range(0, 12).Select(async i =>
+        {
+            using var client = new TcpClient();
+            await client.ConnectAsync("127.0.0.1", server.Port);
+            var stream = client.GetStream();
+
+            int size = i % 3 == 0 ? 50_000 : 200;
+            for (int j = 0; j < 10; j++)
+                await EchoExactly(stream, Payload(size, (byte)(i * 16 + j)));
+        });
+
+        await Task.WhenAll(tasks).WaitAsync(TimeSpan.FromSeconds(20));
+    }
+
+    [Fact]
+    public void Classes_InvalidConfig_Throws()
+    {
+        var engine = new zerg.Engine.Engine();
+        var notPowerOfTwo = new ReactorConfig(RecvBufferClasses: [new RecvBufferClass(512, 1000)]);
+        var tooManyIds = new ReactorConfig(RecvBufferClasses: [new RecvBufferClass(512, 1 << 16), new RecvBufferClass(4096, 16)]);
+
+        Assert.Throws<ArgumentException>(() => new zerg.Engine.Engine.Reactor(0, notPowerOfTwo, engine));
+        Assert.Throws<ArgumentException>(() => new zerg.Engine.Engine.Reactor(0, tooManyIds, engine));
+    }
+
+    // ========================================================================
+    // Helpers
+    // ========================================================================
+
+    /// <summary>
+    /// Echoes 200-byte messages over 32 connections, enough recvs to cycle every buffer of
+    /// the smallest class, and returns the reactor's resident recv slab bytes.
+    /// </summary>
+    private static async Task<long> MeasureResidentAfterSmallEchoes(ReactorConfig config)
+    {
+        await using var server = new ZergTestServer(ChunkedEchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        var tasks = Enumerable.Range(0, 32).Select(async i =>
+        {
+            using var client = new TcpClient();
+            await client.ConnectAsync("127.0.0.1", server.Port);
+            var stream = client.GetStream();
+            for (int j = 0; j < 64; j++)
+                await EchoExactly(stream, Payload(200, (byte)(i + j)));
+        });
+        await Task.WhenAll(tasks).WaitAsync(TimeSpan.FromSeconds(20));
+
+        return server.Engine.Reactors[0].RecvBufferResidentBytes();
+    }
+
+    // ========================================================================
+    // Handlers
+    // ========================================================================
+
+    /// <summary>
+    /// Echo that flushes in 8 KB chunks so 64 KB recv buffers never overrun the write slab.
+    /// </summary>
+    private static async Task ChunkedEchoHandler(Connection connection)
+    {
+        const int chunk = 8 * 1024;
+        try
+        {
+            while (true)
+            {
+                var result = await connection.ReadAsync();
+                if (result.IsClosed) break;
+
+                var rings = connection.GetAllSnapshotRingsAsUnmanagedMemory(result);
+                foreach (var ring in rings)
+                {
+                    for (int off = 0; off < ring.Length; off += chunk)
+                    {
+                        int len = Math.Min(chunk, ring.Length - off);
+                        unsafe
+                        {
+                            connection.Write(new ReadOnlySpan<byte>(ring.Ptr + off, len));
+                        }
+                        await connection.FlushAsync();
+                    }
+                    connection.ReturnRing(ring.BufferId);
+                }
+                connection.ResetRead();
+            }
+        }
+        catch { /* connection gone */ }
+    }
+}
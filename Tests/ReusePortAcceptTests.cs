@@ -0,0 +1,83 @@
+using System.Net.Sockets;
+using System.Text;
+using Xunit;
+using zerg;
+using zerg.Engine.Configs;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// Runs E2E tests with AcceptMode.ReusePort: every reactor owns an SO_REUSEPORT listener
+/// and accepts on its own ring, with no acceptor thread in between.
+/// </summary>
+public class ReusePortAcceptTests
+{
+    [Fact]
+    public async Task ReusePort_Echo()
+    {
+        await using var server = new ZergTestServer(EchoHandler, acceptMode: AcceptMode.ReusePort);
+        await Task.Delay(100);
+
+        Assert.Null(server.Engine.SingleAcceptor);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        var stream = client.GetStream();
+
+        for (int i = 0; i < 10; i++)
+        {
+            var sent = Encoding.UTF8.GetBytes($"reuseport-{i}");
+            await stream.WriteAsync(sent);
+
+            var buf = new byte[1024];
+            var n = await stream.ReadAsync(buf);
+            Assert.Equal($"reuseport-{i}", Encoding.UTF8.GetString(buf, 0, n));
+        }
+    }
+
+    [Fact]
+    public async Task ReusePort_ConcurrentConnections_MultipleReactors()
+    {
+        await using var server = new ZergTestServer(EchoHandler, reactorCount: 4, acceptMode: AcceptMode.ReusePort);
+        await Task.Delay(100);
+
+        await RunConcurrentEchoClients(server.Port, clients: 32);
+    }
+
+    [Fact]
+    public async Task ReusePort_CpuSteering_ConcurrentConnections()
+    {
+        await using var server = new ZergTestServer(EchoHandler, reactorCount: 2,
+            acceptMode: AcceptMode.ReusePort, reusePortCpuSteering: true);
+        await Task.Delay(100);
+
+        await RunConcurrentEchoClients(server.Port, clients: 16);
+    }
+
+    // ========================================================================
+    // Helpers
+    // ========================================================================
+
+    private static async Task RunConcurrentEchoClients(int port, int clients)
+    {
+        var tasks = Enumerable.Range(0, clients).Select(async i =>
+        {
+            using var client = new TcpClient();
+            await client.ConnectAsync("127.0.0.1", port);
+            var stream = client.GetStream();
+
+            for (int j = 0; j < 5; j++)
+            {
+                var sent = Encoding.UTF8.GetBytes($"c{i}-m{j}");
+                await stream.WriteAsync(sent);
+
+                var buf = new byte[1024];
+                var n = await stream.ReadAsync(buf);
+                Assert.Equal($"c{i}-m{j}", Encoding.UTF8.GetString(buf, 0, n));
+            }
+        });
+
+        await Task.WhenAll(tasks).WaitAsync(TimeSpan.FromSeconds(10));
+    }
+}
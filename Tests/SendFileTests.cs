@@ -0,0 +1,275 @@
+using System.Net.Sockets;
+using System.Text;
+using Microsoft.Win32.SafeHandles;
+using Xunit;
+using zerg;
+using zerg.Engine.Configs;
+using zerg.Utils;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// Runs E2E tests of Connection.SendFileAsync: whole files and ranges arriving intact behind the bytes written
+/// before them, repeated sends on one connection, a file shorter than requested, and files served from a FileCache
+/// (including an entry the cache drops between lookup and send).
+/// Also unit-tests the FileCache itself: small files in memory, revalidation and eviction.
+/// </summary>
+public class SendFileTests : IDisposable
+{
+    private readonly string _dir = Directory.CreateTempSubdirectory("zerg-sendfile-").FullName;
+
+    public void Dispose() => Directory.Delete(_dir, recursive: true);
+
+    [Fact]
+    public async Task SendFile_LargeFile_FollowsWrittenHeader()
+    {
+        byte[] content = Pattern(1024 * 1024 + 123);
+        string path = CreateFile("large.bin", content);
+        using SafeFileHandle file = File.OpenHandle(path);
+
+        await using var server = new ZergTestServer(c => RespondPerByte(c, async (conn, _) =>
+        {
+            conn.Write("HDR\n"u8);
+            await conn.SendFileAsync(file, 0, content.Length);
+        }));
+        using var client = await ConnectAsync(server);
+        NetworkStream stream = client.GetStream();
+
+        await stream.WriteAsync(new byte[] { 1 });
+
+        Assert.Equal("HDR\n"u8.ToArray(), await ReadExactly(stream, 4));
+        Assert.Equal(content, await ReadExactly(stream, content.Length));
+    }
+
+    [Fact]
+    public async Task SendFile_Range_SendsOnlyThoseBytes()
+    {
+        byte[] content = Pattern(300 * 1024);
+        string path = CreateFile("range.bin", content);
+        using SafeFileHandle file = File.OpenHandle(path);
+
+        await using var server = new ZergTestServer(c => RespondPerByte(c, (conn, seed) =>
+            conn.SendFileAsync(file, seed * 1000, 70 * 1024)));
+        using var client = await ConnectAsync(server);
+        NetworkStream stream = client.GetStream();
+
+        for (int seed = 0; seed < 5; seed++)
+        {
+            await stream.WriteAsync(new[] { (byte)seed });
+            byte[] received = await ReadExactly(stream, 70 * 1024);
+            Assert.Equal(content.AsSpan(seed * 1000, 70 * 1024).ToArray(), received);
+        }
+    }
+
+    [Fact]
+    public async Task SendFile_ConcurrentConnections_ShareOneHandle()
+    {
+        byte[] content = Pattern(200 * 1024 + 7);
+        string path = CreateFile("shared.bin", content);
+        using SafeFileHandle file = File.OpenHandle(path);
+
+        await using var server = new ZergTestServer(c => RespondPerByte(c, (conn, _) =>
+            conn.SendFileAsync(file, 0, content.Length)), reactorCount: 2);
+
+        Task[] clients = Enumerable.Range(0, 8).Select(async _ =>
+        {
+            using var client = await ConnectAsync(server);
+            NetworkStream stream = client.GetStream();
+            for (int i = 0; i < 3; i++)
+            {
+                await stream.WriteAsync(new byte[] { 1 });
+                Assert.Equal(content, await ReadExactly(stream, content.Length));
+            }
+        }).ToArray();
+
+        await Task.WhenAll(clients).WaitAsync(TimeSpan.FromSeconds(10));
+    }
+
+    [Fact]
+    public async Task SendFile_FileShorterThanLength_Fails()
+    {
+        byte[] content = Pattern(10 * 1024);
+        string path = CreateFile("short.bin", content);
+        using SafeFileHandle file = File.OpenHandle(path);
+
+        await using var server = new ZergTestServer(c => RespondPerByte(c, async (conn, _) =>
+        {
+            try
+            {
+                await conn.SendFileAsync(file, 0, content.Length + 100);
+            }
+            catch (IOException)
+            {
+                conn.Write("ERR"u8);
+                await conn.FlushAsync();
+            }
+        }));
+        using var client = await ConnectAsync(server);
+        NetworkStream stream = client.GetStream();
+
+        await stream.WriteAsync(new byte[] { 1 });
+
+        Assert.Equal(content, await ReadExactly(stream, content.Length));
+        Assert.Equal("ERR"u8.ToArray(), await ReadExactly(stream, 3));
+    }
+
+    [Fact]
+    public async Task SendFile_FromCache_ServesSmallAndLargeFiles()
+    {
+        byte[] small = Encoding.ASCII.GetBytes("<html>small</html>");
+        byte[] large = Pattern(128 * 1024);
+        using var cache = new FileCache(new FileCacheOptions(SmallFileThreshold: 1024));
+        string[] paths = [CreateFile("small.html", small), CreateFile("large.bin", large)];
+
+        await using var server = new ZergTestServer(c => RespondPerByte(c, (conn, seed) =>
+            conn.SendFileAsync(cache.Open(paths[seed]))));
+        using var client = await ConnectAsync(server);
+        NetworkStream stream = client.GetStream();
+
+        for (int i = 0; i < 3; i++)
+        {
+            await stream.WriteAsync(new byte[] { 0 });
+            Assert.Equal(small, await ReadExactly(stream, small.Length));
+            await stream.WriteAsync(new byte[] { 1 });
+            Assert.Equal(large, await ReadExactly(stream, large.Length));
+        }
+
+        Assert.Equal(2, cache.Misses);
+        Assert.Equal(4, cache.Hits);
+    }
+
+    [Fact]
+    public async Task SendFile_FromCache_EntryDroppedBeforeSend_SendsCurrentEntry()
+    {
+        byte[] content = Pattern(64 * 1024);
+        using var cache = new FileCache(new FileCacheOptions(SmallFileThreshold: 0));
+        string path = CreateFile("dropped.bin", content);
+
+        await using var server = new ZergTestServer(c => RespondPerByte(c, (conn, _) =>
+        {
+            CachedFile file = cache.Open(path);
+            cache.Invalidate(path); // another handler drops the entry: its handle is closed
+            return conn.SendFileAsync(file);
+        }));
+        using var client = await ConnectAsync(server);
+        NetworkStream stream = client.GetStream();
+
+        await stream.WriteAsync(new byte[] { 1 });
+
+        Assert.Equal(content, await ReadExactly(stream, content.Length));
+        Assert.Equal(2, cache.Misses);
+    }
+
+    [Fact]
+    public void FileCache_SmallFilesInMemory_LargeFilesAsHandles()
+    {
+        using var cache = new FileCache(new FileCacheOptions(SmallFileThreshold: 100));
+        CachedFile small = cache.Open(CreateFile("a.txt", Pattern(100)));
+        CachedFile large = cache.Open(CreateFile("b.bin", Pattern(101)));
+
+        Assert.True(small.IsInMemory);
+        Assert.Null(small.Handle);
+        Assert.Equal(Pattern(100), small.Contents.ToArray());
+        Assert.False(large.IsInMemory);
+        Assert.NotNull(large.Handle);
+        Assert.Equal(101, large.Length);
+        Assert.Equal(100, cache.MemoryBytes);
+        Assert.Same(small, cache.Open(small.Path));
+    }
+
+    [Fact]
+    public void FileCache_ChangedFile_IsReloaded()
+    {
+        using var cache = new FileCache(new FileCacheOptions(RevalidateAfterMs: 0));
+        string path = CreateFile("c.txt", Pattern(10));
+        CachedFile first = cache.Open(path);
+        Assert.Same(first, cache.Open(path)); // unchanged: revalidated by a stat
+
+        File.WriteAllBytes(path, Pattern(20));
+        File.SetLastWriteTimeUtc(path, first.LastWriteTimeUtc.AddSeconds(1));
+        CachedFile second = cache.Open(path);
+
+        Assert.NotSame(first, second);
+        Assert.Equal(20, second.Length);
+        Assert.Equal(20, cache.MemoryBytes);
+    }
+
+    [Fact]
+    public void FileCache_OverCapacity_EvictsLeastRecentlyUsed()
+    {
+        using var cache = new FileCache(new FileCacheOptions(MaxEntries: 8, SmallFileThreshold: 0));
+        CachedFile[] files = Enumerable.Range(0, 8).Select(i => cache.Open(CreateFile($"f{i}", Pattern(16)))).ToArray();
+        Thread.Sleep(20);
+        cache.Open(files[0].Path); // most recently used: survives
+
+        cache.Open(CreateFile("f8", Pattern(16)));
+
+        Assert.Equal(7, cache.Count); // trimmed to 7/8 of the capacity
+        Assert.False(files[0].Handle!.IsClosed);
+        Assert.Equal(2, files.Count(f => f.Handle!.IsClosed));
+        Assert.Same(files[0], cache.Open(files[0].Path));
+        Assert.Throws<FileNotFoundException>(() => cache.Open(Path.Combine(_dir, "missing")));
+    }
+
+    // ========================================================================
+    // Helpers
+    // ========================================================================
+
+    private string CreateFile(string name, byte[] content)
+    {
+        string path = Path.Combine(_dir, name);
+        File.WriteAllBytes(path, content);
+        return path;
+    }
+
+    private static byte[] Pattern(int length)
+    {
+        byte[] data = new byte[length];
+        for (int i = 0; i < data.Length; i++)
+            data[i] = (byte)(i * 31 + (i >> 8));
+        return data;
+    }
+
+    private static async Task<TcpClient> ConnectAsync(ZergTestServer server)
+    {
+        var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        return client;
+    }
+
+    // ========================================================================
+    // Handlers
+    // ========================================================================
+
+    /// <summary>Calls <paramref name="respond"/> once per received byte, with that byte.</summary>
+    private static async Task RespondPerByte(Connection connection, Func<Connection, byte, ValueTask> respond)
+    {
+        try
+        {
+            while (true)
+            {
+                var result = await connection.ReadAsync();
+                if (result.IsClosed) break;
+
+                List<byte> requests = TakeBytes(connection, result);
+                foreach (byte request in requests)
+                    await respond(connection, request);
+                connection.ResetRead();
+            }
+        }
+        catch { /* connection gone */ }
+    }
+
+    private static unsafe List<byte> TakeBytes(Connection connection, RingSnapshot result)
+    {
+        List<byte> bytes = [];
+        foreach (var ring in connection.GetAllSnapshotRingsAsUnmanagedMemory(result))
+        {
+            for (int i = 0; i < ring.Length; i++)
+                bytes.Add(ring.Ptr[i]);
+            connection.ReturnRing(ring.BufferId);
+        }
+        return bytes;
+    }
+}
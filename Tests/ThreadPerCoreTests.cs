@@ -0,0 +1,156 @@
+using System.Net.Sockets;
+using Xunit;
+using zerg;
+using zerg.Engine;
+using zerg.Engine.Configs;
+using static zerg.ABI.ABI;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// Runs E2E tests in <see cref="ExecutionMode.ThreadPerCore"/> mode: handlers resume on the thread of
+/// the reactor that owns their connection after every await, reactors are pinned to their CPU, and
+/// SQPOLL reactors can share one kernel poller thread.
+/// </summary>
+public class ThreadPerCoreTests
+{
+    [Fact]
+    public async Task ThreadPerCore_HandlersRunOnTheirReactorThread()
+    {
+        int offThread = 0;
+        int checkedAwaits = 0;
+
+        async Task Handler(Connection connection)
+        {
+            void Check()
+            {
+                Interlocked.Increment(ref checkedAwaits);
+                if (!connection.Reactor.IsOnReactorThread ||
+                    Thread.CurrentThread.Name != $"uring-w{connection.Reactor.Id}")
+                    Interlocked.Increment(ref offThread);
+            }
+
+            Check();
+            try
+            {
+                while (true)
+                {
+                    var result = await connection.ReadAsync();
+                    Check();
+                    if (result.IsClosed) break;
+
+                    await Task.Yield();
+                    Check();
+                    await Task.Delay(1);
+                    Check();
+
+                    var rings = connection.GetAllSnapshotRingsAsUnmanagedMemory(result);
+                    foreach (var ring in rings)
+                    {
+                        unsafe
+                        {
+                            connection.Write(new ReadOnlySpan<byte>(ring.Ptr, ring.Length));
+                        }
+                        connection.ReturnRing(ring.BufferId);
+                    }
+                    await connection.FlushAsync();
+                    Check();
+                    connection.ResetRead();
+                }
+            }
+            catch { /* connection gone */ }
+        }
+
+        await using var server = new ZergTestServer(Handler, reactorCount: 2, executionMode: ExecutionMode.ThreadPerCore);
+        await Task.Delay(100);
+
+        await RunConcurrentEchoes(server.Port, connections: 8, rounds: 5);
+
+        Assert.True(checkedAwaits > 8 * 5 * 4, $"checked={checkedAwaits}");
+        Assert.Equal(0, offThread);
+    }
+
+    [Fact]
+    public async Task ThreadPerCore_PinsReactorsToConfiguredCpus()
+    {
+        int wrongCpu = 0;
+
+        async Task Handler(Connection connection)
+        {
+            if (Thread.GetCurrentProcessorId() != 0)
+                Interlocked.Increment(ref wrongCpu);
+            await EchoHandler(connection);
+        }
+
+        await using var server = new ZergTestServer(Handler, executionMode: ExecutionMode.ThreadPerCore, reactorCpus: [0]);
+        await Task.Delay(100);
+
+        await RunConcurrentEchoes(server.Port, connections: 4, rounds: 2);
+
+        Assert.Equal(0, server.Engine.Reactors[0].Cpu);
+        Assert.Equal(0, wrongCpu);
+    }
+
+    [Fact]
+    public async Task ThreadPerCore_ReactorScheduler_RunsTasksOnReactor()
+    {
+        await using var server = new ZergTestServer(EchoHandler, executionMode: ExecutionMode.ThreadPerCore);
+        await Task.Delay(100);
+
+        Engine.Reactor reactor = server.Engine.Reactors[0];
+        string? name = await Task.Factory.StartNew(() => Thread.CurrentThread.Name,
+            CancellationToken.None, TaskCreationOptions.None, reactor.Scheduler).WaitAsync(TimeSpan.FromSeconds(5));
+
+        Assert.Equal("uring-w0", name);
+    }
+
+    [Fact]
+    public async Task ThreadPerCore_SharedSqPoll_OnePollerThread()
+    {
+        var config = new ReactorConfig(RingFlags: IORING_SETUP_SQPOLL, SqThreadIdleMs: 100);
+        await using var server = new ZergTestServer(EchoHandler, reactorCount: 2, reactorConfig: config,
+            executionMode: ExecutionMode.ThreadPerCore, shareSqPollThread: true);
+        await Task.Delay(200);
+
+        await RunConcurrentEchoes(server.Port, connections: 8, rounds: 3);
+
+        int pollers = Directory.GetDirectories("/proc/self/task")
+            .Count(task => File.ReadAllText(Path.Combine(task, "comm")).StartsWith("iou-sqp"));
+        Assert.True(pollers <= 1, $"sq poller threads={pollers}");
+    }
+
+    // ========================================================================
+    // Helpers
+    // ========================================================================
+
+    private static async Task RunConcurrentEchoes(int port, int connections, int rounds)
+    {
+        var tasks = Enumerable.Range(0, connections).Select(async i =>
+        {
+            using var client = new TcpClient();
+            await client.ConnectAsync("127.0.0.1", port);
+            var stream = client.GetStream();
+
+            for (int round = 0; round < rounds; round++)
+            {
+                var sent = new byte[256];
+                for (int k = 0; k < sent.Length; k++)
+                    sent[k] = (byte)(i + round + k * 7);
+                await stream.WriteAsync(sent);
+
+                var received = new byte[sent.Length];
+                int read = 0;
+                while (read < received.Length)
+                {
+                    var n = await stream.ReadAsync(received.AsMemory(read));
+                    if (n == 0) break;
+                    read += n;
+                }
+                Assert.Equal(sent, received);
+            }
+        });
+
+        await Task.WhenAll(tasks).WaitAsync(TimeSpan.FromSeconds(20));
+    }
+}
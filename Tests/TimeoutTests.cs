@@ -0,0 +1,194 @@
+using System.Diagnostics;
+using System.Net.Sockets;
+using Xunit;
+using zerg;
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// Runs E2E tests against the reactor's timing wheel: idle and read-header deadlines close silent clients,
+/// traffic keeps a connection alive, a non-reading peer trips the flush timeout, and expirations are counted.
+/// </summary>
+public class TimeoutTests
+{
+    [Fact]
+    public async Task Idle_SilentClient_IsClosed()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256, IdleTimeoutMs: 200);
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        var sw = Stopwatch.StartNew();
+
+        int n = await client.GetStream().ReadAsync(new byte[16]).AsTask().WaitAsync(TimeSpan.FromSeconds(5));
+
+        Assert.Equal(0, n);
+        Assert.True(sw.ElapsedMilliseconds >= 150, $"closed after {sw.ElapsedMilliseconds} ms");
+        ReactorMetrics m = server.Engine.Reactors[0].GetMetrics();
+        Assert.Equal(1, m.IdleTimeouts);
+        Assert.Equal(1, m.TimerExpirations);
+    }
+
+    [Fact]
+    public async Task Idle_ActiveClient_StaysOpen()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256, IdleTimeoutMs: 300);
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        NetworkStream stream = client.GetStream();
+
+        // Ten round trips 100 ms apart outlive the timeout three times over.
+        var buffer = new byte[1];
+        for (int i = 0; i < 10; i++)
+        {
+            await stream.WriteAsync(new[] { (byte)i });
+            int n = await stream.ReadAsync(buffer).AsTask().WaitAsync(TimeSpan.FromSeconds(5));
+            Assert.Equal(1, n);
+            Assert.Equal((byte)i, buffer[0]);
+            await Task.Delay(100);
+        }
+
+        Assert.Equal(0, server.Engine.Reactors[0].GetMetrics().TimerExpirations);
+    }
+
+    [Fact]
+    public async Task ReadHeader_IncompleteHeader_IsClosed()
+    {
+        // The handler arms a 200 ms header deadline on accept and clears it on a blank line; the client
+        // trickles header bytes (defeating any idle timeout) but never finishes.
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256, IdleTimeoutMs: 10_000);
+        await using var server = new ZergTestServer(HeaderHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        NetworkStream stream = client.GetStream();
+        Task<int> read = stream.ReadAsync(new byte[16]).AsTask();
+
+        for (int i = 0; i < 20 && !read.IsCompleted; i++)
+        {
+            try { await stream.WriteAsync("X"u8.ToArray()); }
+            catch (IOException) { break; }
+            await Task.Delay(50);
+        }
+
+        Assert.Equal(0, await read.WaitAsync(TimeSpan.FromSeconds(5)));
+        ReactorMetrics m = server.Engine.Reactors[0].GetMetrics();
+        Assert.Equal(1, m.ReadHeaderTimeouts);
+        Assert.Equal(0, m.IdleTimeouts);
+    }
+
+    [Fact]
+    public async Task ReadHeader_Cleared_ConnectionStaysOpen()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256);
+        await using var server = new ZergTestServer(HeaderHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        NetworkStream stream = client.GetStream();
+        await stream.WriteAsync("GET / HTTP/1.1\r\n\r\n"u8.ToArray());
+
+        var buffer = new byte[2];
+        int n = await stream.ReadAsync(buffer).AsTask().WaitAsync(TimeSpan.FromSeconds(5));
+        Assert.Equal(2, n);
+
+        await Task.Delay(400);
+        await stream.WriteAsync("\r\n"u8.ToArray());
+        n = await stream.ReadAsync(buffer).AsTask().WaitAsync(TimeSpan.FromSeconds(5));
+        Assert.Equal(2, n);
+        Assert.Equal(0, server.Engine.Reactors[0].GetMetrics().TimerExpirations);
+    }
+
+    [Fact]
+    public async Task Flush_PeerNotReading_IsClosed()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256, FlushTimeoutMs: 300);
+        await using var server = new ZergTestServer(FloodHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient { ReceiveBufferSize = 4096 };
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        await client.GetStream().WriteAsync(new byte[] { 1 });
+
+        // Never read: the socket buffers fill up and the server's send stops making progress.
+        var deadline = Stopwatch.StartNew();
+        while (server.Engine.Reactors[0].GetMetrics().FlushTimeouts == 0 && deadline.Elapsed < TimeSpan.FromSeconds(10))
+            await Task.Delay(50);
+
+        Assert.Equal(1, server.Engine.Reactors[0].GetMetrics().FlushTimeouts);
+    }
+
+    // ========================================================================
+    // Handlers
+    // ========================================================================
+
+    /// <summary>Arms a 200 ms read-header deadline, clears it at "\r\n\r\n", then echoes.</summary>
+    private static async Task HeaderHandler(Connection connection)
+    {
+        connection.SetReadHeaderTimeout(TimeSpan.FromMilliseconds(200));
+        int matched = 0;
+        try
+        {
+            while (true)
+            {
+                var result = await connection.ReadAsync();
+                if (result.IsClosed) break;
+
+                while (connection.TryGetRing(result.TailSnapshot, out var ring))
+                {
+                    if (matched < 4 && (matched = MatchHeaderEnd(ring.AsSpan(), matched)) == 4)
+                        connection.ClearReadHeaderTimeout();
+                    if (matched == 4)
+                        connection.Write("OK"u8);
+                    connection.ReturnRing(ring.BufferId);
+                }
+                await connection.FlushAsync();
+                connection.ResetRead();
+            }
+        }
+        catch { /* connection gone */ }
+    }
+
+    /// <summary>Advances a "\r\n\r\n" match over <paramref name="data"/>; 4 once it is complete.</summary>
+    private static int MatchHeaderEnd(ReadOnlySpan<byte> data, int matched)
+    {
+        foreach (byte b in data)
+        {
+            matched = b == "\r\n\r\n"u8[matched] ? matched + 1 : b == (byte)'\r' ? 1 : 0;
+            if (matched == 4)
+                break;
+        }
+        return matched;
+    }
+
+    /// <summary>Writes 64 KB chunks until the connection closes.</summary>
+    private static async Task FloodHandler(Connection connection)
+    {
+        var result = await connection.ReadAsync();
+        if (result.IsClosed) return;
+        while (connection.TryGetRing(result.TailSnapshot, out var ring))
+            connection.ReturnRing(ring.BufferId);
+        connection.ResetRead();
+
+        var chunk = new byte[64 * 1024];
+        try
+        {
+            for (int i = 0; i < 10_000; i++)
+            {
+                connection.Write(chunk.AsSpan());
+                await connection.FlushAsync().AsTask().WaitAsync(TimeSpan.FromSeconds(15));
+            }
+        }
+        catch { /* connection gone */ }
+    }
+}
@@ -0,0 +1,125 @@
+using System.Net.Sockets;
+using Xunit;
+using zerg;
+using zerg.Engine;
+using zerg.Engine.Configs;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// Runs E2E tests against the reactor wait strategies: spinning reactors must serve request/response traffic
+/// exactly like blocking ones, account their spins, and the adaptive hybrid spin must switch itself off
+/// while the reactor is idle.
+/// </summary>
+public class WaitStrategyTests
+{
+    [Fact]
+    public async Task Hybrid_PingPong_SpinsAndEchoesIntact()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256,
+            WaitStrategy: WaitStrategy.Hybrid, SpinBudget: 200_000, AdaptiveSpin: false);
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        await PingPong(client.GetStream(), 2000);
+
+        ReactorWaitStats stats = server.Engine.Reactors[0].GetWaitStats();
+        Assert.Equal(WaitStrategy.Hybrid, stats.Strategy);
+        Assert.True(stats.Spins > 0, $"spins={stats.Spins}");
+        Assert.True(stats.SpinHits > 0, $"hits={stats.SpinHits}");
+        Assert.True(stats.SpinHits <= stats.Spins);
+        Assert.True(stats.WastedSpinTimeNs <= stats.SpinTimeNs);
+        Assert.InRange(stats.WastedSpinRatio, 0.0, 1.0);
+        Assert.InRange(stats.SpinLimitNs, 199_000L, 201_000L);
+    }
+
+    [Fact]
+    public async Task Hybrid_Adaptive_StopsSpinningWhenIdle()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256,
+            WaitStrategy: WaitStrategy.Hybrid, SpinBudget: 50_000);
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: config);
+
+        // Only 1 ms CQ timeouts for a while: every idle gap exceeds the budget.
+        await Task.Delay(300);
+        ReactorWaitStats idle = server.Engine.Reactors[0].GetWaitStats();
+        Assert.Equal(0, idle.SpinLimitNs);
+        Assert.True(idle.KernelWaits > 0);
+
+        // Tight request/response traffic brings the spin back.
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        await PingPong(client.GetStream(), 2000);
+
+        ReactorWaitStats busy = server.Engine.Reactors[0].GetWaitStats();
+        Assert.True(busy.Spins > idle.Spins, $"spins idle={idle.Spins} busy={busy.Spins}");
+    }
+
+    [Fact]
+    public async Task Spin_NeverBlocks_EchoIntact()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256,
+            WaitStrategy: WaitStrategy.Spin, CqTimeout: 200_000);
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        await PingPong(client.GetStream(), 500);
+        await EchoExactly(client.GetStream(), Payload(300_000, 5));
+
+        ReactorWaitStats stats = server.Engine.Reactors[0].GetWaitStats();
+        Assert.True(stats.SpinHits > 0, $"hits={stats.SpinHits}");
+        // Idle spins run out after CqTimeout and only poll the kernel.
+        Assert.True(stats.Spins >= stats.KernelWaits, $"spins={stats.Spins} waits={stats.KernelWaits}");
+    }
+
+    [Fact]
+    public async Task Block_DoesNotSpin()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256);
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        await PingPong(client.GetStream(), 200);
+
+        ReactorWaitStats stats = server.Engine.Reactors[0].GetWaitStats();
+        Assert.Equal(0, stats.Spins);
+        Assert.True(stats.KernelWaits > 0);
+    }
+
+    [Fact]
+    public async Task Napi_RegistersWhenSupported_EchoIntact()
+    {
+        var config = new ReactorConfig(RecvBufferSize: 4 * 1024, BufferRingEntries: 256,
+            NapiBusyPollTimeout: 50, WaitStrategy: WaitStrategy.Hybrid);
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        Assert.Equal(KernelCapabilities.Current.Napi, server.Engine.Reactors[0].NapiBusyPoll);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        await PingPong(client.GetStream(), 200);
+    }
+
+    // ========================================================================
+    // Helpers
+    // ========================================================================
+
+    /// <summary>Sends <paramref name="rounds"/> 64-byte messages, each after the previous echo came back.</summary>
+    private static async Task PingPong(NetworkStream stream, int rounds)
+    {
+        for (int round = 0; round < rounds; round++)
+        {
+            byte[] sent = Payload(64, (byte)round);
+            await stream.WriteAsync(sent);
+            Assert.Equal(sent, await ReadExactly(stream, sent.Length));
+        }
+    }
+}
@@ -0,0 +1,116 @@
+using System.Diagnostics;
+using System.Net.Sockets;
+using Xunit;
+using zerg;
+using zerg.Engine.Configs;
+
+namespace Tests;
+
+/// <summary>
+/// Verifies the cross-thread doorbell: a flush issued from a thread-pool thread
+/// must wake a reactor blocked in its CQ wait instead of waiting out CqTimeout.
+/// </summary>
+public class WakeupTests
+{
+    // Long enough that a missed wakeup dominates the round trip.
+    private const long SlowCqTimeout = 50_000_000; // 50 ms
+
+    [Fact]
+    public async Task OffloadedFlush_WithDoorbell_IsNotDelayedByCqTimeout()
+    {
+        double withDoorbell = await MeasureOffloadedEchoMs(crossThreadWakeup: true);
+        double withoutDoorbell = await MeasureOffloadedEchoMs(crossThreadWakeup: false);
+
+        Assert.True(withDoorbell * 5 < withoutDoorbell,
+            $"doorbell={withDoorbell:F2}ms, no doorbell={withoutDoorbell:F2}ms");
+    }
+
+    [Fact]
+    public async Task OffloadedFlush_ManyConnections_AllComplete()
+    {
+        var config = new ReactorConfig(CqTimeout: SlowCqTimeout, CrossThreadWakeup: true);
+        await using var server = new ZergTestServer(OffloadedEchoHandler, reactorCount: 2, reactorConfig: config);
+        await Task.Delay(100);
+
+        var tasks = Enumerable.Range(0, 16).Select(async i =>
+        {
+            using var client = new TcpClient();
+            await client.ConnectAsync("127.0.0.1", server.Port);
+            var stream = client.GetStream();
+
+            for (int j = 0; j < 10; j++)
+            {
+                var sent = new[] { (byte)i, (byte)j };
+                await stream.WriteAsync(sent);
+
+                var buf = new byte[16];
+                var n = await stream.ReadAsync(buf);
+                Assert.Equal(sent, buf.AsSpan(0, n).ToArray());
+            }
+        });
+
+        await Task.WhenAll(tasks).WaitAsync(TimeSpan.FromSeconds(10));
+    }
+
+    /// <summary>
+    /// Average echo round trip (ms) against a server whose handler flushes
+    /// from a thread-pool thread rather than from the reactor.
+    /// </summary>
+    private static async Task<double> MeasureOffloadedEchoMs(bool crossThreadWakeup)
+    {
+        var config = new ReactorConfig(CqTimeout: SlowCqTimeout, CrossThreadWakeup: crossThreadWakeup);
+        await using var server = new ZergTestServer(OffloadedEchoHandler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        client.NoDelay = true;
+        var stream = client.GetStream();
+        var buf = new byte[64];
+
+        // Warm up the connection (first recv arm, JIT).
+        await stream.WriteAsync(new byte[] { 0 });
+        _ = await stream.ReadAsync(buf);
+
+        const int iterations = 20;
+        var sw = Stopwatch.StartNew();
+        for (int i = 0; i < iterations; i++)
+        {
+            await stream.WriteAsync(new[] { (byte)i });
+            var n = await stream.ReadAsync(buf);
+            Assert.Equal(1, n);
+        }
+        return sw.Elapsed.TotalMilliseconds / iterations;
+    }
+
+    private static async Task OffloadedEchoHandler(Connection connection)
+    {
+        try
+        {
+            while (true)
+            {
+                var result = await connection.ReadAsync();
+                if (result.IsClosed) break;
+
+                var rings = connection.GetAllSnapshotRingsAsUnmanagedMemory(result);
+                var data = new List<byte>();
+                unsafe
+                {
+                    foreach (var ring in rings)
+                    {
+                        data.AddRange(new ReadOnlySpan<byte>(ring.Ptr, ring.Length).ToArray());
+                        connection.ReturnRing(ring.BufferId);
+                    }
+                }
+                connection.ResetRead();
+
+                // Leave the reactor thread: the write and flush below are enqueued cross-thread.
+                await Task.Yield();
+
+                connection.Write(data.ToArray().AsSpan());
+                await connection.FlushAsync();
+            }
+        }
+        catch { /* connection gone */ }
+    }
+}
@@ -0,0 +1,183 @@
+using System.Net.Sockets;
+using System.Text;
+using Xunit;
+using zerg;
+using zerg.Engine.Configs;
+
+namespace Tests;
+
+/// <summary>
+/// Runs E2E tests against writes that overlap flushes: handlers keep writing while the reactor sends,
+/// FlushAsync returns right away under the high-water mark, and only waits once the unsent backlog
+/// goes above it.
+/// </summary>
+public class WriteBackpressureTests
+{
+    [Fact]
+    public async Task Overlap_WriteWhileFlushPending_BytesArriveInOrder()
+    {
+        // Mark 0: every flush stays pending until its bytes are sent, so the handler writes under a pending flush.
+        await using var server = new ZergTestServer(OverlappingResponder, reactorConfig: new ReactorConfig(WriteHighWaterMark: 0));
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        var stream = client.GetStream();
+
+        // 200 pipelined requests in a single write; the handler answers each with its own flush.
+        const int requests = 200;
+        await stream.WriteAsync(Encoding.ASCII.GetBytes(new string('x', requests)));
+
+        var expected = new StringBuilder();
+        for (int i = 0; i < requests; i++)
+            expected.Append($"response {i:D5};");
+
+        var received = new byte[expected.Length];
+        int read = 0;
+        while (read < received.Length)
+        {
+            int n = await stream.ReadAsync(received.AsMemory(read));
+            if (n == 0) break;
+            read += n;
+        }
+
+        Assert.Equal(expected.ToString(), Encoding.ASCII.GetString(received, 0, read));
+    }
+
+    [Fact]
+    public async Task Overlap_FlushUnderHighWaterMark_CompletesSynchronously()
+    {
+        int synchronous = 0;
+        int total = 0;
+
+        async Task Handler(Connection connection)
+        {
+            try
+            {
+                while (true)
+                {
+                    var result = await connection.ReadAsync();
+                    if (result.IsClosed) break;
+                    foreach (var ring in connection.GetAllSnapshotRingsAsUnmanagedMemory(result))
+                        connection.ReturnRing(ring.BufferId);
+
+                    connection.Write(new byte[1024].AsSpan());
+                    ValueTask flush = connection.FlushAsync();
+                    Interlocked.Increment(ref total);
+                    if (flush.IsCompleted)
+                        Interlocked.Increment(ref synchronous);
+                    await flush;
+                    connection.ResetRead();
+                }
+            }
+            catch { /* connection gone */ }
+        }
+
+        await using var server = new ZergTestServer(Handler);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        var stream = client.GetStream();
+        var buffer = new byte[1024];
+        for (int i = 0; i < 10; i++)
+        {
+            await stream.WriteAsync("a"u8.ToArray());
+            int read = 0;
+            while (read < buffer.Length)
+                read += await stream.ReadAsync(buffer.AsMemory(read));
+        }
+
+        Assert.Equal(10, total);
+        Assert.Equal(10, synchronous);
+    }
+
+    [Fact]
+    public async Task Backpressure_FlushWaitsWhileBacklogAboveHighWaterMark()
+    {
+        const int size = 48 * 1024 * 1024;
+        var flushed = new TaskCompletionSource();
+
+        async Task Handler(Connection connection)
+        {
+            try
+            {
+                var result = await connection.ReadAsync();
+                if (result.IsClosed) return;
+                foreach (var ring in connection.GetAllSnapshotRingsAsUnmanagedMemory(result))
+                    connection.ReturnRing(ring.BufferId);
+
+                var chunk = new byte[64 * 1024];
+                for (int i = 0; i < size / chunk.Length; i++)
+                    connection.Write(chunk.AsSpan());
+                await connection.FlushAsync();
+                flushed.TrySetResult();
+            }
+            catch { /* connection gone */ }
+        }
+
+        var config = new ReactorConfig(WriteHighWaterMark: 64 * 1024);
+        await using var server = new ZergTestServer(Handler, reactorConfig: config);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        var stream = client.GetStream();
+        await stream.WriteAsync("go"u8.ToArray());
+
+        // The peer is not reading: far more than the mark stays unsent, so the flush must hold.
+        await Task.Delay(500);
+        Assert.False(flushed.Task.IsCompleted);
+
+        var buffer = new byte[256 * 1024];
+        long total = 0;
+        while (total < size)
+        {
+            int n = await stream.ReadAsync(buffer);
+            if (n == 0) break;
+            total += n;
+        }
+
+        Assert.Equal(size, total);
+        await flushed.Task.WaitAsync(TimeSpan.FromSeconds(5));
+    }
+
+    // ========================================================================
+    // Handlers
+    // ========================================================================
+
+    /// <summary>
+    /// Answers every request byte with a numbered response. Each response is written before the
+    /// previous flush has been awaited, i.e. while it may still be on the wire.
+    /// </summary>
+    private static async Task OverlappingResponder(Connection connection)
+    {
+        int next = 0;
+        try
+        {
+            while (true)
+            {
+                var result = await connection.ReadAsync();
+                if (result.IsClosed) break;
+
+                int requests = 0;
+                foreach (var ring in connection.GetAllSnapshotRingsAsUnmanagedMemory(result))
+                {
+                    requests += ring.Length;
+                    connection.ReturnRing(ring.BufferId);
+                }
+
+                ValueTask pending = default;
+                for (int i = 0; i < requests; i++)
+                {
+                    connection.Write(Encoding.ASCII.GetBytes($"response {next++:D5};").AsSpan());
+                    await pending;
+                    pending = connection.FlushAsync();
+                }
+                await pending;
+                connection.ResetRead();
+            }
+        }
+        catch { /* connection gone */ }
+    }
+}
@@ -2,7 +2,9 @@ using System.Net;
 using System.Net.Sockets;
 using zerg;
 using zerg.Engine;
+using zerg.Engine.Balancing;
 using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
 
 namespace Tests;
 
@@ -18,7 +20,11 @@ public sealed class ZergTestServer : IAsyncDisposable
     private readonly CancellationTokenSource _cts = new();
     private readonly Task _acceptLoop;
 
-    public ZergTestServer(Func<Connection, Task> handler, int reactorCount = 1, ReactorConfig? reactorConfig = null)
+    public ZergTestServer(Func<Connection, Task> handler, int reactorCount = 1, ReactorConfig? reactorConfig = null,
+        AcceptMode acceptMode = AcceptMode.Acceptor, bool reusePortCpuSteering = false,
+        IConnectionBalancer? balancer = null, ExecutionMode executionMode = ExecutionMode.Shared,
+        int[]? reactorCpus = null, bool shareSqPollThread = false, bool autoTune = false,
+        EngineLogLevel logLevel = EngineLogLevel.Information, Action<EngineLogEvent>? logHandler = null)
     {
         Port = GetAvailablePort();
 
@@ -28,7 +34,15 @@ public sealed class ZergTestServer : IAsyncDisposable
             Port = (ushort)Port,
             ReactorCount = reactorCount,
             Backlog = 128,
-            AcceptorConfig = new AcceptorConfig(IPVersion: IPVersion.IPv4Only),
+            AcceptMode = acceptMode,
+            ReusePortCpuSteering = reusePortCpuSteering,
+            AcceptorConfig = new AcceptorConfig(IPVersion: IPVersion.IPv4Only, Balancer: balancer),
+            ExecutionMode = executionMode,
+            ReactorCpus = reactorCpus,
+            ShareSqPollThread = shareSqPollThread,
+            AutoTune = autoTune,
+            LogLevel = logLevel,
+            LogHandler = logHandler,
             ReactorConfigs = reactorConfig != null
                 ? Enumerable.Range(0, reactorCount).Select(_ => reactorConfig).ToArray()
                 : null
@@ -0,0 +1,188 @@
+using System.Net.Sockets;
+using System.Text;
+using Xunit;
+using zerg;
+using zerg.Engine.Configs;
+using static Tests.EchoHelpers;
+
+namespace Tests;
+
+/// <summary>
+/// Runs E2E tests with SendMode.ZeroCopy (SEND_ZC from registered write slabs).
+/// Responses must arrive intact and flushes must keep completing across many cycles,
+/// which only happens if the notification CQEs are accounted for correctly.
+/// </summary>
+public class ZeroCopySendTests
+{
+    private const int ResponseSize = 12 * 1024;
+
+    private static readonly ReactorConfig ZeroCopyConfig = new(
+        SendMode: SendMode.ZeroCopy,
+        ZeroCopySendThreshold: 4 * 1024
+    );
+
+    [Fact]
+    public async Task ZeroCopy_LargeResponses_SameConnection()
+    {
+        await using var server = new ZergTestServer(LargeResponseHandler, reactorConfig: ZeroCopyConfig);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        var stream = client.GetStream();
+
+        for (int i = 0; i < 20; i++)
+        {
+            byte seed = (byte)i;
+            await stream.WriteAsync(new[] { seed });
+
+            byte[] response = await ReadExactly(stream, ResponseSize);
+            Assert.Equal(ExpectedResponse(seed), response);
+        }
+    }
+
+    [Fact]
+    public async Task ZeroCopy_BelowThreshold_FallsBackToCopy()
+    {
+        await using var server = new ZergTestServer(EchoHandler, reactorConfig: ZeroCopyConfig);
+        await Task.Delay(100);
+
+        using var client = new TcpClient();
+        await client.ConnectAsync("127.0.0.1", server.Port);
+        var stream = client.GetStream();
+
+        for (int i = 0; i < 10; i++)
+        {
+            var sent = Encoding.UTF8.GetBytes($"zc-small-{i}");
+            await stream.WriteAsync(sent);
+
+            var buf = new byte[1024];
+            var n = await stream.ReadAsync(buf);
+            Assert.Equal($"zc-small-{i}", Encoding.UTF8.GetString(buf, 0, n));
+        }
+    }
+
+    [Fact]
+    public async Task ZeroCopy_ConcurrentConnections()
+    {
+        await using var server = new ZergTestServer(LargeResponseHandler, reactorCount: 2, reactorConfig: ZeroCopyConfig);
+        await Task.Delay(100);
+
+        var tasks = Enumerable.Range(0, 16).Select(async i =>
+        {
+            using var client = new TcpClient();
+            await client.ConnectAsync("127.0.0.1", server.Port);
+            var stream = client.GetStream();
+
+            for (int j = 0; j < 5; j++)
+            {
+                byte seed = (byte)(i * 16 + j);
+                await stream.WriteAsync(new[] { seed });
+
+                byte[] response = await ReadExactly(stream, ResponseSize);
+                Assert.Equal(ExpectedResponse(seed), response);
+            }
+        });
+
+        await Task.WhenAll(tasks).WaitAsync(TimeSpan.FromSeconds(10));
+    }
+
+    [Fact]
+    public async Task ZeroCopy_CloseWithUnackedResponse_SlabNotReused()
+    {
+        // The client half-closes before reading. The server closes its side while the response is still
+        // unacknowledged, and the kernel keeps sending it from the write slab. That slab must not go to the
+        // next connection until the zero-copy notification says the kernel is done with it.
+        await using var server = new ZergTestServer(LargeResponseHandler, reactorConfig: ZeroCopyConfig);
+        await Task.Delay(100);
+
+        for (int round = 0; round < 3; round++)
+        {
+            byte seed = (byte)(round * 16);
+
+            // A small receive window that is not read yet keeps most of the response unacknowledged.
+            using var slow = new TcpClient { ReceiveBufferSize = 4096 };
+            await slow.ConnectAsync("127.0.0.1", server.Port);
+            var slowStream = slow.GetStream();
+            await slowStream.WriteAsync(new[] { seed });
+            await Task.Delay(50);
+            slow.Client.Shutdown(SocketShutdown.Send);
+            await Task.Delay(50);
+
+            // Takes the pooled connection next and fills its write slab with other responses.
+            using (var client = new TcpClient())
+            {
+                await client.ConnectAsync("127.0.0.1", server.Port);
+                var stream = client.GetStream();
+                for (int j = 1; j <= 3; j++)
+                {
+                    await stream.WriteAsync(new[] { (byte)(seed + j) });
+                    Assert.Equal(ExpectedResponse((byte)(seed + j)), await ReadExactly(stream, ResponseSize));
+                }
+            }
+
+            // Whatever of the first response arrives must be unchanged.
+            byte[] received = new byte[ResponseSize];
+            int read = 0;
+            while (read < received.Length)
+            {
+                int n = await slowStream.ReadAsync(received.AsMemory(read)).AsTask().WaitAsync(TimeSpan.FromSeconds(20));
+                if (n == 0) break;
+                read += n;
+            }
+            Assert.True(read > 0);
+            Assert.Equal(ExpectedResponse(seed).AsSpan(0, read).ToArray(), received.AsSpan(0, read).ToArray());
+        }
+    }
+
+    // ========================================================================
+    // Helpers
+    // ========================================================================
+
+    private static byte[] ExpectedResponse(byte seed)
+    {
+        var data = new byte[ResponseSize];
+        for (int i = 0; i < data.Length; i++)
+            data[i] = (byte)(seed + i * 7);
+        return data;
+    }
+
+    // ========================================================================
+    // Handlers
+    // ========================================================================
+
+    /// <summary>
+    /// Answers every 1-byte request with a <see cref="ResponseSize"/> body derived from it.
+    /// </summary>
+    private static async Task LargeResponseHandler(Connection connection)
+    {
+        try
+        {
+            while (true)
+            {
+                var result = await connection.ReadAsync();
+                if (result.IsClosed) break;
+
+                var rings = connection.GetAllSnapshotRingsAsUnmanagedMemory(result);
+                var seeds = new List<byte>();
+                unsafe
+                {
+                    foreach (var ring in rings)
+                    {
+                        for (int i = 0; i < ring.Length; i++)
+                            seeds.Add(ring.Ptr[i]);
+                        connection.ReturnRing(ring.BufferId);
+                    }
+                }
+
+                foreach (byte seed in seeds)
+                {
+                    connection.Write(ExpectedResponse(seed).AsSpan());
+                    await connection.FlushAsync();
+                }
+                connection.ResetRead();
+            }
+        }
+        catch { /* connection gone */ }
+    }
+}
@@ -75,5 +75,30 @@ public static partial class ABI {
                     $"sched_setaffinity(tid={tid}, cpu={cpu}) failed. errno={errno}. {hint}");
             }
         }
+        /// <summary>
+        /// Another hardware thread of the core <paramref name="cpu"/> belongs to (its SMT sibling),
+        /// read from sysfs <c>topology/thread_siblings_list</c>. Returns -1 without SMT or when unknown.
+        /// </summary>
+        public static int SiblingOf(int cpu) {
+            string list;
+            try {
+                list = File.ReadAllText($"/sys/devices/system/cpu/cpu{cpu}/topology/thread_siblings_list").Trim();
+            }
+            catch (IOException) { return -1; }
+            catch (UnauthorizedAccessException) { return -1; }
+
+            // Comma separated CPUs and ranges, e.g. "2,66" or "2-3"
+            foreach (string part in list.Split(',')) {
+                string[] range = part.Split('-');
+                if (!int.TryParse(range[0], out int first))
+                    continue;
+                int last = range.Length > 1 && int.TryParse(range[1], out int end) ? end : first;
+                for (int sibling = first; sibling <= last; sibling++) {
+                    if (sibling != cpu)
+                        return sibling;
+                }
+            }
+            return -1;
+        }
     }
 }
\ No newline at end of file
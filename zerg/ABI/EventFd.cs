@@ -0,0 +1,30 @@
+using System.Runtime.InteropServices;
+
+namespace zerg.ABI;
+
+public static partial class ABI {
+    // ------------------------------------------------------------------------------------
+    //  libc EVENTFD INTEROP
+    // ------------------------------------------------------------------------------------
+    /// <summary>
+    /// Creates an eventfd with initial counter <paramref name="initval"/>.
+    /// Returns the new fd, or -1 on error (check errno).
+    /// </summary>
+    [DllImport("libc", SetLastError = true)] internal static extern int eventfd(uint initval, int flags);
+    /// <summary>
+    /// Adds <paramref name="value"/> to the eventfd counter, waking any poller.
+    /// Returns 0 on success, -1 on error.
+    /// </summary>
+    [DllImport("libc")] internal static extern int eventfd_write(int fd, ulong value);
+    /// <summary>
+    /// Reads and resets the eventfd counter into <paramref name="value"/>.
+    /// Returns 0 on success, -1 on error (EAGAIN when non-blocking and the counter is zero).
+    /// </summary>
+    [DllImport("libc")] internal static extern int eventfd_read(int fd, out ulong value);
+    // ----- eventfd constants -----
+    internal const int EFD_NONBLOCK = 0x800;   // O_NONBLOCK
+    internal const int EFD_CLOEXEC  = 0x80000; // O_CLOEXEC
+    // ----- poll(2) event bits -----
+    internal const uint POLLIN      = 0x001;
+    internal const uint POLLOUT     = 0x004;
+}
@@ -25,4 +25,24 @@ public static partial class ABI{
         public long tv_sec;   // seconds (signed 64-bit)
         public long tv_nsec;  // nanoseconds (signed 64-bit)
     }
-}
\ No newline at end of file
+
+    // ------------------------------------------------------------------------------------
+    //  ERRNO VALUES (negated in CQE res)
+    // ------------------------------------------------------------------------------------
+    /// <summary>Operation canceled: the request was stopped by an async cancel.</summary>
+    internal const int ECANCELED = 125;
+    /// <summary>No buffer space: a buffer-select request found its provided-buffer group empty.</summary>
+    internal const int ENOBUFS = 105;
+    /// <summary>Try again: a non-blocking socket or pipe was not ready.</summary>
+    internal const int EAGAIN = 11;
+    /// <summary>Broken pipe: the peer can no longer receive.</summary>
+    internal const int EPIPE = 32;
+    /// <summary>Not connected: the socket is not (or no longer) connected.</summary>
+    internal const int ENOTCONN = 107;
+    /// <summary>I/O error: e.g. a GSO send the device cannot segment or checksum.</summary>
+    internal const int EIO = 5;
+    /// <summary>Invalid argument.</summary>
+    internal const int EINVAL = 22;
+    /// <summary>Timed out: the reactor closed the connection when one of its deadlines expired.</summary>
+    internal const int ETIMEDOUT = 110;
+}
@@ -9,7 +9,7 @@ public static unsafe partial class ABI{
     /// <summary>
     /// Creates a socket (e.g., <see cref="AF_INET"/> + <see cref="SOCK_STREAM"/>).
     /// </summary>
-    [DllImport("libc")] internal static extern int socket(int domain, int type, int proto);
+    [DllImport("libc", SetLastError = true)] internal static extern int socket(int domain, int type, int proto);
     /// <summary>
     /// Sets a socket option; pass pointers to option data via <paramref name="optval"/>.
     /// Returns 0 on success, -1 on error (check errno).
@@ -40,16 +40,33 @@ public static unsafe partial class ABI{
     /// </summary>
     [DllImport("libc")] internal static extern int close(int fd);
     /// <summary>
+    /// Writes the address of the peer connected to <paramref name="fd"/> into <paramref name="addr"/>
+    /// (up to <paramref name="len"/> bytes; <paramref name="len"/> receives the actual size). Returns 0 on success, -1 on error.
+    /// </summary>
+    [DllImport("libc")] internal static extern int getpeername(int fd, void* addr, uint* len);
+    /// <summary>
     /// Converts text IP (&quot;0.0.0.0&quot;, &quot;127.0.0.1&quot;, etc.) to binary form into <paramref name="dst"/>.
     /// Returns 1 on success, 0 on invalid text, or -1 on error (errno set).
     /// </summary>
     [DllImport("libc")] internal static extern int inet_pton(int af, sbyte* src, void* dst);
+    /// <summary>
+    /// Creates a pipe; <paramref name="fds"/>[0] is the read end, [1] the write end.
+    /// Returns 0 on success, -1 on error (errno set).
+    /// </summary>
+    [DllImport("libc", SetLastError = true)] internal static extern int pipe2(int* fds, int flags);
+    /// <summary>
+    /// Writes the address <paramref name="fd"/> is bound to into <paramref name="addr"/>
+    /// (up to <paramref name="len"/> bytes; <paramref name="len"/> receives the actual size). Returns 0 on success, -1 on error.
+    /// </summary>
+    [DllImport("libc")] internal static extern int getsockname(int fd, void* addr, uint* len);
     // ----- socket constants -----
     internal const int AF_INET      = 2;
     internal const int SOCK_STREAM  = 1;
+    internal const int SOCK_DGRAM   = 2;
     internal const int SOL_SOCKET   = 1;
     internal const int SO_REUSEADDR = 2;
     internal const int SO_REUSEPORT = 15;
+    internal const int SO_ATTACH_REUSEPORT_CBPF = 51;
     // ----- IPv6 constants -----
     internal const int AF_INET6     = 10;  // Linux: 10
     internal const int IPPROTO_IPV6 = 41;  // Linux: 41
@@ -59,11 +76,91 @@ public static unsafe partial class ABI{
     internal const int IPPROTO_TCP  = 6;
     internal const int TCP_NODELAY  = 1;
 
+    // UDP socket options (level SOL_UDP == IPPROTO_UDP)
+    internal const int SOL_UDP      = 17;
+    internal const int UDP_SEGMENT  = 103; // sendmsg cmsg: GSO segment size (uint16)
+    internal const int UDP_GRO      = 104; // setsockopt: coalesce received datagrams; recvmsg cmsg: segment size (int)
+    internal const int MSG_TRUNC    = 0x20;
+
     internal const int F_GETFL      = 3;
     internal const int F_SETFL      = 4;
     internal const int O_NONBLOCK   = 0x800;
     internal const int SOCK_NONBLOCK= 0x800; // for accept4/Socket flags (matches Linux)
+    internal const int SOCK_CLOEXEC = 0x80000;
+    internal const int O_CLOEXEC    = 0x80000;
+    internal const int SHUT_WR      = 1;
+
+    // ----- classic BPF (<linux/filter.h>, <linux/bpf_common.h>) -----
+    internal const ushort BPF_LD   = 0x00;
+    internal const ushort BPF_ALU  = 0x04;
+    internal const ushort BPF_RET  = 0x06;
+    internal const ushort BPF_W    = 0x00;
+    internal const ushort BPF_ABS  = 0x20;
+    internal const ushort BPF_MOD  = 0x90;
+    internal const ushort BPF_K    = 0x00;
+    internal const ushort BPF_A    = 0x10;
+    /// <summary>Base offset of the ancillary-data loads (SKF_AD_OFF).</summary>
+    internal const int SKF_AD_OFF  = -0x1000;
+    /// <summary>Ancillary load: id of the CPU processing the packet.</summary>
+    internal const int SKF_AD_CPU  = 36;
+
+    /// <summary>
+    /// One classic BPF instruction (<c>struct sock_filter</c>).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct sock_filter {
+        public ushort code;
+        public byte   jt;
+        public byte   jf;
+        public uint   k;
+    }
+    /// <summary>
+    /// Classic BPF program passed to setsockopt (<c>struct sock_fprog</c>).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct sock_fprog {
+        public ushort       len;
+        public sock_filter* filter;
+    }
     
+#pragma warning disable CS8981 // all-lowercase names on purpose: they mirror the C structs
+    /// <summary>
+    /// One scatter/gather element (<c>struct iovec</c>).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct iovec {
+        public void* iov_base;
+        public nuint iov_len;
+    }
+    /// <summary>
+    /// Message header for sendmsg/recvmsg (<c>struct msghdr</c>, 64-bit layout).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct msghdr {
+        public void*  msg_name;
+        public uint   msg_namelen;
+        public iovec* msg_iov;
+        public nuint  msg_iovlen;
+        public void*  msg_control;
+        public nuint  msg_controllen;
+        public int    msg_flags;
+    }
+
+    /// <summary>
+    /// Ancillary data header (<c>struct cmsghdr</c>, 64-bit layout); the data follows at offset 16.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct cmsghdr {
+        public nuint cmsg_len;
+        public int   cmsg_level;
+        public int   cmsg_type;
+    }
+#pragma warning restore CS8981
+
+    /// <summary><c>CMSG_LEN</c>: header plus <paramref name="dataLength"/> bytes of data.</summary>
+    internal static int CmsgLen(int dataLength) => sizeof(cmsghdr) + dataLength;
+    /// <summary><c>CMSG_SPACE</c>: <see cref="CmsgLen"/> rounded up to the 8-byte alignment of the next header.</summary>
+    internal static int CmsgSpace(int dataLength) => sizeof(cmsghdr) + ((dataLength + 7) & ~7);
     /// <summary>
     /// IPv4 address storage (network byte order).
     /// </summary>
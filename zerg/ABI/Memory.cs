@@ -0,0 +1,52 @@
+using System.Runtime.InteropServices;
+
+namespace zerg.ABI;
+
+public static unsafe partial class ABI {
+    // ------------------------------------------------------------------------------------
+    //  libc MEMORY INTEROP
+    // ------------------------------------------------------------------------------------
+    /// <summary>Size of a base page on the platforms zerg targets (x86_64 / aarch64 with 4K pages).</summary>
+    internal const int PAGE_SIZE = 4096;
+    /// <summary>Size of the huge pages zerg asks for (the default hugetlb / THP size on x86_64 and aarch64).</summary>
+    internal const int HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    internal const int PROT_READ     = 0x1;
+    internal const int PROT_WRITE    = 0x2;
+    internal const int MAP_PRIVATE   = 0x02;
+    internal const int MAP_ANONYMOUS = 0x20;
+    /// <summary>Do not charge the mapping against the commit limit: reserve address space only.</summary>
+    internal const int MAP_NORESERVE = 0x4000;
+    /// <summary>Back the mapping with pages from the hugetlb pool (fails when the pool is empty).</summary>
+    internal const int MAP_HUGETLB   = 0x40000;
+    /// <summary>With <see cref="MAP_HUGETLB"/>: 2 MB pages (log2(2 MB) &lt;&lt; MAP_HUGE_SHIFT).</summary>
+    internal const int MAP_HUGE_2MB  = 21 << 26;
+    /// <summary><see cref="madvise"/>: drop the pages; the next touch maps fresh zero pages.</summary>
+    internal const int MADV_DONTNEED = 4;
+    /// <summary><see cref="madvise"/>: let transparent huge pages back the range.</summary>
+    internal const int MADV_HUGEPAGE = 14;
+    /// <summary><see cref="madvise"/>: fault the range in writable now (Linux 5.14+; EINVAL before).</summary>
+    internal const int MADV_POPULATE_WRITE = 23;
+    /// <summary>Value returned by <see cref="mmap"/> on failure (<c>(void*)-1</c>).</summary>
+    internal static readonly void* MAP_FAILED = (void*)-1;
+
+    /// <summary>
+    /// Maps <paramref name="length"/> bytes. Anonymous private mappings are page aligned and
+    /// committed lazily: a page only becomes resident when it is first written.
+    /// Returns <see cref="MAP_FAILED"/> on error.
+    /// </summary>
+    [DllImport("libc")] internal static extern void* mmap(void* addr, nuint length, int prot, int flags, int fd, nint offset);
+    /// <summary>Unmaps a region returned by <see cref="mmap"/>. Returns 0 on success, -1 on error.</summary>
+    [DllImport("libc")] internal static extern int munmap(void* addr, nuint length);
+    /// <summary>
+    /// Gives the kernel advice about [<paramref name="addr"/>, addr + <paramref name="length"/>).
+    /// <paramref name="addr"/> must be page aligned. Returns 0 on success, -1 on error.
+    /// </summary>
+    [DllImport("libc")] internal static extern int madvise(void* addr, nuint length, int advice);
+    /// <summary>
+    /// Reports which pages of [<paramref name="addr"/>, addr + <paramref name="length"/>) are resident:
+    /// one byte per page in <paramref name="vec"/>, bit 0 set when resident.
+    /// <paramref name="addr"/> must be page aligned. Returns 0 on success, -1 on error.
+    /// </summary>
+    [DllImport("libc")] internal static extern int mincore(void* addr, nuint length, byte* vec);
+}
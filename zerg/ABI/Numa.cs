@@ -0,0 +1,70 @@
+using System.Runtime.InteropServices;
+
+namespace zerg.ABI;
+
+public static unsafe partial class ABI {
+    // ------------------------------------------------------------------------------------
+    //  NUMA PLACEMENT
+    // ------------------------------------------------------------------------------------
+    /// <summary>
+    /// Minimal NUMA helpers (no libnuma dependency): which node the calling thread runs on,
+    /// and a memory policy that places a mapping's pages on a given node.
+    /// <para>
+    /// Best-effort like <see cref="Affinity"/>: on single-node machines, in containers that
+    /// forbid mbind, or on unknown architectures the calls report failure and memory stays
+    /// under the default (first-touch) policy.
+    /// </para>
+    /// </summary>
+    internal static class Numa {
+        /// <summary>mbind mode: allocate on the given node, fall back to others when it is full.</summary>
+        internal const int MPOL_PREFERRED = 1;
+
+        [DllImport("libc")] private static extern int sched_getcpu();
+        [DllImport("libc")] private static extern long syscall(long n, void* addr, nuint len, int mode, ulong* nodemask, nuint maxnode, uint flags);
+
+        /// <summary>
+        /// NUMA node of the CPU the calling thread is running on (the CPU it is pinned to, once pinned),
+        /// or -1 when it cannot be determined.
+        /// </summary>
+        public static int CurrentNode() {
+            int cpu = sched_getcpu();
+            return cpu < 0 ? -1 : NodeOfCpu(cpu);
+        }
+
+        /// <summary>
+        /// NUMA node of <paramref name="cpu"/> read from sysfs (<c>/sys/devices/system/cpu/cpuN/nodeM</c>),
+        /// or -1 when the machine exposes no NUMA topology.
+        /// </summary>
+        public static int NodeOfCpu(int cpu) {
+            try {
+                foreach (string entry in Directory.EnumerateDirectories($"/sys/devices/system/cpu/cpu{cpu}", "node*")) {
+                    if (int.TryParse(Path.GetFileName(entry).AsSpan(4), out int node))
+                        return node;
+                }
+            }
+            catch (IOException) { }
+            catch (UnauthorizedAccessException) { }
+            return -1;
+        }
+
+        /// <summary>
+        /// Sets a <see cref="MPOL_PREFERRED"/> policy for [<paramref name="addr"/>, addr + <paramref name="length"/>)
+        /// so its pages are allocated on <paramref name="node"/> when first touched.
+        /// Must be called before the range is faulted in. Returns false if the policy could not be applied.
+        /// </summary>
+        public static bool PreferNode(void* addr, nuint length, int node) {
+            if (node < 0 || node >= 64)
+                return false;
+            long nr = RuntimeInformation.ProcessArchitecture switch {
+                Architecture.X64   => 237, // SYS_mbind
+                Architecture.Arm64 => 235,
+                _                  => -1
+            };
+            if (nr < 0)
+                return false;
+
+            ulong mask = 1UL << node;
+            return syscall(nr, addr, length, MPOL_PREFERRED, &mask, 65, 0) == 0; // maxnode counts one past the last bit
+        }
+    }
+}
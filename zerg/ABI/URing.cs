@@ -44,6 +44,43 @@ public static unsafe partial class ABI{
         internal uint  flags;
     }
     /// <summary>
+    /// Compact completion record filled by <see cref="shim_harvest_cqes"/>.
+    /// <para>
+    /// Mirrors <c>shim_cqe</c> in uringshim.h. Unlike <see cref="io_uring_cqe"/> it is a copy,
+    /// owned by the caller: it stays valid after the CQ head has moved past the original entry.
+    /// </para>
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct shim_cqe {
+        internal ulong user_data;
+        internal int   res;
+        internal uint  flags;
+    }
+    /// <summary>
+    /// What the running kernel supports, filled by <see cref="shim_probe"/>.
+    /// <para>Mirrors <c>shim_probe_result</c> in uringshim.h.</para>
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct shim_probe_result {
+        internal uint setup_flags; // IORING_SETUP_* bits accepted by trial setups
+        internal uint features;    // IORING_FEAT_* bits of a plain ring
+        internal uint caps;        // SHIM_CAP_* bits
+        internal uint last_op;     // highest opcode the kernel knows
+        internal fixed ulong ops[4]; // bit n set: IORING_OP n is supported
+    }
+    /// <summary>
+    /// Header the kernel writes at the start of every buffer filled by a multishot <c>recvmsg</c>
+    /// (<c>struct io_uring_recvmsg_out</c>). The lengths are the untruncated ones; <c>flags</c> carries
+    /// <c>msg_flags</c> such as <see cref="MSG_TRUNC"/>.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct io_uring_recvmsg_out {
+        internal uint namelen;
+        internal uint controllen;
+        internal uint payloadlen;
+        internal uint flags;
+    }
+    /// <summary>
     /// Opaque token representing a <c>io_uring_buf_ring</c>.
     /// <para>
     /// All manipulation is done via shim functions; we never dereference this in C#.
@@ -65,6 +102,10 @@ public static unsafe partial class ABI{
     /// </summary>
     [DllImport("uringshim")] internal static extern io_uring* shim_create_ring(uint entries, out int err);
     [DllImport("uringshim")] internal static extern uint shim_get_ring_flags(io_uring* ring);
+    /// <summary>
+    /// Returns the <c>IORING_FEAT_*</c> bits the kernel reported when the ring was set up.
+    /// </summary>
+    [DllImport("uringshim")] internal static extern uint shim_get_ring_features(io_uring* ring);
     [DllImport("uringshim")] internal static extern io_uring* shim_create_ring_ex(
         uint entries,
         uint flags,
@@ -72,6 +113,39 @@ public static unsafe partial class ABI{
         uint sq_thread_idle_ms,
         out int err);
     /// <summary>
+    /// Like <see cref="shim_create_ring_ex"/>; when <paramref name="wq_fd"/> is a ring fd (see <see cref="shim_ring_fd"/>)
+    /// the ring is set up with <see cref="IORING_SETUP_ATTACH_WQ"/>: with SQPOLL it shares that ring's SQ thread
+    /// and kernel worker pool instead of spawning its own. Pass -1 for a standalone ring.
+    /// </summary>
+    [DllImport("uringshim")] internal static extern io_uring* shim_create_ring_attach(
+        uint entries,
+        uint flags,
+        int  sq_thread_cpu,
+        uint sq_thread_idle_ms,
+        int  wq_fd,
+        out int err);
+    /// <summary>File descriptor of the ring, used as <c>wq_fd</c> by rings that attach to it.</summary>
+    [DllImport("uringshim")] internal static extern int shim_ring_fd(io_uring* ring);
+    /// <summary>
+    /// Probes the running kernel: opcodes (<c>io_uring_get_probe_ring</c>), feature bits, setup flags
+    /// accepted by trial ring setups, and <c>SHIM_CAP_*</c> registrations. Sets up and tears down a few
+    /// small rings, so call it once and cache the result.
+    /// Returns 0, or a negative errno if io_uring is unavailable.
+    /// </summary>
+    [DllImport("uringshim")] internal static extern int shim_probe(shim_probe_result* result);
+    /// <summary>
+    /// Registers the ring fd with the calling thread (<c>io_uring_register_ring_fd</c>), so liburing's
+    /// enter calls on this ring skip the fd table lookup. Call it from the thread that submits and waits.
+    /// Returns 1 on success or a negative errno.
+    /// </summary>
+    [DllImport("uringshim")] internal static extern int shim_register_ring_fd(io_uring* ring);
+    /// <summary>
+    /// Enables NAPI busy polling (io_uring_register_napi, Linux 6.9+): CQ waits busy-poll the NAPI
+    /// contexts of the ring's sockets for up to <paramref name="busyPollUs"/> microseconds before sleeping.
+    /// Returns 0 or a negative errno.
+    /// </summary>
+    [DllImport("uringshim")] internal static extern int shim_register_napi(io_uring* ring, uint busyPollUs, int preferBusyPoll);
+    /// <summary>
     /// Destroys a ring created with <see cref="shim_create_ring"/> and releases native resources.
     /// Safe to call with <c>null</c>.
     /// </summary>
@@ -79,32 +153,36 @@ public static unsafe partial class ABI{
     // ------------------------------------------------------------------------------------
     //  SHIM: QUEUE OPS
     // ------------------------------------------------------------------------------------
+    // Imports called on the reactor hot path use LibraryImport. Those that never enter the
+    // kernel or block (SQE/CQE bookkeeping, buf-ring updates) also carry SuppressGCTransition,
+    // turning each call into a plain native call. Anything that may reach io_uring_enter
+    // (submit/wait/peek) keeps the GC transition.
     /// <summary>
     /// Acquires a fresh SQE from the ring (may return <c>null</c> if SQ is full).
     /// </summary>
-    [DllImport("uringshim")] internal static extern io_uring_sqe* shim_get_sqe(io_uring* ring);
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial io_uring_sqe* shim_get_sqe(io_uring* ring);
     /// <summary>
     /// Submits pending SQEs to the kernel. Returns number of submitted entries or -errno.
     /// </summary>
-    [DllImport("uringshim")] internal static extern int shim_submit(io_uring* ring);
+    [LibraryImport("uringshim")] internal static partial int shim_submit(io_uring* ring);
     /// <summary>
     /// Blocks until a CQE is available. Returns 0 on success or -errno on error/interrupt.
     /// The out <paramref name="cqe"/> receives the pointer to the available CQE.
     /// </summary>
-    [DllImport("uringshim")] internal static extern int shim_wait_cqe(io_uring* ring, io_uring_cqe** cqe);
+    [LibraryImport("uringshim")] internal static partial int shim_wait_cqe(io_uring* ring, io_uring_cqe** cqe);
     /// <summary>
     /// Non-blocking peek for up to <paramref name="count"/> CQEs into the given buffer.
     /// Returns the number of CQEs copied (0 if none available), or -errno on failure.
     /// </summary>
-    [DllImport("uringshim")] internal static extern int shim_peek_batch_cqe(io_uring* ring, io_uring_cqe** cqes, uint count);
+    [LibraryImport("uringshim")] internal static partial int shim_peek_batch_cqe(io_uring* ring, io_uring_cqe** cqes, uint count);
     /// <summary>
     /// Marks a CQE as seen/consumed, advancing the ring's CQ head.
     /// </summary>
-    [DllImport("uringshim")] internal static extern void shim_cqe_seen(io_uring* ring, io_uring_cqe* cqe);
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_cqe_seen(io_uring* ring, io_uring_cqe* cqe);
     /// <summary>
     /// Returns how many SQEs are ready (available) to be filled without blocking.
     /// </summary>
-    [DllImport("uringshim")] internal static extern uint shim_sq_ready(io_uring* ring);
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial uint shim_sq_ready(io_uring* ring);
     // ------------------------------------------------------------------------------------
     //  SHIM: QUEUE OPS (ADVANCED / HIGH-PERF)
     // ------------------------------------------------------------------------------------
@@ -131,8 +209,8 @@ public static unsafe partial class ABI{
     /// <returns>
     /// Number of SQEs submitted on success, or <c>-errno</c> on error.
     /// </returns>
-    [DllImport("uringshim")]
-    internal static extern int shim_submit_and_wait(io_uring* ring, uint waitNr);
+    [LibraryImport("uringshim")]
+    internal static partial int shim_submit_and_wait(io_uring* ring, uint waitNr);
     /// <summary>
     /// Flushes pending SQEs (liburing), submits them, then waits until at least <paramref name="waitNr"/>
     /// CQEs are available or the timeout elapses. On success, writes up to <paramref name="waitNr"/>
@@ -142,8 +220,8 @@ public static unsafe partial class ABI{
     /// On success: number of CQE pointers written into <paramref name="cqes"/> (typically 1..waitNr).
     /// On failure: -errno (e.g. -ETIME on timeout).
     /// </returns>
-    [DllImport("uringshim")]
-    internal static extern int shim_submit_and_wait_timeout(
+    [LibraryImport("uringshim")]
+    internal static partial int shim_submit_and_wait_timeout(
         io_uring* ring,
         io_uring_cqe** cqes,
         uint waitNr,
@@ -195,8 +273,8 @@ public static unsafe partial class ABI{
     /// On success, returns the number of submitted SQEs.
     /// On failure, returns <c>-errno</c> (e.g., <c>-EINTR</c>, <c>-ETIME</c>).
     /// </returns>
-    [DllImport("uringshim")]
-    internal static extern int shim_enter(
+    [LibraryImport("uringshim")]
+    internal static partial int shim_enter(
         io_uring* ring,
         uint toSubmit,
         uint minComplete,
@@ -219,8 +297,8 @@ public static unsafe partial class ABI{
     /// </summary>
     /// <param name="ring">The io_uring instance.</param>
     /// <param name="count">Number of CQEs to mark as seen.</param>
-    [DllImport("uringshim")]
-    internal static extern void shim_cq_advance(io_uring* ring, uint count);
+    [LibraryImport("uringshim"), SuppressGCTransition]
+    internal static partial void shim_cq_advance(io_uring* ring, uint count);
     /// <summary>
     /// Returns the number of completion queue entries (CQEs) that are
     /// currently available to be consumed.
@@ -237,8 +315,31 @@ public static unsafe partial class ABI{
     /// </summary>
     /// <param name="ring">The io_uring instance.</param>
     /// <returns>Number of ready CQEs in the completion queue.</returns>
-    [DllImport("uringshim")]
-    internal static extern uint shim_cq_ready(io_uring* ring);
+    [LibraryImport("uringshim"), SuppressGCTransition]
+    internal static partial uint shim_cq_ready(io_uring* ring);
+    /// <summary>
+    /// Copies up to <paramref name="max"/> ready CQEs into <paramref name="cqes"/> and advances
+    /// the CQ head past them, all in one native call.
+    ///
+    /// <para>
+    /// Replaces the peek + per-CQE accessor + advance sequence: a batch of N completions costs
+    /// one transition instead of several per CQE. Never enters the kernel; when it returns 0 the
+    /// caller should submit/wait, which also flushes deferred task_work.
+    /// </para>
+    /// </summary>
+    /// <param name="ring">The io_uring instance.</param>
+    /// <param name="cqes">Caller-owned (native or pinned) array of at least <paramref name="max"/> records.</param>
+    /// <param name="max">Capacity of <paramref name="cqes"/>.</param>
+    /// <returns>Number of records written (0..max).</returns>
+    [LibraryImport("uringshim"), SuppressGCTransition]
+    internal static partial int shim_harvest_cqes(io_uring* ring, shim_cqe* cqes, uint max);
+    /// <summary>
+    /// One poll of a busy-waiting reactor: returns the number of CQEs ready. When the kernel flagged
+    /// pending task work (<c>IORING_SQ_TASKRUN</c>, see <see cref="IORING_SETUP_TASKRUN_FLAG"/>) it first
+    /// runs a non-blocking <c>io_uring_get_events</c>; otherwise it never enters the kernel.
+    /// </summary>
+    [LibraryImport("uringshim")]
+    internal static partial uint shim_poll_cqes(io_uring* ring);
     // ------------------------------------------------------------------------------------
     //  SHIM: PREP OPS (SQE FILLERS)
     // ------------------------------------------------------------------------------------
@@ -249,7 +350,12 @@ public static unsafe partial class ABI{
     /// <paramref name="flags"/> maps to <c>accept4</c> flags (e.g., <c>SOCK_NONBLOCK</c>).
     /// </para>
     /// </summary>
-    [DllImport("uringshim")] internal static extern void shim_prep_multishot_accept(io_uring_sqe* sqe, int lfd, int flags);
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_multishot_accept(io_uring_sqe* sqe, int lfd, int flags);
+    /// <summary>
+    /// Like <see cref="shim_prep_multishot_accept"/>, but accepted sockets go straight into a free slot of the
+    /// ring's fixed-file table (<c>IORING_FILE_INDEX_ALLOC</c>): <c>res</c> is the slot, not a process fd.
+    /// </summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_multishot_accept_direct(io_uring_sqe* sqe, int lfd, int flags);
     /// <summary>
     /// Prepares a multishot <c>recv</c> using buffer selection (buf-ring).
     /// <para>
@@ -257,26 +363,136 @@ public static unsafe partial class ABI{
     /// <paramref name="flags"/> maps to <c>recv</c> flags (e.g., <c>MSG_WAITALL</c>).
     /// </para>
     /// </summary>
-    [DllImport("uringshim")] internal static extern void shim_prep_recv_multishot_select(io_uring_sqe* sqe, int fd, uint buf_group, int flags);
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_recv_multishot_select(io_uring_sqe* sqe, int fd, uint buf_group, int flags);
+    /// <summary>
+    /// Prepares a multishot <c>recv</c> in bundle mode (<c>IORING_RECVSEND_BUNDLE</c>).
+    /// <para>
+    /// One CQE may cover several provided buffers: the kernel fills consecutive buf-ring entries,
+    /// starting with the buffer id in the CQE, and <c>res</c> is the total byte count.
+    /// Requires <see cref="IORING_FEAT_RECVSEND_BUNDLE"/>.
+    /// </para>
+    /// </summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_recv_multishot_bundle(io_uring_sqe* sqe, int fd, uint buf_group, int flags);
+    /// <summary>
+    /// Prepares a multishot <c>poll</c> on <paramref name="fd"/> for the events in <paramref name="poll_mask"/>.
+    /// <para>
+    /// Every readiness event produces a CQE with <see cref="IORING_CQE_F_MORE"/> set; re-arm once a CQE arrives without it.
+    /// </para>
+    /// </summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_poll_multishot(io_uring_sqe* sqe, int fd, uint poll_mask);
+    /// <summary>
+    /// Prepares a multishot <c>recvmsg</c> using buffer selection (buf-ring), for datagram sockets.
+    /// <para>
+    /// Only <c>msg_namelen</c> and <c>msg_controllen</c> of <paramref name="msg"/> are used: each selected buffer
+    /// starts with an <see cref="io_uring_recvmsg_out"/>, then that many bytes of source address and control data,
+    /// then the payload. Linux 6.0+.
+    /// </para>
+    /// </summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_recvmsg_multishot_select(io_uring_sqe* sqe, int fd, msghdr* msg, uint buf_group, uint flags);
     /// <summary>
     /// Prepares a <c>send(2)</c> on <paramref name="fd"/> writing <paramref name="nbytes"/> from <paramref name="buf"/>.
     /// <paramref name="flags"/> maps to <c>send</c> flags (e.g., <c>MSG_MORE</c>).
     /// </summary>
-    [DllImport("uringshim")] internal static extern void shim_prep_send(io_uring_sqe* sqe, int fd, void* buf, uint nbytes, int flags);
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_send(io_uring_sqe* sqe, int fd, void* buf, uint nbytes, int flags);
+    /// <summary>
+    /// Prepares a vectored <c>sendmsg</c> (<c>IORING_OP_SENDMSG</c>) of the iovecs described by <paramref name="msg"/>.
+    /// The msghdr and its iovec array must stay valid until the CQE arrives.
+    /// </summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_sendmsg(io_uring_sqe* sqe, int fd, msghdr* msg, uint flags);
+    /// <summary>
+    /// Prepares a zero-copy <c>send</c> (<c>IORING_OP_SEND_ZC</c>) from the fixed buffer registered at <paramref name="buf_index"/>.
+    /// <para>
+    /// <paramref name="buf"/> must point inside that registered buffer. The result CQE carries
+    /// <see cref="IORING_CQE_F_MORE"/> when a second, <see cref="IORING_CQE_F_NOTIF"/> CQE will follow;
+    /// the bytes must stay untouched until that notification arrives.
+    /// </para>
+    /// </summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_send_zc_fixed(io_uring_sqe* sqe, int fd, void* buf, uint nbytes, int flags, uint zc_flags, uint buf_index);
     // SHIM: PREP OPS (SQE FILLERS)
-    [DllImport("uringshim")] internal static extern void shim_prep_cancel64(io_uring_sqe* sqe, ulong user_data, int flags);
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_cancel64(io_uring_sqe* sqe, ulong user_data, int flags);
+    /// <summary>
+    /// Prepares an <c>IORING_OP_CLOSE</c> of fixed-file slot <paramref name="file_index"/>.
+    /// The slot becomes free for reuse once the close completes.
+    /// </summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_close_direct(io_uring_sqe* sqe, uint file_index);
+    /// <summary>
+    /// Sets <c>IOSQE_FIXED_FILE</c> on a prepared SQE: its fd is a slot in the ring's fixed-file table.
+    /// Call after the prep helper.
+    /// </summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_sqe_set_fixed_file(io_uring_sqe* sqe);
+    /// <summary>
+    /// Prepares an <c>IORING_OP_CONNECT</c> of <paramref name="fd"/> to the socket address at <paramref name="addr"/>.
+    /// The address must stay valid until the CQE; a non-blocking socket is fine.
+    /// </summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_connect(io_uring_sqe* sqe, int fd, void* addr, uint addrlen);
+    /// <summary>
+    /// Prepares an <c>IORING_OP_SPLICE</c> of up to <paramref name="nbytes"/> from <paramref name="fd_in"/> to
+    /// <paramref name="fd_out"/> (one end must be a pipe). <c>IOSQE_FIXED_FILE</c> covers <paramref name="fd_out"/> only;
+    /// a fixed <paramref name="fd_in"/> needs <see cref="SPLICE_F_FD_IN_FIXED"/>.
+    /// A non-blocking socket end that is not ready completes with <c>-EAGAIN</c>.
+    /// </summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_splice(io_uring_sqe* sqe, int fd_in, int fd_out, uint nbytes, uint splice_flags);
+    /// <summary>Prepares an <c>IORING_OP_SHUTDOWN</c> of <paramref name="fd"/> (<see cref="SHUT_WR"/>, ...).</summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_shutdown(io_uring_sqe* sqe, int fd, int how);
+    /// <summary>Prepares a single-shot <c>IORING_OP_POLL_ADD</c>; the CQE result is the ready mask.</summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_poll_add(io_uring_sqe* sqe, int fd, uint poll_mask);
+    /// <summary>
+    /// Prepares an <c>IORING_OP_SPLICE</c> of up to <paramref name="nbytes"/> from file <paramref name="fd_in"/>
+    /// at <paramref name="off_in"/> into pipe <paramref name="fd_out"/>. The file position is not used or moved.
+    /// </summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_splice_from(io_uring_sqe* sqe, int fd_in, long off_in, int fd_out, uint nbytes, uint splice_flags);
+    /// <summary>Prepares an <c>IORING_OP_READ</c> of up to <paramref name="nbytes"/> at <paramref name="offset"/> (pread).</summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_read(io_uring_sqe* sqe, int fd, void* buf, uint nbytes, ulong offset);
+    /// <summary>
+    /// Prepares an <c>IORING_OP_READ_FIXED</c> into <paramref name="buf"/>, which must lie in the fixed buffer
+    /// registered at <paramref name="buf_index"/>.
+    /// </summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_prep_read_fixed(io_uring_sqe* sqe, int fd, void* buf, uint nbytes, ulong offset, uint buf_index);
+    /// <summary>
+    /// Sets <c>IOSQE_IO_LINK</c> on a prepared SQE: the next SQE starts once this one completes in full.
+    /// A failed or short operation completes the rest of the chain with <c>-ECANCELED</c>.
+    /// </summary>
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_sqe_set_link(io_uring_sqe* sqe);
     // ------------------------------------------------------------------------------------
     //  SHIM: USERDATA HELPERS
     // ------------------------------------------------------------------------------------
     /// <summary>
     /// Attaches a 64-bit user token to an SQE (visible later via CQE.user_data).
     /// </summary>
-    [DllImport("uringshim")] internal static extern void  shim_sqe_set_data64(io_uring_sqe* sqe, ulong data);
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_sqe_set_data64(io_uring_sqe* sqe, ulong data);
     /// <summary>
     /// Reads the 64-bit user token previously attached to the SQE that completed.
     /// Equivalent to reading <see cref="io_uring_cqe.user_data"/>.
     /// </summary>
-    [DllImport("uringshim")] internal static extern ulong shim_cqe_get_data64(io_uring_cqe* cqe);
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial ulong shim_cqe_get_data64(io_uring_cqe* cqe);
+    // ------------------------------------------------------------------------------------
+    //  SHIM: FIXED (REGISTERED) BUFFERS
+    // ------------------------------------------------------------------------------------
+    /// <summary>
+    /// Registers an empty fixed-buffer table with <paramref name="nr"/> slots. Returns 0 or -errno.
+    /// </summary>
+    [DllImport("uringshim")] internal static extern int shim_register_buffers_sparse(io_uring* ring, uint nr);
+    /// <summary>
+    /// Points fixed-buffer slot <paramref name="slot"/> at <paramref name="addr"/>/<paramref name="len"/>
+    /// (pinning the pages). Pass <c>null</c>/0 to clear the slot. Returns 1 or -errno.
+    /// </summary>
+    [DllImport("uringshim")] internal static extern int shim_register_buffer_slot(io_uring* ring, uint slot, void* addr, uint len);
+    /// <summary>
+    /// Drops the whole fixed-buffer table. Returns 0 or -errno.
+    /// </summary>
+    [DllImport("uringshim")] internal static extern int shim_unregister_buffers(io_uring* ring);
+    // ------------------------------------------------------------------------------------
+    //  SHIM: FIXED (REGISTERED) FILES
+    // ------------------------------------------------------------------------------------
+    /// <summary>
+    /// Registers an empty fixed-file table with <paramref name="nr"/> slots. Returns 0 or -errno.
+    /// </summary>
+    [DllImport("uringshim")] internal static extern int shim_register_files_sparse(io_uring* ring, uint nr);
+    /// <summary>
+    /// Installs <paramref name="fd"/> in fixed-file slot <paramref name="slot"/> (-1 clears it).
+    /// The table holds its own reference, so the fd can be closed afterwards. Returns 1 or -errno.
+    /// </summary>
+    [DllImport("uringshim")] internal static extern int shim_register_file_slot(io_uring* ring, uint slot, int fd);
     // ------------------------------------------------------------------------------------
     //  SHIM: BUF-RING HELPERS (BUFFER SELECTION)
     // ------------------------------------------------------------------------------------
@@ -304,19 +520,19 @@ public static unsafe partial class ABI{
     /// <paramref name="mask"/> must be <c>entries - 1</c> for power-of-two rings.
     /// </para>
     /// </summary>
-    [DllImport("uringshim")] internal static extern void shim_buf_ring_add(io_uring_buf_ring* br, void* addr, uint len, ushort bid, ushort mask, uint idx);
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_buf_ring_add(io_uring_buf_ring* br, void* addr, uint len, ushort bid, ushort mask, uint idx);
     /// <summary>
     /// Advances the visible producer index by <paramref name="count"/> after one or more adds.
     /// </summary>
-    [DllImport("uringshim")] internal static extern void shim_buf_ring_advance(io_uring_buf_ring* br, uint count);
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial void shim_buf_ring_advance(io_uring_buf_ring* br, uint count);
     /// <summary>
     /// Returns non-zero if the CQE indicates a provided buffer was used.
     /// </summary>
-    [DllImport("uringshim")] internal static extern int shim_cqe_has_buffer(io_uring_cqe* cqe);
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial int shim_cqe_has_buffer(io_uring_cqe* cqe);
     /// <summary>
     /// When <see cref="shim_cqe_has_buffer"/> is non-zero, returns the selected buffer id (bid).
     /// </summary>
-    [DllImport("uringshim")] internal static extern uint shim_cqe_buffer_id(io_uring_cqe* cqe);
+    [LibraryImport("uringshim"), SuppressGCTransition] internal static partial uint shim_cqe_buffer_id(io_uring_cqe* cqe);
     /// <summary>
     /// Waits for a CQE with a timeout specified via <see cref="__kernel_timespec"/>.
     /// <para>
@@ -324,8 +540,8 @@ public static unsafe partial class ABI{
     /// e.g. <c>-ETIME</c> when the timeout expires, <c>-EINTR</c> when interrupted.
     /// </para>
     /// </summary>
-    [DllImport("uringshim")] internal static extern int shim_wait_cqe_timeout(io_uring* ring, io_uring_cqe** cqe, __kernel_timespec* ts);
-    [DllImport("uringshim")] internal static extern int shim_wait_cqes(
+    [LibraryImport("uringshim")] internal static partial int shim_wait_cqe_timeout(io_uring* ring, io_uring_cqe** cqe, __kernel_timespec* ts);
+    [LibraryImport("uringshim")] internal static partial int shim_wait_cqes(
         io_uring* ring,
         io_uring_cqe** cqe,         // pointer to first CQE slot (array start)
         uint waitNr,                // how many CQEs we'd *like* to wait for
@@ -340,23 +556,47 @@ public static unsafe partial class ABI{
         Accept = 1,
         Recv   = 2,
         Send   = 3,
-        Cancel = 4
+        Cancel = 4,
+        Wakeup = 5,
+        SendZc = 6,
+        Close  = 7,
+        Connect = 8,
+        Relay  = 9,
+        Datagram = 10,
+        SendFile = 11
     }
     /// <summary>
     /// Packs a kind + fd into a single 64-bit token suitable for <see cref="io_uring_sqe"/>.
+    /// Used for operations that are not tied to a connection slot (accept, wakeup); generation is 0.
+    /// </summary>
+    internal static ulong PackUd(UdKind k, int fd) => ((ulong)k << 56) | (uint)fd;
+    /// <summary>
+    /// Packs a kind + connection slot + slot generation into a 64-bit token.
     /// <para>
-    /// Upper 32 bits: <see cref="UdKind"/>; lower 32 bits: file descriptor.
+    /// Bits 63..56: <see cref="UdKind"/>; bits 55..32: generation (24 bits); bits 31..0: slot.
     /// </para>
+    /// The generation lets a reactor reject late CQEs that belong to an earlier lifetime of a reused slot.
     /// </summary>
-    internal static ulong PackUd(UdKind k, int fd) => ((ulong)k << 32) | (uint)fd;
+    internal static ulong PackUd(UdKind k, int slot, uint generation)
+        => ((ulong)k << 56) | ((ulong)(generation & UdGenerationMask) << 32) | (uint)slot;
+    /// <summary>Mask of the generation field in a packed user_data token (24 bits).</summary>
+    internal const uint UdGenerationMask = 0xffffff;
     /// <summary>
     /// Extracts the kind from a packed user_data token.
     /// </summary>
-    internal static UdKind UdKindOf(ulong ud) => (UdKind)(ud >> 32);
+    internal static UdKind UdKindOf(ulong ud) => (UdKind)(ud >> 56);
     /// <summary>
     /// Extracts the file descriptor from a packed user_data token.
     /// </summary>
     internal static int UdFdOf(ulong ud) => (int)(ud & 0xffffffff);
+    /// <summary>
+    /// Extracts the connection slot from a packed user_data token.
+    /// </summary>
+    internal static int UdSlotOf(ulong ud) => (int)(ud & 0xffffffff);
+    /// <summary>
+    /// Extracts the slot generation from a packed user_data token.
+    /// </summary>
+    internal static uint UdGenerationOf(ulong ud) => (uint)(ud >> 32) & UdGenerationMask;
     
     // =============================================================================
     // io_uring flags & constants (documented)
@@ -414,6 +654,35 @@ public static unsafe partial class ABI{
     /// </summary>
     internal const uint IORING_SETUP_CLAMP = 1u << 4;
 
+    /// <summary>
+    /// io_uring setup flag: attach to an existing ring (<c>wq_fd</c>) instead of creating new kernel-side resources.
+    /// <para>
+    /// With <see cref="IORING_SETUP_SQPOLL"/> the new ring is polled by the existing ring's SQ thread,
+    /// which also owns the async worker pool, so N rings cost one kernel thread instead of N.
+    /// </para>
+    /// </summary>
+    internal const uint IORING_SETUP_ATTACH_WQ = 1u << 5;
+
+    /// <summary>
+    /// io_uring setup flag: keep submitting the rest of a batch when one SQE fails to prepare.
+    /// </summary>
+    internal const uint IORING_SETUP_SUBMIT_ALL = 1u << 7;
+
+    /// <summary>
+    /// io_uring setup flag: do not interrupt the task with an IPI to run completion task_work;
+    /// it runs on the next transition into the kernel instead (Linux 5.19+).
+    /// <para>
+    /// The pre-6.1 alternative to <see cref="IORING_SETUP_DEFER_TASKRUN"/>. Not valid with SQPOLL.
+    /// </para>
+    /// </summary>
+    internal const uint IORING_SETUP_COOP_TASKRUN = 1u << 8;
+
+    /// <summary>
+    /// io_uring setup flag: with <see cref="IORING_SETUP_COOP_TASKRUN"/>, set <c>IORING_SQ_TASKRUN</c>
+    /// in the SQ flags when task_work is pending.
+    /// </summary>
+    internal const uint IORING_SETUP_TASKRUN_FLAG = 1u << 9;
+
     /// <summary>
     /// io_uring setup flag: optimize for a single submitting userspace thread.
     /// <para>
@@ -457,6 +726,38 @@ public static unsafe partial class ABI{
     /// </summary>
     internal const uint IORING_SETUP_REGISTERED_FD_ONLY = 1u << 15; // 0x8000
 
+    /// <summary>
+    /// io_uring setup flag: no SQ index array; SQEs are consumed in ring order (Linux 6.6+).
+    /// </summary>
+    internal const uint IORING_SETUP_NO_SQARRAY = 1u << 16;
+
+    /// <summary><see cref="shim_probe_result.caps"/> bit: buffer rings accept <see cref="IOU_PBUF_RING_INC"/>.</summary>
+    internal const uint SHIM_CAP_PBUF_RING_INC = 1u << 0;
+
+    /// <summary><see cref="shim_probe_result.caps"/> bit: <c>io_uring_register_ring_fd</c> works (Linux 5.18+).</summary>
+    internal const uint SHIM_CAP_REGISTER_RING_FD = 1u << 1;
+
+    /// <summary><see cref="shim_probe_result.caps"/> bit: <c>io_uring_register_napi</c> works (Linux 6.9+).</summary>
+    internal const uint SHIM_CAP_NAPI = 1u << 2;
+
+    /// <summary>Opcode of a zero-copy send (Linux 6.0+).</summary>
+    internal const int IORING_OP_SEND_ZC = 47;
+
+    /// <summary>Opcode of splice(2) (Linux 5.7+).</summary>
+    internal const int IORING_OP_SPLICE = 30;
+
+    /// <summary>splice flag: move pages instead of copying them where possible (a hint).</summary>
+    internal const uint SPLICE_F_MOVE = 1u << 0;
+
+    /// <summary>io_uring splice flag: the input fd is a slot of the ring's fixed-file table.</summary>
+    internal const uint SPLICE_F_FD_IN_FIXED = 1u << 31;
+
+    /// <summary>
+    /// io_uring feature bit (reported at setup): recv/send support <c>IORING_RECVSEND_BUNDLE</c>,
+    /// where one operation consumes several provided buffers (Linux 6.10+).
+    /// </summary>
+    internal const uint IORING_FEAT_RECVSEND_BUNDLE = 1u << 14;
+
 
     // =============================================================================
     // CQE flags (cqe->flags)
@@ -489,6 +790,15 @@ public static unsafe partial class ABI{
     /// </summary>
     internal const uint IORING_CQE_F_BUF_MORE = 1u << 4;
 
+    /// <summary>
+    /// CQE flag: this is the notification CQE of a zero-copy send.
+    /// <para>
+    /// Posted after the result CQE (which carried <see cref="IORING_CQE_F_MORE"/>) once the kernel
+    /// has released the pages of the send buffer. Only then may the buffer be reused.
+    /// </para>
+    /// </summary>
+    internal const uint IORING_CQE_F_NOTIF = 1u << 3;
+
     /// <summary>
     /// Bit shift for extracting the buffer id (bid) from <c>cqe->flags</c>.
     /// <para>
@@ -0,0 +1,21 @@
+using System.Numerics;
+
+namespace zerg;
+
+public sealed partial class Connection
+{
+    /// <summary>
+    /// Handler-owned: scratch area <see cref="ConnectionFramer"/> copies frames into when they straddle receive
+    /// buffers. Grows to the largest such frame seen and is kept across pooled lifetimes.
+    /// </summary>
+    private byte[]? _frameScratch;
+
+    /// <summary>Returns the frame scratch area, at least <paramref name="length"/> bytes long.</summary>
+    internal byte[] FrameScratch(int length)
+    {
+        byte[]? scratch = _frameScratch;
+        if (scratch == null || scratch.Length < length)
+            _frameScratch = scratch = GC.AllocateUninitializedArray<byte>(Math.Max(256, (int)BitOperations.RoundUpToPowerOf2((uint)length)));
+        return scratch;
+    }
+}
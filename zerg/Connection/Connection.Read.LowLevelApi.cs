@@ -26,6 +26,8 @@ public sealed unsafe partial class Connection
     /// - Called by reactor thread(s) when a recv completes for this connection.
     /// - If the connection is already closed/reused, this method is a no-op (caller should
     ///   return buffer elsewhere).
+    /// - Returns false when the ring is full. The item is not queued and the caller keeps it
+    ///   (the reactor holds it back and pauses the connection's recv, see Engine.Reactor.RecvBackpressure).
     ///
     /// Wakeup behavior:
     /// - If a handler is currently armed, we atomically disarm and complete the ValueTask
@@ -33,27 +35,36 @@ public sealed unsafe partial class Connection
     /// - If no handler is armed, we set <see cref="_pending"/> so the next ReadAsync fast-paths.
     /// </summary>
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
-    public void EnqueueRingItem(byte* ptr, int length, ushort bufferId)
+    public bool EnqueueRingItem(byte* ptr, int length, ushort bufferId)
+    {
+        if (!QueueRingItem(ptr, length, bufferId))
+            return false;
+        WakeReader();
+        return true;
+    }
+
+    /// <summary>
+    /// <see cref="EnqueueRingItem"/> without the wakeup: the reactor queues a batch of items
+    /// (e.g. every buffer of a recv bundle) and calls <see cref="WakeReader"/> once.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    internal bool QueueRingItem(byte* ptr, int length, ushort bufferId)
     {
         // If connection already closed/reused, just let reactor return the buffer elsewhere.
         if (Volatile.Read(ref _closed) != 0)
-            return;
-
-        // Ring full policy: close the connection (safer than corrupting the queue).
-        // Alternative policies: drop, backpressure, expand ring.
-        if (!_recv.TryEnqueue(new RingItem(ptr, length, bufferId)))
-        {
-            // Publish close.
-            Volatile.Write(ref _closed, 1);
+            return true;
 
-            // Wake waiter (if any) so it can exit.
-            if (Interlocked.Exchange(ref _armed, 0) == 1)
-                _readSignal.SetResult(RingSnapshot.Closed(error: 0));
-            else
-                Volatile.Write(ref _pending, 1);
+        return _recv.TryEnqueue(new RingItem(ptr, length, bufferId));
+    }
 
+    /// <summary>
+    /// Wakes the handler for items queued with <see cref="QueueRingItem"/>.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    internal void WakeReader()
+    {
+        if (Volatile.Read(ref _closed) != 0)
             return;
-        }
 
         // Edge-trigger wake:
         // If there is an armed waiter, complete it with a tail snapshot.
@@ -0,0 +1,33 @@
+using zerg.Utils;
+
+namespace zerg;
+
+public sealed partial class Connection
+{
+    /// <summary>
+    /// Handler-owned: free list of <see cref="RingSegment"/>s used by <see cref="ConnectionPipeReader"/> to
+    /// present received buffers as a sequence. Kept across reads and across pooled lifetimes; pooled segments
+    /// reference no buffer, so nothing needs resetting on <see cref="Clear"/>.
+    /// </summary>
+    private RingSegment? _freeSegments;
+
+    /// <summary>Takes a pooled segment (or creates one) pointing at <paramref name="item"/>.</summary>
+    internal RingSegment RentSegment(in RingItem item)
+    {
+        RingSegment? segment = _freeSegments;
+        if (segment != null)
+            _freeSegments = segment.NextFree;
+        else
+            segment = new RingSegment();
+        segment.Reset(item);
+        return segment;
+    }
+
+    /// <summary>Gives a segment back to the pool; its receive buffer must already be returned.</summary>
+    internal void ReturnSegment(RingSegment segment)
+    {
+        segment.Clear();
+        segment.NextFree = _freeSegments;
+        _freeSegments = segment;
+    }
+}
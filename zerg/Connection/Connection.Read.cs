@@ -59,6 +59,59 @@ public sealed partial class Connection
     /// </summary>
     private int _generation;
 
+    /// <summary>Current lifetime of this (pooled) instance; changes when it is returned to the pool.</summary>
+    internal int Generation => Volatile.Read(ref _generation);
+
+    // =========================================================================
+    // Recv buffer class (reactor-owned, see Engine.Reactor.BufferGroups)
+    // =========================================================================
+
+    /// <summary>Reactor-owned: index of the buffer group the multishot recv is armed on.</summary>
+    internal int RecvGroup;
+
+    /// <summary>Reactor-owned: group to re-arm on once the current multishot recv terminates, or -1.</summary>
+    internal int RecvGroupPending = -1;
+
+    /// <summary>Reactor-owned: smoothed recv size in bytes, drives the choice of <see cref="RecvGroup"/>.</summary>
+    internal int RecvSizeEstimate;
+
+    /// <summary>
+    /// Reactor-owned: true while a cancel issued to move the recv to another group is in flight,
+    /// so the resulting -ECANCELED completion re-arms instead of closing the connection.
+    /// </summary>
+    internal bool RecvCancelInFlight;
+
+    // =========================================================================
+    // Recv backpressure (reactor-owned, see Engine.Reactor.RecvBackpressure)
+    // =========================================================================
+
+    /// <summary>Reactor-owned: received buffers handed to this connection and not yet returned.</summary>
+    internal int RecvHeldBuffers;
+
+    /// <summary>Reactor-owned: bytes in <see cref="RecvHeldBuffers"/>.</summary>
+    internal long RecvHeldBytes;
+
+    /// <summary>
+    /// Reactor-owned: the connection went over its recv budget (or filled its ring);
+    /// its multishot recv is not re-armed until the handler catches up.
+    /// </summary>
+    internal bool RecvPaused;
+
+    /// <summary>Reactor-owned: the recv has terminated and the connection waits in the reactor's paused list.</summary>
+    internal bool RecvParked;
+
+    /// <summary>
+    /// Reactor-owned: received items that did not fit <see cref="_recv"/>, in arrival order.
+    /// They move into the ring as the handler drains it.
+    /// </summary>
+    internal Queue<RingItem>? RecvOverflow;
+
+    /// <summary>Items queued in the inbound ring and not yet taken by the handler.</summary>
+    internal int RecvQueued => (int)_recv.GetTailHeadDiff();
+
+    /// <summary>Capacity of the inbound ring.</summary>
+    internal int RecvCapacity => _recv.Capacity;
+
     // =========================================================================
     // Inbound recv ring (MPSC)
     // =========================================================================
@@ -212,6 +265,19 @@ public sealed partial class Connection
             return;
         }
 
-        _readSignal.OnCompleted(continuation, state, _readSignal.Version, flags);
+        _readSignal.OnCompleted(continuation, state, _readSignal.Version, InlineOnReactor(flags));
+    }
+
+    /// <summary>
+    /// Read and flush completions are always signalled on the reactor thread. A continuation registered
+    /// under that reactor's own <see cref="Engine.ReactorSynchronizationContext"/> (thread-per-core mode)
+    /// would only be posted back to the same thread, so it is invoked inline instead.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private ValueTaskSourceOnCompletedFlags InlineOnReactor(ValueTaskSourceOnCompletedFlags flags)
+    {
+        if ((flags & ValueTaskSourceOnCompletedFlags.UseSchedulingContext) != 0 && Reactor.OwnsCurrentContext)
+            flags &= ~ValueTaskSourceOnCompletedFlags.UseSchedulingContext;
+        return flags;
     }
 }
\ No newline at end of file
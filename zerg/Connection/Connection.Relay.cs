@@ -0,0 +1,49 @@
+using zerg.Engine;
+using zerg.Engine.Configs;
+using zerg.Utils;
+
+namespace zerg;
+
+public sealed partial class Connection
+{
+    /// <summary>
+    /// Reactor-owned: the relay this connection is paired in by <see cref="ProxyAsync"/>, or null.
+    /// While set, received buffers go to the relay instead of the inbound ring.
+    /// </summary>
+    internal Engine.Engine.Reactor.Relay? Relay;
+
+    /// <summary>Reactor-owned: index of the relay direction this connection is the source of.</summary>
+    internal int RelayDirection;
+
+    /// <summary>
+    /// Relays everything received on this connection to <paramref name="peer"/> and back, until both
+    /// sides have half-closed or either fails, then closes both connections. Received buffers are sent
+    /// straight out of the buf_ring (<see cref="RelayMode.Buffers"/>) or, with <see cref="RelayMode.Splice"/>,
+    /// spliced through a pipe without ever reaching user memory.
+    ///
+    /// Both connections must live on the same reactor (see <see cref="Engine.Engine.Reactor.ConnectAsync"/>).
+    /// Bytes written and not yet flushed on either side are flushed first; data already received and not
+    /// read by the handler is relayed before anything newer. Neither connection may be read from or
+    /// written to once this is called.
+    /// </summary>
+    public async Task<RelayResult> ProxyAsync(Connection peer, RelayMode mode = RelayMode.Buffers)
+    {
+        ArgumentNullException.ThrowIfNull(peer);
+        if (ReferenceEquals(peer, this))
+            throw new ArgumentException("A connection cannot be relayed to itself.", nameof(peer));
+        if (peer.Reactor != Reactor)
+            throw new InvalidOperationException("Both connections of a relay must belong to the same reactor.");
+
+        if (WriteTail != 0)
+            await FlushAsync().ConfigureAwait(false);
+        if (peer.WriteTail != 0)
+            await peer.FlushAsync().ConfigureAwait(false);
+
+        if (mode == RelayMode.Splice && !KernelCapabilities.Current.Splice)
+            mode = RelayMode.Buffers;
+        return await Reactor.StartRelay(this, peer, mode).ConfigureAwait(false);
+    }
+
+    /// <summary>Takes the next item of the inbound ring, for a relay starting with unread data (reactor thread).</summary>
+    internal bool TryTakeQueuedRecv(out RingItem item) => _recv.TryDequeueUntil(_recv.SnapshotTail(), out item);
+}
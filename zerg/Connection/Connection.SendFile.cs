@@ -0,0 +1,120 @@
+using Microsoft.Win32.SafeHandles;
+using static zerg.ABI.ABI;
+
+namespace zerg;
+
+public sealed partial class Connection
+{
+    /// <summary>
+    /// Reactor-owned: the file send in progress on this connection (see <see cref="SendFileAsync(SafeFileHandle, long, long)"/>), or null.
+    /// </summary>
+    internal Engine.Engine.Reactor.FileSend? FileSend;
+
+    /// <summary>
+    /// Sends <paramref name="length"/> bytes of <paramref name="file"/> from <paramref name="offset"/>, after
+    /// everything written so far. The reactor moves the bytes without copying them through managed memory:
+    /// it splices them file → pipe → socket, or, where the file system cannot splice, reads them into a
+    /// reactor buffer (a registered one when a fixed-buffer slot is free) and sends from there.
+    ///
+    /// Completes once every byte is sent, through the same waiter as <see cref="FlushAsync"/>; nothing else
+    /// may be written or flushed until then. Fails with an <see cref="IOException"/> if the file cannot be
+    /// read or ends before <paramref name="length"/>, and with <see cref="OperationCanceledException"/> if
+    /// the connection closes. The file position is neither used nor moved, so one handle can feed
+    /// concurrent sends on many connections.
+    /// </summary>
+    public ValueTask SendFileAsync(SafeFileHandle file, long offset, long length)
+    {
+        ArgumentNullException.ThrowIfNull(file);
+        return SendFile(file, 0, offset, length);
+    }
+
+    /// <summary>
+    /// <see cref="SendFileAsync(SafeFileHandle, long, long)"/> for a raw file descriptor, which must stay open
+    /// until the returned task completes.
+    /// </summary>
+    public ValueTask SendFileAsync(int fd, long offset, long length)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegative(fd);
+        return SendFile(null, fd, offset, length);
+    }
+
+    /// <summary>
+    /// Sends a file from a <see cref="FileCache"/>: a file held in memory is written to the chain and
+    /// flushed (it is small enough that a copy beats a splice), any other is sent with
+    /// <see cref="SendFileAsync(SafeFileHandle, long, long)"/>. If the cache has dropped the entry and closed
+    /// its handle since it was looked up, the path is looked up again and the current entry is sent.
+    /// </summary>
+    public ValueTask SendFileAsync(CachedFile file)
+    {
+        ArgumentNullException.ThrowIfNull(file);
+        while (true)
+        {
+            if (file.Handle == null)
+            {
+                Write(file.Contents.Span);
+                return FlushAsync();
+            }
+            try
+            {
+                return SendFileAsync(file.Handle, 0, file.Length);
+            }
+            catch (ObjectDisposedException)
+            {
+                // Evicted, invalidated or reloaded by another handler before the send referenced the handle.
+                file = file.Cache.Open(file.Path);
+            }
+        }
+    }
+
+    private ValueTask SendFile(SafeFileHandle? handle, int fd, long offset, long length)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegative(offset);
+        ArgumentOutOfRangeException.ThrowIfNegative(length);
+        if (length == 0)
+            return FlushAsync();
+        if (Volatile.Read(ref _closed) != 0)
+            return ValueTask.FromException(new OperationCanceledException("Connection closed."));
+
+        // The file's bytes follow everything written before: the reactor starts on them once the chain is out.
+        PublishFlush();
+
+        if (handle != null)
+        {
+            // Referenced first: a disposed handle throws here, before any waiter is armed.
+            bool added = false;
+            handle.DangerousAddRef(ref added);
+            fd = (int)handle.DangerousGetHandle();
+        }
+
+        try
+        {
+            // Sent-chain progress never reaches long.MaxValue, so only the reactor's CompleteFileSend releases
+            // the waiter, even though PublishFlush may just have started a chain send.
+            ArmFlush(long.MaxValue);
+        }
+        catch
+        {
+            handle?.DangerousRelease();
+            throw;
+        }
+
+        Reactor.StartFileSend(this, handle, fd, offset, length);
+        return new ValueTask(this, token: 0);
+    }
+
+    /// <summary>
+    /// Completes the waiter of <see cref="SendFileAsync(SafeFileHandle, long, long)"/> (reactor thread):
+    /// successfully, or with the negative errno <paramref name="error"/>.
+    /// </summary>
+    internal void CompleteFileSend(int error)
+    {
+        if (Interlocked.Exchange(ref _flushArmed, 0) != 1)
+            return;
+        if (error == 0)
+            CompleteFlush();
+        else if (error == -ENOTCONN)
+            _flushSignal.SetException(new OperationCanceledException("Connection closed."));
+        else
+            _flushSignal.SetException(new IOException($"File send failed, errno={-error}"));
+    }
+}
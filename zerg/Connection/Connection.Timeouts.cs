@@ -0,0 +1,92 @@
+namespace zerg;
+
+public sealed partial class Connection
+{
+    // =========================================================================
+    // Deadlines (see Engine.Reactor.Timers). Times are Environment.TickCount64 milliseconds.
+    // =========================================================================
+
+    /// <summary>Close after this long without received data; 0 = no idle timeout.</summary>
+    internal long IdleTimeoutMs;
+
+    /// <summary>Reactor-owned: when the last recv completed (reactor loop time).</summary>
+    internal long LastRecvMs;
+
+    /// <summary>Close at this time unless cleared (<see cref="SetReadHeaderTimeout"/>); 0 = none.</summary>
+    internal long ReadHeaderDeadlineMs;
+
+    /// <summary>Close when a flush makes no progress for this long; 0 = no flush timeout.</summary>
+    internal long FlushTimeoutMs;
+
+    /// <summary>Reactor-owned: when the send in progress times out, or 0 while nothing is being sent.</summary>
+    internal long FlushDeadlineMs;
+
+    /// <summary>
+    /// Reactor-owned: when the connection's timer wheel entry fires, or <see cref="long.MaxValue"/> while it
+    /// has none. Read by the handler to tell whether a new deadline is earlier and needs the reactor.
+    /// </summary>
+    internal long TimerDueMs = long.MaxValue;
+
+    /// <summary>Reactor-owned: timer wheel bucket the connection is linked in, or -1.</summary>
+    internal int TimerBucket = -1;
+    internal Connection? TimerNext;
+    internal Connection? TimerPrev;
+
+    /// <summary>
+    /// Closes the connection once no data has been received for <paramref name="timeout"/> (measured from the
+    /// last recv). <see cref="TimeSpan.Zero"/> or <see cref="Timeout.InfiniteTimeSpan"/> disables it.
+    /// The reactor default is <see cref="Engine.Configs.ReactorConfig.IdleTimeoutMs"/>.
+    /// </summary>
+    public void SetIdleTimeout(TimeSpan timeout)
+    {
+        long ms = ToMilliseconds(timeout);
+        Interlocked.Exchange(ref IdleTimeoutMs, ms);
+        if (ms != 0)
+            RequestTimer(Volatile.Read(ref LastRecvMs) + ms);
+    }
+
+    /// <summary>
+    /// Closes the connection unless <see cref="ClearReadHeaderTimeout"/> is called within <paramref name="timeout"/>,
+    /// e.g. armed when a request starts and cleared once its header is complete.
+    /// </summary>
+    public void SetReadHeaderTimeout(TimeSpan timeout)
+    {
+        long ms = ToMilliseconds(timeout);
+        if (ms == 0)
+        {
+            ClearReadHeaderTimeout();
+            return;
+        }
+        long deadline = Environment.TickCount64 + ms;
+        Interlocked.Exchange(ref ReadHeaderDeadlineMs, deadline);
+        RequestTimer(deadline);
+    }
+
+    /// <summary>Disarms the deadline set by <see cref="SetReadHeaderTimeout"/>.</summary>
+    public void ClearReadHeaderTimeout() => Volatile.Write(ref ReadHeaderDeadlineMs, 0);
+
+    /// <summary>
+    /// Closes the connection when flushed bytes make no send progress for <paramref name="timeout"/>
+    /// (a peer that stopped reading). <see cref="TimeSpan.Zero"/> or <see cref="Timeout.InfiniteTimeSpan"/> disables it.
+    /// The reactor default is <see cref="Engine.Configs.ReactorConfig.FlushTimeoutMs"/>.
+    /// </summary>
+    public void SetFlushTimeout(TimeSpan timeout) => Volatile.Write(ref FlushTimeoutMs, ToMilliseconds(timeout));
+
+    /// <summary>
+    /// Later deadlines are picked up lazily when the current wheel entry fires; only an earlier one needs
+    /// the reactor to move the entry. The deadline is written with a full fence before this read, pairing
+    /// with the reactor's reset of <see cref="TimerDueMs"/> before it reads the deadlines.
+    /// </summary>
+    private void RequestTimer(long deadline)
+    {
+        if (deadline < Volatile.Read(ref TimerDueMs))
+            Reactor.EnqueueTimerUpdate(this);
+    }
+
+    private static long ToMilliseconds(TimeSpan timeout)
+    {
+        if (timeout == Timeout.InfiniteTimeSpan || timeout <= TimeSpan.Zero)
+            return 0;
+        return Math.Max(1, (long)Math.Ceiling(timeout.TotalMilliseconds));
+    }
+}
@@ -5,79 +5,89 @@ namespace zerg;
 public partial class Connection
 {
     /// <summary>
-    /// Appends a managed buffer into the write slab.
+    /// Appends a managed buffer to the write chain.
     /// </summary>
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
-    public unsafe void Write(ReadOnlyMemory<byte> source)
-    {
-        if (Volatile.Read(ref _flushInProgress) != 0)
-            throw new InvalidOperationException("Cannot write while flush is in progress.");
-        
-        int len = source.Length;
-        if (WriteTail + len > _writeSlabSize)
-            throw new InvalidOperationException("Buffer too small.");
-
-        source.Span.CopyTo(
-            new Span<byte>(WriteBuffer + WriteTail, len)
-        );
-
-        WriteTail += len;
-    }
+    public void Write(ReadOnlyMemory<byte> source) => Write(source.Span);
     
     /// <summary>
-    /// Appends a span into the write slab.
+    /// Appends a span to the write chain. Data that does not fit the slab continues in overflow segments.
     /// </summary>
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
     public unsafe void Write(ReadOnlySpan<byte> source) 
     {
-        if (Volatile.Read(ref _flushInProgress) != 0)
-            throw new InvalidOperationException("Cannot write while flush is in progress.");
-        
         int len = source.Length;
-        if (WriteTail + len > _writeSlabSize)
-            throw new InvalidOperationException("Buffer too small.");
+        if (len > _tailFree)
+        {
+            AppendToChain(source);
+            return;
+        }
 
-        source.CopyTo(new Span<byte>(WriteBuffer + WriteTail, len));
-        WriteTail += len;
+        source.CopyTo(new Span<byte>(_tailPtr, len));
+        CommitWrite(len);
     }
     
     /// <summary>
-    /// Arms a flush and returns a ValueTask that completes when the reactor has flushed the current batch.
+    /// Hands everything written so far to the reactor and returns a ValueTask that applies backpressure.
     ///
     /// Behavior:
-    /// - Captures a tail snapshot (<see cref="WriteInFlight"/>) and blocks further writes until completion.
-    /// - Enqueues the connection to the reactor flush queue.
-    /// - Completes when reactor calls <see cref="CompleteFlush"/>.
+    /// - Publishes the current end of the chain as the flush target; the reactor sends it right away, or as
+    ///   soon as the send already in flight completes.
+    /// - Completes immediately while no more than <see cref="zerg.Engine.Configs.ReactorConfig.WriteHighWaterMark"/> bytes
+    ///   are unsent, so the handler can format its next response during the send. Otherwise completes
+    ///   once the reactor has drained the backlog down to that mark (with a mark of 0: once everything is sent).
+    /// - Writing may continue while the returned ValueTask is pending.
     /// </summary>
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
     public ValueTask FlushAsync()
     {
-        // Start flush barrier (handler must not write until completion)
-        if (Interlocked.Exchange(ref _flushInProgress, 1) == 1)
-            throw new InvalidOperationException("FlushAsync already in progress.");
+        long target = PublishFlush();
+
+        long releaseAt = target - Reactor.Config.WriteHighWaterMark;
+        if (Volatile.Read(ref WriteHead) >= releaseAt)
+            return default;
 
-        int target = WriteTail; // single writer => plain read ok
+        ArmFlush(releaseAt);
 
-        // Fast path: nothing to flush
-        if (target == 0)
-        {
-            Volatile.Write(ref _flushInProgress, 0);
+        // The reactor may have drained the backlog before it could see the waiter.
+        if (Volatile.Read(ref WriteHead) >= releaseAt && Interlocked.Exchange(ref _flushArmed, 0) == 1)
             return default;
-        }
 
-        // Arm single waiter
-        if (Interlocked.Exchange(ref _flushArmed, 1) == 1)
-            throw new InvalidOperationException("FlushAsync already armed.");
+        return new ValueTask(this, token: 0);
+    }
+
+    /// <summary>
+    /// Arms the single flush waiter, to be completed once <see cref="WriteHead"/> reaches <paramref name="releaseAt"/>.
+    /// The reactor may complete the waiter as soon as it sees <see cref="_flushArmed"/> set (a send can be in
+    /// flight), so the completion source and the release position are prepared first and the flag published last.
+    /// </summary>
+    private void ArmFlush(long releaseAt)
+    {
+        // Only the handler arms; the reactor only disarms. A set flag is a waiter still pending.
+        if (Volatile.Read(ref _flushArmed) != 0)
+            throw new InvalidOperationException("FlushAsync already in progress.");
 
-        // IMPORTANT: reset completion *for this new flush* before returning the ValueTask
         _flushSignal.Reset();
+        Volatile.Write(ref _flushWaitPos, releaseAt);
+        Interlocked.Exchange(ref _flushArmed, 1);
+    }
 
-        // Publish the target for the reactor
-        WriteInFlight = target;
-
-        // Ask reactor to flush (enqueue fd)
-        Reactor.EnqueueFlush(ClientFd);
+    /// <summary>
+    /// Publishes the end of the chain as the flush target and returns it.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private long PublishFlush()
+    {
+        long target = _writePos; // single writer => plain read ok
 
-        return new ValueTask(this, token: 0);
+        if (target != Volatile.Read(ref _flushPos))
+        {
+            // Publish the new bytes, then make sure a send sequence picks them up: either the one in
+            // progress (its completion re-reads the flush position) or a new one we claim here.
+            Volatile.Write(ref _flushPos, target);
+            if (Interlocked.Exchange(ref _sending, 1) == 0)
+                Reactor.EnqueueFlush(this);
+        }
+        return target;
     }
 }
\ No newline at end of file
@@ -11,39 +11,34 @@ public unsafe partial class Connection
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
     public void Advance(int count)
     {
-        if (Volatile.Read(ref _flushInProgress) != 0)
-            throw new InvalidOperationException("Cannot write while flush is in progress.");
+        if ((uint)count > (uint)_tailFree)
+            throw new ArgumentOutOfRangeException(nameof(count));
         
-        WriteTail += count;
+        CommitWrite(count);
     }
 
     // ** IBufferWriter Implementation **
     /// <summary>
-    /// Returns a writable <see cref="Memory{Byte}"/> view into the remaining slab.
+    /// Returns a writable <see cref="Memory{Byte}"/> view of at least <paramref name="sizeHint"/> bytes
+    /// (at least one when 0) at the end of the write chain, chaining a new segment when the current one is too full.
     /// </summary>
     public Memory<byte> GetMemory(int sizeHint = 0) 
     {
-        if (Volatile.Read(ref _flushInProgress) != 0)
-            throw new InvalidOperationException("Cannot write while flush is in progress.");
+        if (_tailFree < Math.Max(sizeHint, 1))
+            AppendWriteSegment(sizeHint);
         
-        int remaining = _writeSlabSize - WriteTail;
-        if (sizeHint > remaining)
-            throw new InvalidOperationException("Buffer too small.");
-        
-        return _manager.Memory.Slice(WriteTail, remaining);
+        return _tail.Manager.Memory.Slice(_tail.Length, _tailFree);
     }
     
     /// <summary>
-    /// Returns a writable <see cref="Span{Byte}"/> view into the remaining slab.
+    /// Returns a writable <see cref="Span{Byte}"/> view of at least <paramref name="sizeHint"/> bytes
+    /// (at least one when 0) at the end of the write chain, chaining a new segment when the current one is too full.
     /// </summary>
     public Span<byte> GetSpan(int sizeHint = 0) 
     {
-        if (Volatile.Read(ref _flushInProgress) != 0)
-            throw new InvalidOperationException("Cannot write while flush is in progress.");
-        
-        if (WriteTail + sizeHint > _writeSlabSize)
-            throw new InvalidOperationException("Buffer too small.");
+        if (_tailFree < Math.Max(sizeHint, 1))
+            AppendWriteSegment(sizeHint);
 
-        return new Span<byte>(WriteBuffer + WriteTail, _writeSlabSize - WriteTail);
+        return new Span<byte>(_tailPtr, _tailFree);
     }
 }
\ No newline at end of file
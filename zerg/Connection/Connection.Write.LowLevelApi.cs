@@ -5,27 +5,27 @@ namespace zerg;
 public unsafe partial class Connection 
 {
     /// <summary>
-    /// Copies unmanaged memory into the write slab.
+    /// Copies unmanaged memory to the write chain.
     /// </summary>
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
     internal void Write(byte* ptr, int length)
     {
-        if (Volatile.Read(ref _flushInProgress) != 0)
-            throw new InvalidOperationException("Cannot write while flush is in progress.");
-        
-        if ((uint)length > (uint)_writeSlabSize) // also rejects negative
+        if (length < 0)
             throw new ArgumentOutOfRangeException(nameof(length));
 
-        if (WriteTail + length > _writeSlabSize)
-            throw new InvalidOperationException("Buffer too small.");
+        if (length > _tailFree)
+        {
+            AppendToChain(new ReadOnlySpan<byte>(ptr, length));
+            return;
+        }
 
         // copy unmanaged -> unmanaged
         Buffer.MemoryCopy(
             source: ptr,
-            destination: WriteBuffer + WriteTail,
-            destinationSizeInBytes: _writeSlabSize - WriteTail,
+            destination: _tailPtr,
+            destinationSizeInBytes: _tailFree,
             sourceBytesToCopy: length);
 
-        WriteTail += length;
+        CommitWrite(length);
     }
 }
\ No newline at end of file
@@ -0,0 +1,283 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using zerg.Engine;
+using static zerg.ABI.ABI;
+
+namespace zerg;
+
+/// <summary>
+/// Write chain: a singly linked list of blocks (<see cref="WriteSegment"/>) that the handler appends to
+/// while the reactor sends from the front.
+///
+/// Positions are byte offsets into the connection's output stream since the chain was last reset:
+/// the writer owns <see cref="_tail"/> and <see cref="_writePos"/>, publishes flush targets through
+/// <see cref="_flushPos"/>, and the reactor owns <see cref="_head"/> and <see cref="WriteHead"/> (bytes sent).
+/// The first block is the connection's slab. Once a block is full the writer links a new one (the slab
+/// again if the reactor has released it, otherwise a pooled segment), and the reactor releases blocks as
+/// soon as all of their bytes are sent, so the handler can keep writing during a flush without touching
+/// anything the kernel may still read.
+/// </summary>
+public unsafe partial class Connection
+{
+    /// <summary>Upper bound on iovecs per sendmsg; longer chains continue from the send CQE.</summary>
+    private const int c_maxSendIov = 256;
+
+    /// <summary>The write slab as a chain block.</summary>
+    private readonly WriteSegment _slabSegment;
+
+    /// <summary>1 while <see cref="_slabSegment"/> is linked into the chain (written by the writer, cleared by the reactor on release).</summary>
+    private int _slabInUse;
+
+    /// <summary>Writer-owned: block being appended to.</summary>
+    private WriteSegment _tail;
+
+    /// <summary>Writer-owned: total bytes written.</summary>
+    private long _writePos;
+
+    /// <summary>Next free byte of <see cref="_tail"/>.</summary>
+    private byte* _tailPtr;
+
+    /// <summary>Bytes left at <see cref="_tailPtr"/>.</summary>
+    private int _tailFree;
+
+    /// <summary>Writer-published: bytes handed to the reactor by <see cref="FlushAsync"/>.</summary>
+    private long _flushPos;
+
+    /// <summary>
+    /// 1 while a send sequence owns the chain: claimed by <see cref="FlushAsync"/> when it enqueues the
+    /// connection, released by the reactor once everything flushed has been sent (see <see cref="TryEndSending"/>).
+    /// </summary>
+    private int _sending;
+
+    /// <summary>Reactor-owned: oldest block not yet released.</summary>
+    private WriteSegment _head;
+
+    /// <summary>
+    /// Reactor-owned: msghdr followed by <see cref="c_maxSendIov"/> iovecs describing the bytes of the
+    /// outstanding vectored send. Allocated on the first send that spans blocks.
+    /// </summary>
+    private msghdr* _sendMsg;
+
+    /// <summary>A send sequence owns the chain: flushed bytes are (or are about to be) on their way out.</summary>
+    internal bool IsSending => Volatile.Read(ref _sending) != 0;
+
+    /// <summary>Bytes the reactor may send: the target of the latest <see cref="FlushAsync"/>.</summary>
+    internal long FlushPosition => Volatile.Read(ref _flushPos);
+
+    /// <summary>
+    /// Records <paramref name="count"/> bytes written at <see cref="_tailPtr"/>.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private void CommitWrite(int count)
+    {
+        _tailPtr += count;
+        _tailFree -= count;
+        _tail.Length += count;
+        _writePos += count;
+    }
+
+    /// <summary>
+    /// Makes room for at least <paramref name="sizeHint"/> bytes at the end of the chain. If everything written
+    /// so far has been sent, the tail block starts over from its beginning; otherwise a new block is linked:
+    /// the slab when it is free and large enough, else a segment from the reactor's pool.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    private void AppendWriteSegment(int sizeHint)
+    {
+        if (Volatile.Read(ref WriteHead) == _writePos && Volatile.Read(ref ZeroCopyPending) == 0 &&
+            _tail.Capacity >= sizeHint)
+        {
+            // Drained: nothing in the tail is still needed by the reactor or the kernel.
+            _tail.Base = _writePos;
+            _tail.Length = 0;
+            _tailPtr = _tail.Ptr;
+            _tailFree = _tail.Capacity;
+            return;
+        }
+
+        if (Reactor == null)
+            throw new InvalidOperationException("Buffer too small.");
+
+        WriteSegment segment = sizeHint <= _slabSegment.Capacity && Interlocked.CompareExchange(ref _slabInUse, 1, 0) == 0
+            ? _slabSegment
+            : Reactor.WriteSegments.Rent(sizeHint);
+        segment.Base = _writePos;
+        segment.Length = 0;
+        segment.Next = null;
+
+        Volatile.Write(ref _tail.Next, segment);
+        _tail = segment;
+        _tailPtr = segment.Ptr;
+        _tailFree = segment.Capacity;
+    }
+
+    /// <summary>
+    /// Copies <paramref name="source"/> to the end of the chain, moving on to new blocks as they fill.
+    /// </summary>
+    private void AppendToChain(ReadOnlySpan<byte> source)
+    {
+        while (true)
+        {
+            int n = Math.Min(source.Length, _tailFree);
+            source.Slice(0, n).CopyTo(new Span<byte>(_tailPtr, n));
+            CommitWrite(n);
+
+            source = source.Slice(n);
+            if (source.IsEmpty)
+                return;
+            AppendWriteSegment(0);
+        }
+    }
+
+    // =========================================================================
+    // Reactor side
+    // =========================================================================
+
+    /// <summary>
+    /// First block holding bytes at or after <paramref name="pos"/> (reactor thread).
+    /// </summary>
+    private WriteSegment BlockAt(long pos)
+    {
+        WriteSegment block = _head;
+        while (block.Base + block.Length <= pos && Volatile.Read(ref block.Next) is { } next)
+            block = next;
+        return block;
+    }
+
+    /// <summary>
+    /// Start of staged bytes [<paramref name="from"/>, <paramref name="to"/>) when they lie in a single block,
+    /// otherwise null (the range needs a vectored send). <paramref name="inSlab"/> tells whether that block is the slab.
+    /// </summary>
+    internal byte* ContiguousRange(long from, long to, out bool inSlab)
+    {
+        WriteSegment block = BlockAt(from);
+        inSlab = block.IsSlab;
+        if (to > block.Base + block.Length)
+            return null;
+        return block.Ptr + (from - block.Base);
+    }
+
+    /// <summary>
+    /// Builds the msghdr for a vectored send of staged bytes [<paramref name="from"/>, <paramref name="to"/>)
+    /// (reactor thread). At most <see cref="c_maxSendIov"/> iovecs are used; the send CQE path
+    /// continues with the rest.
+    /// </summary>
+    internal msghdr* PrepareSendMsg(long from, long to)
+    {
+        if (_sendMsg == null)
+            _sendMsg = (msghdr*)NativeMemory.Alloc((nuint)(sizeof(msghdr) + c_maxSendIov * sizeof(iovec)));
+
+        iovec* iov = (iovec*)(_sendMsg + 1);
+        int count = 0;
+
+        for (WriteSegment? block = BlockAt(from); block != null && block.Base < to && count < c_maxSendIov;
+             block = Volatile.Read(ref block.Next))
+        {
+            long lo = Math.Max(from, block.Base);
+            long hi = Math.Min(to, block.Base + block.Length);
+            if (hi <= lo)
+                continue;
+            iov[count].iov_base = block.Ptr + (lo - block.Base);
+            iov[count].iov_len = (nuint)(hi - lo);
+            count++;
+        }
+
+        *_sendMsg = default;
+        _sendMsg->msg_iov = iov;
+        _sendMsg->msg_iovlen = (nuint)count;
+        return _sendMsg;
+    }
+
+    /// <summary>
+    /// Records <paramref name="bytes"/> more sent (reactor thread), then releases drained blocks and
+    /// resumes a backpressured <see cref="FlushAsync"/> (see <see cref="OnSentProgress"/>).
+    /// </summary>
+    internal void AdvanceSent(int bytes)
+    {
+        Volatile.Write(ref WriteHead, WriteHead + bytes);
+        OnSentProgress();
+    }
+
+    /// <summary>
+    /// Releases every block whose bytes have all been sent and that the writer has moved past, and completes
+    /// the flush waiter once the unsent backlog is under its target. Deferred while zero-copy sends are
+    /// pending, since the kernel may still read the sent bytes until then.
+    /// </summary>
+    internal void OnSentProgress()
+    {
+        if (ZeroCopyPending != 0)
+            return;
+
+        long sent = WriteHead;
+        while (Volatile.Read(ref _head.Next) is { } next && _head.Base + _head.Length <= sent)
+        {
+            ReleaseBlock(_head);
+            _head = next;
+        }
+
+        if (Volatile.Read(ref _flushArmed) != 0 && sent >= Volatile.Read(ref _flushWaitPos) &&
+            Interlocked.Exchange(ref _flushArmed, 0) == 1)
+            CompleteFlush();
+    }
+
+    /// <summary>
+    /// Ends a send sequence once everything flushed has been sent (reactor thread). Returns false if
+    /// <see cref="FlushAsync"/> published more bytes in the meantime and the reactor still owns the chain,
+    /// in which case the caller continues sending.
+    /// </summary>
+    internal bool TryEndSending()
+    {
+        // Full fence: the flush position must be read after the release is visible, or a FlushAsync that
+        // publishes in between sees the sequence still claimed and the reactor sees the old position.
+        Interlocked.Exchange(ref _sending, 0);
+        if (FlushPosition == WriteHead)
+            return true;
+        // A flush raced with us. Whoever claims the chain first sends it: if FlushAsync already did,
+        // the connection is queued again.
+        return Interlocked.Exchange(ref _sending, 1) != 0;
+    }
+
+    private void ReleaseBlock(WriteSegment block)
+    {
+        if (block.IsSlab)
+            Volatile.Write(ref _slabInUse, 0);
+        else
+            Reactor.WriteSegments.Return(block);
+    }
+
+    /// <summary>
+    /// Drops all staged bytes and gives every segment back (connection reuse). The chain restarts at the slab.
+    /// </summary>
+    private void ResetWriteChain()
+    {
+        for (WriteSegment? block = _head; block != null;)
+        {
+            WriteSegment? next = block.Next;
+            if (!block.IsSlab)
+                Reactor.WriteSegments.Return(block);
+            block = next;
+        }
+
+        _slabSegment.Base = 0;
+        _slabSegment.Length = 0;
+        _slabSegment.Next = null;
+        _slabInUse = 1;
+        _head = _tail = _slabSegment;
+        _tailPtr = _slabSegment.Ptr;
+        _tailFree = _slabSegment.Capacity;
+        _writePos = 0;
+        Volatile.Write(ref _flushPos, 0);
+        Volatile.Write(ref WriteHead, 0);
+        WriteInFlight = 0;
+        Volatile.Write(ref _sending, 0);
+    }
+
+    /// <summary>Frees the vectored-send header (connection disposal).</summary>
+    private void FreeSendMsg()
+    {
+        if (_sendMsg == null)
+            return;
+        NativeMemory.Free(_sendMsg);
+        _sendMsg = null;
+    }
+}
@@ -1,6 +1,7 @@
 using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 using System.Threading.Tasks.Sources;
+using zerg.Engine;
 using zerg.Utils.UnmanagedMemoryManager;
 
 namespace zerg;
@@ -8,22 +9,24 @@ namespace zerg;
 /// <summary>
 /// <br/>
 /// <br/>
-/// Connection-owned outbound write staging buffer + flush completion primitive.
+/// Connection-owned outbound write chain + flush completion primitive.
 ///
 /// Design / ownership model:
-/// - The connection owns an unmanaged fixed-size slab (<see cref="WriteBuffer"/>) used for staging outgoing bytes.
-/// - A *single producer* (typically the request handler / user code) appends data by advancing <see cref="WriteTail"/>.
-/// - A *single consumer* (the reactor thread) flushes the staged bytes to the transport and completes the flush waiter.
+/// - The connection owns an unmanaged fixed-size slab (<see cref="WriteBuffer"/>), the first block of its
+///   write chain; writes that outgrow it continue in pooled overflow segments (see Connection.Write.Segments).
+/// - A *single producer* (typically the request handler / user code) appends data at the end of the chain.
+/// - A *single consumer* (the reactor thread) sends flushed bytes from the front and releases drained blocks.
 ///
 /// Threading / correctness rules:
-/// - Writes are allowed only when no flush is active (<see cref="_flushInProgress"/> == 0).
-/// - <see cref="FlushAsync"/> arms a single waiter and publishes a snapshot target (<see cref="WriteInFlight"/>).
-/// - The reactor must eventually call <see cref="CompleteFlush"/> exactly once per armed flush.
+/// - Writes may continue while a flush is being sent: they land behind the flushed bytes and go out with the
+///   next <see cref="FlushAsync"/>, which the reactor picks up as soon as the current send completes.
+/// - <see cref="FlushAsync"/> only waits when more than <see cref="zerg.Engine.Configs.ReactorConfig.WriteHighWaterMark"/>
+///   bytes are still unsent; a single waiter may be armed at a time.
+/// - The reactor completes the waiter (<see cref="CompleteFlush"/>) once the backlog drops to the mark.
 ///
 /// Invariants:
-/// - Valid staged data range is [<see cref="WriteHead"/>, <see cref="WriteTail"/>).
-/// - Flush target is a snapshot of tail captured in <see cref="FlushAsync"/> and stored in <see cref="WriteInFlight"/>.
-/// - While flushing, producer must not modify any bytes below <see cref="WriteInFlight"/>.
+/// - Sent &lt;= flushed &lt;= written: <see cref="WriteHead"/> &lt;= <see cref="_flushPos"/> &lt;= <see cref="_writePos"/>.
+/// - The reactor never reads past <see cref="_flushPos"/>, and the writer never touches bytes below it.
 /// <br/>
 /// <br/>
 /// </summary>
@@ -41,18 +44,16 @@ public unsafe partial class Connection
     /// - 1: waiter armed (a ValueTask has been handed out)
     /// </summary>
     private int _flushArmed;
-    
+
     /// <summary>
-    /// Write/flush barrier.
-    /// - 0: writes allowed
-    /// - 1: flush in progress (producer must not write)
+    /// Sent position the armed flush waiter is released at.
     /// </summary>
-    private int _flushInProgress;
+    private long _flushWaitPos;
     
     /// <summary>
-    /// True when a flush is active; used to enforce the "no writes while flushing" rule.
+    /// True while a <see cref="FlushAsync"/> waiter is armed.
     /// </summary>
-    internal bool IsFlushInProgress => Volatile.Read(ref _flushInProgress) != 0;
+    internal bool IsFlushInProgress => Volatile.Read(ref _flushArmed) != 0;
     
     /// <summary>Size of the unmanaged write slab.</summary>
     private readonly int _writeSlabSize;
@@ -64,25 +65,30 @@ public unsafe partial class Connection
     private readonly UnmanagedMemoryManager _manager;
 
     /// <summary>
-    /// Pointer to the unmanaged write slab. Bytes are staged here before being flushed by the reactor.
+    /// Pointer to the unmanaged write slab, the first block of the write chain.
     /// </summary>
     public byte* WriteBuffer { get; }
 
     /// <summary>
-    /// Logical start of valid staged data. Currently unused (kept at 0), but reserved for streaming /
-    /// partial flush scenarios.
+    /// Reactor-owned: bytes of the chain sent so far. Written by the reactor with volatile writes so
+    /// the producer can tell when the chain has drained.
+    /// </summary>
+    internal long WriteHead;
+
+    /// <summary>
+    /// Bytes written and not yet sent (staged plus in flight).
     /// </summary>
-    internal int WriteHead { get; set; }
+    public int WriteTail => (int)(_writePos - Volatile.Read(ref WriteHead));
 
     /// <summary>
-    /// Logical end of written staged data in <see cref="WriteBuffer"/>. Producer appends here.
+    /// Reactor-owned: end of the range the current send sequence is sending (a snapshot of the flush position).
     /// </summary>
-    public int WriteTail { get; private set; }
+    internal long WriteInFlight { get; set; }
 
     /// <summary>
-    /// Logical end of written staged data in <see cref="WriteBuffer"/>. Producer appends here.
+    /// Reactor-owned: Stopwatch timestamp at which the current send batch was issued (flush latency metric).
     /// </summary>
-    internal int WriteInFlight { get; set; }
+    internal long SendBatchStart;
     
     /// <summary>
     /// Reactor-owned flag:
@@ -91,6 +97,22 @@ public unsafe partial class Connection
     /// </summary>
     internal int SendInflight; // 0/1
 
+    /// <summary>
+    /// Reactor-owned: fixed-buffer slot under which <see cref="WriteBuffer"/> is registered in the
+    /// owning reactor's ring, or -1 when not registered (zero-copy send mode only).
+    /// </summary>
+    internal int FixedWriteIndex = -1;
+
+    /// <summary>
+    /// Reactor-owned: zero-copy sends the kernel may still read from, counted when the SEND_ZC is issued
+    /// and done at its notification. While non-zero, blocks are not released, the flush waiter is not
+    /// completed and a closed connection is not pooled.
+    /// </summary>
+    internal int ZeroCopyPending;
+
+    /// <summary>Size of the unmanaged write slab in bytes.</summary>
+    internal int WriteSlabSize => _writeSlabSize;
+
     /// <summary>
     /// Creates a new unmanaged write slab for the connection.
     /// </summary>
@@ -98,35 +120,38 @@ public unsafe partial class Connection
     public Connection(int writeSlabSize = 1024 * 16) {
         _writeSlabSize = writeSlabSize;
         WriteBuffer = (byte*)NativeMemory.AlignedAlloc((nuint)(writeSlabSize), 64);
-        WriteHead = 0; WriteTail = 0;
         
         _manager = new UnmanagedMemoryManager(WriteBuffer, writeSlabSize);
+        _slabSegment = new WriteSegment(_manager);
+        _head = _tail = _slabSegment;
+        ResetWriteChain();
     }
-    
+
     /// <summary>
-    /// Resets the logical range markers so the slab can be reused for the next batch.
-    /// Does not clear the underlying memory (bytes are considered overwritten on next writes).
+    /// Creates a connection over a write slab owned by someone else (e.g. a reactor's huge-page arena).
+    /// The slab is not freed on <see cref="Dispose"/>.
     /// </summary>
-    [MethodImpl(MethodImplOptions.AggressiveInlining)]
-    internal void ResetWriteBuffer()
-    {
-        WriteHead = 0;
-        WriteTail = 0; 
+    /// <param name="writeSlab">Start of the slab; 64-byte aligned.</param>
+    /// <param name="writeSlabSize">Size in bytes of the slab.</param>
+    internal Connection(byte* writeSlab, int writeSlabSize) {
+        _writeSlabSize = writeSlabSize;
+        WriteBuffer = writeSlab;
+
+        _manager = new UnmanagedMemoryManager(WriteBuffer, writeSlabSize, freeable: false);
+        _slabSegment = new WriteSegment(_manager);
+        _head = _tail = _slabSegment;
+        ResetWriteChain();
     }
-    
 
     /// <summary>
     /// Completes the active flush waiter (reactor thread).
-    /// Must be called exactly once for each successful <see cref="FlushAsync"/> that armed a waiter.
+    /// Must be called exactly once for each <see cref="FlushAsync"/> that armed a waiter, by whoever disarmed it.
     /// </summary>
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
     internal void CompleteFlush()
     {
-        // Allow next write/flush cycle BEFORE signaling completion.
-        // SetResult can resume the handler synchronously (inline continuation),
-        // so barriers must be cleared first or the handler will see _flushInProgress == 1.
-        Volatile.Write(ref _flushInProgress, 0);
-        Volatile.Write(ref _flushArmed, 0);
+        // The caller has already disarmed the waiter (Interlocked.Exchange on _flushArmed), so the
+        // handler can arm the next flush as soon as SetResult resumes it inline on this thread.
 
         // Resume waiter (may execute handler inline on this thread)
         _flushSignal.SetResult(true);
@@ -145,5 +170,5 @@ public unsafe partial class Connection
 
     void IValueTaskSource.OnCompleted(Action<object?> continuation, object? state, short token,
         ValueTaskSourceOnCompletedFlags flags)
-        => _flushSignal.OnCompleted(continuation, state, _flushSignal.Version, flags);
+        => _flushSignal.OnCompleted(continuation, state, _flushSignal.Version, InlineOnReactor(flags));
 }
\ No newline at end of file
@@ -16,10 +16,29 @@ public sealed partial class Connection :
     /// </summary>
     public int ClientFd { get; private set; }
 
+    /// <summary>
+    /// True when <see cref="ClientFd"/> is a slot in the owning reactor's fixed-file table
+    /// (<see cref="Engine.Configs.ReactorConfig.DirectDescriptors"/>) rather than a process fd.
+    /// A direct descriptor is only meaningful to io_uring requests on that reactor's ring.
+    /// </summary>
+    public bool IsDirectDescriptor { get; private set; }
+
     /// <summary>
     /// Owning reactor (used to return buffers back to reactor-owned pool).
     /// </summary>
     public Engine.Engine.Reactor Reactor { get; private set; } = null!;
+
+    /// <summary>
+    /// Reactor-owned: slot id in the owning reactor's <see cref="Engine.ConnectionSlotTable"/>,
+    /// or -1 while the connection is not registered. Identifies the connection in flush requests and CQEs.
+    /// </summary>
+    internal int Slot = -1;
+
+    /// <summary>
+    /// Reactor-owned: generation of <see cref="Slot"/> for this lifetime, packed into the user_data
+    /// of every SQE issued for the connection.
+    /// </summary>
+    internal uint SlotGeneration;
     
     // =========================================================================
     // Pooling / lifecycle
@@ -42,7 +61,7 @@ public sealed partial class Connection :
         Volatile.Write(ref _closed, 1);
 
         // Write-side state (defined in another partial).
-        ResetWriteBuffer();
+        ResetWriteChain();
 
         // Read-side state.
         Volatile.Write(ref _armed, 0);
@@ -76,15 +95,23 @@ public sealed partial class Connection :
             catch { /* ignore */ }
         }
 
-        Volatile.Write(ref _flushInProgress, 0);
         Volatile.Write(ref SendInflight, 0);
 
-        // Write-side state
-        ResetWriteBuffer();
-        WriteInFlight = 0;
+        // Write-side state: staged bytes are dropped and segments go back to the reactor pool.
+        ZeroCopyPending = 0;
+        ResetWriteChain();
+
+        // Give the fixed-buffer slot back to the reactor; the next lifetime may run on another ring.
+        if (FixedWriteIndex >= 0)
+        {
+            Reactor.ReleaseFixedWriteSlot(FixedWriteIndex);
+            FixedWriteIndex = -1;
+        }
 
         // Read-side buffers
         _recv.Clear();
+        Relay = null;
+        FileSend = null;
 
         // Finally reset the VTS cores for reuse
         _readSignal.Reset();
@@ -93,10 +120,12 @@ public sealed partial class Connection :
 
     /// <summary>
     /// Assign fd for a newly accepted connection.
+    /// With <paramref name="direct"/>, <paramref name="fd"/> is a fixed-file slot of the reactor's ring.
     /// </summary>
-    public Connection SetFd(int fd)
+    public Connection SetFd(int fd, bool direct = false)
     {
         ClientFd = fd; 
+        IsDirectDescriptor = direct;
         return this; 
     }
 
@@ -122,6 +151,7 @@ public sealed partial class Connection :
     {
         // Free the unmanaged slab (AlignedFree)
         _manager.Free();
+        FreeSendMsg();
 
         // No-op for your implementation, but fine to keep for correctness/future changes.
         ((IDisposable)_manager).Dispose();
@@ -0,0 +1,387 @@
+using System.Runtime.CompilerServices;
+using System.Threading.Tasks.Sources;
+using zerg.Utils;
+using zerg.Utils.Framing;
+
+namespace zerg;
+
+/// <summary>
+/// Splits the bytes received on a <see cref="Connection"/> into frames described by a <see cref="FrameDecoder"/>
+/// (delimiter, length prefix or custom predicate), without going through <see cref="ReadOnlySequence{T}"/>.
+///
+/// Frames are handed out as spans over the io_uring receive buffers themselves. Only a frame that straddles
+/// two or more buffers is copied, into the connection's scratch area. Delimiters are searched with
+/// <see cref="DelimiterSearch"/> inside each buffer, and a partial match at the end of a buffer carries over
+/// to the next one, so no byte is scanned twice while a frame is incomplete.
+///
+/// A frame stays valid until the next <see cref="TryReadFrame"/>, <see cref="ReadAsync"/> or <see cref="Dispose"/>;
+/// that call consumes it and returns every buffer it fully covered to the reactor pool.
+///
+/// <code>
+/// var framer = new ConnectionFramer(connection, FrameDecoder.Delimiter("\r\n\r\n"u8));
+/// while (await framer.ReadAsync())
+/// {
+///     while (framer.TryReadFrame(out ReadOnlySpan&lt;byte&gt; frame))
+///         Handle(frame);
+/// }
+/// framer.Dispose();
+/// </code>
+/// </summary>
+public sealed unsafe class ConnectionFramer : IValueTaskSource<bool>, IDisposable
+{
+    private readonly Connection _inner;
+    private readonly FrameDecoder _decoder;
+
+    /// <summary>Receive buffers not yet consumed, oldest at <see cref="_head"/>; [_head, _tail) is live.</summary>
+    private RingItem[] _items = new RingItem[16];
+    private int _head;
+    private int _tail;
+    /// <summary>Bytes of <c>_items[_head]</c> already consumed.</summary>
+    private int _headOffset;
+    /// <summary>Unconsumed bytes across all held buffers.</summary>
+    private long _buffered;
+    /// <summary>Length of the frame last handed out; consumed by the next call.</summary>
+    private long _pendingConsume;
+
+    /// <summary>
+    /// Delimiter scan resume point: item and offset the scan continues from, bytes scanned since the start of
+    /// unconsumed data, and how many delimiter bytes the scanned data ends with.
+    /// </summary>
+    private int _scanItem;
+    private int _scanOffset;
+    private long _scanned;
+    private int _matched;
+
+    private bool _closed;
+    private bool _disposed;
+
+    /// <summary>The connection read a pending <see cref="ReadAsync"/> waits on.</summary>
+    private ValueTask<RingSnapshot> _pendingRead;
+    private short _readToken;
+    private Action<object?>? _continuation;
+    private object? _continuationState;
+    private readonly Action _onReadCompleted;
+
+    public ConnectionFramer(Connection inner, FrameDecoder decoder)
+    {
+        _inner = inner ?? throw new ArgumentNullException(nameof(inner));
+        _decoder = decoder ?? throw new ArgumentNullException(nameof(decoder));
+        _onReadCompleted = OnReadCompleted;
+    }
+
+    // -----------------------------------------------------------------
+    // ReadAsync
+    // -----------------------------------------------------------------
+
+    /// <summary>
+    /// Waits for more data from the reactor. Returns false once the connection is closed; frames still
+    /// complete in the held data can be read before that. Call it only after <see cref="TryReadFrame"/>
+    /// returned false, otherwise it waits with complete frames held.
+    /// </summary>
+    public ValueTask<bool> ReadAsync()
+    {
+        ObjectDisposedException.ThrowIf(_disposed, this);
+        ConsumePending();
+
+        if (_closed)
+            return new ValueTask<bool>(false);
+
+        ValueTask<RingSnapshot> read = _inner.ReadAsync();
+        if (read.IsCompletedSuccessfully)
+            return new ValueTask<bool>(OnSnapshot(read.Result));
+
+        _pendingRead = read;
+        return new ValueTask<bool>(this, ++_readToken);
+    }
+
+    private bool OnSnapshot(RingSnapshot result)
+    {
+        if (result.IsClosed)
+        {
+            _closed = true;
+            return false;
+        }
+
+        while (_inner.TryGetRing(result.TailSnapshot, out RingItem item))
+        {
+            if (_tail == _items.Length)
+                MakeRoom();
+            _items[_tail++] = item;
+            _buffered += item.Length;
+        }
+
+        _inner.ResetRead();
+        return true;
+    }
+
+    /// <summary>Compacts the live items to the front of the array, or grows it when they fill it.</summary>
+    private void MakeRoom()
+    {
+        if (_head == 0)
+        {
+            Array.Resize(ref _items, _items.Length * 2);
+            return;
+        }
+
+        Array.Copy(_items, _head, _items, 0, _tail - _head);
+        _scanItem -= _head;
+        _tail -= _head;
+        _head = 0;
+    }
+
+    // -----------------------------------------------------------------
+    // TryReadFrame
+    // -----------------------------------------------------------------
+
+    /// <summary>
+    /// Consumes the previous frame and returns the next complete one, if the held data contains it.
+    /// Throws <see cref="InvalidDataException"/> when a frame exceeds <see cref="FrameDecoder.MaxFrameLength"/>
+    /// or the custom decoder rejects the data.
+    /// </summary>
+    public bool TryReadFrame(out ReadOnlySpan<byte> frame)
+    {
+        ObjectDisposedException.ThrowIf(_disposed, this);
+        ConsumePending();
+
+        frame = default;
+        if (_buffered == 0)
+            return false;
+
+        long length = _decoder.Kind switch
+        {
+            FrameDecoder.FrameKind.Delimiter => ScanDelimiter(),
+            FrameDecoder.FrameKind.LengthPrefix => MeasureLengthPrefix(),
+            _ => MeasureCustom()
+        };
+        if (length == 0)
+            return false;
+        if (length > _decoder.MaxFrameLength)
+            throw new InvalidDataException($"Frame of {length} bytes exceeds the {_decoder.MaxFrameLength} byte limit.");
+
+        frame = Gather((int)length);
+        _pendingConsume = length;
+        return true;
+    }
+
+    /// <summary>Resumes the delimiter scan; returns the frame length including the delimiter, or 0.</summary>
+    private long ScanDelimiter()
+    {
+        ReadOnlySpan<byte> delimiter = _decoder.DelimiterBytes;
+        int delimiterLength = delimiter.Length;
+
+        while (_scanItem < _tail)
+        {
+            RingItem item = _items[_scanItem];
+            byte* ptr = item.Ptr;
+            int length = item.Length;
+            int i = _scanOffset;
+
+            // A match that began in an earlier buffer continues byte by byte until it completes or breaks.
+            while (_matched > 0 && i < length)
+            {
+                _matched = _decoder.Step(_matched, ptr[i++]);
+                if (_matched == delimiterLength)
+                    return _scanned + (i - _scanOffset);
+            }
+
+            if (i < length)
+            {
+                int index = DelimiterSearch.IndexOf(ptr + i, length - i, delimiter);
+                if (index >= 0)
+                    return _scanned + (i + index + delimiterLength - _scanOffset);
+
+                // No match: remember how much of the delimiter the buffer ends with.
+                for (int j = Math.Max(i, length - (delimiterLength - 1)); j < length; j++)
+                    _matched = _decoder.Step(_matched, ptr[j]);
+            }
+
+            _scanned += length - _scanOffset;
+            _scanItem++;
+            _scanOffset = 0;
+        }
+
+        if (_scanned > _decoder.MaxFrameLength)
+            throw new InvalidDataException($"No delimiter within {_decoder.MaxFrameLength} bytes.");
+        return 0;
+    }
+
+    /// <summary>Returns the prefix plus payload length once all of it is held, or 0.</summary>
+    private long MeasureLengthPrefix()
+    {
+        int prefixLength = _decoder.PrefixLength;
+        if (_buffered < prefixLength)
+            return 0;
+
+        Span<byte> prefix = stackalloc byte[4];
+        Copy(prefix[..prefixLength]);
+        long length = prefixLength + (long)_decoder.ReadPrefix(prefix[..prefixLength]);
+        if (length > _decoder.MaxFrameLength)
+            throw new InvalidDataException($"Frame of {length} bytes exceeds the {_decoder.MaxFrameLength} byte limit.");
+
+        return _buffered >= length ? length : 0;
+    }
+
+    /// <summary>Runs the custom decoder over the held data, contiguous only when it has to be.</summary>
+    private long MeasureCustom()
+    {
+        RingItem head = _items[_head];
+        ReadOnlySpan<byte> first = new(head.Ptr + _headOffset, head.Length - _headOffset);
+        int length = _decoder.Custom!(first);
+
+        if (length == 0 && _tail - _head > 1)
+        {
+            int available = (int)Math.Min(_buffered, _decoder.MaxFrameLength);
+            Span<byte> all = _inner.FrameScratch(available).AsSpan(0, available);
+            Copy(all);
+            length = _decoder.Custom(all);
+        }
+
+        if (length < 0)
+            throw new InvalidDataException("The frame decoder rejected the received data.");
+        if (length == 0 && _buffered >= _decoder.MaxFrameLength)
+            throw new InvalidDataException($"No frame within {_decoder.MaxFrameLength} bytes.");
+
+        // A decoder that reads the length from a header may name a frame that has not fully arrived yet.
+        return length <= _buffered ? length : 0;
+    }
+
+    /// <summary>
+    /// The first <paramref name="length"/> unconsumed bytes: straight from the head buffer when it holds them,
+    /// otherwise copied into the connection's scratch area.
+    /// </summary>
+    private ReadOnlySpan<byte> Gather(int length)
+    {
+        RingItem head = _items[_head];
+        if (head.Length - _headOffset >= length)
+            return new ReadOnlySpan<byte>(head.Ptr + _headOffset, length);
+
+        Span<byte> scratch = _inner.FrameScratch(length).AsSpan(0, length);
+        Copy(scratch);
+        return scratch;
+    }
+
+    /// <summary>Copies the first <c>destination.Length</c> unconsumed bytes into <paramref name="destination"/>.</summary>
+    private void Copy(Span<byte> destination)
+    {
+        int copied = 0;
+        int offset = _headOffset;
+        for (int i = _head; copied < destination.Length; i++)
+        {
+            RingItem item = _items[i];
+            int n = Math.Min(item.Length - offset, destination.Length - copied);
+            new ReadOnlySpan<byte>(item.Ptr + offset, n).CopyTo(destination[copied..]);
+            copied += n;
+            offset = 0;
+        }
+    }
+
+    /// <summary>
+    /// Consumes the frame handed out last: buffers it fully covered go back to the reactor pool and the
+    /// delimiter scan restarts at the new start of unconsumed data.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private void ConsumePending()
+    {
+        long remaining = _pendingConsume;
+        if (remaining == 0)
+            return;
+
+        _pendingConsume = 0;
+        _buffered -= remaining;
+
+        while (remaining > 0)
+        {
+            RingItem item = _items[_head];
+            int available = item.Length - _headOffset;
+            if (remaining >= available)
+            {
+                _inner.ReturnRing(item.BufferId);
+                _head++;
+                _headOffset = 0;
+                remaining -= available;
+            }
+            else
+            {
+                _headOffset += (int)remaining;
+                remaining = 0;
+            }
+        }
+
+        if (_head == _tail)
+            _head = _tail = 0;
+
+        _scanItem = _head;
+        _scanOffset = _headOffset;
+        _scanned = 0;
+        _matched = 0;
+    }
+
+    // -----------------------------------------------------------------
+    // IValueTaskSource<bool>: forwards to the pending connection read
+    // -----------------------------------------------------------------
+
+    ValueTaskSourceStatus IValueTaskSource<bool>.GetStatus(short token)
+    {
+        ValidateToken(token);
+        ValueTask<RingSnapshot> read = _pendingRead;
+        if (!read.IsCompleted)
+            return ValueTaskSourceStatus.Pending;
+        if (read.IsCompletedSuccessfully)
+            return ValueTaskSourceStatus.Succeeded;
+        return read.IsCanceled ? ValueTaskSourceStatus.Canceled : ValueTaskSourceStatus.Faulted;
+    }
+
+    void IValueTaskSource<bool>.OnCompleted(
+        Action<object?> continuation, object? state, short token, ValueTaskSourceOnCompletedFlags flags)
+    {
+        ValidateToken(token);
+        _continuation = continuation;
+        _continuationState = state;
+        if ((flags & ValueTaskSourceOnCompletedFlags.UseSchedulingContext) != 0)
+            _pendingRead.GetAwaiter().UnsafeOnCompleted(_onReadCompleted);
+        else
+            _pendingRead.ConfigureAwait(false).GetAwaiter().UnsafeOnCompleted(_onReadCompleted);
+    }
+
+    bool IValueTaskSource<bool>.GetResult(short token)
+    {
+        ValidateToken(token);
+        ValueTask<RingSnapshot> read = _pendingRead;
+        _pendingRead = default;
+        return OnSnapshot(read.GetAwaiter().GetResult());
+    }
+
+    private void OnReadCompleted()
+    {
+        Action<object?> continuation = _continuation!;
+        object? state = _continuationState;
+        _continuation = null;
+        _continuationState = null;
+        continuation(state);
+    }
+
+    private void ValidateToken(short token)
+    {
+        if (token != _readToken)
+            throw new InvalidOperationException("The ReadAsync result was already consumed.");
+    }
+
+    // -----------------------------------------------------------------
+    // Dispose
+    // -----------------------------------------------------------------
+
+    /// <summary>Returns every held buffer, including a partial frame, to the reactor pool.</summary>
+    public void Dispose()
+    {
+        if (_disposed)
+            return;
+
+        _disposed = true;
+        for (int i = _head; i < _tail; i++)
+            _inner.ReturnRing(_items[i].BufferId);
+
+        _head = _tail = 0;
+        _buffered = 0;
+        _pendingConsume = 0;
+    }
+}
@@ -1,5 +1,7 @@
 using System.Buffers;
 using System.IO.Pipelines;
+using System.Runtime.CompilerServices;
+using System.Threading.Tasks.Sources;
 using zerg.Utils;
 
 namespace zerg;
@@ -12,6 +14,10 @@ namespace zerg;
 /// to the consumer as a <see cref="ReadOnlySequence{T}"/>. Buffers are only returned to the
 /// reactor pool when the consumer advances past them via <see cref="AdvanceTo"/>.
 ///
+/// Steady-state reads allocate nothing: the sequence segments come from a per-connection pool
+/// (<see cref="Connection.RentSegment"/>) and go back to it as they are consumed, and a read that has
+/// to wait completes through this reader's own <see cref="IValueTaskSource{TResult}"/>.
+///
 /// This gives two key advantages over the Stream path:
 /// <list type="bullet">
 ///   <item>No per-read copy — data stays in the original unmanaged receive buffers.</item>
@@ -33,16 +39,17 @@ namespace zerg;
 /// reader.Complete();
 /// </code>
 /// </summary>
-public sealed class ConnectionPipeReader : PipeReader
+public sealed class ConnectionPipeReader : PipeReader, IValueTaskSource<ReadResult>
 {
     private readonly Connection _inner;
 
     /// <summary>
-    /// Ring buffers dequeued from the connection but not yet fully consumed.
-    /// Each entry holds a (possibly sliced) memory region and the kernel buffer ID
+    /// Ring buffers dequeued from the connection but not yet fully consumed, oldest first.
+    /// Each pooled segment holds a (possibly partially consumed) buffer and the kernel buffer ID
     /// needed to return it to the reactor pool.
     /// </summary>
-    private readonly List<HeldBuffer> _held = new(4);
+    private RingSegment? _head;
+    private RingSegment? _tail;
 
     /// <summary>
     /// The last <see cref="ReadOnlySequence{T}"/> returned to the consumer.
@@ -54,16 +61,25 @@ public sealed class ConnectionPipeReader : PipeReader
     private bool _cancelRequested;
     private bool _connectionClosed;
 
+    /// <summary>The connection read a pending <see cref="ReadAsync"/> waits on.</summary>
+    private ValueTask<RingSnapshot> _pendingRead;
+    /// <summary>Token of the pending <see cref="ReadAsync"/>, bumped per wait to catch stale awaits.</summary>
+    private short _readToken;
+    private Action<object?>? _continuation;
+    private object? _continuationState;
+    private readonly Action _onReadCompleted;
+
     public ConnectionPipeReader(Connection inner)
     {
         _inner = inner ?? throw new ArgumentNullException(nameof(inner));
+        _onReadCompleted = OnReadCompleted;
     }
 
     // -----------------------------------------------------------------
     // ReadAsync
     // -----------------------------------------------------------------
 
-    public override async ValueTask<ReadResult> ReadAsync(
+    public override ValueTask<ReadResult> ReadAsync(
         CancellationToken cancellationToken = default)
     {
         ThrowIfCompleted();
@@ -71,19 +87,31 @@ public sealed class ConnectionPipeReader : PipeReader
         if (_cancelRequested)
         {
             _cancelRequested = false;
-            return new ReadResult(BuildSequence(), isCanceled: true, isCompleted: _connectionClosed);
+            return new ValueTask<ReadResult>(new ReadResult(BuildSequence(), isCanceled: true, isCompleted: _connectionClosed));
         }
 
         // Unconsumed data from a previous partial AdvanceTo — return it immediately.
-        if (_held.Count > 0)
-            return new ReadResult(BuildSequence(), isCanceled: false, isCompleted: _connectionClosed);
+        if (_head != null)
+            return new ValueTask<ReadResult>(new ReadResult(BuildSequence(), isCanceled: false, isCompleted: _connectionClosed));
 
         if (_connectionClosed)
-            return new ReadResult(default, isCanceled: false, isCompleted: true);
+            return new ValueTask<ReadResult>(new ReadResult(default, isCanceled: false, isCompleted: true));
 
-        // Await new data from the reactor.
-        var result = await _inner.ReadAsync();
+        // Await new data from the reactor: synchronously when it is already there, otherwise
+        // through this reader (the connection's wait is forwarded, see IValueTaskSource below).
+        ValueTask<RingSnapshot> read = _inner.ReadAsync();
+        if (read.IsCompletedSuccessfully)
+            return new ValueTask<ReadResult>(OnSnapshot(read.Result));
 
+        _pendingRead = read;
+        return new ValueTask<ReadResult>(this, ++_readToken);
+    }
+
+    /// <summary>
+    /// Takes the items of a completed connection read into <see cref="_head"/> and builds the result.
+    /// </summary>
+    private ReadResult OnSnapshot(RingSnapshot result)
+    {
         if (result.IsClosed)
         {
             _connectionClosed = true;
@@ -102,6 +130,59 @@ public sealed class ConnectionPipeReader : PipeReader
         return new ReadResult(BuildSequence(), isCanceled: false, isCompleted: false);
     }
 
+    // -----------------------------------------------------------------
+    // IValueTaskSource<ReadResult>: forwards to the pending connection read
+    // -----------------------------------------------------------------
+
+    ValueTaskSourceStatus IValueTaskSource<ReadResult>.GetStatus(short token)
+    {
+        ValidateToken(token);
+        ValueTask<RingSnapshot> read = _pendingRead;
+        if (!read.IsCompleted)
+            return ValueTaskSourceStatus.Pending;
+        if (read.IsCompletedSuccessfully)
+            return ValueTaskSourceStatus.Succeeded;
+        return read.IsCanceled ? ValueTaskSourceStatus.Canceled : ValueTaskSourceStatus.Faulted;
+    }
+
+    void IValueTaskSource<ReadResult>.OnCompleted(
+        Action<object?> continuation, object? state, short token, ValueTaskSourceOnCompletedFlags flags)
+    {
+        ValidateToken(token);
+        _continuation = continuation;
+        _continuationState = state;
+        // The cached delegate keeps the wait allocation-free; the connection captures the scheduling
+        // context exactly as it would for a direct await.
+        if ((flags & ValueTaskSourceOnCompletedFlags.UseSchedulingContext) != 0)
+            _pendingRead.GetAwaiter().UnsafeOnCompleted(_onReadCompleted);
+        else
+            _pendingRead.ConfigureAwait(false).GetAwaiter().UnsafeOnCompleted(_onReadCompleted);
+    }
+
+    ReadResult IValueTaskSource<ReadResult>.GetResult(short token)
+    {
+        ValidateToken(token);
+        ValueTask<RingSnapshot> read = _pendingRead;
+        _pendingRead = default;
+        return OnSnapshot(read.GetAwaiter().GetResult());
+    }
+
+    private void OnReadCompleted()
+    {
+        Action<object?> continuation = _continuation!;
+        object? state = _continuationState;
+        _continuation = null;
+        _continuationState = null;
+        continuation(state);
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private void ValidateToken(short token)
+    {
+        if (token != _readToken)
+            throw new InvalidOperationException("The ReadAsync result was already consumed.");
+    }
+
     // -----------------------------------------------------------------
     // TryRead
     // -----------------------------------------------------------------
@@ -117,7 +198,7 @@ public sealed class ConnectionPipeReader : PipeReader
             return true;
         }
 
-        if (_held.Count > 0)
+        if (_head != null)
         {
             result = new ReadResult(BuildSequence(), isCanceled: false, isCompleted: _connectionClosed);
             return true;
@@ -142,30 +223,37 @@ public sealed class ConnectionPipeReader : PipeReader
 
     public override void AdvanceTo(SequencePosition consumed, SequencePosition examined)
     {
-        if (_held.Count == 0)
+        if (_head == null)
             return;
 
         long consumedBytes = _lastSequence.Slice(0, consumed).Length;
 
-        while (_held.Count > 0 && consumedBytes > 0)
+        while (_head != null && consumedBytes > 0)
         {
-            var seg = _held[0];
+            RingSegment seg = _head;
             int available = seg.Memory.Length;
 
             if (consumedBytes >= available)
             {
-                // Fully consumed — return kernel buffer to reactor pool.
+                // Fully consumed — return kernel buffer to reactor pool, the segment to the connection.
+                _head = seg.NextSegment;
                 _inner.ReturnRing(seg.BufferId);
-                _held.RemoveAt(0);
+                _inner.ReturnSegment(seg);
                 consumedBytes -= available;
             }
             else
             {
                 // Partially consumed — keep the remainder.
-                _held[0] = new HeldBuffer(seg.Memory.Slice((int)consumedBytes), seg.BufferId);
+                seg.Consume((int)consumedBytes);
                 consumedBytes = 0;
             }
         }
+
+        if (_head == null)
+        {
+            _tail = null;
+            _lastSequence = default;
+        }
     }
 
     // -----------------------------------------------------------------
@@ -183,10 +271,16 @@ public sealed class ConnectionPipeReader : PipeReader
         _completed = true;
 
         // Return all held kernel buffers back to the reactor pool.
-        foreach (var seg in _held)
+        while (_head != null)
+        {
+            RingSegment seg = _head;
+            _head = seg.NextSegment;
             _inner.ReturnRing(seg.BufferId);
+            _inner.ReturnSegment(seg);
+        }
 
-        _held.Clear();
+        _tail = null;
+        _lastSequence = default;
     }
 
     // -----------------------------------------------------------------
@@ -194,13 +288,19 @@ public sealed class ConnectionPipeReader : PipeReader
     // -----------------------------------------------------------------
 
     /// <summary>
-    /// Dequeue all ring items from the current snapshot into <see cref="_held"/>.
+    /// Dequeue all ring items from the current snapshot into pooled segments at the end of the held chain.
     /// </summary>
     private void DrainSnapshot(RingSnapshot result)
     {
-        var rings = _inner.GetAllSnapshotRingsAsUnmanagedMemory(result);
-        foreach (var ring in rings)
-            _held.Add(new HeldBuffer(ring.Memory, ring.BufferId));
+        while (_inner.TryGetRing(result.TailSnapshot, out RingItem item))
+        {
+            RingSegment seg = _inner.RentSegment(item);
+            if (_tail == null)
+                _head = seg;
+            else
+                _tail.SetNext(seg);
+            _tail = seg;
+        }
     }
 
     /// <summary>
@@ -208,25 +308,21 @@ public sealed class ConnectionPipeReader : PipeReader
     /// </summary>
     private ReadOnlySequence<byte> BuildSequence()
     {
-        if (_held.Count == 0)
+        if (_head == null)
         {
             _lastSequence = default;
             return _lastSequence;
         }
 
-        if (_held.Count == 1)
+        // Partial consumption shifts every segment, so running indexes are recomputed per sequence.
+        long runningIndex = 0;
+        for (RingSegment? seg = _head; seg != null; seg = seg.NextSegment)
         {
-            _lastSequence = new ReadOnlySequence<byte>(_held[0].Memory);
-            return _lastSequence;
+            seg.SetRunningIndex(runningIndex);
+            runningIndex += seg.Memory.Length;
         }
 
-        var head = new RingSegment(_held[0].Memory, _held[0].BufferId);
-        var tail = head;
-
-        for (int i = 1; i < _held.Count; i++)
-            tail = tail.Append(_held[i].Memory, _held[i].BufferId);
-
-        _lastSequence = new ReadOnlySequence<byte>(head, 0, tail, tail.Memory.Length);
+        _lastSequence = new ReadOnlySequence<byte>(_head, 0, _tail!, _tail!.Memory.Length);
         return _lastSequence;
     }
 
@@ -236,9 +332,4 @@ public sealed class ConnectionPipeReader : PipeReader
             throw new InvalidOperationException(
                 "Reading is not allowed after the reader was completed.");
     }
-
-    /// <summary>
-    /// A held receive buffer that may have been partially consumed (sliced).
-    /// </summary>
-    private readonly record struct HeldBuffer(ReadOnlyMemory<byte> Memory, ushort BufferId);
 }
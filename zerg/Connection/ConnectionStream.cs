@@ -1,4 +1,5 @@
-using zerg.Utils.Memory;
+using System.Threading.Tasks.Sources;
+using zerg.Utils;
 
 namespace zerg;
 
@@ -9,14 +10,16 @@ namespace zerg;
 ///
 /// This stream is a *zero-copy façade*:
 /// - Writes append directly into the unmanaged slab owned by <see cref="Connection"/>.
-/// - Reads pull from the reactor's receive rings and copy once into the caller buffer.
+/// - Reads pull from the reactor's receive rings and copy once into the caller buffer. A buffer that does
+///   not fit is continued by the next read; steady-state reads allocate nothing (a read that has to wait
+///   completes through this stream's own <see cref="IValueTaskSource{TResult}"/>).
 /// - No internal buffering is performed here.
 /// - No synchronization is performed here; the owning reactor must provide exclusivity.
 ///
 /// This type exists purely to bridge APIs that only accept <see cref="Stream"/>.
 /// Directly using <see cref="Connection"/> is always faster and preferred.
 /// </summary>
-public sealed class ConnectionStream : Stream
+public sealed unsafe class ConnectionStream : Stream, IValueTaskSource<int>
 {
     /// <summary>
     /// Underlying high-performance connection.
@@ -30,6 +33,7 @@ public sealed class ConnectionStream : Stream
     public ConnectionStream(Connection inner)
     {
         _inner = inner ?? throw new ArgumentNullException(nameof(inner));
+        _onReadCompleted = OnReadCompleted;
     }
 
     // -----------------------------------------------------------------
@@ -90,36 +94,166 @@ public sealed class ConnectionStream : Stream
     /// Reads from the reactor receive rings and copies the data into the destination.
     ///
     /// This method:
-    /// - Awaits the next receive snapshot.
-    /// - Copies all contiguous ring segments into <paramref name="destination"/>.
-    /// - Returns each ring to the pool immediately after copy.
+    /// - Continues the current receive snapshot if the previous read left part of it.
+    /// - Otherwise awaits the next receive snapshot.
+    /// - Copies as many ring segments as fit into <paramref name="destination"/>, returning each ring
+    ///   to the pool as soon as it is fully copied.
     /// </summary>
-    public override async ValueTask<int> ReadAsync(
+    public override ValueTask<int> ReadAsync(
         Memory<byte> destination,
         CancellationToken cancellationToken = default)
     {
         if (destination.Length == 0)
-            return 0;
+            return new ValueTask<int>(0);
+
+        if (_inSnapshot)
+            return new ValueTask<int>(CopyOut(destination.Span));
+
+        while (true)
+        {
+            // Await a receive snapshot from the reactor.
+            ValueTask<RingSnapshot> read = _inner.ReadAsync();
+            if (!read.IsCompletedSuccessfully)
+            {
+                _pendingRead = read;
+                _pendingDestination = destination;
+                return new ValueTask<int>(this, ++_readToken);
+            }
+
+            // A snapshot can come up empty when its items were taken by the previous one; wait again.
+            RingSnapshot result = read.Result;
+            int copied = OnSnapshot(result, destination.Span);
+            if (copied != 0 || result.IsClosed)
+                return new ValueTask<int>(copied);
+        }
+    }
+
+    // -----------------------------------------------------------------
+    // Read state
+    // -----------------------------------------------------------------
+
+    /// <summary>A receive snapshot is being copied out: <see cref="_snapshotTail"/> bounds it.</summary>
+    private bool _inSnapshot;
+    private long _snapshotTail;
+    /// <summary>Ring item being copied and how much of it went out already.</summary>
+    private RingItem _current;
+    private int _currentOffset;
+    private bool _hasCurrent;
 
-        // Await a receive snapshot from the reactor.
-        var result = await _inner.ReadAsync();
+    /// <summary>The connection read a pending <see cref="ReadAsync(Memory{byte}, CancellationToken)"/> waits on.</summary>
+    private ValueTask<RingSnapshot> _pendingRead;
+    private Memory<byte> _pendingDestination;
+    private short _readToken;
+    private Action<object?>? _continuation;
+    private object? _continuationState;
+    private readonly Action _onReadCompleted;
+
+    private int OnSnapshot(RingSnapshot result, Span<byte> destination)
+    {
         if (result.IsClosed)
             return 0;
 
-        // Gather all segments that belong to this snapshot.
-        var rings = _inner.GetAllSnapshotRings(result);
+        _snapshotTail = result.TailSnapshot;
+        _inSnapshot = true;
+        return CopyOut(destination);
+    }
+
+    /// <summary>
+    /// Copies the current snapshot into <paramref name="destination"/>. Ends the snapshot (and prepares the
+    /// connection for the next read cycle) once no item of it is left.
+    /// </summary>
+    private int CopyOut(Span<byte> destination)
+    {
+        int copied = 0;
+        while (copied < destination.Length && NextItem())
+        {
+            int n = Math.Min(_current.Length - _currentOffset, destination.Length - copied);
+            new ReadOnlySpan<byte>(_current.Ptr + _currentOffset, n).CopyTo(destination.Slice(copied));
+            copied += n;
+            _currentOffset += n;
+
+            // Return ring buffers back to the reactor pool.
+            if (_currentOffset == _current.Length)
+            {
+                _inner.ReturnRing(_current.BufferId);
+                _hasCurrent = false;
+            }
+        }
 
-        // Copy once into the caller buffer.
-        var len = destination.CopyFromRings(rings);
+        // Look ahead so a drained snapshot ends now and the next read waits for new data.
+        NextItem();
+        return copied;
+    }
 
-        // Return ring buffers back to the reactor pool.
-        foreach (var ring in rings)
-            _inner.ReturnRing(ring.BufferId);
+    private bool NextItem()
+    {
+        if (_hasCurrent)
+            return true;
+        if (!_inSnapshot)
+            return false;
+        if (_inner.TryGetRing(_snapshotTail, out _current))
+        {
+            _currentOffset = 0;
+            _hasCurrent = true;
+            return true;
+        }
 
         // Prepare for the next read cycle (resets the ManualResetValueTaskSourceCore).
+        _inSnapshot = false;
         _inner.ResetRead();
+        return false;
+    }
+
+    // -----------------------------------------------------------------
+    // IValueTaskSource<int>: forwards to the pending connection read
+    // -----------------------------------------------------------------
+
+    ValueTaskSourceStatus IValueTaskSource<int>.GetStatus(short token)
+    {
+        ValidateToken(token);
+        ValueTask<RingSnapshot> read = _pendingRead;
+        if (!read.IsCompleted)
+            return ValueTaskSourceStatus.Pending;
+        if (read.IsCompletedSuccessfully)
+            return ValueTaskSourceStatus.Succeeded;
+        return read.IsCanceled ? ValueTaskSourceStatus.Canceled : ValueTaskSourceStatus.Faulted;
+    }
 
-        return len;
+    void IValueTaskSource<int>.OnCompleted(
+        Action<object?> continuation, object? state, short token, ValueTaskSourceOnCompletedFlags flags)
+    {
+        ValidateToken(token);
+        _continuation = continuation;
+        _continuationState = state;
+        if ((flags & ValueTaskSourceOnCompletedFlags.UseSchedulingContext) != 0)
+            _pendingRead.GetAwaiter().UnsafeOnCompleted(_onReadCompleted);
+        else
+            _pendingRead.ConfigureAwait(false).GetAwaiter().UnsafeOnCompleted(_onReadCompleted);
+    }
+
+    int IValueTaskSource<int>.GetResult(short token)
+    {
+        ValidateToken(token);
+        ValueTask<RingSnapshot> read = _pendingRead;
+        Memory<byte> destination = _pendingDestination;
+        _pendingRead = default;
+        _pendingDestination = default;
+        return OnSnapshot(read.GetAwaiter().GetResult(), destination.Span);
+    }
+
+    private void OnReadCompleted()
+    {
+        Action<object?> continuation = _continuation!;
+        object? state = _continuationState;
+        _continuation = null;
+        _continuationState = null;
+        continuation(state);
+    }
+
+    private void ValidateToken(short token)
+    {
+        if (token != _readToken)
+            throw new InvalidOperationException("The ReadAsync result was already consumed.");
     }
 
     // -----------------------------------------------------------------
@@ -0,0 +1,20 @@
+namespace zerg;
+
+/// <summary>
+/// One received datagram (see <see cref="DatagramSocket.TryReceive"/>). <see cref="Payload"/> points into a
+/// reactor recv buffer and is only valid until the next <see cref="DatagramSocket.TryReceive"/> or
+/// <see cref="DatagramSocket.Dispose"/>; copy what must outlive it.
+/// </summary>
+public readonly ref struct Datagram
+{
+    internal Datagram(ReadOnlySpan<byte> payload, in DatagramPeer peer)
+    {
+        Payload = payload;
+        Peer = peer;
+    }
+
+    public ReadOnlySpan<byte> Payload { get; }
+
+    /// <summary>The sender; pass it to <see cref="DatagramSocket.Send(ReadOnlySpan{byte}, in DatagramPeer)"/> to reply.</summary>
+    public DatagramPeer Peer { get; }
+}
@@ -0,0 +1,141 @@
+using System.Buffers.Binary;
+using System.Net;
+using System.Net.Sockets;
+using System.Runtime.CompilerServices;
+using static zerg.ABI.ABI;
+
+namespace zerg;
+
+/// <summary>
+/// The address of a datagram's sender or recipient, held as the raw socket address the kernel reports
+/// (<c>sockaddr_in</c> or <c>sockaddr_in6</c>), so receiving and replying never allocate.
+/// Equal peers compare and hash equal.
+/// </summary>
+[SkipLocalsInit]
+public unsafe struct DatagramPeer : IEquatable<DatagramPeer>
+{
+    /// <summary>Size of <c>sockaddr_in6</c>, the largest address a peer holds.</summary>
+    internal const int MaxLength = 28;
+
+    private fixed byte _address[MaxLength];
+    private int _length;
+
+    /// <summary>Copies a socket address of <paramref name="length"/> bytes (truncated to <see cref="MaxLength"/>).</summary>
+    internal DatagramPeer(byte* address, int length)
+    {
+        _length = Math.Min(length, MaxLength);
+        fixed (byte* dst = _address)
+            Buffer.MemoryCopy(address, dst, MaxLength, _length);
+    }
+
+    /// <summary>Length of the socket address; 0 for a default instance.</summary>
+    internal readonly int Length => _length;
+
+    public readonly AddressFamily AddressFamily => _length == 0
+        ? AddressFamily.Unspecified
+        : ReadFamily() == AF_INET6 ? AddressFamily.InterNetworkV6 : AddressFamily.InterNetwork;
+
+    public readonly int Port
+    {
+        get
+        {
+            fixed (byte* p = _address)
+                return _length == 0 ? 0 : BinaryPrimitives.ReadUInt16BigEndian(new ReadOnlySpan<byte>(p + 2, 2));
+        }
+    }
+
+    /// <summary>Creates the socket address of <paramref name="endPoint"/>.</summary>
+    public static DatagramPeer FromEndPoint(IPEndPoint endPoint)
+    {
+        ArgumentNullException.ThrowIfNull(endPoint);
+        DatagramPeer peer = default;
+        byte* p = peer._address;
+        bool v6 = endPoint.AddressFamily == AddressFamily.InterNetworkV6;
+        *(ushort*)p = (ushort)(v6 ? AF_INET6 : AF_INET);
+        BinaryPrimitives.WriteUInt16BigEndian(new Span<byte>(p + 2, 2), (ushort)endPoint.Port);
+        if (v6)
+        {
+            endPoint.Address.TryWriteBytes(new Span<byte>(p + 8, 16), out _);
+            *(uint*)(p + 24) = (uint)endPoint.Address.ScopeId;
+            peer._length = sizeof(sockaddr_in6);
+        }
+        else
+        {
+            endPoint.Address.TryWriteBytes(new Span<byte>(p + 4, 4), out _);
+            peer._length = sizeof(sockaddr_in);
+        }
+        return peer;
+    }
+
+    /// <summary>The peer as an <see cref="IPEndPoint"/> (allocates).</summary>
+    public readonly IPEndPoint ToEndPoint()
+    {
+        fixed (byte* p = _address)
+        {
+            if (_length == 0)
+                return new IPEndPoint(IPAddress.None, 0);
+            if (ReadFamily() == AF_INET6)
+                return new IPEndPoint(new IPAddress(new ReadOnlySpan<byte>(p + 8, 16), *(uint*)(p + 24)), Port);
+            return new IPEndPoint(new IPAddress(new ReadOnlySpan<byte>(p + 4, 4)), Port);
+        }
+    }
+
+    /// <summary>
+    /// The IPv4-mapped IPv6 form of an IPv4 peer (<c>::ffff:a.b.c.d</c>), as a dual-stack IPv6 socket
+    /// needs it; any other peer is returned unchanged.
+    /// </summary>
+    internal readonly DatagramPeer MapToIPv6()
+    {
+        if (_length == 0 || ReadFamily() == AF_INET6)
+            return this;
+        DatagramPeer mapped = default;
+        byte* dst = mapped._address;
+        fixed (byte* src = _address)
+        {
+            *(ushort*)dst = (ushort)AF_INET6;
+            *(ushort*)(dst + 2) = *(ushort*)(src + 2);
+            dst[18] = 0xff;
+            dst[19] = 0xff;
+            *(uint*)(dst + 20) = *(uint*)(src + 4);
+        }
+        mapped._length = sizeof(sockaddr_in6);
+        return mapped;
+    }
+
+    /// <summary>Copies the socket address to <paramref name="destination"/> and returns its length.</summary>
+    internal readonly int CopyTo(byte* destination)
+    {
+        fixed (byte* src = _address)
+            Buffer.MemoryCopy(src, destination, MaxLength, _length);
+        return _length;
+    }
+
+    private readonly ushort ReadFamily()
+    {
+        fixed (byte* p = _address)
+            return *(ushort*)p;
+    }
+
+    public readonly bool Equals(DatagramPeer other)
+    {
+        if (_length != other._length)
+            return false;
+        fixed (byte* a = _address)
+            return new ReadOnlySpan<byte>(a, _length).SequenceEqual(new ReadOnlySpan<byte>(other._address, _length));
+    }
+
+    public override readonly bool Equals(object? obj) => obj is DatagramPeer other && Equals(other);
+
+    public override readonly int GetHashCode()
+    {
+        HashCode hash = default;
+        fixed (byte* p = _address)
+            hash.AddBytes(new ReadOnlySpan<byte>(p, _length));
+        return hash.ToHashCode();
+    }
+
+    public override readonly string ToString() => _length == 0 ? "(none)" : ToEndPoint().ToString();
+
+    public static bool operator ==(DatagramPeer left, DatagramPeer right) => left.Equals(right);
+    public static bool operator !=(DatagramPeer left, DatagramPeer right) => !left.Equals(right);
+}
@@ -0,0 +1,280 @@
+using System.Net;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Threading.Tasks.Sources;
+using static zerg.ABI.ABI;
+
+namespace zerg;
+
+public sealed unsafe partial class DatagramSocket : IValueTaskSource
+{
+    /// <summary>Most datagrams the kernel accepts in one segmented send (UDP_MAX_SEGMENTS).</summary>
+    internal const int MaxSegments = 64;
+    /// <summary>Largest UDP payload over IPv4, and the cap on the bytes of one segmented send.</summary>
+    public const int MaxDatagramSize = 65507;
+
+    /// <summary>
+    /// Datagrams to one peer that go out in a single sendmsg: all <see cref="SegmentSize"/> bytes except
+    /// possibly the last, which seals the batch (GSO requires every segment but the last to be full).
+    /// </summary>
+    private struct SendBatch
+    {
+        public DatagramPeer Peer;
+        public int Count;
+        public int SegmentSize;
+        public int Bytes;
+        /// <summary>Reactor-owned: -1, or the next datagram to resend alone after the segmented send was rejected.</summary>
+        public int Resend;
+    }
+
+    private readonly SendBatch[] _batches;
+    private int _batchCount;
+    /// <summary>Open batches by peer (at most one per peer), so datagrams to a peer join its batch.</summary>
+    private readonly Dictionary<DatagramPeer, int> _openBatches = new();
+
+    // Send arena (native): payload bytes, then per batch its iovecs, msghdr, address and UDP_SEGMENT cmsg.
+    private byte* _arena;
+    private byte* _payload;
+    private int _payloadUsed;
+    private iovec* _iov;
+    private msghdr* _msgs;
+    private byte* _names;
+    private byte* _controls;
+    private static readonly int s_controlSpace = CmsgSpace(sizeof(ushort));
+
+    private ManualResetValueTaskSourceCore<bool> _flushSignal;
+    /// <summary>1 from <see cref="FlushAsync"/> until the reactor has completed every batch.</summary>
+    private int _flushing;
+
+    /// <summary>Send batches (one sendmsg each) queued since the last flush.</summary>
+    public int QueuedBatches => _batchCount;
+
+    private void AllocateSendArena()
+    {
+        int batches = _batches.Length;
+        nuint payload = Align((nuint)Options.SendBufferSize);
+        nuint iov = Align((nuint)(batches * MaxSegments * sizeof(iovec)));
+        nuint msgs = Align((nuint)((batches + 1) * sizeof(msghdr)));
+        nuint names = (nuint)(batches * 32);
+        nuint controls = Align((nuint)(batches * s_controlSpace));
+
+        _arena = (byte*)NativeMemory.AlignedAlloc(payload + iov + msgs + names + controls, 64);
+        _payload = _arena;
+        _iov = (iovec*)(_arena + payload);
+        _msgs = (msghdr*)((byte*)_iov + iov);
+        _names = (byte*)_msgs + msgs;
+        _controls = _names + names;
+        NativeMemory.Clear(_msgs, msgs);
+        // The last msghdr is the recv header; the kernel only reads its name and control lengths.
+        RecvMsg = _msgs + batches;
+
+        static nuint Align(nuint n) => (n + 63) & ~(nuint)63;
+    }
+
+    private void FreeSendArena()
+    {
+        NativeMemory.AlignedFree(_arena);
+        _arena = null;
+        RecvMsg = null;
+    }
+
+    /// <summary>
+    /// Queues <paramref name="payload"/> as one datagram to <paramref name="peer"/>; nothing is sent before
+    /// <see cref="FlushAsync"/>. Consecutive datagrams of the same size to the same peer are sent as one
+    /// segmented (GSO) sendmsg. Returns false when the send buffer or the batch table is full: flush, then retry.
+    /// Must not be called while a flush is in progress.
+    /// </summary>
+    public bool Send(ReadOnlySpan<byte> payload, in DatagramPeer peer)
+    {
+        if (Volatile.Read(ref _flushing) != 0)
+            throw new InvalidOperationException("FlushAsync in progress.");
+        if (payload.Length > MaxDatagramSize)
+            throw new ArgumentOutOfRangeException(nameof(payload), $"A datagram carries at most {MaxDatagramSize} bytes.");
+        if (peer.Length == 0)
+            throw new ArgumentException("The peer has no address.", nameof(peer));
+        if (_payloadUsed + payload.Length > Options.SendBufferSize)
+            return false;
+
+        DatagramPeer target = IsIPv6 ? peer.MapToIPv6() : peer;
+        bool gso = Volatile.Read(ref Gso);
+        if (gso && _openBatches.TryGetValue(target, out int open))
+        {
+            ref SendBatch batch = ref _batches[open];
+            if (payload.Length <= batch.SegmentSize && batch.Bytes + payload.Length <= MaxDatagramSize)
+            {
+                Append(open, ref batch, payload);
+                if (payload.Length < batch.SegmentSize || batch.Count == MaxSegments)
+                    _openBatches.Remove(target); // sealed
+                return true;
+            }
+            _openBatches.Remove(target);
+        }
+
+        if (_batchCount == _batches.Length)
+            return false;
+        int index = _batchCount++;
+        ref SendBatch created = ref _batches[index];
+        created = new SendBatch { Peer = target, SegmentSize = payload.Length, Resend = -1 };
+        Append(index, ref created, payload);
+        if (gso && payload.Length != 0)
+            _openBatches[target] = index;
+        return true;
+    }
+
+    /// <inheritdoc cref="Send(ReadOnlySpan{byte}, in DatagramPeer)"/>
+    public bool Send(ReadOnlySpan<byte> payload, IPEndPoint peer) => Send(payload, DatagramPeer.FromEndPoint(peer));
+
+    private void Append(int index, ref SendBatch batch, ReadOnlySpan<byte> payload)
+    {
+        byte* dst = _payload + _payloadUsed;
+        payload.CopyTo(new Span<byte>(dst, payload.Length));
+        _payloadUsed += payload.Length;
+
+        iovec* iov = _iov + index * MaxSegments + batch.Count;
+        iov->iov_base = dst;
+        iov->iov_len = (nuint)payload.Length;
+        batch.Count++;
+        batch.Bytes += payload.Length;
+    }
+
+    /// <summary>
+    /// Hands the queued datagrams to the reactor, one sendmsg per batch, and completes once the kernel has
+    /// taken all of them (failures are counted in <see cref="SendErrors"/>). Completes synchronously when
+    /// nothing is queued.
+    /// </summary>
+    public ValueTask FlushAsync()
+    {
+        if (_batchCount == 0)
+            return default;
+        if (Interlocked.Exchange(ref _flushing, 1) == 1)
+            throw new InvalidOperationException("FlushAsync already in progress.");
+        _openBatches.Clear();
+        if (Volatile.Read(ref _closed) != 0)
+        {
+            // The reactor no longer sends for this socket (and may be gone): fail the batches here.
+            _flushSignal.Reset();
+            AbandonFlush();
+            return default;
+        }
+
+        for (int i = 0; i < _batchCount; i++)
+            PrepareBatch(i);
+
+        _flushSignal.Reset();
+        short version = _flushSignal.Version;
+        Reactor.FlushDatagramSocket(this);
+        return new ValueTask(this, version);
+    }
+
+    /// <summary>Fills the msghdr of batch <paramref name="index"/>: its peer, its iovecs and (segmented) the UDP_SEGMENT cmsg.</summary>
+    private void PrepareBatch(int index)
+    {
+        ref SendBatch batch = ref _batches[index];
+        msghdr* msg = _msgs + index;
+        byte* name = _names + index * 32;
+        msg->msg_name = name;
+        msg->msg_namelen = (uint)batch.Peer.CopyTo(name);
+        msg->msg_iov = _iov + index * MaxSegments;
+        msg->msg_iovlen = (nuint)batch.Count;
+        msg->msg_flags = 0;
+        if (batch.Count == 1)
+        {
+            msg->msg_control = null;
+            msg->msg_controllen = 0;
+            return;
+        }
+
+        cmsghdr* cmsg = (cmsghdr*)(_controls + index * s_controlSpace);
+        cmsg->cmsg_len = (nuint)CmsgLen(sizeof(ushort));
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        *(ushort*)(cmsg + 1) = (ushort)batch.SegmentSize;
+        msg->msg_control = cmsg;
+        msg->msg_controllen = (nuint)s_controlSpace;
+    }
+
+    // =========================================================================
+    // Reactor side of a flush (see Engine.Reactor.Datagram)
+    // =========================================================================
+
+    /// <summary>Batches of the flush in progress.</summary>
+    internal int FlushBatches => _batchCount;
+
+    internal msghdr* BatchHeader(int index) => _msgs + index;
+
+    /// <summary>
+    /// Accounts the CQE of batch <paramref name="index"/>. Returns true when the batch needs another sendmsg,
+    /// already prepared in its header: a segmented send the kernel or device rejected (-EIO, -EINVAL) is
+    /// resent one datagram at a time, and segmentation is switched off for the socket.
+    /// </summary>
+    internal bool OnBatchSent(int index, int res)
+    {
+        ref SendBatch batch = ref _batches[index];
+        if (batch.Resend >= 0)
+        {
+            if (res >= 0)
+                Volatile.Write(ref _sent, _sent + 1);
+            else
+                Volatile.Write(ref _sendErrors, _sendErrors + 1);
+            if (++batch.Resend == batch.Count)
+                return false;
+            PrepareSingle(index, batch.Resend);
+            return true;
+        }
+
+        if (res >= 0)
+        {
+            Volatile.Write(ref _sent, _sent + batch.Count);
+            if (batch.Count > 1)
+                Volatile.Write(ref _gsoSends, _gsoSends + 1);
+            return false;
+        }
+        if (batch.Count > 1 && (res == -EIO || res == -EINVAL))
+        {
+            Volatile.Write(ref Gso, false);
+            batch.Resend = 0;
+            PrepareSingle(index, 0);
+            return true;
+        }
+        Volatile.Write(ref _sendErrors, _sendErrors + batch.Count);
+        return false;
+    }
+
+    /// <summary>Points the header of batch <paramref name="index"/> at its datagram <paramref name="segment"/> alone.</summary>
+    private void PrepareSingle(int index, int segment)
+    {
+        msghdr* msg = _msgs + index;
+        msg->msg_iov = _iov + index * MaxSegments + segment;
+        msg->msg_iovlen = 1;
+        msg->msg_control = null;
+        msg->msg_controllen = 0;
+    }
+
+    /// <summary>Every batch of the flush has completed: resets the send state and wakes the <see cref="FlushAsync"/> waiter.</summary>
+    internal void CompleteFlush()
+    {
+        _batchCount = 0;
+        _payloadUsed = 0;
+        Volatile.Write(ref _flushing, 0);
+        _flushSignal.SetResult(true);
+    }
+
+    /// <summary>The socket closed before the flush went out: counts its datagrams as failed and completes the flush.</summary>
+    internal void AbandonFlush()
+    {
+        for (int i = 0; i < _batchCount; i++)
+            Volatile.Write(ref _sendErrors, _sendErrors + _batches[i].Count);
+        CompleteFlush();
+    }
+
+    // =========================================================================
+    // IValueTaskSource plumbing (flush)
+    // =========================================================================
+
+    void IValueTaskSource.GetResult(short token) => _flushSignal.GetResult(token);
+
+    ValueTaskSourceStatus IValueTaskSource.GetStatus(short token) => _flushSignal.GetStatus(token);
+
+    void IValueTaskSource.OnCompleted(Action<object?> continuation, object? state, short token, ValueTaskSourceOnCompletedFlags flags)
+        => _flushSignal.OnCompleted(continuation, state, token, InlineOnReactor(flags));
+}
@@ -0,0 +1,304 @@
+using System.Net;
+using System.Runtime.CompilerServices;
+using System.Threading.Tasks.Sources;
+using zerg.Engine.Configs;
+using static zerg.ABI.ABI;
+
+namespace zerg;
+
+/// <summary>
+/// A UDP socket served by a reactor: a multishot <c>recvmsg</c> fills the reactor's provided buffers
+/// (optionally with GRO-coalesced batches), and queued sends go out per peer as GSO batches
+/// (see <see cref="Engine.Engine.OpenDatagramSocket"/>).
+///
+/// Concurrency model:
+/// - The reactor produces received batches into an SPSC queue and wakes the single <see cref="ReceiveAsync"/> waiter.
+/// - One handler consumes with <see cref="TryReceive"/>, queues replies with <see cref="Send(ReadOnlySpan{byte}, in DatagramPeer)"/>
+///   and hands them to the reactor with <see cref="FlushAsync"/>.
+/// - Native memory is released by whichever of <see cref="Dispose"/> and the reactor's close comes last.
+/// </summary>
+[SkipLocalsInit]
+public sealed unsafe partial class DatagramSocket : IValueTaskSource<bool>, IDisposable
+{
+    /// <summary>A received buffer: one datagram, or a GRO batch of <see cref="SegmentSize"/>-byte datagrams (the last may be shorter).</summary>
+    internal struct DatagramItem
+    {
+        public byte* Payload;
+        public int Length;
+        /// <summary>GRO segment size, or 0 for a single datagram.</summary>
+        public int SegmentSize;
+        public ushort BufferId;
+        public DatagramPeer Peer;
+    }
+
+    internal DatagramSocket(Engine.Engine.Reactor reactor, int fd, IPEndPoint localEndPoint, DatagramOptions options)
+    {
+        Reactor = reactor;
+        Fd = fd;
+        LocalEndPoint = localEndPoint;
+        Options = options;
+        IsIPv6 = localEndPoint.AddressFamily == System.Net.Sockets.AddressFamily.InterNetworkV6;
+        Gso = options.Gso;
+        _items = new DatagramItem[options.ReceiveQueueCapacity];
+        _itemMask = options.ReceiveQueueCapacity - 1;
+        _batches = new SendBatch[options.MaxSendBatches];
+        AllocateSendArena();
+    }
+
+    /// <summary>The reactor that owns the socket's recv and sends.</summary>
+    public Engine.Engine.Reactor Reactor { get; }
+
+    /// <summary>The address the socket is bound to (with the kernel-chosen port when bound to port 0).</summary>
+    public IPEndPoint LocalEndPoint { get; }
+
+    internal readonly int Fd;
+    internal readonly DatagramOptions Options;
+    /// <summary>Bound to an IPv6 (dual-stack) address: IPv4 peers are addressed as IPv4-mapped IPv6.</summary>
+    internal readonly bool IsIPv6;
+
+    // =========================================================================
+    // Reactor-owned state (see Engine.Reactor.Datagram)
+    // =========================================================================
+
+    /// <summary>Slot in the reactor's datagram table, packed into user_data with <see cref="Generation"/>; -1 when not registered.</summary>
+    internal int Index = -1;
+    internal uint Generation;
+    /// <summary>Buffer group the recv selects from.</summary>
+    internal int RecvGroup;
+    /// <summary>Bytes of source address and of control data the kernel reserves in each recv buffer.</summary>
+    internal int RecvNameSpace;
+    internal int RecvControlSpace;
+    /// <summary>The multishot recvmsg is in flight (its final CQE has not arrived yet).</summary>
+    internal bool RecvArmed;
+    /// <summary>Parked in the reactor's starved list until its buffer group has buffers again.</summary>
+    internal bool RecvStarved;
+    /// <summary>Send batches of the flush in progress whose CQE has not arrived yet.</summary>
+    internal int SendsInFlight;
+    /// <summary>Closing: the recv is being cancelled; the socket closes once nothing is in flight.</summary>
+    internal bool Closing;
+    /// <summary>Header the recvmsg reads <c>msg_namelen</c> / <c>msg_controllen</c> from.</summary>
+    internal msghdr* RecvMsg;
+
+    /// <summary>
+    /// Segmented sends are allowed. Cleared by the reactor when the kernel or device rejects one;
+    /// read by <see cref="Send(ReadOnlySpan{byte}, in DatagramPeer)"/> to decide whether to batch.
+    /// </summary>
+    internal bool Gso;
+
+    // =========================================================================
+    // Receive queue (SPSC: reactor -> handler)
+    // =========================================================================
+
+    private readonly DatagramItem[] _items;
+    private readonly int _itemMask;
+    /// <summary>Consumer position (handler).</summary>
+    private long _head;
+    /// <summary>Producer position (reactor).</summary>
+    private long _tail;
+
+    private ManualResetValueTaskSourceCore<bool> _recvSignal;
+    /// <summary>1 while a <see cref="ReceiveAsync"/> waiter is armed.</summary>
+    private int _armed;
+    /// <summary>1 once the reactor stopped receiving (closed, failed or shut down).</summary>
+    private int _closed;
+    /// <summary>Error the socket closed with (negative errno), or 0.</summary>
+    private int _error;
+
+    /// <summary>Handler-owned: the batch <see cref="TryReceive"/> is splitting, and how far it got.</summary>
+    private DatagramItem _current;
+    private int _currentOffset;
+    private bool _hasCurrent;
+
+    /// <summary>Owners of the native memory: the handler until <see cref="Dispose"/>, the reactor until the fd is closed.</summary>
+    private int _references = 2;
+    private int _disposed;
+
+    // =========================================================================
+    // Statistics (written by the reactor, read anywhere)
+    // =========================================================================
+
+    private long _received;
+    private long _dropped;
+    private long _truncated;
+    private long _sent;
+    private long _sendErrors;
+    private long _gsoSends;
+    private long _groBatches;
+
+    /// <summary>Datagrams queued for the handler.</summary>
+    public long Received => Volatile.Read(ref _received);
+    /// <summary>Datagrams dropped because the receive queue was full.</summary>
+    public long Dropped => Volatile.Read(ref _dropped);
+    /// <summary>Recvs dropped because the datagram (or GRO batch) did not fit the recv buffer.</summary>
+    public long Truncated => Volatile.Read(ref _truncated);
+    /// <summary>Datagrams the kernel accepted for sending.</summary>
+    public long Sent => Volatile.Read(ref _sent);
+    /// <summary>Datagrams whose send failed (or was abandoned because the socket closed).</summary>
+    public long SendErrors => Volatile.Read(ref _sendErrors);
+    /// <summary>Segmented (GSO) sendmsg calls that carried more than one datagram.</summary>
+    public long GsoSends => Volatile.Read(ref _gsoSends);
+    /// <summary>Recvs that carried more than one GRO-coalesced datagram.</summary>
+    public long GroBatches => Volatile.Read(ref _groBatches);
+
+    /// <summary>Error the socket closed with (negative errno), or 0 for a regular close.</summary>
+    public int Error => Volatile.Read(ref _error);
+
+    // =========================================================================
+    // Reactor thread API (producer side)
+    // =========================================================================
+
+    /// <summary>Queues a received buffer and wakes the handler. False when the queue is full (the caller drops it).</summary>
+    internal bool TryEnqueue(in DatagramItem item, int datagrams)
+    {
+        long tail = _tail;
+        if (tail - Volatile.Read(ref _head) == _items.Length)
+        {
+            Volatile.Write(ref _dropped, _dropped + datagrams);
+            return false;
+        }
+        _items[(int)tail & _itemMask] = item;
+        Volatile.Write(ref _tail, tail + 1);
+        Volatile.Write(ref _received, _received + datagrams);
+        if (datagrams > 1)
+            Volatile.Write(ref _groBatches, _groBatches + 1);
+
+        if (Volatile.Read(ref _armed) == 1 && Interlocked.Exchange(ref _armed, 0) == 1)
+            _recvSignal.SetResult(true);
+        return true;
+    }
+
+    internal void CountTruncated() => Volatile.Write(ref _truncated, _truncated + 1);
+
+    /// <summary>The recv has stopped for good: wakes the handler, which drains what is queued and then sees the close.</summary>
+    internal void MarkClosed(int error)
+    {
+        if (error != 0)
+            Volatile.Write(ref _error, error);
+        Volatile.Write(ref _closed, 1);
+        if (Interlocked.Exchange(ref _armed, 0) == 1)
+            _recvSignal.SetResult(false);
+    }
+
+    // =========================================================================
+    // Handler API (consumer side)
+    // =========================================================================
+
+    /// <summary>
+    /// Waits until <see cref="TryReceive"/> has datagrams to return. Returns false once the socket is closed
+    /// and everything received before the close has been consumed. Only one waiter at a time.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public ValueTask<bool> ReceiveAsync()
+    {
+        if (HasReceived())
+            return new ValueTask<bool>(true);
+        if (Volatile.Read(ref _closed) != 0)
+            return new ValueTask<bool>(HasReceived());
+
+        _recvSignal.Reset();
+        if (Interlocked.Exchange(ref _armed, 1) == 1)
+            throw new InvalidOperationException("ReceiveAsync already armed.");
+
+        // Data or a close may have been published between the checks and the arm.
+        if ((HasReceived() || Volatile.Read(ref _closed) != 0) && Interlocked.Exchange(ref _armed, 0) == 1)
+            return new ValueTask<bool>(HasReceived());
+
+        return new ValueTask<bool>(this, _recvSignal.Version);
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private bool HasReceived()
+        => (_hasCurrent && _currentOffset < _current.Length) || Volatile.Read(ref _tail) != _head;
+
+    /// <summary>
+    /// Takes the next received datagram; GRO batches are split back into their datagrams.
+    /// The previous datagram's payload is invalid once this is called again.
+    /// </summary>
+    public bool TryReceive(out Datagram datagram)
+    {
+        while (true)
+        {
+            if (_hasCurrent)
+            {
+                int left = _current.Length - _currentOffset;
+                if (left > 0)
+                {
+                    int length = _current.SegmentSize > 0 ? Math.Min(_current.SegmentSize, left) : left;
+                    datagram = new Datagram(new ReadOnlySpan<byte>(_current.Payload + _currentOffset, length), _current.Peer);
+                    _currentOffset += length;
+                    return true;
+                }
+                _hasCurrent = false;
+                Reactor.EnqueueReturnQ(_current.BufferId);
+            }
+
+            long head = _head;
+            if (Volatile.Read(ref _tail) == head)
+            {
+                datagram = default;
+                return false;
+            }
+            _current = _items[(int)head & _itemMask];
+            Volatile.Write(ref _head, head + 1);
+            _currentOffset = 0;
+            _hasCurrent = true;
+            if (_current.Length == 0)
+            {
+                datagram = new Datagram(ReadOnlySpan<byte>.Empty, _current.Peer);
+                return true;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Closes the socket: the reactor cancels the recv and closes the fd once sends in flight complete.
+    /// Received datagrams not consumed yet are discarded.
+    /// </summary>
+    public void Dispose()
+    {
+        if (Interlocked.Exchange(ref _disposed, 1) == 1)
+            return;
+        if (_hasCurrent)
+        {
+            _hasCurrent = false;
+            Reactor.EnqueueReturnQ(_current.BufferId);
+        }
+        Reactor.CloseDatagramSocket(this);
+        Release();
+    }
+
+    /// <summary>
+    /// Drops one owner of the native memory. The last one returns the buffers still queued (nobody consumes
+    /// them any more) and frees the send arena.
+    /// </summary>
+    internal void Release()
+    {
+        if (Interlocked.Decrement(ref _references) != 0)
+            return;
+        long tail = Volatile.Read(ref _tail);
+        for (long i = _head; i < tail; i++)
+            Reactor.EnqueueReturnQ(_items[(int)i & _itemMask].BufferId);
+        _head = tail;
+        FreeSendArena();
+    }
+
+    // =========================================================================
+    // IValueTaskSource<bool> plumbing (receive)
+    // =========================================================================
+
+    bool IValueTaskSource<bool>.GetResult(short token) => _recvSignal.GetResult(token);
+
+    ValueTaskSourceStatus IValueTaskSource<bool>.GetStatus(short token) => _recvSignal.GetStatus(token);
+
+    void IValueTaskSource<bool>.OnCompleted(Action<object?> continuation, object? state, short token, ValueTaskSourceOnCompletedFlags flags)
+        => _recvSignal.OnCompleted(continuation, state, token, InlineOnReactor(flags));
+
+    /// <summary>Receive and flush completions are signalled on the reactor thread (see <see cref="Connection"/>).</summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private ValueTaskSourceOnCompletedFlags InlineOnReactor(ValueTaskSourceOnCompletedFlags flags)
+    {
+        if ((flags & ValueTaskSourceOnCompletedFlags.UseSchedulingContext) != 0 && Reactor.OwnsCurrentContext)
+            flags &= ~ValueTaskSourceOnCompletedFlags.UseSchedulingContext;
+        return flags;
+    }
+}
@@ -0,0 +1,19 @@
+// ReSharper disable always CheckNamespace
+
+namespace zerg.Engine.Balancing;
+
+/// <summary>
+/// Chooses the reactor that takes ownership of a newly accepted connection.
+///
+/// Invoked only from the acceptor thread (<see cref="Configs.AcceptMode.Acceptor"/> mode), one call per
+/// accepted fd, so implementations may keep unsynchronized state but must not block.
+/// </summary>
+public interface IConnectionBalancer
+{
+    /// <summary>
+    /// Returns the index of the reactor in <c>[0, loads.Count)</c> that should own <paramref name="clientFd"/>.
+    /// </summary>
+    /// <param name="clientFd">The accepted client socket (can be inspected, e.g. with getpeername).</param>
+    /// <param name="loads">Live load counters of every reactor.</param>
+    int SelectReactor(int clientFd, ReactorLoadTable loads);
+}
@@ -0,0 +1,36 @@
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine.Balancing;
+
+/// <summary>
+/// Assigns the reactor with the fewest open connections. Corrects the drift round-robin accumulates
+/// when connection lifetimes differ, but treats an idle and a chatty connection as equal.
+/// Ties go to the lowest index after the previous pick, so equal loads still rotate.
+/// </summary>
+public sealed class LeastConnectionsBalancer : IConnectionBalancer
+{
+    private int _start;
+
+    public int SelectReactor(int clientFd, ReactorLoadTable loads)
+    {
+        int count = loads.Count;
+        int best = _start;
+        long bestConnections = loads.Connections(best);
+
+        for (int n = 1; n < count && bestConnections > 0; n++)
+        {
+            int i = (_start + n) % count;
+            long connections = loads.Connections(i);
+            if (connections < bestConnections)
+            {
+                best = i;
+                bestConnections = connections;
+            }
+        }
+
+        _start = (best + 1) % count;
+        return best;
+    }
+}
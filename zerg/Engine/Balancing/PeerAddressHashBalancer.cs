@@ -0,0 +1,58 @@
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine.Balancing;
+
+/// <summary>
+/// Pins every connection from the same peer IP address to the same reactor (the port is ignored),
+/// so per-client state and caches stay on one core. Load is not considered: a single busy client
+/// always lands on one reactor. Falls back to round-robin when the peer address is unavailable.
+/// </summary>
+public sealed unsafe class PeerAddressHashBalancer : IConnectionBalancer
+{
+    private readonly RoundRobinBalancer _fallback = new();
+
+    public int SelectReactor(int clientFd, ReactorLoadTable loads)
+    {
+        sockaddr_in6 addr;
+        uint len = (uint)sizeof(sockaddr_in6);
+        if (getpeername(clientFd, &addr, &len) < 0)
+            return _fallback.SelectReactor(clientFd, loads);
+
+        uint hash;
+        if (addr.sin6_family == AF_INET)
+        {
+            // sockaddr_in: family(2) port(2) addr(4)
+            hash = Fnv1a(((byte*)&addr) + 4, 4);
+        }
+        else
+        {
+            byte* a = addr.sin6_addr.s6_addr;
+            // Treat IPv4-mapped (::ffff:a.b.c.d) like plain IPv4 so dual-stack and v4 listeners agree.
+            hash = IsV4Mapped(a) ? Fnv1a(a + 12, 4) : Fnv1a(a, 16);
+        }
+
+        return (int)(hash % (uint)loads.Count);
+    }
+
+    private static bool IsV4Mapped(byte* a)
+    {
+        for (int i = 0; i < 10; i++)
+            if (a[i] != 0) return false;
+        return a[10] == 0xff && a[11] == 0xff;
+    }
+
+    private static uint Fnv1a(byte* p, int len)
+    {
+        uint h = 2166136261;
+        for (int i = 0; i < len; i++)
+        {
+            h ^= p[i];
+            h *= 16777619;
+        }
+        return h;
+    }
+}
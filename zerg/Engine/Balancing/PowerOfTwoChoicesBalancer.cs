@@ -0,0 +1,48 @@
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine.Balancing;
+
+/// <summary>
+/// Power-of-two-choices: samples two distinct reactors at random and assigns the less loaded one.
+///
+/// Load is what the reactor is actually doing rather than how many sockets it holds:
+/// <c>CqesPerSecond + InFlightBytes / bytesPerCqe + Connections</c>. Sampling two instead of scanning all
+/// keeps the choice O(1) and avoids herding every new connection onto the same reactor while the
+/// once-per-second CQE rate lags behind.
+/// </summary>
+public sealed class PowerOfTwoChoicesBalancer : IConnectionBalancer
+{
+    private readonly Random _random;
+    private readonly long _bytesPerCqe;
+
+    /// <param name="bytesPerCqe">How many queued send bytes weigh as much as one CQE per second.</param>
+    /// <param name="seed">Optional seed for reproducible placement.</param>
+    public PowerOfTwoChoicesBalancer(int bytesPerCqe = 4096, int? seed = null)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegativeOrZero(bytesPerCqe);
+        _bytesPerCqe = bytesPerCqe;
+        _random = seed.HasValue ? new Random(seed.Value) : new Random();
+    }
+
+    public int SelectReactor(int clientFd, ReactorLoadTable loads)
+    {
+        int count = loads.Count;
+        if (count == 1)
+            return 0;
+
+        int a = _random.Next(count);
+        int b = _random.Next(count - 1);
+        if (b >= a) b++; // distinct from a
+
+        return Score(loads, b) < Score(loads, a) ? b : a;
+    }
+
+    private long Score(ReactorLoadTable loads, int reactorId)
+    {
+        return loads.CqesPerSecond(reactorId)
+               + loads.InFlightBytes(reactorId) / _bytesPerCqe
+               + loads.Connections(reactorId);
+    }
+}
@@ -0,0 +1,55 @@
+using System.Runtime.InteropServices;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine.Balancing;
+
+/// <summary>
+/// Live per-reactor load, published by the reactors and read by <see cref="IConnectionBalancer"/>s.
+///
+/// Each reactor's counters sit in their own 128-byte slot so that a reactor updating its
+/// counters never invalidates the cache line (or the adjacent-line prefetch pair) of another.
+/// Values are eventually consistent snapshots; balancers should treat them as hints.
+/// </summary>
+public sealed class ReactorLoadTable
+{
+    private readonly ReactorLoadSlot[] _slots;
+
+    internal ReactorLoadTable(int reactorCount)
+    {
+        _slots = new ReactorLoadSlot[reactorCount];
+    }
+
+    /// <summary>Number of reactors.</summary>
+    public int Count => _slots.Length;
+
+    /// <summary>Connections currently assigned to the reactor (handed off or accepted, not yet closed).</summary>
+    public long Connections(int reactorId) => Volatile.Read(ref _slots[reactorId].Connections);
+
+    /// <summary>Bytes submitted for sending whose send completions have not arrived yet.</summary>
+    public long InFlightBytes(int reactorId) => Volatile.Read(ref _slots[reactorId].InFlightBytes);
+
+    /// <summary>CQEs the reactor processed during its last full one-second window.</summary>
+    public long CqesPerSecond(int reactorId) => Volatile.Read(ref _slots[reactorId].CqesPerSecond);
+
+    /// <summary>CQEs the reactor processed since it started.</summary>
+    public long TotalCqes(int reactorId) => Volatile.Read(ref _slots[reactorId].TotalCqes);
+
+    internal ref ReactorLoadSlot this[int reactorId] => ref _slots[reactorId];
+}
+
+/// <summary>
+/// One reactor's load counters, padded to 128 bytes.
+/// <see cref="Connections"/> is written by both the acceptor (increment) and the reactor (decrement)
+/// and therefore updated with <see cref="Interlocked"/>; the other fields have a single writer, the reactor.
+/// </summary>
+[StructLayout(LayoutKind.Explicit, Size = 128)]
+internal struct ReactorLoadSlot
+{
+    [FieldOffset(0)]  public long Connections;
+    [FieldOffset(8)]  public long InFlightBytes;
+    [FieldOffset(16)] public long CqesPerSecond;
+    [FieldOffset(24)] public long TotalCqes;
+}
@@ -0,0 +1,18 @@
+// ReSharper disable always CheckNamespace
+
+namespace zerg.Engine.Balancing;
+
+/// <summary>
+/// Assigns reactors in turn, ignoring load. The default; cheapest and fair when connections are alike.
+/// </summary>
+public sealed class RoundRobinBalancer : IConnectionBalancer
+{
+    private int _next;
+
+    public int SelectReactor(int clientFd, ReactorLoadTable loads)
+    {
+        int target = _next;
+        _next = (_next + 1) % loads.Count;
+        return target;
+    }
+}
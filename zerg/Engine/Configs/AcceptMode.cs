@@ -0,0 +1,21 @@
+namespace zerg.Engine.Configs;
+
+/// <summary>
+/// Controls where incoming connections are accepted.
+/// </summary>
+public enum AcceptMode
+{
+    /// <summary>
+    /// One dedicated acceptor thread and ring owns the listening socket and hands
+    /// accepted fds to reactors round-robin through per-reactor queues.
+    /// </summary>
+    Acceptor,
+
+    /// <summary>
+    /// Every reactor opens its own SO_REUSEPORT listener on the same address and arms
+    /// multishot accept on its own ring. The kernel spreads connections across the
+    /// listeners and each reactor adopts its accepted fds inline in its CQE loop:
+    /// no acceptor thread and no cross-thread handoff.
+    /// </summary>
+    ReusePort
+}
@@ -1,4 +1,6 @@
 // ReSharper disable InvalidXmlDocComment
+using zerg.Engine.Balancing;
+
 namespace zerg.Engine.Configs;
 
 /// <summary>
@@ -72,5 +74,15 @@ public sealed record AcceptorConfig(
     /// <summary>
     /// Controls which IP stack the engine uses for its listening socket.
     /// </summary>
-    IPVersion IPVersion = IPVersion.IPv6DualStack
+    IPVersion IPVersion = IPVersion.IPv6DualStack,
+    /// <summary>
+    /// Strategy that picks the reactor for each accepted connection.
+    /// null means <see cref="RoundRobinBalancer"/>.
+    ///
+    /// Built in: <see cref="RoundRobinBalancer"/>, <see cref="LeastConnectionsBalancer"/>,
+    /// <see cref="PowerOfTwoChoicesBalancer"/> (live reactor load) and
+    /// <see cref="PeerAddressHashBalancer"/> (client IP affinity).
+    /// Balancers keep state; use one instance per engine.
+    /// </summary>
+    IConnectionBalancer? Balancer = null
 );
\ No newline at end of file
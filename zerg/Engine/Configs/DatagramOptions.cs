@@ -0,0 +1,42 @@
+// ReSharper disable InvalidXmlDocComment
+
+namespace zerg.Engine.Configs;
+
+/// <summary>
+/// Configuration of a <see cref="DatagramSocket"/> (see <see cref="Engine.OpenDatagramSocket"/>).
+/// </summary>
+public sealed record DatagramOptions(
+    /// <summary>
+    /// Enable UDP_GRO: the kernel coalesces consecutive datagrams of one flow into a single recv,
+    /// which <see cref="DatagramSocket.TryReceive"/> splits back into datagrams.
+    ///
+    /// Only enabled when the reactor's largest recv buffer is at least 64 KB, so that a coalesced
+    /// batch fits; a batch that does not fit is truncated by the kernel and dropped (see <see cref="DatagramSocket.Truncated"/>).
+    /// </summary>
+    bool Gro = true,
+    /// <summary>
+    /// Send consecutive equal-sized datagrams to the same peer as one <c>sendmsg</c> with a UDP_SEGMENT
+    /// control message (GSO): up to 64 datagrams and 64 KB per call, split by the kernel or the NIC.
+    /// Switched off for the socket when the kernel or device rejects a segmented send.
+    /// </summary>
+    bool Gso = true,
+    /// <summary>
+    /// Received datagram batches queued for the handler before further ones are dropped.
+    /// Must be a power of two. Each queued batch holds one recv buffer.
+    /// </summary>
+    int ReceiveQueueCapacity = 1024,
+    /// <summary>
+    /// Bytes of datagram payload <see cref="DatagramSocket.Send(ReadOnlySpan{byte}, in DatagramPeer)"/> can queue
+    /// between flushes.
+    /// </summary>
+    int SendBufferSize = 256 * 1024,
+    /// <summary>
+    /// Send batches (one <c>sendmsg</c> each) that can be queued between flushes. At most 1024.
+    /// </summary>
+    int MaxSendBatches = 256,
+    /// <summary>
+    /// Set SO_REUSEPORT before binding, so one socket per reactor can share a port and the kernel
+    /// spreads incoming flows across them.
+    /// </summary>
+    bool ReusePort = false
+);
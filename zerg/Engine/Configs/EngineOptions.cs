@@ -1,3 +1,5 @@
+using zerg.Engine.Diagnostics;
+
 namespace zerg.Engine.Configs;
 
 /// <summary>
@@ -30,11 +32,93 @@ public class EngineOptions
     /// </summary>
     public int Backlog { get; init; } = 65535;
 
+    /// <summary>
+    /// Where connections are accepted (see <see cref="Configs.AcceptMode"/>).
+    /// <see cref="AcceptMode.Acceptor"/> is the default and the fallback.
+    /// </summary>
+    public AcceptMode AcceptMode { get; init; } = AcceptMode.Acceptor;
+
+    /// <summary>
+    /// With <see cref="AcceptMode.ReusePort"/>, attach a classic BPF program
+    /// (SO_ATTACH_REUSEPORT_CBPF) that sends each connection to the listener of
+    /// reactor <c>cpu % ReactorCount</c>, where <c>cpu</c> received the SYN.
+    /// Best combined with reactors pinned one per CPU.
+    /// Ignored in <see cref="AcceptMode.Acceptor"/> mode.
+    /// </summary>
+    public bool ReusePortCpuSteering { get; init; }
+
     /// <summary>
     /// Configuration for the acceptor ring and its event loop.
+    /// <see cref="AcceptorConfig.IPVersion"/> also applies to the per-reactor
+    /// listeners in <see cref="AcceptMode.ReusePort"/> mode.
     /// </summary>
     public AcceptorConfig AcceptorConfig { get; init; } = new();
 
+    /// <summary>
+    /// Where connection handlers run (see <see cref="Configs.ExecutionMode"/>).
+    /// </summary>
+    public ExecutionMode ExecutionMode { get; init; } = ExecutionMode.Shared;
+
+    /// <summary>
+    /// CPUs the reactor threads are pinned to: reactor <c>i</c> runs on <c>ReactorCpus[i % Length]</c>.
+    /// When null, reactors are not pinned in <see cref="ExecutionMode.Shared"/> mode, and reactor <c>i</c>
+    /// is pinned to CPU <c>i % ProcessorCount</c> in <see cref="ExecutionMode.ThreadPerCore"/> mode.
+    /// Pinning happens before the ring and slabs are set up, so NUMA-local slabs follow it.
+    /// </summary>
+    public int[]? ReactorCpus { get; init; }
+
+    /// <summary>
+    /// For pinned reactors whose ring uses SQPOLL without an explicit <see cref="ReactorConfig.SqCpuThread"/>:
+    /// pin the SQPOLL kernel thread to the SMT sibling of the reactor's CPU (same core, shared L1/L2).
+    /// Ignored on CPUs without a sibling.
+    /// </summary>
+    public bool SqPollOnSiblingCpu { get; init; }
+
+    /// <summary>
+    /// Create the SQPOLL rings of reactors 1..N with IORING_SETUP_ATTACH_WQ against reactor 0's ring,
+    /// so one SQPOLL kernel thread and one kernel worker pool serve every reactor instead of one each.
+    /// Only affects reactors whose <see cref="ReactorConfig.RingFlags"/> include SQPOLL.
+    /// </summary>
+    public bool ShareSqPollThread { get; init; }
+
+    /// <summary>
+    /// Probe the kernel once at <see cref="Engine.Listen"/> (see <see cref="KernelCapabilities"/>) and run each
+    /// reactor with the fastest supported setup instead of its config as given: SINGLE_ISSUER | DEFER_TASKRUN
+    /// (or COOP_TASKRUN on older kernels), recv bundles, zero-copy sends and a registered ring fd.
+    /// Requested setup flags and incremental buffer consumption are dropped where the kernel lacks them.
+    /// The choices are logged once; <see cref="Engine.Reactor.Config"/> shows the config a reactor runs with.
+    /// Lets one binary use what each host offers across a fleet of mixed kernels.
+    /// </summary>
+    public bool AutoTune { get; init; }
+
+    /// <summary>
+    /// Minimum level of the engine's log events; <see cref="EngineLogLevel.None"/> silences them.
+    /// Ring setup details and shutdown are <see cref="EngineLogLevel.Debug"/>, startup and auto-tune choices
+    /// <see cref="EngineLogLevel.Information"/>, fallbacks and accept errors <see cref="EngineLogLevel.Warning"/>.
+    /// </summary>
+    public EngineLogLevel LogLevel { get; init; } = EngineLogLevel.Information;
+
+    /// <summary>
+    /// Receives the engine's log events that pass <see cref="LogLevel"/>, on whichever thread raised them
+    /// (often a reactor thread: hand them off rather than block). When null, events are written to the
+    /// console, warnings and above to stderr.
+    /// </summary>
+    public Action<EngineLogEvent>? LogHandler { get; init; }
+
+    /// <summary>
+    /// Publish per-reactor metrics (see <see cref="Engine.GetMetrics"/>) as observable instruments on the
+    /// <c>System.Diagnostics.Metrics</c> meter named "zerg", from <see cref="Engine.Listen"/> until
+    /// <see cref="Engine.Stop"/>. The counters are kept either way; this only controls publishing.
+    /// </summary>
+    public bool PublishMetrics { get; init; } = true;
+
+    /// <summary>
+    /// Create a <see cref="zerg.FileCache"/> shared by the engine's handlers (<see cref="Engine.FileCache"/>),
+    /// keeping hot files open, and small ones in memory, for <see cref="Connection.SendFileAsync(CachedFile)"/>.
+    /// Null (the default) creates none.
+    /// </summary>
+    public FileCacheOptions? FileCache { get; init; }
+
     /// <summary>
     /// Per-reactor configuration.
     /// Must contain at least ReactorCount entries.
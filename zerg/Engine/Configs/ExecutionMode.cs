@@ -0,0 +1,26 @@
+namespace zerg.Engine.Configs;
+
+/// <summary>
+/// Where connection handlers run relative to the reactor that owns their connection.
+/// </summary>
+public enum ExecutionMode
+{
+    /// <summary>
+    /// Handlers run wherever their awaits resume: inline on the reactor thread for
+    /// <see cref="Connection.ReadAsync"/> / <see cref="Connection.FlushAsync"/> completions,
+    /// on the thread pool after any other await. Reactors are only pinned when
+    /// <see cref="EngineOptions.ReactorCpus"/> is set.
+    /// </summary>
+    Shared,
+
+    /// <summary>
+    /// Each reactor is pinned to one CPU (<see cref="EngineOptions.ReactorCpus"/>, or CPU <c>i</c> for reactor <c>i</c>)
+    /// and installs a single-threaded <see cref="SynchronizationContext"/> on its thread.
+    ///
+    /// <see cref="Engine.AcceptAsync"/> resumes its caller on the reactor that owns the returned connection,
+    /// so a handler started there, and every continuation it awaits, runs on that reactor thread.
+    /// Flushes and buffer returns issued from the reactor thread skip the cross-thread queues.
+    /// Handlers must not block: a blocked handler stalls every connection of its reactor.
+    /// </summary>
+    ThreadPerCore
+}
@@ -0,0 +1,27 @@
+// ReSharper disable InvalidXmlDocComment
+
+namespace zerg.Engine.Configs;
+
+/// <summary>
+/// Configuration of an engine's <see cref="FileCache"/> (see <see cref="EngineOptions.FileCache"/>).
+/// </summary>
+public sealed record FileCacheOptions(
+    /// <summary>
+    /// Files kept open (or in memory) at once. Beyond it the least recently used entries are dropped.
+    /// </summary>
+    int MaxEntries = 1024,
+    /// <summary>
+    /// Files up to this size are read into memory once and their handle closed, so sending them is a plain
+    /// write. 0 keeps every file as an open handle.
+    /// </summary>
+    int SmallFileThreshold = 16 * 1024,
+    /// <summary>
+    /// Total bytes of file contents held in memory. Once reached, further small files are kept as handles.
+    /// </summary>
+    long MaxSmallFileBytes = 16 * 1024 * 1024,
+    /// <summary>
+    /// Milliseconds an entry is served without looking at the file system. After that, the next lookup stats
+    /// the path and reloads the file if its size or modification time changed.
+    /// </summary>
+    int RevalidateAfterMs = 1000
+);
@@ -55,6 +55,7 @@ public sealed record ReactorConfig(
     ///
     /// Each multishot recv selects one of these buffers and writes up to this size.
     /// Larger values reduce syscalls for large payloads but increase memory usage.
+    /// Ignored when <see cref="RecvBufferClasses"/> is set.
     /// </summary>
     int RecvBufferSize = 32 * 1024,
 
@@ -65,6 +66,7 @@ public sealed record ReactorConfig(
     /// "in flight" (owned by the kernel or handed to user space).
     ///
     /// Must be a power of two.
+    /// Ignored when <see cref="RecvBufferClasses"/> is set.
     /// </summary>
     int BufferRingEntries = 16 * 1024,
 
@@ -103,5 +105,209 @@ public sealed record ReactorConfig(
     ///
     /// Requires Linux kernel 6.12+.
     /// </summary>
-    bool IncrementalBufferConsumption = false
+    bool IncrementalBufferConsumption = false,
+
+    /// <summary>
+    /// Arm an eventfd doorbell (multishot poll) in the reactor's ring.
+    ///
+    /// When enabled, the first flush or buffer return enqueued from a thread other
+    /// than the reactor rings the doorbell, so a reactor blocked in its CQ wait
+    /// wakes up immediately instead of sleeping out <see cref="CqTimeout"/>.
+    /// Further enqueues before the reactor drains its queues do not ring again.
+    ///
+    /// Disable only when the reactor never waits (e.g. spinning SQPOLL setups).
+    /// </summary>
+    bool CrossThreadWakeup = true,
+
+    /// <summary>
+    /// How flushed bytes are sent (see <see cref="Configs.SendMode"/>).
+    ///
+    /// <see cref="SendMode.ZeroCopy"/> registers each connection's write slab as a fixed
+    /// buffer on first use and sends it with SEND_ZC. It pays off for large responses;
+    /// for small ones page pinning and the extra notification CQE cost more than the copy.
+    /// </summary>
+    SendMode SendMode = SendMode.Copy,
+
+    /// <summary>
+    /// Minimum flush size (bytes) sent zero-copy when <see cref="SendMode"/> is
+    /// <see cref="SendMode.ZeroCopy"/>. Smaller flushes fall back to a copying send.
+    /// </summary>
+    int ZeroCopySendThreshold = 8 * 1024,
+
+    /// <summary>
+    /// Size classes of provided recv buffers, e.g. 512 B, 4 KB and 64 KB.
+    /// Each class is registered as its own buffer group; supersedes
+    /// <see cref="RecvBufferSize"/> x <see cref="BufferRingEntries"/> when set.
+    ///
+    /// Every connection starts on the smallest class. The reactor tracks each connection's
+    /// recv sizes and re-arms its multishot recv on a larger class when buffers come back
+    /// full, or on a smaller one when its messages shrink. Small-message workloads then touch
+    /// only small buffers, which keeps resident memory a fraction of a single large-buffer ring.
+    ///
+    /// At most 8 classes; entries must be powers of two and sum to at most 65536
+    /// (buffer ids are 16-bit and unique across the reactor's groups).
+    /// </summary>
+    RecvBufferClass[]? RecvBufferClasses = null,
+
+    /// <summary>
+    /// Buffers per buffer group handed to the kernel at startup.
+    ///
+    /// Slabs only reserve address space. More buffers are published as occupancy grows,
+    /// doubling up to the group's entries. Once a second, a group whose peak occupancy
+    /// fell well below what is published withdraws the buffers above this floor and
+    /// returns their pages to the OS with MADV_DONTNEED.
+    /// A value at or above the group's entries publishes everything up front (no elasticity).
+    /// </summary>
+    int BufferRingInitialEntries = 1024,
+
+    /// <summary>
+    /// How recv buffer slabs and connection write slabs are backed (see <see cref="Configs.SlabMemory"/>).
+    ///
+    /// <see cref="SlabMemory.HugePages"/> maps them with 2 MB pages (hugetlb pool, transparent huge
+    /// pages as fallback) on the NUMA node of the CPU the reactor thread runs on. Slabs of hundreds of
+    /// MB then need a few hundred TLB entries instead of tens of thousands, at the cost of committing
+    /// the recv slabs up front.
+    /// </summary>
+    SlabMemory SlabMemory = SlabMemory.Default,
+
+    /// <summary>
+    /// Size in bytes of each connection's write slab under <see cref="SlabMemory.HugePages"/>, where
+    /// the reactor carves the slabs from its own huge-page chunks; rounded up to a cache line.
+    /// Connections from the engine-wide pool (<see cref="SlabMemory.Default"/>) use a 16 KB slab.
+    /// Writes past the slab go to overflow segments (<see cref="WriteSegmentSize"/>).
+    /// </summary>
+    int WriteSlabSize = 16 * 1024,
+
+    /// <summary>
+    /// Size in bytes of the overflow segments a connection chains after its write slab once the slab
+    /// is full.
+    ///
+    /// Responses larger than the slab are staged across several segments and flushed with a
+    /// single vectored sendmsg, so one FlushAsync covers the whole response. Segments are pooled
+    /// per reactor and go back to the pool when the flush that sent them completes.
+    /// </summary>
+    int WriteSegmentSize = 16 * 1024,
+
+    /// <summary>
+    /// Unsent bytes a connection may have queued before <c>FlushAsync</c> waits.
+    ///
+    /// Handlers can keep writing while a flush is on the wire: new bytes go behind it and are sent
+    /// as soon as the current send completes. <c>FlushAsync</c> returns immediately while the
+    /// backlog stays at or below this mark, and otherwise completes once the reactor has drained it
+    /// back down to the mark. 0 makes every <c>FlushAsync</c> wait until all its bytes are sent.
+    /// </summary>
+    int WriteHighWaterMark = 64 * 1024,
+
+    /// <summary>
+    /// Received buffers a connection may hold (queued for its handler or not yet returned with
+    /// <c>ReturnRing</c>) before the reactor pauses its recv.
+    ///
+    /// A paused connection has its multishot recv cancelled; the kernel keeps the unread data in
+    /// the socket buffer and TCP flow control slows the peer down. The recv is re-armed once the
+    /// handler has returned enough buffers to drop under half of both budgets, so one slow consumer
+    /// cannot drain the buffer ring shared by every connection of the reactor. 0 disables the limit.
+    /// Not enforced with <see cref="IncrementalBufferConsumption"/>, where a buffer can be shared
+    /// by several connections.
+    /// </summary>
+    int RecvBudgetBuffers = 512,
+
+    /// <summary>
+    /// Received bytes a connection may hold before the reactor pauses its recv
+    /// (see <see cref="RecvBudgetBuffers"/>). 0 disables the limit.
+    /// </summary>
+    int RecvBudgetBytes = 8 * 1024 * 1024,
+
+    /// <summary>
+    /// Arms recvs in bundle mode (IORING_RECVSEND_BUNDLE) when the kernel supports it (Linux 6.10+).
+    ///
+    /// Without bundles every provided buffer the kernel fills produces its own CQE, so a burst of
+    /// pipelined requests turns into many completions and reader wakeups. In bundle mode one CQE
+    /// covers the whole run of buffers a burst filled, and the reactor queues them to the connection
+    /// with a single wakeup. The handler still sees one RingItem per buffer.
+    /// Falls back to one CQE per buffer on older kernels and with <see cref="IncrementalBufferConsumption"/>;
+    /// <c>Reactor.RecvBundles</c> reports which mode is in effect.
+    /// </summary>
+    bool RecvBundles = false,
+
+    /// <summary>
+    /// Registers the ring fd with the reactor thread (io_uring_register_ring_fd, Linux 5.18+), so the
+    /// io_uring_enter calls of the reactor loop skip the fd table lookup of the ring itself.
+    /// If registration fails the reactor keeps using the plain ring fd.
+    /// </summary>
+    bool RegisterRingFd = false,
+
+    /// <summary>
+    /// Uses direct descriptors for client sockets: the reactor registers a sparse fixed-file table with
+    /// <see cref="MaxConnectionsPerReactor"/> slots, and recv, send and close go through IOSQE_FIXED_FILE
+    /// and IORING_OP_CLOSE on the slot, so the kernel skips the fdget/fdput on the process-wide fd table
+    /// for every operation. Reactors with their own listener (<see cref="AcceptMode.ReusePort"/>) accept
+    /// straight into the table; connections handed over by the acceptor are installed with one register
+    /// call each and their plain fd is closed. Implies <see cref="RegisterRingFd"/>.
+    /// If the table cannot be registered the reactor keeps using plain fds.
+    /// </summary>
+    bool DirectDescriptors = false,
+
+    /// <summary>
+    /// How the reactor waits when it finds no completions (see <see cref="Configs.WaitStrategy"/>).
+    ///
+    /// <see cref="WaitStrategy.Hybrid"/> and <see cref="WaitStrategy.Spin"/> trade CPU for latency:
+    /// a completion found while spinning skips the sleep and wakeup of a blocking CQ wait.
+    /// With COOP_TASKRUN / DEFER_TASKRUN rings the reactor adds IORING_SETUP_TASKRUN_FLAG, so the
+    /// spin only enters the kernel when the kernel has flagged completions to post.
+    /// <c>Reactor.GetWaitStats()</c> reports spin time and how much of it was wasted.
+    /// </summary>
+    WaitStrategy WaitStrategy = WaitStrategy.Block,
+
+    /// <summary>
+    /// Longest spin (in nanoseconds) before a <see cref="WaitStrategy.Hybrid"/> reactor blocks.
+    /// Ignored by the other strategies.
+    /// </summary>
+    long SpinBudget = 50_000,
+
+    /// <summary>
+    /// Sizes each <see cref="WaitStrategy.Hybrid"/> spin from a moving average of recent idle gaps
+    /// (time from running out of completions to the next one): up to twice the average gap, within
+    /// <see cref="SpinBudget"/>, and no spin at all while the average gap exceeds the budget.
+    /// When false every idle gap spins the full budget.
+    /// </summary>
+    bool AdaptiveSpin = true,
+
+    /// <summary>
+    /// NAPI busy-poll timeout in microseconds (io_uring_register_napi, Linux 6.9+); 0 disables it.
+    ///
+    /// While the reactor waits in the kernel, the kernel busy-polls the NIC queues (NAPI contexts) of
+    /// the sockets the ring receives on for up to this long before sleeping, so packets are picked up
+    /// without waiting for an interrupt. Only pays off on NICs with NAPI and busy-poll friendly
+    /// interrupt settings; loopback has no NAPI context. <c>Reactor.NapiBusyPoll</c> reports whether
+    /// registration succeeded.
+    /// </summary>
+    uint NapiBusyPollTimeout = 0,
+
+    /// <summary>
+    /// Sets NAPI prefer-busy-poll for the ring: with <see cref="NapiBusyPollTimeout"/> the NIC defers
+    /// its interrupts while the reactor polls. Needs gro_flush_timeout / napi_defer_hard_irqs configured
+    /// on the device.
+    /// </summary>
+    bool NapiPreferBusyPoll = false,
+
+    /// <summary>
+    /// Event loop the reactor runs (see <see cref="ReactorLoop"/>). All variants handle the same
+    /// completions; they differ in how submits and waits are issued.
+    /// </summary>
+    ReactorLoop Loop = ReactorLoop.Handle,
+
+    /// <summary>
+    /// Milliseconds a connection may go without receiving data before the reactor closes it; 0 disables it.
+    ///
+    /// Deadlines live in a per-reactor timing wheel advanced by the event loop, so they fire up to
+    /// <see cref="CqTimeout"/> late. A connection whose recv is paused by its recv budget is not idle.
+    /// Handlers override it per connection with <c>Connection.SetIdleTimeout</c>.
+    /// </summary>
+    int IdleTimeoutMs = 0,
+
+    /// <summary>
+    /// Milliseconds a flush may go without send progress (a peer that stopped reading) before the reactor
+    /// closes the connection; 0 disables it. Handlers override it with <c>Connection.SetFlushTimeout</c>.
+    /// </summary>
+    int FlushTimeoutMs = 0
 );
@@ -0,0 +1,26 @@
+namespace zerg.Engine.Configs;
+
+/// <summary>
+/// Which event loop a reactor runs. The variants differ only in how they hand queued SQEs to the kernel
+/// before waiting for completions; they are kept side by side so they can be benchmarked against each other.
+/// </summary>
+public enum ReactorLoop
+{
+    /// <summary>
+    /// Harvests completions and, only when there are none, submits and waits in a single
+    /// io_uring_submit_and_wait_timeout call. The default.
+    /// </summary>
+    Handle,
+
+    /// <summary>
+    /// Submits queued SQEs every iteration with io_uring_submit, then waits for completions with a separate
+    /// io_uring_wait_cqes call when there are none: one more syscall per idle gap, but SQEs reach the kernel
+    /// while completions are still being processed.
+    /// </summary>
+    SubmitAndWaitCqe,
+
+    /// <summary>
+    /// Same shape as <see cref="Handle"/>, written out step by step (drain, harvest, submit + wait).
+    /// </summary>
+    SubmitAndWaitSingleCall
+}
@@ -0,0 +1,9 @@
+namespace zerg.Engine.Configs;
+
+/// <summary>
+/// One size class of provided recv buffers: a buffer group (buf-ring) of <paramref name="Entries"/>
+/// buffers of <paramref name="BufferSize"/> bytes each.
+/// </summary>
+/// <param name="BufferSize">Size in bytes of each buffer in this class.</param>
+/// <param name="Entries">Number of buffers in this class. Must be a power of two.</param>
+public readonly record struct RecvBufferClass(int BufferSize, int Entries);
@@ -0,0 +1,20 @@
+namespace zerg.Engine.Configs;
+
+/// <summary>
+/// How <see cref="Connection.ProxyAsync"/> moves bytes between the two connections of a relay.
+/// </summary>
+public enum RelayMode
+{
+    /// <summary>
+    /// Received provided buffers are sent to the peer socket as they are; each buffer id goes back to the
+    /// buf_ring once its send completes. No copy and no handler hop, but the bytes pass through user memory.
+    /// </summary>
+    Buffers,
+
+    /// <summary>
+    /// <c>IORING_OP_SPLICE</c> socket → pipe → socket: the bytes never reach user space and no provided
+    /// buffers are held. Two operations per chunk, so it pays off for bulk transfers rather than small
+    /// messages. Falls back to <see cref="Buffers"/> when the kernel lacks splice.
+    /// </summary>
+    Splice
+}
@@ -0,0 +1,24 @@
+namespace zerg.Engine.Configs;
+
+/// <summary>
+/// Controls how a reactor hands flushed write-slab bytes to the kernel.
+/// </summary>
+public enum SendMode
+{
+    /// <summary>
+    /// Plain <c>IORING_OP_SEND</c>: the kernel copies the bytes into socket buffers
+    /// and the write slab is reusable as soon as the send CQE arrives.
+    /// </summary>
+    Copy,
+
+    /// <summary>
+    /// <c>IORING_OP_SEND_ZC</c> from the connection's write slab, registered as a fixed buffer.
+    ///
+    /// The kernel transmits straight from the slab pages, so the flush only completes once the
+    /// zero-copy notification CQE reports that the pages were released.
+    /// Flushes smaller than <see cref="ReactorConfig.ZeroCopySendThreshold"/> still use <see cref="Copy"/>.
+    ///
+    /// Requires Linux kernel 6.0+.
+    /// </summary>
+    ZeroCopy
+}
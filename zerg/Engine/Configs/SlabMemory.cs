@@ -0,0 +1,27 @@
+namespace zerg.Engine.Configs;
+
+/// <summary>
+/// Controls how a reactor backs its recv buffer slabs and its connections' write slabs.
+/// </summary>
+public enum SlabMemory
+{
+    /// <summary>
+    /// Recv slabs are lazily committed anonymous mappings (4 KB pages) that elastic buffer groups
+    /// trim back to the OS; write slabs are 64-byte aligned heap allocations from the engine-wide
+    /// connection pool.
+    /// </summary>
+    Default,
+
+    /// <summary>
+    /// Slabs are backed by 2 MB pages and placed on the NUMA node of the CPU the reactor thread runs on.
+    ///
+    /// Pages come from the hugetlb pool (<c>MAP_HUGETLB</c>, see <c>/proc/sys/vm/nr_hugepages</c>);
+    /// when the pool cannot serve a slab it is mapped 2 MB aligned with <c>MADV_HUGEPAGE</c> so
+    /// transparent huge pages back it instead. Far fewer TLB entries then cover the slabs.
+    ///
+    /// Recv slabs stay fully committed, since releasing part of a huge page would split it: elastic
+    /// buffer groups still publish and withdraw buffers but no longer return pages to the OS.
+    /// Write slabs are carved from per-reactor 2 MB chunks, so connections are pooled per reactor.
+    /// </summary>
+    HugePages
+}
@@ -0,0 +1,27 @@
+namespace zerg.Engine.Configs;
+
+/// <summary>
+/// Controls how a reactor waits when a loop iteration finds no completions.
+/// </summary>
+public enum WaitStrategy
+{
+    /// <summary>
+    /// Enter the kernel right away and sleep in the CQ wait for up to <see cref="ReactorConfig.CqTimeout"/>.
+    /// Cheapest on CPU; every idle gap pays a sleep and a wakeup.
+    /// </summary>
+    Block,
+
+    /// <summary>
+    /// Spin in userspace on the CQ for up to <see cref="ReactorConfig.SpinBudget"/> before blocking like
+    /// <see cref="Block"/>. With <see cref="ReactorConfig.AdaptiveSpin"/> the spin is sized from the recent
+    /// gaps between completions: it shrinks to nothing while completions arrive slower than the budget
+    /// and comes back as soon as they speed up.
+    /// </summary>
+    Hybrid,
+
+    /// <summary>
+    /// Never sleep: the reactor spins on the CQ and only enters the kernel without waiting.
+    /// Lowest latency, at the cost of one fully busy core per reactor even when idle.
+    /// </summary>
+    Spin
+}
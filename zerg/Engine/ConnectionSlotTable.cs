@@ -0,0 +1,111 @@
+using System.Runtime.CompilerServices;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+/// <summary>
+/// Per-reactor table of live connections, indexed by slot id.
+///
+/// Replaces an fd-keyed dictionary on the CQE hot path: a lookup is one array index plus a
+/// generation compare. Each slot carries a 24-bit generation that is packed into the user_data
+/// of every SQE issued for the connection and bumped when the slot is freed, so completions that
+/// arrive after a close (or after the slot and fd were reused) are recognised as stale.
+///
+/// Owned by the reactor thread; not thread-safe.
+/// </summary>
+internal sealed class ConnectionSlotTable
+{
+    private Connection?[] _connections;
+    private uint[] _generations;
+    /// <summary>Stack of free slot ids; low ids are handed out first.</summary>
+    private int[] _free;
+    private int _freeCount;
+
+    public ConnectionSlotTable(int capacity)
+    {
+        capacity = Math.Max(capacity, 16);
+        _connections = new Connection?[capacity];
+        _generations = new uint[capacity];
+        _free = new int[capacity];
+        for (int i = 0; i < capacity; i++)
+            _free[i] = capacity - 1 - i;
+        _freeCount = capacity;
+    }
+
+    /// <summary>Number of live connections.</summary>
+    public int Count { get; private set; }
+
+    /// <summary>Number of slots (live or free); slot ids are in <c>[0, Capacity)</c>.</summary>
+    public int Capacity => _connections.Length;
+
+    /// <summary>
+    /// Assigns a slot to <paramref name="connection"/> and stamps it with the slot id and generation.
+    /// Doubles the table when full, so the preallocated capacity is a hint, not a limit.
+    /// </summary>
+    public int Add(Connection connection)
+    {
+        if (_freeCount == 0)
+            Grow();
+
+        int slot = _free[--_freeCount];
+        _connections[slot] = connection;
+        connection.Slot = slot;
+        connection.SlotGeneration = _generations[slot];
+        Count++;
+        return slot;
+    }
+
+    /// <summary>
+    /// Returns the connection in <paramref name="slot"/> if it is still the lifetime that issued
+    /// <paramref name="generation"/>; null for stale completions.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public Connection? Get(int slot, uint generation)
+    {
+        if ((uint)slot >= (uint)_connections.Length || _generations[slot] != generation)
+            return null;
+        return _connections[slot];
+    }
+
+    /// <summary>Returns the live connection in <paramref name="slot"/>, or null if the slot is free.</summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public Connection? Get(int slot)
+    {
+        if ((uint)slot >= (uint)_connections.Length)
+            return null;
+        return _connections[slot];
+    }
+
+    /// <summary>
+    /// Frees the slot of <paramref name="connection"/> and bumps its generation so in-flight CQEs of
+    /// this lifetime no longer resolve. Returns false if the connection was not (or no longer) in the table.
+    /// </summary>
+    public bool Remove(Connection connection)
+    {
+        int slot = connection.Slot;
+        if ((uint)slot >= (uint)_connections.Length || !ReferenceEquals(_connections[slot], connection))
+            return false;
+
+        _connections[slot] = null;
+        _generations[slot] = (_generations[slot] + 1) & UdGenerationMask;
+        _free[_freeCount++] = slot;
+        connection.Slot = -1;
+        Count--;
+        return true;
+    }
+
+    private void Grow()
+    {
+        int oldCapacity = _connections.Length;
+        int newCapacity = oldCapacity * 2;
+        Array.Resize(ref _connections, newCapacity);
+        Array.Resize(ref _generations, newCapacity);
+        Array.Resize(ref _free, newCapacity);
+        for (int i = newCapacity - 1; i >= oldCapacity; i--)
+            _free[_freeCount++] = i;
+    }
+}
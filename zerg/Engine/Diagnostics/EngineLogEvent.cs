@@ -0,0 +1,19 @@
+namespace zerg.Engine.Diagnostics;
+
+/// <summary>
+/// A log event raised by the engine (see <see cref="Configs.EngineOptions.LogHandler"/>).
+/// </summary>
+/// <param name="Level">Severity.</param>
+/// <param name="Source">Loop that raised it: <c>w0</c>, <c>w1</c>... for reactors, <c>acceptor</c> or <c>engine</c>.</param>
+/// <param name="Message">Human readable message.</param>
+/// <param name="Exception">The exception behind an error, if any.</param>
+public readonly record struct EngineLogEvent(
+    EngineLogLevel Level,
+    string Source,
+    string Message,
+    Exception? Exception = null)
+{
+    /// <summary>Formats the event the way the default console handler prints it.</summary>
+    public override string ToString()
+        => Exception == null ? $"[{Source}] {Message}" : $"[{Source}] {Message}: {Exception}";
+}
@@ -0,0 +1,23 @@
+namespace zerg.Engine.Diagnostics;
+
+/// <summary>
+/// Severity of an <see cref="EngineLogEvent"/>. Events below <see cref="Configs.EngineOptions.LogLevel"/>
+/// are dropped before their message is built.
+/// </summary>
+public enum EngineLogLevel
+{
+    /// <summary>Per-event detail, e.g. individual accept failures.</summary>
+    Trace,
+    /// <summary>Startup and shutdown detail: ring flags, armed requests, per-reactor teardown.</summary>
+    Debug,
+    /// <summary>Lifecycle: server started, auto-tune choices.</summary>
+    Information,
+    /// <summary>A feature fell back (e.g. a registration the kernel refused) or something leaked.</summary>
+    Warning,
+    /// <summary>An operation failed and was dropped, e.g. scheduled work that threw.</summary>
+    Error,
+    /// <summary>A loop died.</summary>
+    Critical,
+    /// <summary>Disables logging.</summary>
+    None
+}
@@ -0,0 +1,95 @@
+using System.Diagnostics.Metrics;
+
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine.Diagnostics;
+
+/// <summary>
+/// Publishes the engine's <see cref="ReactorMetrics"/> as <see cref="System.Diagnostics.Metrics"/> instruments
+/// on the <see cref="MeterName"/> meter, one measurement per reactor tagged <c>zerg.reactor</c>.
+/// Every instrument is observable: nothing is recorded on the reactor threads, listeners pull a snapshot
+/// when they collect.
+/// </summary>
+internal sealed class EngineMetrics : IDisposable
+{
+    public const string MeterName = "zerg";
+
+    private static readonly string[] s_quantiles = ["0.5", "0.9", "0.99", "0.999", "max"];
+
+    private readonly Engine _engine;
+    private readonly Meter _meter;
+    private readonly KeyValuePair<string, object?>[][] _reactorTags;
+    private readonly KeyValuePair<string, object?>[][] _quantileTags;
+
+    public EngineMetrics(Engine engine)
+    {
+        _engine = engine;
+        int reactors = engine.Reactors.Length;
+        _reactorTags = new KeyValuePair<string, object?>[reactors][];
+        _quantileTags = new KeyValuePair<string, object?>[reactors * s_quantiles.Length][];
+        for (int i = 0; i < reactors; i++)
+        {
+            _reactorTags[i] = [new("zerg.reactor", i)];
+            for (int q = 0; q < s_quantiles.Length; q++)
+                _quantileTags[i * s_quantiles.Length + q] = [new("zerg.reactor", i), new("quantile", s_quantiles[q])];
+        }
+
+        _meter = new Meter(MeterName);
+        Counter("zerg.reactor.loop_iterations", "{iteration}", "Event loop iterations.", m => m.LoopIterations);
+        Counter("zerg.reactor.cqes", "{cqe}", "Completion queue entries processed.", m => m.Cqes);
+        Counter("zerg.reactor.cqe_batches", "{batch}", "Loop iterations that harvested at least one CQE.", m => m.CqeBatches);
+        Counter("zerg.reactor.submits", "{call}", "Explicit io_uring submits outside the loop's submit + wait.", m => m.Submits);
+        Counter("zerg.reactor.kernel_waits", "{call}", "Submit + wait calls that entered the kernel.", m => m.KernelWaits);
+        Counter("zerg.reactor.sq_full", "{event}", "SQE requests that found the submission queue full.", m => m.SqFull);
+        Counter("zerg.reactor.recv_buffer_starvations", "{event}", "Multishot recvs that ended with ENOBUFS.", m => m.RecvBufferStarvations);
+        Counter("zerg.reactor.return_queue.drained", "{buffer}", "Buffer returns drained from the return queue.", m => m.ReturnQDrained);
+        Counter("zerg.reactor.flush_queue.drained", "{request}", "Flush requests drained from the flush queue.", m => m.FlushQDrained);
+        Counter("zerg.reactor.sends", "{send}", "Send SQEs issued.", m => m.Sends);
+        Counter("zerg.reactor.partial_sends", "{send}", "Sends that moved fewer bytes than requested.", m => m.PartialSends);
+        Counter("zerg.reactor.send_errors", "{send}", "Send completions with an error.", m => m.SendErrors);
+        Counter("zerg.reactor.timer_expirations", "{connection}", "Connections closed by an idle, read-header or flush deadline.", m => m.TimerExpirations);
+        Gauge("zerg.reactor.connections", "{connection}", "Connections assigned to the reactor.", m => m.Connections);
+        Gauge("zerg.reactor.max_cqe_batch", "{cqe}", "Largest CQE batch harvested in one iteration.", m => m.MaxCqeBatch);
+        Gauge("zerg.reactor.recv_buffers.published", "{buffer}", "Recv buffers in circulation.", m => m.RecvBuffersPublished);
+        Gauge("zerg.reactor.recv_buffers.outstanding", "{buffer}", "Recv buffers holding received data.", m => m.RecvBuffersOutstanding);
+        Gauge("zerg.reactor.return_queue.max_depth", "{buffer}", "Deepest the return queue was when drained.", m => m.ReturnQMaxDepth);
+        Gauge("zerg.reactor.flush_queue.max_depth", "{request}", "Deepest the flush queue was when drained.", m => m.FlushQMaxDepth);
+        _meter.CreateObservableGauge("zerg.reactor.flush_latency", ObserveFlushLatency, "ns",
+            "Flush latency quantiles: from issuing a send batch until its last byte is sent.");
+    }
+
+    private void Counter(string name, string unit, string description, Func<ReactorMetrics, long> select)
+        => _meter.CreateObservableCounter(name, () => Observe(select), unit, description);
+
+    private void Gauge(string name, string unit, string description, Func<ReactorMetrics, long> select)
+        => _meter.CreateObservableGauge(name, () => Observe(select), unit, description);
+
+    private IEnumerable<Measurement<long>> Observe(Func<ReactorMetrics, long> select)
+    {
+        Engine.Reactor[] reactors = _engine.Reactors;
+        Measurement<long>[] measurements = new Measurement<long>[reactors.Length];
+        for (int i = 0; i < reactors.Length; i++)
+            measurements[i] = new Measurement<long>(select(reactors[i].GetMetrics()), _reactorTags[i]);
+        return measurements;
+    }
+
+    private IEnumerable<Measurement<long>> ObserveFlushLatency()
+    {
+        Engine.Reactor[] reactors = _engine.Reactors;
+        Measurement<long>[] measurements = new Measurement<long>[reactors.Length * s_quantiles.Length];
+        for (int i = 0; i < reactors.Length; i++)
+        {
+            LatencySummary s = reactors[i].FlushLatency.Summarize();
+            int at = i * s_quantiles.Length;
+            measurements[at] = new Measurement<long>(s.P50Ns, _quantileTags[at]);
+            measurements[at + 1] = new Measurement<long>(s.P90Ns, _quantileTags[at + 1]);
+            measurements[at + 2] = new Measurement<long>(s.P99Ns, _quantileTags[at + 2]);
+            measurements[at + 3] = new Measurement<long>(s.P999Ns, _quantileTags[at + 3]);
+            measurements[at + 4] = new Measurement<long>(s.MaxNs, _quantileTags[at + 4]);
+        }
+        return measurements;
+    }
+
+    public void Dispose() => _meter.Dispose();
+}
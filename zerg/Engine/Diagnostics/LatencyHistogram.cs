@@ -0,0 +1,153 @@
+using System.Numerics;
+
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine.Diagnostics;
+
+/// <summary>
+/// Log-linear (HDR-style) histogram of nanosecond latencies with a single writer.
+///
+/// Values are bucketed by power of two, each power split into 8 linear sub-buckets, so any recorded
+/// value is reported within 12.5% from 8 ns up to ~18 minutes in a fixed 312-entry array: recording is
+/// an index computation and two increments, never an allocation. Readers on other threads see a
+/// best-effort snapshot.
+/// </summary>
+public sealed class LatencyHistogram
+{
+    private const int c_subBucketBits = 3;
+    private const int c_subBuckets = 1 << c_subBucketBits;
+    /// <summary>Highest power of two with its own buckets; larger values land in the last bucket.</summary>
+    private const int c_maxExponent = 40;
+    private const int c_bucketCount = (c_maxExponent - c_subBucketBits + 2) * c_subBuckets;
+
+    private readonly long[] _counts = new long[c_bucketCount];
+    private long _count;
+    private long _sum;
+    private long _max;
+
+    /// <summary>Values recorded.</summary>
+    public long Count => Volatile.Read(ref _count);
+
+    /// <summary>Largest value recorded (exact).</summary>
+    public long MaxNs => Volatile.Read(ref _max);
+
+    /// <summary>Records one value. Must only be called by the owning (single writing) thread.</summary>
+    public void Record(long ns)
+    {
+        if (ns < 0)
+            ns = 0;
+        _counts[IndexOf(ns)]++;
+        _sum += ns;
+        if (ns > _max)
+            _max = ns;
+        Volatile.Write(ref _count, _count + 1);
+    }
+
+    /// <summary>
+    /// Adds the values recorded by <paramref name="other"/> to this histogram, e.g. to merge per-thread
+    /// histograms. Called by this histogram's writer; <paramref name="other"/> should be quiescent.
+    /// </summary>
+    public void Add(LatencyHistogram other)
+    {
+        for (int i = 0; i < _counts.Length; i++)
+            _counts[i] += Volatile.Read(ref other._counts[i]);
+        _sum += Volatile.Read(ref other._sum);
+        long max = other.MaxNs;
+        if (max > _max)
+            _max = max;
+        Volatile.Write(ref _count, _count + other.Count);
+    }
+
+    /// <summary>
+    /// Value at or below which <paramref name="percentile"/> percent of the recorded values fall
+    /// (the upper bound of the bucket that holds it). 0 when nothing was recorded.
+    /// </summary>
+    public long ValueAtPercentile(double percentile)
+    {
+        long total = 0;
+        for (int i = 0; i < _counts.Length; i++)
+            total += Volatile.Read(ref _counts[i]);
+        if (total == 0)
+            return 0;
+
+        long rank = RankOf(percentile, total);
+        long seen = 0;
+        for (int i = 0; i < _counts.Length; i++)
+        {
+            seen += Volatile.Read(ref _counts[i]);
+            if (seen >= rank)
+                return Math.Min(UpperBoundOf(i), MaxNs);
+        }
+        return MaxNs;
+    }
+
+    /// <summary>Count, mean, p50/p90/p99/p99.9 and max in one pass over the buckets.</summary>
+    public LatencySummary Summarize()
+    {
+        long total = 0;
+        for (int i = 0; i < _counts.Length; i++)
+            total += Volatile.Read(ref _counts[i]);
+        if (total == 0)
+            return default;
+
+        long max = MaxNs;
+        long r50 = RankOf(50, total), r90 = RankOf(90, total), r99 = RankOf(99, total), r999 = RankOf(99.9, total);
+        long p50 = 0, p90 = 0, p99 = 0, p999 = 0;
+        long seen = 0;
+        for (int i = 0; i < _counts.Length && seen < r999; i++)
+        {
+            long n = Volatile.Read(ref _counts[i]);
+            if (n == 0)
+                continue;
+            long before = seen;
+            seen += n;
+            long bound = Math.Min(UpperBoundOf(i), max);
+            if (before < r50 && seen >= r50) p50 = bound;
+            if (before < r90 && seen >= r90) p90 = bound;
+            if (before < r99 && seen >= r99) p99 = bound;
+            if (seen >= r999) p999 = bound;
+        }
+
+        long count = Count;
+        double mean = count == 0 ? 0 : (double)Volatile.Read(ref _sum) / count;
+        return new LatencySummary(total, mean, p50, p90, p99, p999, max);
+    }
+
+    private static long RankOf(double percentile, long total)
+        => Math.Clamp((long)Math.Ceiling(percentile / 100.0 * total), 1, total);
+
+    private static int IndexOf(long value)
+    {
+        if (value < c_subBuckets)
+            return (int)value;
+        int exponent = 63 - BitOperations.LeadingZeroCount((ulong)value);
+        if (exponent > c_maxExponent)
+            return c_bucketCount - 1;
+        int sub = (int)(value >> (exponent - c_subBucketBits)) & (c_subBuckets - 1);
+        return (exponent - c_subBucketBits + 1) * c_subBuckets + sub;
+    }
+
+    private static long UpperBoundOf(int index)
+    {
+        int block = index >> c_subBucketBits;
+        int sub = index & (c_subBuckets - 1);
+        if (block == 0)
+            return sub;
+        int shift = block - 1;
+        return ((long)(c_subBuckets + sub) << shift) + (1L << shift) - 1;
+    }
+}
+
+/// <summary>
+/// Summary of a <see cref="LatencyHistogram"/>. Percentiles are bucket upper bounds (within 12.5%),
+/// capped at the exact <see cref="MaxNs"/>.
+/// </summary>
+public readonly record struct LatencySummary(
+    long Count,
+    double MeanNs,
+    long P50Ns,
+    long P90Ns,
+    long P99Ns,
+    long P999Ns,
+    long MaxNs);
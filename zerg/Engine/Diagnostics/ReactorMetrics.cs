@@ -0,0 +1,91 @@
+using System.Runtime.InteropServices;
+
+namespace zerg.Engine.Diagnostics;
+
+/// <summary>
+/// Point-in-time metrics of one reactor (see <see cref="Engine.Reactor.GetMetrics"/> and <see cref="Engine.GetMetrics"/>).
+/// Counters are cumulative since the reactor started; taking a snapshot allocates nothing.
+/// </summary>
+/// <param name="ReactorId">Reactor the snapshot belongs to.</param>
+/// <param name="LoopIterations">Event loop iterations.</param>
+/// <param name="CqeBatches">Iterations that harvested at least one CQE.</param>
+/// <param name="Cqes">CQEs processed.</param>
+/// <param name="MaxCqeBatch">Largest CQE batch harvested in one iteration.</param>
+/// <param name="Submits">Explicit submits (outside the submit + wait of the loop), including those forced by a full SQ.</param>
+/// <param name="KernelWaits">Submit + wait calls that entered the kernel.</param>
+/// <param name="SqFull">Times an SQE was needed with the SQ full, forcing an early submit.</param>
+/// <param name="Connections">Connections currently assigned to the reactor.</param>
+/// <param name="RecvBuffersPublished">Recv buffers in circulation, summed over the buffer groups.</param>
+/// <param name="RecvBuffersOutstanding">Recv buffers holding received data (filled and not yet returned).</param>
+/// <param name="RecvBufferStarvations">Multishot recvs that ended with -ENOBUFS.</param>
+/// <param name="ReturnQDrained">Buffer returns drained from the return queue.</param>
+/// <param name="ReturnQMaxDepth">Deepest the return queue was when the loop drained it.</param>
+/// <param name="FlushQDrained">Flush requests drained from the flush queue.</param>
+/// <param name="FlushQMaxDepth">Deepest the flush queue was when the loop drained it.</param>
+/// <param name="Sends">Send SQEs issued (copying and zero-copy, including resubmits of partial sends).</param>
+/// <param name="PartialSends">Send completions that moved fewer bytes than requested and had to be resubmitted.</param>
+/// <param name="SendErrors">Send completions with an error (typically the peer going away).</param>
+/// <param name="IdleTimeouts">Connections closed by their idle timeout.</param>
+/// <param name="ReadHeaderTimeouts">Connections closed by their read-header deadline.</param>
+/// <param name="FlushTimeouts">Connections closed because a flush made no progress within its timeout.</param>
+/// <param name="FlushLatency">Time from the reactor issuing a send batch until its last byte is sent (partial sends included).</param>
+public readonly record struct ReactorMetrics(
+    int ReactorId,
+    long LoopIterations,
+    long CqeBatches,
+    long Cqes,
+    long MaxCqeBatch,
+    long Submits,
+    long KernelWaits,
+    long SqFull,
+    long Connections,
+    int RecvBuffersPublished,
+    int RecvBuffersOutstanding,
+    long RecvBufferStarvations,
+    long ReturnQDrained,
+    long ReturnQMaxDepth,
+    long FlushQDrained,
+    long FlushQMaxDepth,
+    long Sends,
+    long PartialSends,
+    long SendErrors,
+    long IdleTimeouts,
+    long ReadHeaderTimeouts,
+    long FlushTimeouts,
+    LatencySummary FlushLatency)
+{
+    /// <summary>Average CQEs per non-empty batch.</summary>
+    public double CqesPerBatch => CqeBatches == 0 ? 0 : (double)Cqes / CqeBatches;
+
+    /// <summary>io_uring_enter calls of the loop: explicit submits plus kernel waits (fewer with SQPOLL).</summary>
+    public long Enters => Submits + KernelWaits;
+
+    /// <summary>Connections closed by any of their deadlines.</summary>
+    public long TimerExpirations => IdleTimeouts + ReadHeaderTimeouts + FlushTimeouts;
+}
+
+/// <summary>
+/// A reactor's hot-path counters. Written only by the reactor thread with plain increments; readers use
+/// <see cref="Volatile"/> reads. 64 bytes of padding on both sides keep them off the cache lines of the
+/// reactor fields around them, so a metrics reader never slows the loop down through false sharing.
+/// </summary>
+[StructLayout(LayoutKind.Explicit, Size = 256)]
+internal struct ReactorCounters
+{
+    [FieldOffset(64)]  public long LoopIterations;
+    [FieldOffset(72)]  public long CqeBatches;
+    [FieldOffset(80)]  public long Cqes;
+    [FieldOffset(88)]  public long MaxCqeBatch;
+    [FieldOffset(96)]  public long Submits;
+    [FieldOffset(104)] public long SqFull;
+    [FieldOffset(112)] public long ReturnQDrained;
+    [FieldOffset(120)] public long ReturnQMaxDepth;
+    [FieldOffset(128)] public long FlushQDrained;
+    [FieldOffset(136)] public long FlushQMaxDepth;
+    [FieldOffset(144)] public long Sends;
+    [FieldOffset(152)] public long PartialSends;
+    [FieldOffset(160)] public long SendErrors;
+    [FieldOffset(168)] public long IdleTimeouts;
+    [FieldOffset(176)] public long ReadHeaderTimeouts;
+    [FieldOffset(184)] public long FlushTimeouts;
+}
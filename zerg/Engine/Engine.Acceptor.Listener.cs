@@ -1,6 +1,7 @@
 using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 using System.Text;
+using zerg.Engine.Configs;
 using static zerg.ABI.ABI;
 
 namespace zerg.Engine;
@@ -15,11 +16,23 @@ public sealed unsafe partial class Engine
     /// </summary>
     public partial class Acceptor
     {
+        /// <summary>
+        /// Creates the listening socket described by <paramref name="options"/>
+        /// (IPv4-only or dual-stack, per <see cref="AcceptorConfig.IPVersion"/>).
+        /// Every listener sets SO_REUSEPORT, so calling this once per reactor builds a reuseport group.
+        /// </summary>
+        internal static int CreateListenerSocket(EngineOptions options)
+        {
+            return options.AcceptorConfig.IPVersion == IPVersion.IPv4Only
+                ? CreateIPv4ListenerSocket(options.Ip, options.Port, options.Backlog)
+                : CreateListenerSocketDualStack(options.Ip, options.Port, options.Backlog);
+        }
+
         /// <summary>
         /// Creates an IPv4-only listening socket bound to the given IPv4 address and port.
         /// This socket will accept ONLY IPv4 connections.
         /// </summary>
-        private int CreateIPv4ListenerSocket(string ip, ushort port)
+        private static int CreateIPv4ListenerSocket(string ip, ushort port, int backlog)
         {
             int lfd = socket(AF_INET, SOCK_STREAM, 0);
             if (lfd < 0) ThrowErrno("socket");
@@ -53,7 +66,7 @@ public sealed unsafe partial class Engine
                 if (bind(lfd, &addr, (uint)sizeof(sockaddr_in)) < 0)
                     ThrowErrno("bind");
 
-                if (listen(lfd, _engine.Options.Backlog) < 0)
+                if (listen(lfd, backlog) < 0)
                     ThrowErrno("listen");
 
                 int fl = fcntl(lfd, F_GETFL, 0);
@@ -81,7 +94,7 @@ public sealed unsafe partial class Engine
         ///   IPv6 addr -> binds that IPv6 (still dual-stack)
         ///   IPv4 addr -> binds to ::ffff:a.b.c.d (IPv4-mapped)
         /// </summary>
-        private int CreateListenerSocketDualStack(string ip, ushort port)
+        private static int CreateListenerSocketDualStack(string ip, ushort port, int backlog)
         {
             // Interpret empty/"*" as any
             if (string.IsNullOrEmpty(ip) || ip == "*")
@@ -158,7 +171,7 @@ public sealed unsafe partial class Engine
                 if (bind(lfd, &addr6, (uint)sizeof(sockaddr_in6)) < 0)
                     ThrowErrno("bind(AF_INET6)");
 
-                if (listen(lfd, _engine.Options.Backlog) < 0)
+                if (listen(lfd, backlog) < 0)
                     ThrowErrno("listen");
 
                 int fl = fcntl(lfd, F_GETFL, 0);
@@ -176,6 +189,26 @@ public sealed unsafe partial class Engine
             }
         }
 
+        /// <summary>
+        /// Attaches a classic BPF program to a reuseport group that picks the listener by the CPU
+        /// that received the connection: <c>return cpu % groupSize</c>.
+        ///
+        /// The returned index selects the socket by its position in the group (creation order),
+        /// so listener i must belong to reactor i. Steering pays off when reactor i runs on CPU i
+        /// and NIC queues are spread across those CPUs (RSS/RPS).
+        /// </summary>
+        internal static void AttachReusePortCpuSteering(int lfd, int groupSize)
+        {
+            sock_filter* code = stackalloc sock_filter[3];
+            code[0] = new sock_filter { code = BPF_LD  | BPF_W   | BPF_ABS, k = unchecked((uint)(SKF_AD_OFF + SKF_AD_CPU)) };
+            code[1] = new sock_filter { code = BPF_ALU | BPF_MOD | BPF_K,   k = (uint)groupSize };
+            code[2] = new sock_filter { code = BPF_RET | BPF_A };
+
+            sock_fprog prog = new sock_fprog { len = 3, filter = code };
+            if (setsockopt(lfd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, (uint)sizeof(sock_fprog)) < 0)
+                ThrowErrno("setsockopt(SO_ATTACH_REUSEPORT_CBPF)");
+        }
+
         /// <summary>
         /// Converts an IPv4 address to an IPv4-mapped IPv6 address (::ffff:a.b.c.d).
         /// This is the standard mechanism used by dual-stack IPv6 sockets.
@@ -1,4 +1,6 @@
+using zerg.Engine.Balancing;
 using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
 using static zerg.ABI.ABI;
 
 // ReSharper disable always CheckNamespace
@@ -53,8 +55,8 @@ public sealed unsafe partial class Engine
             _acceptorConfig = acceptorConfig; 
             _engine = engine;
             _listenFd = acceptorConfig.IPVersion == IPVersion.IPv4Only 
-                ? CreateIPv4ListenerSocket(_engine.Options.Ip, _engine.Options.Port) 
-                : CreateListenerSocketDualStack(_engine.Options.Ip, _engine.Options.Port);
+                ? CreateIPv4ListenerSocket(_engine.Options.Ip, _engine.Options.Port, _engine.Options.Backlog) 
+                : CreateListenerSocketDualStack(_engine.Options.Ip, _engine.Options.Port, _engine.Options.Backlog);
             _cqes = new io_uring_cqe*[_acceptorConfig.BatchSqes];
         }
         /// <summary>
@@ -67,32 +69,33 @@ public sealed unsafe partial class Engine
         {
             _io_uring = CreateRing(_acceptorConfig.RingFlags, _acceptorConfig.SqCpuThread, _acceptorConfig.SqThreadIdleMs, out int err, _acceptorConfig.RingEntries);
             CheckRingFlags(shim_get_ring_flags(_io_uring));
-            if (_io_uring == null || err < 0) { Console.Error.WriteLine($"[acceptor] create_ring failed: {err}"); return; }
+            if (_io_uring == null || err < 0) { Log(EngineLogLevel.Error, $"create_ring failed: {err}"); return; }
             // Start multishot accept
             _sqe = SqeGet(_io_uring);
             shim_prep_multishot_accept(_sqe, _listenFd, SOCK_NONBLOCK);
             shim_sqe_set_data64(_sqe, PackUd(UdKind.Accept, _listenFd));
             shim_submit(_io_uring);
-            Console.WriteLine("[acceptor] Multishot accept armed");
+            Log(EngineLogLevel.Debug, "multishot accept armed");
         }
 
         private void CheckRingFlags(uint flags) 
         {
-            Console.WriteLine($"[acceptor] ring flags = 0x{flags:x} " +
-                              $"(SQPOLL={(flags & IORING_SETUP_SQPOLL) != 0}, " +
-                              $"SQ_AFF={(flags & IORING_SETUP_SQ_AFF) != 0})");
+            Log(EngineLogLevel.Debug, $"ring flags = 0x{flags:x} " +
+                                      $"(SQPOLL={(flags & IORING_SETUP_SQPOLL) != 0}, " +
+                                      $"SQ_AFF={(flags & IORING_SETUP_SQ_AFF) != 0})");
         }
         
         public void Handle(Acceptor acceptor, int reactorCount) 
         {
             try 
             {
-                int nextReactor = 0;
+                IConnectionBalancer balancer = _acceptorConfig.Balancer ?? new RoundRobinBalancer();
+                ReactorLoadTable loads = _engine.ReactorLoads;
                 int one = 1;
                 __kernel_timespec ts;
                 ts.tv_sec  = 0;
                 ts.tv_nsec = _acceptorConfig.CqTimeout;
-                Console.WriteLine($"[acceptor] Load balancing across {reactorCount} reactors");
+                Log(EngineLogLevel.Debug, $"load balancing across {reactorCount} reactors ({balancer.GetType().Name})");
 
                 while (_engine.ServerRunning) 
                 {
@@ -122,20 +125,19 @@ public sealed unsafe partial class Engine
                                 int clientFd = res;
                                 setsockopt(clientFd, IPPROTO_TCP, TCP_NODELAY, &one, (uint)sizeof(int));
 
-                                // Round-robin to next reactor
-                                // TODO: This is naive, not all connections are the same,
-                                // TODO: should balance considering each connection's weight
-                                // TODO: Allow user to inject balancing logic and provide multiple algorithms he can choose from
-                                int targetReactor = nextReactor;
-                                nextReactor = (nextReactor + 1) % reactorCount;
+                                int targetReactor = balancer.SelectReactor(clientFd, loads);
+                                if ((uint)targetReactor >= (uint)reactorCount)
+                                    targetReactor = (int)((uint)targetReactor % (uint)reactorCount);
+                                Interlocked.Increment(ref loads[targetReactor].Connections);
 
                                 ReactorQueues[targetReactor].Enqueue(clientFd);
+                                _engine.Reactors[targetReactor].Wake();
                                 
-                            }else { Console.WriteLine($"[acceptor] Accept error: {res}"); }
+                            }else if (IsLogEnabled(EngineLogLevel.Warning)) { Log(EngineLogLevel.Warning, $"accept error: {res}"); }
                         }
                         shim_cqe_seen(acceptor._io_uring, cqe);
                     }
-                    if (shim_sq_ready(acceptor._io_uring) > 0) { Console.WriteLine("S3"); shim_submit(acceptor._io_uring); }
+                    if (shim_sq_ready(acceptor._io_uring) > 0) shim_submit(acceptor._io_uring);
                 }
             }
             finally 
@@ -143,7 +145,7 @@ public sealed unsafe partial class Engine
                 // close listener and ring even on exception/StopAll
                 if (acceptor._listenFd >= 0) close(acceptor._listenFd);
                 if (acceptor._io_uring != null) shim_destroy_ring(acceptor._io_uring);
-                Console.WriteLine($"[acceptor] Shutdown complete.");
+                Log(EngineLogLevel.Debug, "shutdown complete");
             }
         }
     }
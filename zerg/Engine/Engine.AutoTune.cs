@@ -0,0 +1,107 @@
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed partial class Engine
+{
+    /// <summary>Setup flags <c>shim_probe</c> tries; other flags of a config are passed through untouched.</summary>
+    private const uint c_probedSetupFlags = IORING_SETUP_SQPOLL | IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN
+        | IORING_SETUP_TASKRUN_FLAG | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_NO_SQARRAY;
+
+    private const uint c_taskrunFlags = IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG | IORING_SETUP_DEFER_TASKRUN;
+
+    /// <summary>
+    /// Returns the reactor configs to run with: <see cref="EngineOptions.ReactorConfigs"/> as given, or with
+    /// <see cref="EngineOptions.AutoTune"/> each one tuned to <see cref="KernelCapabilities.Current"/>.
+    /// The choices are logged once, one line per distinct outcome.
+    /// </summary>
+    private ReactorConfig[] ResolveReactorConfigs()
+    {
+        ReactorConfig[] configs = new ReactorConfig[Options.ReactorCount];
+        if (!Options.AutoTune)
+        {
+            Array.Copy(Options.ReactorConfigs, configs, configs.Length);
+            return configs;
+        }
+
+        KernelCapabilities caps = KernelCapabilities.Current;
+        Dictionary<string, List<int>> choices = new();
+        for (int i = 0; i < configs.Length; i++)
+        {
+            configs[i] = AutoTune(Options.ReactorConfigs[i], caps);
+            string choice = DescribeTuning(configs[i]);
+            if (!choices.TryGetValue(choice, out List<int>? ids))
+                choices[choice] = ids = [];
+            ids.Add(i);
+        }
+
+        Log(EngineLogLevel.Information, "auto-tune", $"kernel: {caps}");
+        foreach (KeyValuePair<string, List<int>> choice in choices)
+            Log(EngineLogLevel.Information, "auto-tune", $"reactors {string.Join(",", choice.Value)}: {choice.Key}");
+        return configs;
+    }
+
+    /// <summary>
+    /// Picks the fastest setup the kernel supports for one reactor config:
+    /// <list type="bullet">
+    /// <item><description>Ring flags: SINGLE_ISSUER | DEFER_TASKRUN, else COOP_TASKRUN; with SQPOLL (which
+    /// rejects both) only SINGLE_ISSUER. Requested flags the kernel rejected are dropped.</description></item>
+    /// <item><description>Recv bundles when supported. Incremental buffer consumption is kept only if requested
+    /// and supported: it saves memory rather than time, and rules out bundles and recv budgets.</description></item>
+    /// <item><description><see cref="SendMode.ZeroCopy"/> instead of the default <see cref="SendMode.Copy"/> when SEND_ZC
+    /// is supported; any other send mode is the caller's choice and kept. Flushes under
+    /// <see cref="ReactorConfig.ZeroCopySendThreshold"/> keep copying.</description></item>
+    /// <item><description>A registered ring fd when supported.</description></item>
+    /// </list>
+    /// If io_uring is unavailable the config is returned unchanged.
+    /// </summary>
+    internal static ReactorConfig AutoTune(ReactorConfig config, KernelCapabilities caps)
+    {
+        if (!caps.Available)
+            return config;
+
+        uint flags = config.RingFlags & ~(c_probedSetupFlags & ~caps.SetupFlags);
+        if ((flags & IORING_SETUP_SQPOLL) == 0)
+            flags &= ~IORING_SETUP_SQ_AFF;
+
+        flags &= ~c_taskrunFlags;
+        if (caps.SingleIssuer)
+            flags |= IORING_SETUP_SINGLE_ISSUER;
+        if ((flags & IORING_SETUP_SQPOLL) == 0)
+        {
+            if (caps.DeferTaskrun)
+                flags |= IORING_SETUP_DEFER_TASKRUN;
+            else if (caps.CoopTaskrun)
+                flags |= IORING_SETUP_COOP_TASKRUN;
+        }
+
+        bool incremental = config.IncrementalBufferConsumption && caps.IncrementalBuffers;
+        return config with
+        {
+            RingFlags = flags,
+            IncrementalBufferConsumption = incremental,
+            RecvBundles = caps.RecvBundles && !incremental,
+            SendMode = config.SendMode == SendMode.Copy && caps.ZeroCopySend ? SendMode.ZeroCopy : config.SendMode,
+            RegisterRingFd = caps.RegisterRingFd,
+        };
+    }
+
+    private static string DescribeTuning(ReactorConfig config)
+    {
+        uint flags = config.RingFlags;
+        string taskrun = (flags & IORING_SETUP_DEFER_TASKRUN) != 0 ? "DEFER_TASKRUN"
+            : (flags & IORING_SETUP_COOP_TASKRUN) != 0 ? "COOP_TASKRUN"
+            : "none";
+        string buffers = config.IncrementalBufferConsumption ? "incremental"
+            : config.RecvBundles ? "bundles"
+            : "single";
+        return $"ring flags=0x{flags:x} (taskrun={taskrun}, sqpoll={(flags & IORING_SETUP_SQPOLL) != 0}), " +
+               $"recv buffers={buffers}, send={config.SendMode}, registered ring fd={config.RegisterRingFd}";
+    }
+}
@@ -4,7 +4,9 @@
 
 using System.Collections.Concurrent;
 using System.Threading.Channels;
+using zerg.Engine.Balancing;
 using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
 
 namespace zerg.Engine;
 
@@ -16,11 +18,6 @@ public sealed partial class Engine
     /// </summary>
     private const int c_bufferRingGID = 1;
     /// <summary>
-    /// Per-reactor connection counters used for metrics / diagnostics / load balancing.
-    /// Index corresponds to reactor ID.
-    /// </summary>
-    private static long[] ReactorConnectionCounts = null!;
-    /// <summary>
     /// Lock-free queues used by the acceptor to hand off accepted client fds
     /// to each reactor thread (one queue per reactor).
     /// </summary>
@@ -31,6 +28,7 @@ public sealed partial class Engine
     public bool ServerRunning { get; private set; }
     /// <summary>
     /// The single acceptor responsible for listening and distributing connections.
+    /// Null in <see cref="AcceptMode.ReusePort"/> mode, where each reactor accepts on its own listener.
     /// </summary>
     public Acceptor SingleAcceptor { get; set; } = null!;
     /// <summary>
@@ -39,14 +37,19 @@ public sealed partial class Engine
     /// </summary>
     public Reactor[] Reactors { get; set; } = null!;
     /// <summary>
-    /// Per-reactor connection dictionaries (fd -> Connection).
-    /// Index corresponds to reactor ID.
-    /// </summary>
-    public Dictionary<int, Connection>[] Connections { get; set; } = null!;
-    /// <summary>
     /// Engine configuration (reactor count, networking options, buffer sizes, etc.).
     /// </summary>
     public EngineOptions Options { get; }
+    /// <summary>
+    /// Live per-reactor load (connections, in-flight send bytes, CQE rate) published by the reactors.
+    /// Consumed by the acceptor's <see cref="AcceptorConfig.Balancer"/>; also useful for diagnostics.
+    /// </summary>
+    public ReactorLoadTable ReactorLoads { get; }
+    /// <summary>
+    /// Open files and small file contents for the engine's handlers, or null unless
+    /// <see cref="EngineOptions.FileCache"/> is set. Emptied by <see cref="Stop"/>.
+    /// </summary>
+    public FileCache? FileCache { get; }
     
     public Engine() : this(new EngineOptions()) { }
 
@@ -62,7 +65,9 @@ public sealed partial class Engine
             }
         }
         ReactorQueues = new ConcurrentQueue<int>[options.ReactorCount];
-        ReactorConnectionCounts = new long[options.ReactorCount];
+        ReactorLoads = new ReactorLoadTable(options.ReactorCount);
+        if (options.FileCache != null)
+            FileCache = new FileCache(options.FileCache);
     }
 
     /// <summary>
@@ -72,55 +77,77 @@ public sealed partial class Engine
     private readonly Channel<ConnectionItem> ConnectionQueues =
         Channel.CreateUnbounded<ConnectionItem>(new UnboundedChannelOptions());
     /// <summary>
-    /// Internal struct used to pass (reactorId, fd) pairs
-    /// from the acceptor to the async AcceptAsync API.
+    /// Internal struct used to pass a registered connection (and the lifetime it was
+    /// registered in) from the reactor to the async AcceptAsync API.
     /// </summary>
-    private struct ConnectionItem(int reactorId, int clientFd)
+    private readonly struct ConnectionItem(Connection connection, int generation)
     {
-        public readonly int ReactorId = reactorId;
-        public readonly int ClientFd = clientFd;
+        public readonly Connection Connection = connection;
+        public readonly int Generation = generation;
     }
     /// <summary>
     /// Asynchronously waits for the next accepted connection.
     /// Returns the fully registered Connection object.
+    /// In <see cref="ExecutionMode.ThreadPerCore"/> mode the caller resumes on the thread of the reactor
+    /// that owns the connection, so the handler it starts runs there.
     /// </summary>
-    public async ValueTask<Connection?> AcceptAsync(CancellationToken cancellationToken = default) 
+    public ValueTask<Connection?> AcceptAsync(CancellationToken cancellationToken = default)
+        => Options.ExecutionMode == ExecutionMode.ThreadPerCore
+            ? AcceptOnReactorAsync(cancellationToken)
+            : AcceptFromQueueAsync(cancellationToken);
+
+    private async ValueTask<Connection?> AcceptFromQueueAsync(CancellationToken cancellationToken) 
     {
         while (true) 
         {
             var item = await ConnectionQueues.Reader.ReadAsync(cancellationToken).ConfigureAwait(false);
 
-            var dict = Connections[item.ReactorId];
-            if (dict.TryGetValue(item.ClientFd, out var conn))
-                return conn;
+            if (item.Connection.Generation == item.Generation)
+                return item.Connection;
 
-            // The fd was closed/removed before we got here (recv res<=0 path).
+            // The connection was closed and pooled before we got here (recv res<=0 path).
             // Skip it and wait for the next accepted connection.
         }
     }
     /// <summary>
     /// Starts the engine:
-    ///  - creates acceptor
+    ///  - creates acceptor (or one SO_REUSEPORT listener per reactor)
     ///  - creates reactors
     ///  - starts reactor threads
-    ///  - starts acceptor thread
+    ///  - starts acceptor thread (Acceptor mode only)
     /// </summary>
     public void Listen() 
     {
         ServerRunning = true;
+        bool reusePort = Options.AcceptMode == AcceptMode.ReusePort;
         // Init Acceptor
-        SingleAcceptor = new Acceptor(Options.AcceptorConfig, this);
+        if (!reusePort)
+            SingleAcceptor = new Acceptor(Options.AcceptorConfig, this);
         
         // Init Reactors
+        ReactorConfig[] reactorConfigs = ResolveReactorConfigs();
         Reactors = new Reactor[Options.ReactorCount];
-        Connections = new Dictionary<int, Connection>[Options.ReactorCount];
         for (var i = 0; i < Options.ReactorCount; i++) 
         {
             ReactorQueues[i] = new ConcurrentQueue<int>();
-            ReactorConnectionCounts[i] = 0;
             
-            Reactors[i] = new Reactor(i, Options.ReactorConfigs[i],this);
-            Connections[i] = new Dictionary<int, Connection>(Reactors[i].Config.MaxConnectionsPerReactor);
+            Reactors[i] = new Reactor(i, reactorConfigs[i], this);
+            Reactors[i].Cpu = ResolveReactorCpu(i);
+        }
+        _sharedSqPollRing = Options.ShareSqPollThread ? new TaskCompletionSource<int>() : null;
+        StartMetrics();
+
+        if (reusePort)
+        {
+            // Listeners join the reuseport group in creation order; the CPU steering program
+            // indexes that order, so listener i is created for (and owned by) reactor i.
+            for (int i = 0; i < Options.ReactorCount; i++)
+            {
+                int lfd = Acceptor.CreateListenerSocket(Options);
+                Reactors[i].UseListener(lfd);
+                if (i == 0 && Options.ReusePortCpuSteering)
+                    Acceptor.AttachReusePortCpuSteering(lfd, Options.ReactorCount);
+            }
         }
         
         var reactorThreads = new Thread[Options.ReactorCount];
@@ -131,12 +158,13 @@ public sealed partial class Engine
                 {
                     try
                     {
+                        Reactors[wi].EnterThread();
                         Reactors[wi].InitRing();
-                        Reactors[wi].Handle();
+                        Reactors[wi].Run();
                     }
                     catch (Exception ex)
                     {
-                        Console.Error.WriteLine($"[w{wi}] crash: {ex}"); 
+                        Log(EngineLogLevel.Critical, $"w{wi}", "reactor crashed", ex);
                     }
                 })
             {
@@ -145,6 +173,12 @@ public sealed partial class Engine
             reactorThreads[i].Start();
         }
 
+        if (reusePort)
+        {
+            Log(EngineLogLevel.Information, "engine", $"server started with {Options.ReactorCount} reactors (SO_REUSEPORT accept)");
+            return;
+        }
+
         var acceptorThread = new Thread(() => 
         {
             try
@@ -154,15 +188,20 @@ public sealed partial class Engine
             }
             catch (Exception ex)
             {
-                Console.Error.WriteLine($"[acceptor] crash: {ex}"); 
+                Log(EngineLogLevel.Critical, "acceptor", "acceptor crashed", ex);
             }
         });
         acceptorThread.Start();
-        Console.WriteLine($"Server started with {Options.ReactorCount} reactors + 1 acceptor");
+        Log(EngineLogLevel.Information, "engine", $"server started with {Options.ReactorCount} reactors + 1 acceptor");
     }
     /// <summary>
     /// Signals all loops (acceptor + reactors) to exit.
     /// Threads will stop once they observe ServerRunning == false.
     /// </summary>
-    public void Stop() => ServerRunning = false;
+    public void Stop()
+    {
+        ServerRunning = false;
+        StopMetrics();
+        FileCache?.Clear();
+    }
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+using System.Net;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed partial class Engine
+{
+    /// <summary>
+    /// Opens an outbound TCP connection on the reactor with the fewest connections
+    /// (see <see cref="Reactor.ConnectAsync"/>). To relay an accepted connection, connect on its own reactor
+    /// instead: <c>connection.Reactor.ConnectAsync(remote)</c>.
+    /// </summary>
+    public Task<Connection> ConnectAsync(IPEndPoint remote)
+    {
+        Reactor[] reactors = Reactors;
+        if (reactors == null!)
+            throw new InvalidOperationException("The engine is not running.");
+
+        int best = 0;
+        for (int i = 1; i < reactors.Length; i++)
+        {
+            if (ReactorLoads.Connections(i) < ReactorLoads.Connections(best))
+                best = i;
+        }
+        return reactors[best].ConnectAsync(remote);
+    }
+}
@@ -0,0 +1,29 @@
+using System.Net;
+using zerg.Engine.Configs;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed partial class Engine
+{
+    private int _nextDatagramReactor;
+
+    /// <summary>
+    /// Opens a UDP socket bound to <paramref name="local"/> on the next reactor in turn
+    /// (see <see cref="Reactor.OpenDatagramSocket"/>). To spread one port over every reactor, open one socket
+    /// per reactor with <see cref="DatagramOptions.ReusePort"/> instead:
+    /// <c>engine.Reactors[i].OpenDatagramSocket(local, options with { ReusePort = true })</c>.
+    /// </summary>
+    public DatagramSocket OpenDatagramSocket(IPEndPoint local, DatagramOptions? options = null)
+    {
+        Reactor[] reactors = Reactors;
+        if (reactors == null!)
+            throw new InvalidOperationException("The engine is not running.");
+
+        int next = (int)((uint)Interlocked.Increment(ref _nextDatagramReactor) % (uint)reactors.Length);
+        return reactors[next].OpenDatagramSocket(local, options);
+    }
+}
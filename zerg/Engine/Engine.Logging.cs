@@ -0,0 +1,66 @@
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed partial class Engine
+{
+    /// <summary>
+    /// True when events of <paramref name="level"/> pass <see cref="EngineOptions.LogLevel"/>.
+    /// Hot paths check it before building a message.
+    /// </summary>
+    internal bool IsLogEnabled(EngineLogLevel level)
+        => level >= Options.LogLevel && level < EngineLogLevel.None;
+
+    /// <summary>
+    /// Raises a log event through <see cref="EngineOptions.LogHandler"/>, or writes it to the console
+    /// (warnings and above to stderr) when no handler is set.
+    /// </summary>
+    internal void Log(EngineLogLevel level, string source, string message, Exception? exception = null)
+    {
+        if (!IsLogEnabled(level))
+            return;
+
+        EngineLogEvent logEvent = new(level, source, message, exception);
+        Action<EngineLogEvent>? handler = Options.LogHandler;
+        if (handler == null)
+        {
+            if (level >= EngineLogLevel.Warning)
+                Console.Error.WriteLine(logEvent.ToString());
+            else
+                Console.WriteLine(logEvent.ToString());
+            return;
+        }
+
+        try
+        {
+            handler(logEvent);
+        }
+        catch
+        {
+            // A failing log sink must not take a reactor or the acceptor down.
+        }
+    }
+
+    public partial class Reactor
+    {
+        private string? _logSource;
+
+        private bool IsLogEnabled(EngineLogLevel level) => _engine.IsLogEnabled(level);
+
+        private void Log(EngineLogLevel level, string message, Exception? exception = null)
+            => _engine.Log(level, _logSource ??= $"w{Id}", message, exception);
+    }
+
+    public partial class Acceptor
+    {
+        private bool IsLogEnabled(EngineLogLevel level) => _engine.IsLogEnabled(level);
+
+        private void Log(EngineLogLevel level, string message, Exception? exception = null)
+            => _engine.Log(level, "acceptor", message, exception);
+    }
+}
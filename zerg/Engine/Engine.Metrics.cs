@@ -0,0 +1,42 @@
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed partial class Engine
+{
+    /// <summary>Instruments published on the "zerg" meter while running (see <see cref="EngineOptions.PublishMetrics"/>).</summary>
+    private EngineMetrics? _metrics;
+
+    /// <summary>
+    /// Writes a <see cref="ReactorMetrics"/> snapshot of each reactor into <paramref name="destination"/> and
+    /// returns how many were written (the reactor count, or the span length if shorter). Allocates nothing;
+    /// safe to call from any thread while the engine runs.
+    /// </summary>
+    public int GetMetrics(Span<ReactorMetrics> destination)
+    {
+        Reactor[] reactors = Reactors;
+        if (reactors == null!)
+            return 0;
+        int count = Math.Min(reactors.Length, destination.Length);
+        for (int i = 0; i < count; i++)
+            destination[i] = reactors[i].GetMetrics();
+        return count;
+    }
+
+    private void StartMetrics()
+    {
+        if (Options.PublishMetrics)
+            _metrics = new EngineMetrics(this);
+    }
+
+    private void StopMetrics()
+    {
+        _metrics?.Dispose();
+        _metrics = null;
+    }
+}
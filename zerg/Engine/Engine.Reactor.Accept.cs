@@ -0,0 +1,127 @@
+using zerg.Engine.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>
+        /// This reactor's own SO_REUSEPORT listener (<see cref="Configs.AcceptMode.ReusePort"/>), or -1
+        /// when connections are handed over by the <see cref="Acceptor"/> instead.
+        /// </summary>
+        private int _listenFd = -1;
+
+        /// <summary>
+        /// Gives this reactor its own listening socket. Must be called before <see cref="InitRing"/>;
+        /// the reactor arms multishot accept on it and owns (closes) it from then on.
+        /// </summary>
+        internal void UseListener(int listenFd) => _listenFd = listenFd;
+
+        /// <summary>
+        /// Arms multishot accept on this reactor's listener. Accepted fds (or fixed-file slots, with
+        /// direct descriptors) arrive as <see cref="UdKind.Accept"/> CQEs in this reactor's own loop.
+        /// </summary>
+        private void ArmAccept()
+        {
+            io_uring_sqe* sqe = SqeGet();
+            if (_directDescriptors)
+                shim_prep_multishot_accept_direct(sqe, _listenFd, SOCK_NONBLOCK);
+            else
+                shim_prep_multishot_accept(sqe, _listenFd, SOCK_NONBLOCK);
+            shim_sqe_set_data64(sqe, PackUd(UdKind.Accept, _listenFd));
+        }
+
+        /// <summary>
+        /// Registers a client fd handed over by the acceptor, moving it into the fixed-file table first
+        /// when this reactor uses direct descriptors.
+        /// </summary>
+        private void AdoptConnection(int fd)
+        {
+            if (_freeDirectSlots != null)
+            {
+                int slot = InstallDirectDescriptor(fd);
+                if (slot >= 0)
+                {
+                    AdoptConnection(slot, direct: true);
+                    return;
+                }
+            }
+            AdoptConnection(fd, direct: false);
+        }
+
+        /// <summary>
+        /// Registers a new client socket with this reactor (see <see cref="RegisterConnection"/>) and
+        /// publishes the connection to <see cref="AcceptAsync"/>.
+        /// <paramref name="direct"/> marks <paramref name="fd"/> as a fixed-file slot.
+        /// </summary>
+        private void AdoptConnection(int fd, bool direct)
+        {
+            Connection connection = RegisterConnection(fd, direct);
+            bool connectionAdded = _engine.ConnectionQueues.Writer.TryWrite(new ConnectionItem(connection, connection.Generation));
+            if (!connectionAdded) Log(EngineLogLevel.Error, "failed to publish connection to ConnectionQueues");
+        }
+
+        /// <summary>
+        /// Takes a pooled <see cref="Connection"/> for a connected socket, assigns it a slot and arms multishot recv.
+        /// </summary>
+        private Connection RegisterConnection(int fd, bool direct)
+        {
+            Connection connection = _connectionPool.Get()
+                .SetFd(fd, direct)
+                .SetReactor(this);
+            _connectionSlots.Add(connection);
+            // Every connection starts on the smallest recv buffer class
+            connection.RecvGroup = 0;
+            connection.RecvGroupPending = -1;
+            connection.RecvSizeEstimate = 0;
+            connection.RecvCancelInFlight = false;
+            connection.RecvHeldBuffers = 0;
+            connection.RecvHeldBytes = 0;
+            connection.RecvPaused = false;
+            connection.RecvParked = false;
+            InitConnectionTimers(connection);
+            // Queue multishot recv SQE (flushed by the loop's next submit)
+            ArmRecv(connection);
+            return connection;
+        }
+
+        /// <summary>
+        /// Handles an accept CQE from this reactor's listener: adopts the fd inline and
+        /// re-arms accept if the kernel terminated the multishot request.
+        /// </summary>
+        private void OnAccept(int res, uint cqeFlags)
+        {
+            if (res >= 0)
+            {
+                if (!_directDescriptors)
+                {
+                    int one = 1;
+                    setsockopt(res, IPPROTO_TCP, TCP_NODELAY, &one, (uint)sizeof(int));
+                }
+                Interlocked.Increment(ref _engine.ReactorLoads[Id].Connections);
+                AdoptConnection(res, _directDescriptors);
+            }
+            else if (IsLogEnabled(EngineLogLevel.Warning))
+            {
+                Log(EngineLogLevel.Warning, $"accept error: {res}");
+            }
+
+            if ((cqeFlags & IORING_CQE_F_MORE) == 0 && _engine.ServerRunning)
+                ArmAccept();
+        }
+
+        private void CloseListener()
+        {
+            if (_listenFd < 0)
+                return;
+            close(_listenFd);
+            _listenFd = -1;
+        }
+    }
+}
@@ -0,0 +1,279 @@
+using zerg.Engine.Configs;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>Upper bound on <see cref="ReactorConfig.RecvBufferClasses"/>.</summary>
+        private const int c_maxBufferGroups = 8;
+
+        /// <summary>
+        /// One provided-buffer group: a kernel buf_ring plus the slab of equally sized buffers it hands out.
+        /// Buffer ids are unique across all groups of a reactor; this group owns
+        /// [<see cref="FirstBid"/>, FirstBid + <see cref="Entries"/>).
+        /// </summary>
+        private sealed class BufferGroup
+        {
+            public BufferGroup(uint bgid, int bufferSize, int entries, int firstBid, int initialEntries, bool trackRing)
+            {
+                Bgid = bgid;
+                BufferSize = bufferSize;
+                Entries = entries;
+                FirstBid = firstBid;
+                Mask = (ushort)(entries - 1);
+                SlabSize = (nuint)entries * (nuint)bufferSize;
+                InitialEntries = Math.Clamp(initialEntries, 1, entries);
+                ParkedBids = new ushort[entries];
+                if (trackRing)
+                {
+                    RingBids = new ushort[entries];
+                    RingPositions = new uint[entries];
+                }
+            }
+
+            public readonly uint Bgid;
+            public readonly int BufferSize;
+            public readonly int Entries;
+            public readonly int FirstBid;
+            public readonly ushort Mask;
+            public readonly nuint SlabSize;
+            /// <summary>Kernel-registered buf_ring of this group.</summary>
+            public io_uring_buf_ring* Ring;
+            /// <summary>Page-aligned anonymous mapping backing the group's buffers; pages commit on first write (see <see cref="Committed"/>).</summary>
+            public byte* Slab;
+            /// <summary>Length of the mapping at <see cref="Slab"/> (<see cref="SlabSize"/> rounded up to its page size).</summary>
+            public nuint MappedLength;
+            /// <summary>
+            /// The slab's pages stay resident for the ring's lifetime (huge pages, which releasing part of
+            /// would split): trimming withdraws buffers but never releases their pages.
+            /// </summary>
+            public bool Committed;
+            /// <summary>Next position in the buf_ring.</summary>
+            public uint Index;
+
+            // Elastic publishing (see Engine.Reactor.BufferRingElastic)
+            /// <summary>Floor of <see cref="Published"/>: buffers handed to the kernel at startup.</summary>
+            public readonly int InitialEntries;
+            /// <summary>Buffers [0, Published) of the group are in circulation; the rest of the slab is untouched.</summary>
+            public int Published;
+            /// <summary>Where <see cref="Published"/> is shrinking to; returned buffers at or above it are parked.</summary>
+            public int Target;
+            /// <summary>Buffers taken by the kernel and not yet returned.</summary>
+            public int Outstanding;
+            /// <summary>Peak <see cref="Outstanding"/> since startup.</summary>
+            public int HighWater;
+            /// <summary>Peak <see cref="Outstanding"/> in the current trim window.</summary>
+            public int WindowHighWater;
+            /// <summary>Recvs of this group that ended with -ENOBUFS.</summary>
+            public long Starvations;
+            /// <summary>Returned buffers withheld from the ring while the group shrinks.</summary>
+            public readonly ushort[] ParkedBids;
+            public int ParkedCount;
+
+            /// <summary>Buffers currently available to the kernel in the buf_ring.</summary>
+            public int InRing => Published - Outstanding - ParkedCount;
+
+            // Ring shadow for recv bundles (see Engine.Reactor.Recv)
+            /// <summary>Buffer id staged at each buf_ring entry (position &amp; <see cref="Mask"/>), or null without bundles.</summary>
+            public readonly ushort[]? RingBids;
+            /// <summary>Per buffer (bid - <see cref="FirstBid"/>): buf_ring position it was last staged at.</summary>
+            public readonly uint[]? RingPositions;
+
+            /// <summary>
+            /// Stages buffer <paramref name="bid"/> at the next buf_ring position (published by the caller's
+            /// shim_buf_ring_advance), recording the position when bundles need to walk the ring.
+            /// </summary>
+            public void Add(ushort bid)
+            {
+                if (RingBids != null)
+                {
+                    RingBids[Index & Mask] = bid;
+                    RingPositions![bid - FirstBid] = Index;
+                }
+                byte* addr = Slab + (nuint)(bid - FirstBid) * (nuint)BufferSize;
+                shim_buf_ring_add(Ring, addr, (uint)BufferSize, bid, Mask, Index++);
+            }
+        }
+
+        /// <summary>Buffer groups ordered by ascending buffer size; index 0 is every connection's starting class.</summary>
+        private BufferGroup[] _bufferGroups = [];
+        /// <summary>Buffer id -> index into <see cref="_bufferGroups"/>.</summary>
+        private byte[] _bufferGroupOf = [];
+        /// <summary>Total buffers across all groups.</summary>
+        private int _bufferEntries;
+        /// <summary>Per-buffer flag: taken by the kernel (or held by a handler) and not yet returned.</summary>
+        private bool[] _bufferTaken = [];
+        /// <summary>Validated recv buffer classes, ascending by size (resolved at construction).</summary>
+        private readonly RecvBufferClass[] _recvBufferClasses;
+
+        /// <summary>
+        /// Resolves the configured recv buffer classes: <see cref="ReactorConfig.RecvBufferClasses"/> sorted by size,
+        /// or a single class of <see cref="ReactorConfig.RecvBufferSize"/> x <see cref="ReactorConfig.BufferRingEntries"/>.
+        /// </summary>
+        private static RecvBufferClass[] ResolveRecvBufferClasses(ReactorConfig config)
+        {
+            if (config.RecvBufferClasses == null || config.RecvBufferClasses.Length == 0)
+                return [new RecvBufferClass(config.RecvBufferSize, config.BufferRingEntries)];
+
+            RecvBufferClass[] classes = (RecvBufferClass[])config.RecvBufferClasses.Clone();
+            if (classes.Length > c_maxBufferGroups)
+                throw new ArgumentException($"At most {c_maxBufferGroups} recv buffer classes are supported.", nameof(config));
+
+            int total = 0;
+            foreach (RecvBufferClass cls in classes)
+            {
+                if (cls.BufferSize <= 0)
+                    throw new ArgumentException($"Recv buffer class size must be positive: {cls.BufferSize}.", nameof(config));
+                if (cls.Entries <= 0 || (cls.Entries & (cls.Entries - 1)) != 0)
+                    throw new ArgumentException($"Recv buffer class entries must be a power of two: {cls.Entries}.", nameof(config));
+                total += cls.Entries;
+            }
+            if (total > 1 << 16)
+                throw new ArgumentException($"Recv buffer classes hold {total} buffers; buffer ids are 16-bit (max 65536).", nameof(config));
+
+            Array.Sort(classes, static (a, b) => a.BufferSize.CompareTo(b.BufferSize));
+            return classes;
+        }
+
+        /// <summary>
+        /// Reserves the slabs and registers one buf_ring per recv buffer class, providing the first
+        /// <see cref="ReactorConfig.BufferRingInitialEntries"/> buffers of each to the kernel.
+        /// </summary>
+        private void InitBufferGroups(uint bufRingFlags)
+        {
+            RecvBufferClass[] classes = _recvBufferClasses;
+            _bufferGroups = new BufferGroup[classes.Length];
+
+            int firstBid = 0;
+            for (int i = 0; i < classes.Length; i++)
+            {
+                BufferGroup group = new((uint)(c_bufferRingGID + i), classes[i].BufferSize, classes[i].Entries, firstBid,
+                    Config.BufferRingInitialEntries, _recvBundles);
+                group.Ring = shim_setup_buf_ring(io_uring_instance, (uint)group.Entries, group.Bgid, bufRingFlags, out int ret);
+                if (group.Ring == null || ret < 0)
+                    throw new Exception($"setup_buf_ring failed: bgid={group.Bgid} ret={ret}");
+
+                MapRecvSlab(group);
+
+                PublishBuffers(group, group.InitialEntries);
+
+                _bufferGroups[i] = group;
+                firstBid += group.Entries;
+            }
+
+            _bufferEntries = firstBid;
+            _bufferTaken = new bool[firstBid];
+            _bufferGroupOf = new byte[firstBid];
+            for (int i = 0; i < _bufferGroups.Length; i++)
+                Array.Fill(_bufferGroupOf, (byte)i, _bufferGroups[i].FirstBid, _bufferGroups[i].Entries);
+        }
+
+        /// <summary>Start address of buffer <paramref name="bid"/>.</summary>
+        private byte* BufferAddress(ushort bid)
+        {
+            BufferGroup group = _bufferGroups[_bufferGroupOf[bid]];
+            return group.Slab + (nuint)(bid - group.FirstBid) * (nuint)group.BufferSize;
+        }
+
+        /// <summary>
+        /// Recycles pending buffer returns and unregisters the buf_rings.
+        /// Must run before the io_uring instance is destroyed.
+        /// </summary>
+        private void FreeBufferRings()
+        {
+            if (io_uring_instance == null)
+                return;
+            DrainReturnQ();
+            foreach (BufferGroup group in _bufferGroups)
+            {
+                if (group.Ring == null)
+                    continue;
+                shim_free_buf_ring(io_uring_instance, group.Ring, (uint)group.Entries, group.Bgid);
+                group.Ring = null;
+            }
+        }
+
+        /// <summary>
+        /// Unmaps the recv slabs. Must run after the io_uring instance is destroyed, so no recv can still land in them.
+        /// </summary>
+        private void FreeBufferSlabs()
+        {
+            foreach (BufferGroup group in _bufferGroups)
+            {
+                if (group.Slab == null)
+                    continue;
+                munmap(group.Slab, group.MappedLength);
+                group.Slab = null;
+            }
+        }
+
+        /// <summary>
+        /// Picks the buffer group for a connection from its smoothed recv size.
+        /// A CQE that filled its buffer counts as twice the buffer size, so a connection outgrowing
+        /// its class climbs within a few reads. Moving down needs the estimate to fit well inside
+        /// the smaller class (3/4 of it), which keeps a connection from flapping between neighbours.
+        /// </summary>
+        private int ObserveRecvSize(Connection c, int res)
+        {
+            if (_bufferGroups.Length == 1)
+                return 0;
+
+            int current = c.RecvGroup;
+            int sample = res >= _bufferGroups[current].BufferSize ? _bufferGroups[current].BufferSize * 2 : res;
+            int estimate = c.RecvSizeEstimate == 0 ? sample : (c.RecvSizeEstimate * 3 + sample) >> 2;
+            c.RecvSizeEstimate = estimate;
+
+            int fit = 0;
+            while (fit < _bufferGroups.Length - 1 && _bufferGroups[fit].BufferSize < estimate)
+                fit++;
+
+            if (fit > current)
+                return fit;
+            if (fit < current && (long)estimate * 4 <= (long)_bufferGroups[fit].BufferSize * 3)
+                return fit;
+            return current;
+        }
+
+        /// <summary>
+        /// Resident bytes of this reactor's recv buffer slabs (pages the kernel has written into and
+        /// that have not been released since), measured with mincore(2). Safe to call from any thread.
+        /// </summary>
+        public long RecvBufferResidentBytes()
+        {
+            long resident = 0;
+            foreach (BufferGroup group in _bufferGroups)
+            {
+                byte* slab = group.Slab;
+                if (slab == null)
+                    continue;
+
+                nuint pages = (group.SlabSize + PAGE_SIZE - 1) / PAGE_SIZE;
+                byte[] vec = new byte[pages];
+                fixed (byte* pVec = vec)
+                {
+                    if (mincore(slab, group.SlabSize, pVec) != 0)
+                        continue;
+                }
+                foreach (byte page in vec)
+                    resident += page & 1;
+            }
+            return resident * PAGE_SIZE;
+        }
+
+        /// <summary>Bytes of address space reserved for this reactor's recv buffer slabs.</summary>
+        public long RecvBufferReservedBytes()
+        {
+            long reserved = 0;
+            foreach (BufferGroup group in _bufferGroups)
+                reserved += (long)group.SlabSize;
+            return reserved;
+        }
+    }
+}
@@ -0,0 +1,262 @@
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>
+        /// Recvs that ended with -ENOBUFS, as (slot, generation) keys packed like their user_data.
+        /// They are re-armed once their buffer group has buffers again instead of being closed.
+        /// </summary>
+        private readonly List<ulong> _starvedRecvs = [];
+        /// <summary>A trim lowered some group's target; idle pages are released at the next quiescent point.</summary>
+        private bool _trimPending;
+        /// <summary>
+        /// Ring runs with DEFER_TASKRUN: recvs only pick and fill buffers inside this thread's io_uring_enter,
+        /// so between enters (with the CQ drained) a buffer not marked taken really holds no data.
+        /// </summary>
+        private bool _deferTaskrun;
+
+        /// <summary>
+        /// Hands the next <paramref name="count"/> unpublished buffers of a group to the kernel.
+        /// </summary>
+        private static void PublishBuffers(BufferGroup group, int count)
+        {
+            for (int n = group.Published; n < group.Published + count; n++)
+                group.Add((ushort)(group.FirstBid + n));
+            shim_buf_ring_advance(group.Ring, (uint)count);
+            group.Published += count;
+            group.Target = group.Published;
+        }
+
+        /// <summary>
+        /// Records that the kernel took buffer <paramref name="bid"/> (first CQE that reports it),
+        /// updates the occupancy high-water marks and grows the group when the ring runs low.
+        /// </summary>
+        private void TakeBuffer(ushort bid)
+        {
+            if (_bufferTaken[bid])
+                return; // incremental consumption: a later CQE of a buffer already taken
+            _bufferTaken[bid] = true;
+
+            BufferGroup group = _bufferGroups[_bufferGroupOf[bid]];
+            int outstanding = ++group.Outstanding;
+            if (outstanding > group.WindowHighWater)
+            {
+                group.WindowHighWater = outstanding;
+                if (outstanding > group.HighWater)
+                    group.HighWater = outstanding;
+            }
+
+            if (group.InRing <= group.Published >> 2)
+                GrowBufferGroup(group);
+        }
+
+        /// <summary>
+        /// Puts more buffers in circulation: first any parked by a shrink in progress,
+        /// otherwise doubles the published count (up to the group's entries).
+        /// Returns false when the group is already fully published.
+        /// </summary>
+        private static bool GrowBufferGroup(BufferGroup group)
+        {
+            int parked = group.ParkedCount;
+            if (parked > 0)
+            {
+                for (int i = 0; i < parked; i++)
+                    group.Add(group.ParkedBids[i]);
+                shim_buf_ring_advance(group.Ring, (uint)parked);
+                group.ParkedCount = 0;
+            }
+            group.Target = group.Published;
+            if (parked > 0)
+                return true;
+
+            if (group.Published == group.Entries)
+                return false;
+            PublishBuffers(group, Math.Min(group.Entries - group.Published, group.Published));
+            return true;
+        }
+
+        /// <summary>
+        /// Withholds a returned buffer above the shrink target. Once every buffer of the withdrawn
+        /// region is back, the region's pages go to the OS and the group stops publishing it.
+        /// </summary>
+        private static void ParkBuffer(BufferGroup group, ushort bid)
+        {
+            group.ParkedBids[group.ParkedCount++] = bid;
+            if (group.ParkedCount < group.Published - group.Target)
+                return;
+
+            ReleasePages(group, group.Target, group.Published);
+            group.Published = group.Target;
+            group.ParkedCount = 0;
+        }
+
+        /// <summary>
+        /// Once a second: a group whose peak occupancy over the last window stayed under a quarter of
+        /// its published buffers shrinks towards twice that peak (never below its initial entries).
+        /// Buffers above the target are parked as they come back; see <see cref="ReleaseTrimmedPages"/>
+        /// for the ones still sitting in the ring.
+        /// </summary>
+        private void TrimBufferGroups()
+        {
+            foreach (BufferGroup group in _bufferGroups)
+            {
+                int peak = group.WindowHighWater;
+                group.WindowHighWater = group.Outstanding;
+
+                if (group.Published > group.InitialEntries && peak * 4 <= group.Published)
+                    group.Target = Math.Min(group.Target, Math.Max(group.InitialEntries, peak * 2));
+
+                if (group.Target < group.Published)
+                    _trimPending = true;
+            }
+        }
+
+        /// <summary>
+        /// Drops the pages of idle buffers in every shrinking group's withdrawn region, including buffers
+        /// still in the ring, so an idle reactor gives memory back without waiting for traffic to cycle them
+        /// out. Only done when no completion can be pending (DEFER_TASKRUN ring, CQ empty, called between
+        /// batches); otherwise the region is released once all of its buffers are parked.
+        /// </summary>
+        private void ReleaseTrimmedPages()
+        {
+            if (!_deferTaskrun || shim_cq_ready(io_uring_instance) != 0)
+                return; // retry at the next quiescent point
+            _trimPending = false;
+
+            foreach (BufferGroup group in _bufferGroups)
+            {
+                if (group.Target < group.Published && !group.Committed)
+                    ReleaseIdlePages(group, group.Target, group.Published);
+            }
+        }
+
+        /// <summary>
+        /// MADV_DONTNEEDs the pages of buffers [<paramref name="from"/>, <paramref name="to"/>)
+        /// that are not held by the kernel or a handler. Pages shared with a buffer below
+        /// <paramref name="from"/> are kept.
+        /// </summary>
+        private void ReleaseIdlePages(BufferGroup group, int from, int to)
+        {
+            nuint size = (nuint)group.BufferSize;
+            nuint start = AlignUpToPage((nuint)from * size);
+            nuint end = Math.Min(AlignUpToPage((nuint)to * size), group.SlabSize);
+
+            nuint runStart = start;
+            for (nuint page = start; page < end; page += PAGE_SIZE)
+            {
+                int first = (int)(page / size);
+                int last = Math.Min(to - 1, (int)((page + PAGE_SIZE - 1) / size));
+                bool idle = true;
+                for (int n = first; n <= last; n++)
+                {
+                    if (_bufferTaken[group.FirstBid + n])
+                    {
+                        idle = false;
+                        break;
+                    }
+                }
+                if (idle)
+                    continue;
+
+                if (page > runStart)
+                    madvise(group.Slab + runStart, page - runStart, MADV_DONTNEED);
+                runStart = page + PAGE_SIZE;
+            }
+            if (end > runStart)
+                madvise(group.Slab + runStart, end - runStart, MADV_DONTNEED);
+        }
+
+        /// <summary>
+        /// Drops the pages of buffers [<paramref name="from"/>, <paramref name="to"/>), all of which are idle.
+        /// Committed (huge-page) slabs keep their pages.
+        /// </summary>
+        private static void ReleasePages(BufferGroup group, int from, int to)
+        {
+            if (group.Committed)
+                return;
+            nuint start = AlignUpToPage((nuint)from * (nuint)group.BufferSize);
+            nuint end = Math.Min(AlignUpToPage((nuint)to * (nuint)group.BufferSize), group.SlabSize);
+            if (end > start)
+                madvise(group.Slab + start, end - start, MADV_DONTNEED);
+        }
+
+        private static nuint AlignUpToPage(nuint offset) => (offset + PAGE_SIZE - 1) & ~(nuint)(PAGE_SIZE - 1);
+
+        /// <summary>
+        /// A multishot recv ended with -ENOBUFS: its group ran dry. Re-arms right away if buffers went
+        /// back into the ring since (other CQEs of the batch may already have grown the group) or the
+        /// group can grow; otherwise parks the recv until <see cref="DrainReturnQ"/> recycles buffers.
+        /// The connection stays open either way.
+        /// </summary>
+        private void OnRecvNoBuffers(Connection connection)
+        {
+            if (connection.RecvGroupPending >= 0)
+            {
+                connection.RecvGroup = connection.RecvGroupPending;
+                connection.RecvGroupPending = -1;
+            }
+
+            BufferGroup group = _bufferGroups[connection.RecvGroup];
+            group.Starvations++;
+            if (connection.RecvPaused)
+            {
+                ArmOrParkRecv(connection); // over budget anyway: wait for the handler, not for buffers
+                return;
+            }
+            if (group.InRing > group.Published >> 2 || GrowBufferGroup(group))
+            {
+                ArmRecv(connection);
+                return;
+            }
+            _starvedRecvs.Add(PackUd(UdKind.Recv, connection.Slot, connection.SlotGeneration));
+        }
+
+        /// <summary>
+        /// Re-arms starved recvs whose group has buffers in the ring again. Entries of connections
+        /// that closed in the meantime are dropped.
+        /// </summary>
+        private void RearmStarvedRecvs()
+        {
+            int kept = 0;
+            for (int i = 0; i < _starvedRecvs.Count; i++)
+            {
+                ulong key = _starvedRecvs[i];
+                Connection? connection = _connectionSlots.Get(UdSlotOf(key), UdGenerationOf(key));
+                if (connection == null)
+                    continue;
+                if (_bufferGroups[connection.RecvGroup].InRing == 0)
+                {
+                    _starvedRecvs[kept++] = key;
+                    continue;
+                }
+                ArmRecv(connection);
+            }
+            _starvedRecvs.RemoveRange(kept, _starvedRecvs.Count - kept);
+        }
+
+        /// <summary>
+        /// Occupancy of this reactor's recv buffer groups, one entry per class (ascending buffer size).
+        /// Values are written by the reactor thread; reads from other threads are a best-effort snapshot.
+        /// </summary>
+        public RecvBufferGroupStats[] GetRecvBufferStats()
+        {
+            BufferGroup[] groups = _bufferGroups;
+            RecvBufferGroupStats[] stats = new RecvBufferGroupStats[groups.Length];
+            for (int i = 0; i < groups.Length; i++)
+            {
+                BufferGroup g = groups[i];
+                stats[i] = new RecvBufferGroupStats(g.BufferSize, g.Entries, g.Published, g.Outstanding,
+                    g.HighWater, g.Starvations);
+            }
+            return stats;
+        }
+    }
+}
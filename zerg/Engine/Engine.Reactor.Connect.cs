@@ -0,0 +1,188 @@
+using System.Net;
+using System.Net.Sockets;
+using System.Runtime.InteropServices;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>An outbound connect in flight: its socket, the address the kernel reads and the waiting task.</summary>
+        private sealed class PendingConnect(Reactor reactor, int fd)
+        {
+            public readonly Reactor Reactor = reactor;
+            public readonly int Fd = fd;
+            /// <summary>sockaddr_in or sockaddr_in6 in native memory; must outlive the connect SQE.</summary>
+            public void* Address;
+            public uint AddressLength;
+            public readonly TaskCompletionSource<Connection> Completion = new(TaskCreationOptions.RunContinuationsAsynchronously);
+
+            public void FreeAddress()
+            {
+                if (Address == null)
+                    return;
+                NativeMemory.Free(Address);
+                Address = null;
+            }
+        }
+
+        private static readonly SendOrPostCallback s_startConnect = static state =>
+        {
+            PendingConnect pending = (PendingConnect)state!;
+            pending.Reactor.StartConnect(pending);
+        };
+
+        /// <summary>Connects in flight, indexed by the slot packed into their user_data.</summary>
+        private readonly List<PendingConnect?> _connects = [];
+        private readonly Stack<int> _freeConnects = new();
+
+        /// <summary>
+        /// Opens an outbound TCP connection from this reactor's ring (IORING_OP_CONNECT). The returned
+        /// connection lives on this reactor like an accepted one (multishot recv armed, same buffer rings),
+        /// but is not published to <see cref="Engine.AcceptAsync"/>. Pair it with an accepted connection through
+        /// <see cref="Connection.ProxyAsync"/> to relay between the two without copying.
+        /// Fails with a <see cref="SocketException"/> when the connect fails.
+        /// </summary>
+        public Task<Connection> ConnectAsync(IPEndPoint remote)
+        {
+            ArgumentNullException.ThrowIfNull(remote);
+            if (!_engine.ServerRunning)
+                throw new InvalidOperationException("The engine is not running.");
+
+            PendingConnect pending = CreateConnectSocket(remote);
+            Schedule(s_startConnect, pending);
+            return pending.Completion.Task;
+        }
+
+        /// <summary>Creates the non-blocking socket and the socket address for a connect to <paramref name="remote"/>.</summary>
+        private PendingConnect CreateConnectSocket(IPEndPoint remote)
+        {
+            bool v6 = remote.AddressFamily == AddressFamily.InterNetworkV6;
+            if (!v6 && remote.AddressFamily != AddressFamily.InterNetwork)
+                throw new ArgumentException($"Unsupported address family: {remote.AddressFamily}", nameof(remote));
+
+            int fd = socket(v6 ? AF_INET6 : AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0)
+                throw new SocketException((int)ToSocketError(Marshal.GetLastPInvokeError()));
+
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, (uint)sizeof(int));
+
+            PendingConnect pending = new(this, fd);
+            if (v6)
+            {
+                sockaddr_in6* addr6 = (sockaddr_in6*)NativeMemory.AllocZeroed((nuint)sizeof(sockaddr_in6));
+                addr6->sin6_family = (ushort)AF_INET6;
+                addr6->sin6_port = Htons((ushort)remote.Port);
+                addr6->sin6_scope_id = (uint)remote.Address.ScopeId;
+                remote.Address.TryWriteBytes(new Span<byte>(&addr6->sin6_addr, 16), out _);
+                pending.Address = addr6;
+                pending.AddressLength = (uint)sizeof(sockaddr_in6);
+            }
+            else
+            {
+                sockaddr_in* addr = (sockaddr_in*)NativeMemory.AllocZeroed((nuint)sizeof(sockaddr_in));
+                addr->sin_family = (ushort)AF_INET;
+                addr->sin_port = Htons((ushort)remote.Port);
+                remote.Address.TryWriteBytes(new Span<byte>(&addr->sin_addr, 4), out _);
+                pending.Address = addr;
+                pending.AddressLength = (uint)sizeof(sockaddr_in);
+            }
+            return pending;
+        }
+
+        /// <summary>Queues the connect SQE (reactor thread).</summary>
+        private void StartConnect(PendingConnect pending)
+        {
+            if (!_engine.ServerRunning)
+            {
+                FailConnect(pending, -ECANCELED);
+                return;
+            }
+
+            int index;
+            if (_freeConnects.Count != 0)
+            {
+                index = _freeConnects.Pop();
+                _connects[index] = pending;
+            }
+            else
+            {
+                index = _connects.Count;
+                _connects.Add(pending);
+            }
+
+            io_uring_sqe* sqe = SqeGet();
+            shim_prep_connect(sqe, pending.Fd, pending.Address, pending.AddressLength);
+            shim_sqe_set_data64(sqe, PackUd(UdKind.Connect, index));
+        }
+
+        /// <summary>
+        /// Connect CQE: registers the connected socket (in a fixed-file slot when this reactor hands them out)
+        /// and completes the waiting <see cref="ConnectAsync"/>, or fails it with the errno.
+        /// </summary>
+        private void OnConnect(int index, int res)
+        {
+            PendingConnect? pending = _connects[index];
+            if (pending == null)
+                return;
+            _connects[index] = null;
+            _freeConnects.Push(index);
+
+            if (res < 0)
+            {
+                FailConnect(pending, res);
+                return;
+            }
+            pending.FreeAddress();
+
+            int slot = _freeDirectSlots != null ? InstallDirectDescriptor(pending.Fd) : -1;
+            Connection connection = slot >= 0
+                ? RegisterConnection(slot, direct: true)
+                : RegisterConnection(pending.Fd, direct: false);
+            Interlocked.Increment(ref _engine.ReactorLoads[Id].Connections);
+            pending.Completion.TrySetResult(connection);
+        }
+
+        private static void FailConnect(PendingConnect pending, int res)
+        {
+            pending.FreeAddress();
+            close(pending.Fd);
+            pending.Completion.TrySetException(new SocketException((int)ToSocketError(-res)));
+        }
+
+        /// <summary>Fails the connects still in flight at shutdown; their sockets are closed.</summary>
+        private void AbortConnects()
+        {
+            for (int i = 0; i < _connects.Count; i++)
+            {
+                PendingConnect? pending = _connects[i];
+                if (pending == null)
+                    continue;
+                _connects[i] = null;
+                FailConnect(pending, -ECANCELED);
+            }
+        }
+
+        /// <summary>Maps the errno of a failed socket or connect to its <see cref="SocketError"/>.</summary>
+        private static SocketError ToSocketError(int errno) => errno switch
+        {
+            111 => SocketError.ConnectionRefused,
+            110 => SocketError.TimedOut,
+            104 => SocketError.ConnectionReset,
+            101 => SocketError.NetworkUnreachable,
+            113 => SocketError.HostUnreachable,
+            99  => SocketError.AddressNotAvailable,
+            24 or 23 => SocketError.TooManyOpenSockets,
+            ENOBUFS => SocketError.NoBufferSpaceAvailable,
+            ECANCELED => SocketError.OperationAborted,
+            _ => SocketError.SocketError,
+        };
+    }
+}
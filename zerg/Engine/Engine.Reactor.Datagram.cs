@@ -0,0 +1,420 @@
+using System.Net;
+using System.Net.Sockets;
+using System.Runtime.InteropServices;
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>
+        /// Smallest recv buffer UDP_GRO is enabled with: a coalesced batch carries up to 64 KB of payload,
+        /// and a batch that does not fit is truncated (and dropped).
+        /// </summary>
+        private const int c_groMinBufferSize = 64 * 1024;
+        /// <summary>Bytes reserved for the source address in each recv buffer (sockaddr_in6, padded to 8).</summary>
+        private const int c_datagramNameSpace = 32;
+
+        // user_data slot of a datagram operation: (table index << 12) | (send batch << 2) | op
+        private const int c_datagramRecv = 0;
+        private const int c_datagramSend = 1;
+
+        private static readonly SendOrPostCallback s_beginDatagram = static state =>
+        {
+            DatagramSocket socket = (DatagramSocket)state!;
+            socket.Reactor.BeginDatagram(socket);
+        };
+
+        private static readonly SendOrPostCallback s_flushDatagram = static state =>
+        {
+            DatagramSocket socket = (DatagramSocket)state!;
+            socket.Reactor.StartDatagramFlush(socket);
+        };
+
+        private static readonly SendOrPostCallback s_closeDatagram = static state =>
+        {
+            DatagramSocket socket = (DatagramSocket)state!;
+            socket.Reactor.CloseDatagram(socket, 0);
+        };
+
+        /// <summary>Open datagram sockets, indexed by <see cref="DatagramSocket.Index"/>.</summary>
+        private readonly List<DatagramSocket?> _datagrams = [];
+        private readonly Stack<int> _freeDatagrams = new();
+        private uint _datagramGeneration;
+        /// <summary>Datagram sockets whose recv ran out of buffers, re-armed by <see cref="RearmStarvedDatagrams"/>.</summary>
+        private readonly List<DatagramSocket> _starvedDatagrams = [];
+
+        /// <summary>
+        /// Opens a UDP socket bound to <paramref name="local"/> and served by this reactor: a multishot recvmsg
+        /// on its largest recv buffer class (with UDP_GRO when those buffers can hold a coalesced batch) and
+        /// segmented (GSO) sends. Port 0 binds an ephemeral port, see <see cref="DatagramSocket.LocalEndPoint"/>.
+        /// Fails with a <see cref="SocketException"/> when the socket cannot be created or bound.
+        /// Not available with <see cref="ReactorConfig.IncrementalBufferConsumption"/>.
+        /// </summary>
+        public DatagramSocket OpenDatagramSocket(IPEndPoint local, DatagramOptions? options = null)
+        {
+            ArgumentNullException.ThrowIfNull(local);
+            options ??= new DatagramOptions();
+            if (!_engine.ServerRunning)
+                throw new InvalidOperationException("The engine is not running.");
+            if (Config.IncrementalBufferConsumption)
+                throw new NotSupportedException("Datagram sockets need whole recv buffers; incremental buffer consumption is enabled.");
+            if (options.ReceiveQueueCapacity <= 0 || (options.ReceiveQueueCapacity & (options.ReceiveQueueCapacity - 1)) != 0)
+                throw new ArgumentException($"ReceiveQueueCapacity must be a power of two: {options.ReceiveQueueCapacity}.", nameof(options));
+            if (options.MaxSendBatches is <= 0 or > 1024)
+                throw new ArgumentException($"MaxSendBatches must be in [1, 1024]: {options.MaxSendBatches}.", nameof(options));
+            if (options.SendBufferSize <= 0)
+                throw new ArgumentException($"SendBufferSize must be positive: {options.SendBufferSize}.", nameof(options));
+
+            bool v6 = local.AddressFamily == AddressFamily.InterNetworkV6;
+            if (!v6 && local.AddressFamily != AddressFamily.InterNetwork)
+                throw new ArgumentException($"Unsupported address family: {local.AddressFamily}", nameof(local));
+
+            // Blocking: io_uring waits for readiness itself instead of completing sends with -EAGAIN.
+            int fd = socket(v6 ? AF_INET6 : AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+            if (fd < 0)
+                throw new SocketException((int)ToSocketError(Marshal.GetLastPInvokeError()));
+
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, (uint)sizeof(int));
+            if (options.ReusePort)
+                setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, (uint)sizeof(int));
+
+            byte* address = stackalloc byte[DatagramPeer.MaxLength];
+            uint length = (uint)DatagramPeer.FromEndPoint(local).CopyTo(address);
+            if (bind(fd, (sockaddr_in6*)address, length) < 0)
+            {
+                int errno = Marshal.GetLastPInvokeError();
+                close(fd);
+                throw new SocketException((int)ToSocketError(errno));
+            }
+            length = DatagramPeer.MaxLength;
+            getsockname(fd, address, &length);
+            IPEndPoint bound = new DatagramPeer(address, (int)length).ToEndPoint();
+
+            DatagramSocket datagramSocket = new(this, fd, bound, options);
+            Schedule(s_beginDatagram, datagramSocket);
+            return datagramSocket;
+        }
+
+        /// <summary>Queues the flush of <paramref name="socket"/>'s send batches (any thread).</summary>
+        internal void FlushDatagramSocket(DatagramSocket socket) => Schedule(s_flushDatagram, socket);
+
+        /// <summary>Queues the close of <paramref name="socket"/> (any thread).</summary>
+        internal void CloseDatagramSocket(DatagramSocket socket) => Schedule(s_closeDatagram, socket);
+
+        /// <summary>
+        /// Registers the socket and arms its recv on the largest buffer class, enabling UDP_GRO when requested
+        /// and those buffers can take a coalesced batch.
+        /// </summary>
+        private void BeginDatagram(DatagramSocket socket)
+        {
+            if (socket.Closing)
+                return; // closed before it started
+            if (!_engine.ServerRunning)
+            {
+                CloseDatagram(socket, -ECANCELED);
+                return;
+            }
+
+            socket.Generation = ++_datagramGeneration & UdGenerationMask;
+            if (_freeDatagrams.Count != 0)
+            {
+                socket.Index = _freeDatagrams.Pop();
+                _datagrams[socket.Index] = socket;
+            }
+            else
+            {
+                socket.Index = _datagrams.Count;
+                _datagrams.Add(socket);
+            }
+
+            socket.RecvGroup = _bufferGroups.Length - 1;
+            socket.RecvNameSpace = c_datagramNameSpace;
+            socket.RecvControlSpace = 0;
+            if (socket.Options.Gro && _bufferGroups[socket.RecvGroup].BufferSize >= c_groMinBufferSize)
+            {
+                int one = 1;
+                if (setsockopt(socket.Fd, SOL_UDP, UDP_GRO, &one, (uint)sizeof(int)) == 0)
+                    socket.RecvControlSpace = CmsgSpace(sizeof(int));
+                else if (IsLogEnabled(EngineLogLevel.Debug))
+                    Log(EngineLogLevel.Debug, $"UDP_GRO unavailable on datagram socket {socket.Index}");
+            }
+            socket.RecvMsg->msg_namelen = (uint)socket.RecvNameSpace;
+            socket.RecvMsg->msg_controllen = (nuint)socket.RecvControlSpace;
+            ArmDatagramRecv(socket);
+        }
+
+        private static ulong DatagramUd(DatagramSocket socket, int batch, int op)
+            => PackUd(UdKind.Datagram, (socket.Index << 12) | (batch << 2) | op, socket.Generation);
+
+        private void ArmDatagramRecv(DatagramSocket socket)
+        {
+            io_uring_sqe* sqe = SqeGet();
+            shim_prep_recvmsg_multishot_select(sqe, socket.Fd, socket.RecvMsg, _bufferGroups[socket.RecvGroup].Bgid, 0);
+            shim_sqe_set_data64(sqe, DatagramUd(socket, 0, c_datagramRecv));
+            socket.RecvArmed = true;
+        }
+
+        /// <summary>
+        /// Completion of a datagram socket's recv or of one of its send batches. A stale CQE (socket gone)
+        /// only gives back its buffer.
+        /// </summary>
+        private void OnDatagram(int slot, uint generation, int res, uint cqeFlags)
+        {
+            int index = slot >> 12;
+            DatagramSocket? socket = (uint)index < (uint)_datagrams.Count ? _datagrams[index] : null;
+            if (socket == null || socket.Generation != generation)
+            {
+                if ((cqeFlags & IORING_CQE_F_BUFFER) != 0)
+                {
+                    ushort bid = (ushort)(cqeFlags >> IORING_CQE_BUFFER_SHIFT);
+                    TakeBuffer(bid);
+                    ReturnBufferRing(bid);
+                }
+                return;
+            }
+
+            if ((slot & 3) == c_datagramSend)
+                OnDatagramSent(socket, (slot >> 2) & 1023, res);
+            else
+                OnDatagramRecv(socket, res, cqeFlags);
+        }
+
+        /// <summary>
+        /// Multishot recvmsg CQE: queues the buffer for the handler (or recycles it), then handles the end of
+        /// the recv: re-armed, parked while its buffer class is dry, or the socket closes on an error.
+        /// </summary>
+        private void OnDatagramRecv(DatagramSocket socket, int res, uint cqeFlags)
+        {
+            if ((cqeFlags & IORING_CQE_F_BUFFER) != 0)
+            {
+                ushort bid = (ushort)(cqeFlags >> IORING_CQE_BUFFER_SHIFT);
+                TakeBuffer(bid);
+                if (res <= 0 || socket.Closing || !QueueDatagram(socket, bid, res))
+                    ReturnBufferRing(bid);
+            }
+            if ((cqeFlags & IORING_CQE_F_MORE) != 0)
+                return;
+
+            socket.RecvArmed = false;
+            if (socket.Closing)
+            {
+                TryFinishDatagram(socket);
+                return;
+            }
+            if (res == -ENOBUFS)
+            {
+                OnDatagramNoBuffers(socket);
+                return;
+            }
+            if (res < 0)
+            {
+                if (IsLogEnabled(EngineLogLevel.Debug))
+                    Log(EngineLogLevel.Debug, $"datagram socket {socket.Index} recv failed: {res}");
+                CloseDatagram(socket, res);
+                return;
+            }
+            ArmDatagramRecv(socket);
+        }
+
+        /// <summary>
+        /// Parses the <see cref="io_uring_recvmsg_out"/> layout of a filled buffer (header, source address,
+        /// control data, payload) and queues it. False when it is dropped: truncated, or the queue is full.
+        /// </summary>
+        private bool QueueDatagram(DatagramSocket socket, ushort bid, int res)
+        {
+            byte* buffer = BufferAddress(bid);
+            io_uring_recvmsg_out* header = (io_uring_recvmsg_out*)buffer;
+            int offset = sizeof(io_uring_recvmsg_out) + socket.RecvNameSpace + socket.RecvControlSpace;
+            if ((header->flags & MSG_TRUNC) != 0 || res < offset)
+            {
+                socket.CountTruncated();
+                return false;
+            }
+
+            int length = res - offset;
+            int segment = 0;
+            if (socket.RecvControlSpace != 0)
+            {
+                byte* control = buffer + sizeof(io_uring_recvmsg_out) + socket.RecvNameSpace;
+                segment = GroSegmentSize(control, (int)Math.Min(header->controllen, (uint)socket.RecvControlSpace));
+                if (segment >= length)
+                    segment = 0;
+            }
+
+            DatagramSocket.DatagramItem item = new()
+            {
+                Payload = buffer + offset,
+                Length = length,
+                SegmentSize = segment,
+                BufferId = bid,
+                Peer = new DatagramPeer(buffer + sizeof(io_uring_recvmsg_out), (int)Math.Min(header->namelen, (uint)socket.RecvNameSpace)),
+            };
+            return socket.TryEnqueue(item, segment == 0 ? 1 : (length + segment - 1) / segment);
+        }
+
+        /// <summary>Segment size of a GRO-coalesced recv (its SOL_UDP/UDP_GRO control message), or 0.</summary>
+        private static int GroSegmentSize(byte* control, int length)
+        {
+            int offset = 0;
+            while (offset + sizeof(cmsghdr) <= length)
+            {
+                cmsghdr* cmsg = (cmsghdr*)(control + offset);
+                int cmsgLength = (int)cmsg->cmsg_len;
+                if (cmsgLength < sizeof(cmsghdr))
+                    break;
+                if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO && cmsgLength >= CmsgLen(sizeof(int)))
+                    return *(int*)(cmsg + 1);
+                offset += (cmsgLength + 7) & ~7;
+            }
+            return 0;
+        }
+
+        /// <summary>
+        /// The recv's buffer class ran dry: re-arms right away if it has (or can publish) buffers again,
+        /// otherwise waits for <see cref="DrainReturnQ"/> to recycle some. The socket stays open either way.
+        /// </summary>
+        private void OnDatagramNoBuffers(DatagramSocket socket)
+        {
+            BufferGroup group = _bufferGroups[socket.RecvGroup];
+            group.Starvations++;
+            if (group.InRing > group.Published >> 2 || GrowBufferGroup(group))
+            {
+                ArmDatagramRecv(socket);
+                return;
+            }
+            socket.RecvStarved = true;
+            _starvedDatagrams.Add(socket);
+        }
+
+        /// <summary>Re-arms starved datagram recvs whose buffer class has buffers in the ring again.</summary>
+        private void RearmStarvedDatagrams()
+        {
+            int kept = 0;
+            for (int i = 0; i < _starvedDatagrams.Count; i++)
+            {
+                DatagramSocket socket = _starvedDatagrams[i];
+                if (!socket.RecvStarved)
+                    continue; // closed meanwhile
+                if (_bufferGroups[socket.RecvGroup].InRing == 0)
+                {
+                    _starvedDatagrams[kept++] = socket;
+                    continue;
+                }
+                socket.RecvStarved = false;
+                ArmDatagramRecv(socket);
+            }
+            _starvedDatagrams.RemoveRange(kept, _starvedDatagrams.Count - kept);
+        }
+
+        /// <summary>Submits one sendmsg per queued batch (reactor thread).</summary>
+        private void StartDatagramFlush(DatagramSocket socket)
+        {
+            if (socket.Index < 0 || socket.Closing)
+            {
+                socket.AbandonFlush();
+                return;
+            }
+            int batches = socket.FlushBatches;
+            for (int i = 0; i < batches; i++)
+                SubmitDatagramSend(socket, i);
+            socket.SendsInFlight = batches;
+        }
+
+        private void SubmitDatagramSend(DatagramSocket socket, int batch)
+        {
+            io_uring_sqe* sqe = SqeGet();
+            shim_prep_sendmsg(sqe, socket.Fd, socket.BatchHeader(batch), 0);
+            shim_sqe_set_data64(sqe, DatagramUd(socket, batch, c_datagramSend));
+        }
+
+        /// <summary>
+        /// Send batch CQE: accounts it (resending a rejected segmented batch datagram by datagram) and
+        /// completes the flush once the last batch is done.
+        /// </summary>
+        private void OnDatagramSent(DatagramSocket socket, int batch, int res)
+        {
+            if (res < 0 && IsLogEnabled(EngineLogLevel.Debug))
+                Log(EngineLogLevel.Debug, $"datagram socket {socket.Index} send failed: {res}");
+            if (socket.OnBatchSent(batch, res) && !socket.Closing)
+            {
+                SubmitDatagramSend(socket, batch);
+                return;
+            }
+            if (--socket.SendsInFlight != 0)
+                return;
+            socket.CompleteFlush();
+            if (socket.Closing)
+                TryFinishDatagram(socket);
+        }
+
+        /// <summary>
+        /// Starts closing a datagram socket: wakes its handler and cancels the recv. The fd closes once the
+        /// recv has terminated and the sends in flight have completed.
+        /// </summary>
+        private void CloseDatagram(DatagramSocket socket, int error)
+        {
+            if (socket.Closing)
+                return;
+            socket.Closing = true;
+            socket.RecvStarved = false;
+            socket.MarkClosed(error);
+            if (socket.RecvArmed)
+            {
+                io_uring_sqe* sqe = SqeGet();
+                shim_prep_cancel64(sqe, DatagramUd(socket, 0, c_datagramRecv), 0);
+                shim_sqe_set_data64(sqe, PackUd(UdKind.Cancel, -1, 0)); // resolves to no connection
+            }
+            TryFinishDatagram(socket);
+        }
+
+        private void TryFinishDatagram(DatagramSocket socket)
+        {
+            if (!socket.RecvArmed && socket.SendsInFlight == 0)
+                FinishDatagram(socket);
+        }
+
+        /// <summary>Unregisters the socket, closes its fd and drops the reactor's hold on its native memory.</summary>
+        private void FinishDatagram(DatagramSocket socket)
+        {
+            if (socket.Index >= 0)
+            {
+                _datagrams[socket.Index] = null;
+                _freeDatagrams.Push(socket.Index);
+                socket.Index = -1;
+            }
+            close(socket.Fd);
+            socket.Release();
+        }
+
+        /// <summary>Closes the datagram sockets still open at shutdown; flushes in flight complete as failed.</summary>
+        private void AbortDatagrams()
+        {
+            for (int i = 0; i < _datagrams.Count; i++)
+            {
+                DatagramSocket? socket = _datagrams[i];
+                if (socket == null)
+                    continue;
+                socket.Closing = true;
+                socket.RecvArmed = false;
+                socket.MarkClosed(-ECANCELED);
+                if (socket.SendsInFlight != 0)
+                {
+                    socket.SendsInFlight = 0;
+                    socket.AbandonFlush();
+                }
+                FinishDatagram(socket);
+            }
+            _starvedDatagrams.Clear();
+        }
+    }
+}
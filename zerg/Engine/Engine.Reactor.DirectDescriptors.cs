@@ -0,0 +1,103 @@
+using zerg.Engine.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>True once this reactor's fixed-file table is registered.</summary>
+        private bool _directDescriptors;
+        /// <summary>
+        /// Stack of free fixed-file slots for connections handed over by the acceptor. Null on reactors that
+        /// accept directly, where the kernel allocates the slots (IORING_FILE_INDEX_ALLOC).
+        /// A slot is pushed back only when the close of its previous socket has completed.
+        /// </summary>
+        private int[]? _freeDirectSlots;
+        private int _freeDirectSlotCount;
+
+        /// <summary>
+        /// True when client sockets of this reactor are direct descriptors
+        /// (<see cref="Configs.ReactorConfig.DirectDescriptors"/> requested and the table registered).
+        /// </summary>
+        public bool DirectDescriptors => _directDescriptors;
+
+        /// <summary>
+        /// Registers the sparse fixed-file table, one slot per connection. If registration fails the
+        /// reactor keeps using plain fds.
+        /// </summary>
+        private void InitDirectDescriptors()
+        {
+            if (!Config.DirectDescriptors)
+                return;
+
+            int slots = Config.MaxConnectionsPerReactor;
+            int rc = shim_register_files_sparse(io_uring_instance, (uint)slots);
+            if (rc < 0)
+            {
+                Log(EngineLogLevel.Warning, $"register_files_sparse failed: {rc}, using plain fds");
+                return;
+            }
+            _directDescriptors = true;
+
+            if (_listenFd >= 0)
+            {
+                // A direct descriptor cannot be passed to setsockopt; accepted sockets inherit TCP_NODELAY.
+                int one = 1;
+                setsockopt(_listenFd, IPPROTO_TCP, TCP_NODELAY, &one, (uint)sizeof(int));
+                return;
+            }
+
+            _freeDirectSlots = new int[slots];
+            for (int i = 0; i < slots; i++)
+                _freeDirectSlots[i] = slots - 1 - i; // pop low slots first
+            _freeDirectSlotCount = slots;
+        }
+
+        /// <summary>
+        /// Moves a socket handed over by the acceptor into a free fixed-file slot and closes its plain fd.
+        /// Returns the slot, or -1 (the socket keeps its plain fd) when no slot is free or the update fails.
+        /// </summary>
+        private int InstallDirectDescriptor(int fd)
+        {
+            if (_freeDirectSlotCount == 0)
+                return -1;
+            int slot = _freeDirectSlots![--_freeDirectSlotCount];
+            int rc = shim_register_file_slot(io_uring_instance, (uint)slot, fd);
+            if (rc < 0)
+            {
+                _freeDirectSlots[_freeDirectSlotCount++] = slot;
+                return -1;
+            }
+            close(fd);
+            return slot;
+        }
+
+        /// <summary>
+        /// Queues an IORING_OP_CLOSE of a connection's fixed-file slot. It runs after the cancel of the
+        /// connection's recv queued just before it.
+        /// </summary>
+        private void CloseDirectDescriptor(int slot)
+        {
+            io_uring_sqe* sqe = SqeGet();
+            shim_prep_close_direct(sqe, (uint)slot);
+            shim_sqe_set_data64(sqe, PackUd(UdKind.Close, slot));
+        }
+
+        /// <summary>
+        /// Close CQE of a fixed-file slot: the slot is free again. Kernel-allocated slots need no bookkeeping.
+        /// </summary>
+        private void OnCloseDirect(int slot, int res)
+        {
+            if (res < 0 && IsLogEnabled(EngineLogLevel.Warning))
+                Log(EngineLogLevel.Warning, $"close of direct descriptor {slot} failed: {res}");
+            if (_freeDirectSlots != null)
+                _freeDirectSlots[_freeDirectSlotCount++] = slot;
+        }
+    }
+}
@@ -1,144 +1,111 @@
 using System.Collections.Concurrent;
 using System.Runtime.InteropServices;
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
 using static zerg.ABI.ABI;
 
 namespace zerg.Engine;
 
 public sealed unsafe partial class Engine {
     public partial class Reactor {
+        /// <summary>Runs the event loop selected by <see cref="ReactorConfig.Loop"/> until the engine stops.</summary>
+        internal void Run() {
+            switch (Config.Loop) {
+                case ReactorLoop.SubmitAndWaitCqe:
+                    HandleSubmitAndWaitCqe();
+                    break;
+                case ReactorLoop.SubmitAndWaitSingleCall:
+                    HandleSubmitAndWaitSingleCall();
+                    break;
+                default:
+                    Handle();
+                    break;
+            }
+        }
+
         internal void Handle() {
-            Dictionary<int, Connection> connections = _engine.Connections[Id];
+            ConnectionSlotTable connections = _connectionSlots;
             ConcurrentQueue<int> reactorQueue = ReactorQueues[Id];
-            io_uring_cqe*[] cqes = new io_uring_cqe*[Config.BatchCqes];
+            shim_cqe* cqes = (shim_cqe*)NativeMemory.Alloc((nuint)Config.BatchCqes, (nuint)sizeof(shim_cqe));
             
             try {
-                io_uring_cqe* cqe;
+                shim_cqe* cqe;
                 __kernel_timespec ts;
                 ts.tv_sec  = 0;
                 ts.tv_nsec = Config.CqTimeout;
+                __kernel_timespec noWait = default; // scheduled work pending: poll instead of sleeping
                 while (_engine.ServerRunning) {
-                    while (reactorQueue.TryDequeue(out int newFd)) {
-                        connections[newFd] = _engine.ConnectionPool.Get()
-                            .SetFd(newFd)
-                            .SetReactor(_engine.Reactors[Id]);
-                        // Queue multishot recv SQE (will be flushed by submit_and_wait_timeout)
-                        ArmRecvMultishot(io_uring_instance, newFd, c_bufferRingGID);
-                        bool connectionAdded = _engine.ConnectionQueues.Writer.TryWrite(new ConnectionItem(Id, newFd));
-                        if (!connectionAdded) Console.WriteLine("Failed to write connection!!");
-                    }
+                    ResetWakeup();
+                    RunScheduledWork();
+                    while (reactorQueue.TryDequeue(out int newFd))
+                        AdoptConnection(newFd);
                     DrainReturnQ();
                     DrainFlushQ();
-                    int got;
-                    fixed (io_uring_cqe** pC = cqes) {
-                        got = shim_peek_batch_cqe(io_uring_instance, pC, (uint)Config.BatchCqes);
-                        if (got == 0) {
-                            int rc = shim_submit_and_wait_timeout(io_uring_instance, pC, 1u, &ts);
-                            if (rc < 0) continue;
-                            got = shim_peek_batch_cqe(io_uring_instance, pC, (uint)Config.BatchCqes);
+                    int got = shim_harvest_cqes(io_uring_instance, cqes, (uint)Config.BatchCqes);
+                    if (got == 0) {
+                        __kernel_timespec* timeout = BeginIdleWait(&ts, &noWait);
+                        if (timeout != null) {
+                            io_uring_cqe* waitCqe;
+                            int rc = shim_submit_and_wait_timeout(io_uring_instance, &waitCqe, 1u, timeout);
+                            EndKernelWait();
+                            if (rc < 0) { AccountCqes(0); continue; }
                         }
+                        got = shim_harvest_cqes(io_uring_instance, cqes, (uint)Config.BatchCqes);
                     }
+                    AccountCqes(got);
 
                     for (int i = 0; i < got; i++) {
-                        cqe = cqes[i];
-                        ulong ud = shim_cqe_get_data64(cqe);
+                        cqe = cqes + i;
+                        ulong ud = cqe->user_data;
                         UdKind kind = UdKindOf(ud);
                         int res = cqe->res;
                         if (kind == UdKind.Recv) {
-                            int fd = UdFdOf(ud);
-                            bool hasBuffer = shim_cqe_has_buffer(cqe) != 0;
-                            bool hasMore   = (cqe->flags & IORING_CQE_F_MORE) != 0;
-                            if (res <= 0) {
-                                if (hasBuffer) {
-                                    ushort bufferId = (ushort)shim_cqe_buffer_id(cqe);
-                                    if (_incrementalBuffers) {
-                                        _bufferKernelDone![bufferId] = true;
-                                        if (_bufferRefCounts![bufferId] > 0)
-                                            goto skipReturnError; // outstanding RingItems will return it
-                                    }
-                                    byte* addr = _bufferRingSlab + (nuint)bufferId * (nuint)Config.RecvBufferSize;
-                                    ReturnBufferRing(addr, bufferId);
-                                    skipReturnError:;
-                                }
-                                if (connections.Remove(fd, out var connection)) {
-                                    connection.MarkClosed(res);
-                                    _engine.ConnectionPool.Return(connection);
-                                    SubmitCancelRecv(io_uring_instance, fd);
-                                    close(fd);
-                                }
-                                continue;
-                            }
-                            if (!hasBuffer) continue;
-                            ushort bid = (ushort)shim_cqe_buffer_id(cqe);
-                            byte* ptr;
-                            if (_incrementalBuffers) {
-                                bool bufMore = (cqe->flags & IORING_CQE_F_BUF_MORE) != 0;
-                                ptr = _bufferRingSlab + (nuint)bid * (nuint)Config.RecvBufferSize + (nuint)_bufferOffsets![bid];
-                                _bufferOffsets[bid] += res;
-                                _bufferRefCounts![bid]++;
-                                if (!bufMore)
-                                    _bufferKernelDone![bid] = true;
-                            } else {
-                                ptr = _bufferRingSlab + (nuint)bid * (nuint)Config.RecvBufferSize;
-                            }
-                            if (connections.TryGetValue(fd, out var connection2)) {
-                                connection2.EnqueueRingItem(ptr, res, bid);
-                                if (!hasMore) {
-                                    ArmRecvMultishot(io_uring_instance, fd, c_bufferRingGID);
-                                }
-                            } else {
-                                if (_incrementalBuffers) {
-                                    // No connection: mark kernel done and check if we can return immediately
-                                    _bufferKernelDone![bid] = true;
-                                    if (--_bufferRefCounts![bid] > 0)
-                                        continue; // other RingItems still hold refs
-                                }
-                                ReturnBufferRing(_bufferRingSlab + (nuint)bid * (nuint)Config.RecvBufferSize, bid);
-                            }
+                            OnRecv(connections.Get(UdSlotOf(ud), UdGenerationOf(ud)), res, cqe->flags);
                         } else if (kind == UdKind.Send) {
-                            int fd = UdFdOf(ud);
-                            if (connections.TryGetValue(fd, out var connection)) {
-                                if (res <= 0) {
-                                    // error/close handling
-                                    Volatile.Write(ref connection.SendInflight, 0);
-                                    continue;
-                                }
-                                connection.WriteHead += res;
-                                int target = connection.WriteInFlight;
-                                // Still flushing target snapshot
-                                if (connection.WriteHead < target) {
-                                    // Correct: len is total-end (target), not remaining
-                                    SubmitSend(io_uring_instance, fd, connection.WriteBuffer, (uint)connection.WriteHead, (uint)target);
-                                    continue;
-                                }
-                                Volatile.Write(ref connection.SendInflight, 0); // Flush batch done
-                                connection.WriteInFlight = 0;
-                                connection.ResetWriteBuffer(); // safe because _flushInProgress forbids concurrent writes
-                                if (connection.IsFlushInProgress) connection.CompleteFlush();
-                            }
-                        } else if (kind == UdKind.Cancel) { }
+                            OnSend(connections.Get(UdSlotOf(ud), UdGenerationOf(ud)), res);
+                        } else if (kind == UdKind.Accept) {
+                            OnAccept(res, cqe->flags);
+                        } else if (kind == UdKind.SendZc) {
+                            OnSendZeroCopy(ud, res, cqe->flags);
+                        } else if (kind == UdKind.Wakeup) {
+                            OnWakeup(cqe->flags);
+                        } else if (kind == UdKind.Cancel) {
+                            OnRecvCancel(connections.Get(UdSlotOf(ud), UdGenerationOf(ud)));
+                        } else if (kind == UdKind.Close) {
+                            OnCloseDirect(UdFdOf(ud), res);
+                        } else if (kind == UdKind.Relay) {
+                            OnRelay(UdSlotOf(ud), UdGenerationOf(ud), res);
+                        } else if (kind == UdKind.Connect) {
+                            OnConnect(UdFdOf(ud), res);
+                        } else if (kind == UdKind.Datagram) {
+                            OnDatagram(UdSlotOf(ud), UdGenerationOf(ud), res, cqe->flags);
+                        } else if (kind == UdKind.SendFile) {
+                            OnFileSend(UdSlotOf(ud), UdGenerationOf(ud), res);
+                        }
                     }
-                    shim_cq_advance(io_uring_instance, (uint)got);
                 }
             }finally {
                 // Close any remaining connections
                 CloseAll(connections);
-                // Free buffer ring BEFORE destroying the ring
-                if (io_uring_instance != null && _bufferRing != null) {
-                    DrainReturnQ();
-                    shim_free_buf_ring(io_uring_instance, _bufferRing, (uint)Config.BufferRingEntries, c_bufferRingGID);
-                    _bufferRing = null;
-                }
+                // Let handlers woken by the close run their continuations
+                RunScheduledWork();
+                // Free buffer rings BEFORE destroying the ring
+                FreeBufferRings();
                 // Destroy ring
                 if (io_uring_instance != null) {
                     shim_destroy_ring(io_uring_instance); 
                     io_uring_instance = null; 
                 }
-                // Free slab memory used by buf ring
-                if (_bufferRingSlab != null) {
-                    NativeMemory.AlignedFree(_bufferRingSlab); 
-                    _bufferRingSlab = null; 
-                }
-                Console.WriteLine($"Reactor[{Id}] Shutdown complete.");
+                CloseWakeup();
+                CloseListener();
+                NativeMemory.Free(cqes);
+                // Free slab memory used by buf rings
+                FreeBufferSlabs();
+                ReturnParkedConnections();
+                WriteSegments.Clear();
+                FreeFileSendBuffers();
+                FreeWriteSlabArena();
+                Log(EngineLogLevel.Debug, "shutdown complete");
             }
         }
     }
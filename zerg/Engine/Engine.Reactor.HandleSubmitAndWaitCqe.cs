@@ -1,5 +1,6 @@
 using System.Collections.Concurrent;
 using System.Runtime.InteropServices;
+using zerg.Engine.Diagnostics;
 using static zerg.ABI.ABI;
 
 namespace zerg.Engine;
@@ -10,176 +11,109 @@ public sealed unsafe partial class Engine
     {
         internal void HandleSubmitAndWaitCqe() 
         {
-            Dictionary<int,Connection> connections = _engine.Connections[Id];
+            ConnectionSlotTable connections = _connectionSlots;
             ConcurrentQueue<int> reactorQueue = ReactorQueues[Id];     // new FDs from acceptor
-            io_uring_cqe*[] cqes = new io_uring_cqe*[Config.BatchCqes];
+            shim_cqe* cqes = (shim_cqe*)NativeMemory.Alloc((nuint)Config.BatchCqes, (nuint)sizeof(shim_cqe));
 
             try 
             {
-                io_uring_cqe* cqe; 
+                shim_cqe* cqe; 
                 __kernel_timespec ts;
                 ts.tv_sec  = 0; 
                 ts.tv_nsec = Config.CqTimeout; // 1 ms timeout
+                __kernel_timespec noWait = default; // scheduled work pending: poll instead of sleeping
                 
                 while (_engine.ServerRunning) 
                 {
+                    // Re-open the doorbell before looking at the queues
+                    ResetWakeup();
+                    RunScheduledWork();
+
                     // Drain new connections
                     while (reactorQueue.TryDequeue(out int newFd)) 
-                    {
-                        connections[newFd] = _engine.ConnectionPool.Get()
-                            .SetFd(newFd)
-                            .SetReactor(_engine.Reactors[Id]);
-                        
-                        ArmRecvMultishot(io_uring_instance, newFd, c_bufferRingGID); 
-                        bool connectionAdded = _engine.ConnectionQueues.Writer.TryWrite(new ConnectionItem(Id, newFd));
-                        if (!connectionAdded) Console.WriteLine("Failed to write connection!!");
-                    }
+                        AdoptConnection(newFd);
                     
                     DrainReturnQ(); // Drain rings returns
                     
                     DrainFlushQ();
                     
                     if (shim_sq_ready(io_uring_instance) > 0) 
-                        shim_submit(io_uring_instance);
+                        Submit();
                     
-                    int rc = shim_wait_cqes(io_uring_instance, &cqe, (uint)1, &ts); int got;
-
-                    if (rc < 0)
+                    int got = shim_harvest_cqes(io_uring_instance, cqes, (uint)Config.BatchCqes);
+                    if (got == 0)
                     {
-                        continue; 
+                        // Spin first if the wait strategy says so; null means the spin found work
+                        __kernel_timespec* timeout = BeginIdleWait(&ts, &noWait);
+                        if (timeout != null)
+                        {
+                            io_uring_cqe* waitCqe;
+                            int rc = shim_wait_cqes(io_uring_instance, &waitCqe, (uint)1, timeout);
+                            EndKernelWait();
+
+                            if (rc < 0)
+                            {
+                                AccountCqes(0); // keep the once-a-second upkeep running while idle
+                                continue;
+                            }
+                        }
+                        //if (rc == -62 || rc < 0 && rc != -17) { _counter++; continue; }
+
+                        got = shim_harvest_cqes(io_uring_instance, cqes, (uint)Config.BatchCqes);
                     }
-                    //if (rc == -62 || rc < 0 && rc != -17) { _counter++; continue; }
-                    
-                    fixed (io_uring_cqe** pC = cqes) 
-                        got = shim_peek_batch_cqe(io_uring_instance, pC, (uint)Config.BatchCqes);
+                    AccountCqes(got);
 
                     for (int i = 0; i < got; i++) 
                     {
-                        cqe = cqes[i];
-                        ulong ud = shim_cqe_get_data64(cqe);
+                        cqe = cqes + i;
+                        ulong ud = cqe->user_data;
                         UdKind kind = UdKindOf(ud);
                         int res  = cqe->res;
 
                         if (kind == UdKind.Recv) 
                         {
-                            int fd = UdFdOf(ud);
-                            bool hasBuffer = shim_cqe_has_buffer(cqe) != 0;
-                            bool hasMore   = (cqe->flags & IORING_CQE_F_MORE) != 0;
-
-                            if (res <= 0)
-                            {
-                                Console.WriteLine($"[w{Id}] recv res={res} fd={fd}");
-                                // Return the CQE's provided buffer (if any)
-                                if (hasBuffer)
-                                {
-                                    ushort bufferId = (ushort)shim_cqe_buffer_id(cqe);
-                                    if (_incrementalBuffers) {
-                                        _bufferKernelDone![bufferId] = true;
-                                        if (_bufferRefCounts![bufferId] > 0)
-                                            goto skipReturnError; // outstanding RingItems will return it
-                                    }
-                                    byte* addr = _bufferRingSlab + (nuint)bufferId * (nuint)Config.RecvBufferSize;
-                                    ReturnBufferRing(addr, bufferId);
-                                    skipReturnError:;
-                                }
-                                // REMOVE the connection mapping so we don't process this fd again,
-                                // and so fd reuse won't hit a stale Connection.
-                                if (connections.Remove(fd, out var connection))
-                                {
-                                    connection.MarkClosed(res);
-                                    _engine.ConnectionPool.Return(connection);
-                                    SubmitCancelRecv(io_uring_instance, fd);   // Cancel the multishot recv
-                                    if (shim_sq_ready(io_uring_instance) > 0)
-                                        shim_submit(io_uring_instance);
-                                    // Close once (only if we owned this connection)
-                                    close(fd);
-                                }
-                                shim_cqe_seen(io_uring_instance, cqe);
-                                continue;
-                            }
-                            else
-                            {
-
-                                // This should never happen?
-                                if (!hasBuffer)
-                                {
-                                    shim_cqe_seen(io_uring_instance, cqe);
-                                    continue;
-                                }
-
-                                var bufferId = (ushort)shim_cqe_buffer_id(cqe);
-                                byte* ptr;
-                                if (_incrementalBuffers) {
-                                    bool bufMore = (cqe->flags & IORING_CQE_F_BUF_MORE) != 0;
-                                    ptr = _bufferRingSlab + (nuint)bufferId * (nuint)Config.RecvBufferSize + (nuint)_bufferOffsets![bufferId];
-                                    _bufferOffsets[bufferId] += res;
-                                    _bufferRefCounts![bufferId]++;
-                                    if (!bufMore)
-                                        _bufferKernelDone![bufferId] = true;
-                                } else {
-                                    ptr = _bufferRingSlab + (nuint)bufferId * (nuint)Config.RecvBufferSize;
-                                }
-
-                                if (connections.TryGetValue(fd, out var connection))
-                                {
-                                    connection.EnqueueRingItem(ptr, res, bufferId);
-                                    if (!hasMore)
-                                        ArmRecvMultishot(io_uring_instance, fd, c_bufferRingGID);
-                                }
-                                else
-                                {
-                                    if (_incrementalBuffers) {
-                                        _bufferKernelDone![bufferId] = true;
-                                        if (--_bufferRefCounts![bufferId] > 0)
-                                        {
-                                            shim_cqe_seen(io_uring_instance, cqe);
-                                            continue;
-                                        }
-                                    }
-                                    ReturnBufferRing(_bufferRingSlab + (nuint)bufferId * (nuint)Config.RecvBufferSize, bufferId);
-                                }
-                            }
-                        }
+                            OnRecv(connections.Get(UdSlotOf(ud), UdGenerationOf(ud)), res, cqe->flags);
+                        } 
                         else if (kind == UdKind.Send) 
                         {
-                            int fd = UdFdOf(ud);
-                            if (connections.TryGetValue(fd, out var connection))
-                            {
-                                if (res <= 0)
-                                {
-                                    // error/close handling
-                                    Volatile.Write(ref connection.SendInflight, 0);
-                                    continue;
-                                }
-
-                                connection.WriteHead += res;
-
-                                int target = connection.WriteInFlight;
-
-                                // Still flushing target snapshot
-                                if (connection.WriteHead < target)
-                                {
-                                    // Correct: len is total-end (target), not remaining
-                                    SubmitSend(io_uring_instance, fd, connection.WriteBuffer, (uint)connection.WriteHead, (uint)target);
-                                    continue;
-                                }
-
-                                // Flush batch done
-                                Volatile.Write(ref connection.SendInflight, 0);
-
-                                connection.WriteInFlight = 0;
-                                connection.ResetWriteBuffer(); // safe because _flushInProgress forbids concurrent writes
-
-                                if (connection.IsFlushInProgress)
-                                    connection.CompleteFlush();
-                            }
+                            OnSend(connections.Get(UdSlotOf(ud), UdGenerationOf(ud)), res);
+                        } 
+                        else if (kind == UdKind.Accept)
+                        {
+                            OnAccept(res, cqe->flags);
+                        }
+                        else if (kind == UdKind.SendZc)
+                        {
+                            OnSendZeroCopy(ud, res, cqe->flags);
+                        }
+                        else if (kind == UdKind.Wakeup)
+                        {
+                            OnWakeup(cqe->flags);
                         }
                         else if (kind == UdKind.Cancel) 
                         {
-                            Console.WriteLine("Cancel");
-                            // ignore; res==0 means cancel succeeded, res<0 often means it was already gone
+                            OnRecvCancel(connections.Get(UdSlotOf(ud), UdGenerationOf(ud)));
+                        }
+                        else if (kind == UdKind.Close)
+                        {
+                            OnCloseDirect(UdFdOf(ud), res);
+                        }
+                        else if (kind == UdKind.Relay)
+                        {
+                            OnRelay(UdSlotOf(ud), UdGenerationOf(ud), res);
+                        }
+                        else if (kind == UdKind.Connect)
+                        {
+                            OnConnect(UdFdOf(ud), res);
+                        }
+                        else if (kind == UdKind.Datagram)
+                        {
+                            OnDatagram(UdSlotOf(ud), UdGenerationOf(ud), res, cqe->flags);
+                        }
+                        else if (kind == UdKind.SendFile)
+                        {
+                            OnFileSend(UdSlotOf(ud), UdGenerationOf(ud), res);
                         }
-                        shim_cqe_seen(io_uring_instance, cqe);
                     }
                 }
             } 
@@ -187,24 +121,25 @@ public sealed unsafe partial class Engine
             {
                 // Close any remaining connections
                 CloseAll(connections);
-                // Free buffer ring BEFORE destroying the ring
-                if (io_uring_instance != null && _bufferRing != null) 
-                {
-                    DrainReturnQ();
-                    shim_free_buf_ring(io_uring_instance, _bufferRing, (uint)Config.BufferRingEntries, c_bufferRingGID);
-                    _bufferRing = null;
-                }
+                // Let handlers woken by the close run their continuations
+                RunScheduledWork();
+                // Free buffer rings BEFORE destroying the ring
+                FreeBufferRings();
                 // Destroy ring (unregisters CQ/SQ memory mappings)
                 if (io_uring_instance != null)
                 {
                     shim_destroy_ring(io_uring_instance); io_uring_instance = null; 
                 }
-                // Free slab memory used by buf ring
-                if (_bufferRingSlab != null)
-                {
-                    NativeMemory.AlignedFree(_bufferRingSlab); _bufferRingSlab = null; 
-                }
-                Console.WriteLine($"Reactor[{Id}] Shutdown complete.");
+                CloseWakeup();
+                CloseListener();
+                NativeMemory.Free(cqes);
+                // Free slab memory used by buf rings
+                FreeBufferSlabs();
+                ReturnParkedConnections();
+                WriteSegments.Clear();
+                FreeFileSendBuffers();
+                FreeWriteSlabArena();
+                Log(EngineLogLevel.Debug, "shutdown complete");
             }
         }
     }
@@ -0,0 +1,99 @@
+using Microsoft.Extensions.ObjectPool;
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    /// <summary>
+    /// A reactor's own connection pool under <see cref="SlabMemory.HugePages"/>: new connections get their
+    /// write slab from the reactor's huge-page arena, and a connection returned to a full pool gives its slab
+    /// back to the arena instead of taking it along. Used on the reactor thread only.
+    /// </summary>
+    private sealed class ArenaConnectionPool(WriteSlabArena arena, int maximumRetained) : ObjectPool<Connection>
+    {
+        private readonly Stack<Connection> _retained = new();
+
+        public override Connection Get() => _retained.TryPop(out Connection? connection)
+            ? connection
+            : new Connection(arena.Rent(), arena.SlabSize);
+
+        public override void Return(Connection connection)
+        {
+            connection.Clear();
+            if (_retained.Count < maximumRetained)
+                _retained.Push(connection);
+            else
+                arena.Return(connection.WriteBuffer);
+        }
+    }
+
+    public partial class Reactor
+    {
+
+        /// <summary>
+        /// Where this reactor takes connections from and returns them to: the engine-wide pool, or under
+        /// <see cref="SlabMemory.HugePages"/> a pool of its own whose write slabs live on its NUMA node.
+        /// </summary>
+        private ObjectPool<Connection> _connectionPool;
+        /// <summary>Huge-page chunks this reactor's write slabs are carved from, or null outside <see cref="SlabMemory.HugePages"/>.</summary>
+        private WriteSlabArena? _writeSlabArena;
+        /// <summary>NUMA node slabs are placed on (the reactor thread's node at ring setup), -1 if unknown.</summary>
+        private int _numaNode = -1;
+
+        /// <summary>
+        /// Resolves the reactor's NUMA node and, under <see cref="SlabMemory.HugePages"/>, switches the
+        /// reactor to its own connection pool backed by a huge-page write slab arena.
+        /// Runs on the reactor thread before the recv slabs are mapped.
+        /// </summary>
+        private void InitSlabMemory()
+        {
+            if (Config.SlabMemory != SlabMemory.HugePages)
+                return;
+
+            _numaNode = Numa.CurrentNode();
+            _writeSlabArena = new WriteSlabArena(Config.WriteSlabSize, _numaNode);
+            _connectionPool = new ArenaConnectionPool(_writeSlabArena, Config.MaxConnectionsPerReactor);
+        }
+
+        /// <summary>
+        /// Unmaps the write slab arena at shutdown, once every connection is closed and returned to the pool.
+        /// </summary>
+        private void FreeWriteSlabArena()
+        {
+            _writeSlabArena?.Dispose();
+            _writeSlabArena = null;
+        }
+
+        /// <summary>
+        /// Maps the slab of a recv buffer group: a lazily committed 4 KB-page mapping by default,
+        /// huge pages on the reactor's node under <see cref="SlabMemory.HugePages"/>, faulted in up front
+        /// since they stay committed anyway.
+        /// </summary>
+        private void MapRecvSlab(BufferGroup group)
+        {
+            if (Config.SlabMemory == SlabMemory.HugePages)
+            {
+                group.Slab = HugePageSlab.Map(group.SlabSize, _numaNode, out group.MappedLength, out _);
+                group.Committed = true;
+            }
+            else
+            {
+                void* slab = mmap(null, group.SlabSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+                group.Slab = slab == MAP_FAILED ? null : (byte*)slab;
+                group.MappedLength = group.SlabSize;
+            }
+
+            if (group.Slab == null)
+                throw new OutOfMemoryException($"mmap of {group.SlabSize} byte recv slab failed");
+            if (group.Committed)
+                HugePageSlab.Populate(group.Slab, group.MappedLength);
+        }
+    }
+}
@@ -0,0 +1,71 @@
+using System.Runtime.CompilerServices;
+using zerg.Engine.Balancing;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>Start (Environment.TickCount64) of the current CQE rate window.</summary>
+        private long _cqeWindowStart;
+        /// <summary>CQEs processed in the current rate window.</summary>
+        private long _cqeWindowCount;
+
+        /// <summary>
+        /// Publishes a harvested CQE batch to this reactor's <see cref="ReactorLoadTable"/> slot and
+        /// refreshes <see cref="ReactorLoadTable.CqesPerSecond"/> once per second (when the recv buffer
+        /// groups are also trimmed, see <see cref="TrimBufferGroups"/>).
+        /// Called every loop iteration, including empty ones, so the rate decays when idle.
+        /// </summary>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private void AccountCqes(int got)
+        {
+            CountLoop(got);
+            ref ReactorLoadSlot load = ref _engine.ReactorLoads[Id];
+            if (got > 0)
+            {
+                Volatile.Write(ref load.TotalCqes, load.TotalCqes + got);
+                _cqeWindowCount += got;
+            }
+
+            long now = Environment.TickCount64;
+            long elapsed = now - _cqeWindowStart;
+            if (elapsed >= 1000)
+            {
+                Volatile.Write(ref load.CqesPerSecond, _cqeWindowCount * 1000 / elapsed);
+                _cqeWindowCount = 0;
+                _cqeWindowStart = now;
+                TrimBufferGroups();
+            }
+
+            AdvanceTimers(now);
+        }
+
+        /// <summary>
+        /// Adjusts the published in-flight send bytes: positive when a send is submitted,
+        /// negative as send completions (or failures) retire them.
+        /// </summary>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private void AddInFlightBytes(long delta)
+        {
+            ref ReactorLoadSlot load = ref _engine.ReactorLoads[Id];
+            Volatile.Write(ref load.InFlightBytes, load.InFlightBytes + delta);
+        }
+
+        /// <summary>
+        /// Removes a closing connection from the published load, including the unsent
+        /// remainder of a send whose completion will no longer find the connection.
+        /// </summary>
+        private void ReleaseConnectionLoad(Connection c)
+        {
+            Interlocked.Decrement(ref _engine.ReactorLoads[Id].Connections);
+            if (Volatile.Read(ref c.SendInflight) != 0 && c.WriteInFlight > c.WriteHead)
+                AddInFlightBytes(-(c.WriteInFlight - c.WriteHead));
+        }
+    }
+}
@@ -0,0 +1,135 @@
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using zerg.Engine.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>Hot-path counters; single writer (the reactor thread), padded against false sharing.</summary>
+        private ReactorCounters _counters;
+
+        /// <summary>
+        /// Time from the reactor issuing a connection's send batch (everything flushed so far) until its last
+        /// byte is sent, partial sends included. Recorded by the reactor thread; read from anywhere.
+        /// </summary>
+        public LatencyHistogram FlushLatency { get; } = new();
+
+        /// <summary>
+        /// Gets a free SQE, submitting the queued ones first when the SQ is full.
+        /// </summary>
+        private io_uring_sqe* SqeGet()
+        {
+            io_uring_sqe* sqe = shim_get_sqe(io_uring_instance);
+            if (sqe == null)
+            {
+                Volatile.Write(ref _counters.SqFull, _counters.SqFull + 1);
+                Submit();
+                sqe = shim_get_sqe(io_uring_instance);
+            }
+            return sqe;
+        }
+
+        /// <summary>Submits the queued SQEs without waiting (the loop's own submit + wait is counted as a kernel wait).</summary>
+        private void Submit()
+        {
+            Volatile.Write(ref _counters.Submits, _counters.Submits + 1);
+            shim_submit(io_uring_instance);
+        }
+
+        /// <summary>Counts one loop iteration and the CQE batch it harvested.</summary>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private void CountLoop(int got)
+        {
+            Volatile.Write(ref _counters.LoopIterations, _counters.LoopIterations + 1);
+            if (got <= 0)
+                return;
+            Volatile.Write(ref _counters.CqeBatches, _counters.CqeBatches + 1);
+            Volatile.Write(ref _counters.Cqes, _counters.Cqes + got);
+            if (got > _counters.MaxCqeBatch)
+                Volatile.Write(ref _counters.MaxCqeBatch, got);
+        }
+
+        /// <summary>Counts the items one drain of a queue took; the largest drain is the deepest the queue was seen.</summary>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private static void CountDrain(ref long drained, ref long maxDepth, int count)
+        {
+            if (count == 0)
+                return;
+            Volatile.Write(ref drained, drained + count);
+            if (count > maxDepth)
+                Volatile.Write(ref maxDepth, count);
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private void CountSend()
+            => Volatile.Write(ref _counters.Sends, _counters.Sends + 1);
+
+        /// <summary>
+        /// Counts a send completion: an error, or a partial send when fewer bytes than requested went out.
+        /// </summary>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private void CountSendResult(Connection c, int res)
+        {
+            if (res <= 0)
+                Volatile.Write(ref _counters.SendErrors, _counters.SendErrors + 1);
+            else if (res < c.WriteInFlight - c.WriteHead)
+                Volatile.Write(ref _counters.PartialSends, _counters.PartialSends + 1);
+        }
+
+        /// <summary>Records the flush latency of a send batch that has just gone out completely.</summary>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private void RecordFlushLatency(Connection c)
+            => FlushLatency.Record(TicksToNs(Stopwatch.GetTimestamp() - c.SendBatchStart));
+
+        /// <summary>
+        /// Snapshot of this reactor's counters, buffer-ring occupancy and flush latency. Allocates nothing and is
+        /// safe to call from any thread; values are a best-effort snapshot of counters the reactor keeps writing.
+        /// </summary>
+        public ReactorMetrics GetMetrics()
+        {
+            int published = 0, outstanding = 0;
+            long starvations = 0;
+            BufferGroup[] groups = _bufferGroups;
+            for (int i = 0; i < groups.Length; i++)
+            {
+                BufferGroup g = groups[i];
+                published += Volatile.Read(ref g.Published);
+                outstanding += Volatile.Read(ref g.Outstanding);
+                starvations += Volatile.Read(ref g.Starvations);
+            }
+
+            return new ReactorMetrics(
+                Id,
+                Volatile.Read(ref _counters.LoopIterations),
+                Volatile.Read(ref _counters.CqeBatches),
+                Volatile.Read(ref _counters.Cqes),
+                Volatile.Read(ref _counters.MaxCqeBatch),
+                Volatile.Read(ref _counters.Submits),
+                Volatile.Read(ref _kernelWaits),
+                Volatile.Read(ref _counters.SqFull),
+                _engine.ReactorLoads.Connections(Id),
+                published,
+                outstanding,
+                starvations,
+                Volatile.Read(ref _counters.ReturnQDrained),
+                Volatile.Read(ref _counters.ReturnQMaxDepth),
+                Volatile.Read(ref _counters.FlushQDrained),
+                Volatile.Read(ref _counters.FlushQMaxDepth),
+                Volatile.Read(ref _counters.Sends),
+                Volatile.Read(ref _counters.PartialSends),
+                Volatile.Read(ref _counters.SendErrors),
+                Volatile.Read(ref _counters.IdleTimeouts),
+                Volatile.Read(ref _counters.ReadHeaderTimeouts),
+                Volatile.Read(ref _counters.FlushTimeouts),
+                FlushLatency.Summarize());
+        }
+    }
+}
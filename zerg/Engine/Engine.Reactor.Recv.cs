@@ -0,0 +1,238 @@
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>
+        /// Recvs are armed in bundle mode: one CQE covers every buffer a burst filled.
+        /// See <see cref="ReactorConfig.RecvBundles"/>.
+        /// </summary>
+        private bool _recvBundles;
+        /// <summary>Scratch list of the buffer ids of one bundle CQE.</summary>
+        private ushort[] _bundleBids = [];
+
+        /// <summary>True when this reactor's recvs run in bundle mode (requested and supported by the kernel).</summary>
+        public bool RecvBundles => _recvBundles;
+
+        /// <summary>
+        /// Resolves <see cref="ReactorConfig.RecvBundles"/> against the kernel's IORING_FEAT_RECVSEND_BUNDLE.
+        /// Incrementally consumed buffers can end a bundle mid-buffer, so that mode keeps one CQE per buffer.
+        /// </summary>
+        private bool ProbeRecvBundles()
+        {
+            if (!Config.RecvBundles || _incrementalBuffers)
+                return false;
+            if ((shim_get_ring_features(io_uring_instance) & IORING_FEAT_RECVSEND_BUNDLE) != 0)
+                return true;
+            Log(EngineLogLevel.Warning, "kernel lacks recv bundles, using one CQE per buffer");
+            return false;
+        }
+
+        /// <summary>
+        /// Arms multishot recv for a connection on the buffer group selected by <see cref="Connection.RecvGroup"/>.
+        /// </summary>
+        private void ArmRecv(Connection connection)
+        {
+            if (connection.Relay != null && StopRelayRecv(connection))
+                return;
+            io_uring_sqe* sqe = SqeGet();
+            uint bgid = _bufferGroups[connection.RecvGroup].Bgid;
+            if (_recvBundles)
+                shim_prep_recv_multishot_bundle(sqe, connection.ClientFd, bgid, 0);
+            else
+                shim_prep_recv_multishot_select(sqe, connection.ClientFd, bgid, 0);
+            if (connection.IsDirectDescriptor)
+                shim_sqe_set_fixed_file(sqe);
+            shim_sqe_set_data64(sqe, PackUd(UdKind.Recv, connection.Slot, connection.SlotGeneration));
+        }
+
+        /// <summary>
+        /// Handles a multishot recv CQE: hands the buffer to the connection, tracks its recv size
+        /// to pick a buffer class, re-arms terminated recvs (or parks them while the connection is
+        /// over its recv budget) and closes on EOF/error.
+        /// <paramref name="connection"/> is null when the CQE belongs to a closed lifetime of its slot.
+        /// </summary>
+        private void OnRecv(Connection? connection, int res, uint cqeFlags)
+        {
+            bool hasBuffer = (cqeFlags & IORING_CQE_F_BUFFER) != 0;
+            bool hasMore   = (cqeFlags & IORING_CQE_F_MORE) != 0;
+
+            if (res <= 0)
+            {
+                // Return the CQE's provided buffer (if any)
+                if (hasBuffer)
+                {
+                    ushort bufferId = (ushort)(cqeFlags >> IORING_CQE_BUFFER_SHIFT);
+                    TakeBuffer(bufferId);
+                    if (_incrementalBuffers)
+                    {
+                        _bufferKernelDone![bufferId] = true;
+                        if (_bufferRefCounts![bufferId] > 0)
+                            goto skipReturnError; // outstanding RingItems will return it
+                    }
+                    ReturnBufferRing(bufferId);
+                    skipReturnError:;
+                }
+
+                if (connection == null)
+                    return;
+
+                // Buffer group ran dry: wait for buffers rather than dropping the connection.
+                if (res == -ENOBUFS && !hasMore)
+                {
+                    OnRecvNoBuffers(connection);
+                    return;
+                }
+
+                // The recv was cancelled to move it to another buffer class: re-arm, don't close.
+                if (res == -ECANCELED && !hasMore && (connection.RecvGroupPending >= 0 || connection.RecvCancelInFlight))
+                {
+                    if (connection.RecvGroupPending >= 0)
+                        connection.RecvGroup = connection.RecvGroupPending;
+                    connection.RecvGroupPending = -1;
+                    ArmOrParkRecv(connection);
+                    return;
+                }
+
+                // A relayed connection ends through its relay, which closes both sides.
+                if (connection.Relay != null)
+                {
+                    OnRelayRecvEnd(connection, res);
+                    return;
+                }
+
+                // Queues the recv cancel (flushed by the loop's next submit)
+                CloseConnection(connection, res);
+                return;
+            }
+
+            // res > 0
+            if (!hasBuffer)
+                return;
+
+            ushort bid = (ushort)(cqeFlags >> IORING_CQE_BUFFER_SHIFT);
+            if (_recvBundles)
+                DeliverBundle(connection, res, bid);
+            else
+                DeliverBuffer(connection, res, bid, cqeFlags);
+            if (connection == null)
+                return;
+            connection.LastRecvMs = _timerNow;
+            if (connection.Relay != null)
+                PumpRelay(connection.Relay, connection.RelayDirection);
+
+            int group = ObserveRecvSize(connection, res);
+            if (!hasMore)
+            {
+                // The multishot recv ended on its own; take any class change with the re-arm.
+                connection.RecvGroup = group;
+                connection.RecvGroupPending = -1;
+                ArmOrParkRecv(connection);
+            }
+            else if (connection.RecvGroupPending >= 0)
+            {
+                connection.RecvGroupPending = group;
+            }
+            else if (group != connection.RecvGroup || connection.RecvPaused)
+            {
+                // Stop the running multishot recv; its -ECANCELED completion re-arms on the new class,
+                // or parks the connection while it is paused.
+                connection.RecvGroupPending = group;
+                connection.RecvCancelInFlight = true;
+                SubmitCancelRecv(io_uring_instance, connection);
+            }
+        }
+
+        /// <summary>
+        /// Hands the single buffer of a non-bundle recv CQE to the connection (or back to the ring when the
+        /// connection is gone), tracking partial consumption of incrementally consumed buffers.
+        /// </summary>
+        private void DeliverBuffer(Connection? connection, int res, ushort bid, uint cqeFlags)
+        {
+            TakeBuffer(bid);
+            byte* ptr = BufferAddress(bid);
+            if (_incrementalBuffers)
+            {
+                bool bufMore = (cqeFlags & IORING_CQE_F_BUF_MORE) != 0;
+                ptr += _bufferOffsets![bid];
+                _bufferOffsets[bid] += res;
+                _bufferRefCounts![bid]++;
+                if (!bufMore)
+                    _bufferKernelDone![bid] = true;
+            }
+
+            if (connection == null)
+            {
+                if (_incrementalBuffers)
+                {
+                    // No connection: mark kernel done and check if we can return immediately
+                    _bufferKernelDone![bid] = true;
+                    if (--_bufferRefCounts![bid] > 0)
+                        return; // other RingItems still hold refs
+                }
+                ReturnBufferRing(bid);
+                return;
+            }
+
+            if (DeliverRecv(connection, ptr, res, bid))
+                connection.WakeReader();
+        }
+
+        /// <summary>
+        /// Hands every buffer of a bundle CQE to the connection with a single reader wakeup.
+        /// The kernel filled consecutive buf_ring entries starting at <paramref name="firstBid"/>'s position;
+        /// all but the last are full. The ids are read off the ring shadow before any buffer is taken or
+        /// returned, since either can stage new entries over the consumed slots.
+        /// </summary>
+        private void DeliverBundle(Connection? connection, int res, ushort firstBid)
+        {
+            BufferGroup group = _bufferGroups[_bufferGroupOf[firstBid]];
+            int count = (res + group.BufferSize - 1) / group.BufferSize;
+            if (_bundleBids.Length < count)
+                _bundleBids = new ushort[Math.Max(count, 64)];
+
+            uint position = group.RingPositions![firstBid - group.FirstBid];
+            for (int i = 0; i < count; i++)
+                _bundleBids[i] = group.RingBids![(position + (uint)i) & group.Mask];
+
+            bool queued = false;
+            int remaining = res;
+            for (int i = 0; i < count; i++)
+            {
+                ushort bid = _bundleBids[i];
+                int length = Math.Min(remaining, group.BufferSize);
+                remaining -= length;
+                TakeBuffer(bid);
+                if (connection == null)
+                    ReturnBufferRing(bid);
+                else
+                    queued |= DeliverRecv(connection, BufferAddress(bid), length, bid);
+            }
+            if (queued)
+                connection!.WakeReader();
+        }
+
+        /// <summary>
+        /// Handles the completion of a recv cancel. Only class-switch and pause cancels of live connections
+        /// need bookkeeping; cancels issued by <see cref="CloseConnection"/> find their slot already freed.
+        /// A connection parked while its cancel was in flight gets another chance to resume.
+        /// </summary>
+        private void OnRecvCancel(Connection? connection)
+        {
+            if (connection == null)
+                return;
+            connection.RecvCancelInFlight = false;
+            if (connection.RecvParked)
+                TryResumeRecv(connection);
+        }
+    }
+}
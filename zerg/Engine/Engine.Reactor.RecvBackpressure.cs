@@ -0,0 +1,214 @@
+using zerg.Engine.Configs;
+using zerg.Utils;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>
+        /// Paused connections whose recv has terminated, as (slot, generation) keys packed like their user_data.
+        /// They are re-armed once their handler has returned enough buffers.
+        /// </summary>
+        private readonly List<ulong> _pausedRecvs = [];
+        /// <summary>
+        /// Per buffer id: the connection charged for it (packed like a recv user_data), or 0 when the buffer
+        /// is not charged. Null when no recv budget is enforced.
+        /// </summary>
+        private ulong[]? _bufferHolder;
+        /// <summary>Per buffer id: bytes charged to <see cref="_bufferHolder"/>.</summary>
+        private int[]? _bufferHeldBytes;
+        /// <summary>Connections currently paused.</summary>
+        private int _recvPaused;
+        /// <summary>Recvs paused since startup.</summary>
+        private long _recvPauses;
+        /// <summary>Recvs resumed since startup.</summary>
+        private long _recvResumes;
+
+        /// <summary>
+        /// Sets up per-buffer charging when <see cref="ReactorConfig.RecvBudgetBuffers"/> or
+        /// <see cref="ReactorConfig.RecvBudgetBytes"/> is set. Incrementally consumed buffers can be
+        /// shared by several connections, so budgets are not enforced in that mode; only a full
+        /// inbound ring pauses a connection there.
+        /// </summary>
+        private void InitRecvBudgets()
+        {
+            if (_incrementalBuffers || (Config.RecvBudgetBuffers <= 0 && Config.RecvBudgetBytes <= 0))
+                return;
+            _bufferHolder = new ulong[_bufferEntries];
+            _bufferHeldBytes = new int[_bufferEntries];
+        }
+
+        /// <summary>
+        /// Queues a received buffer to the connection, charging it against the connection's recv budget.
+        /// Items that do not fit the inbound ring (or must queue behind earlier ones that did not) are held
+        /// in <see cref="Connection.RecvOverflow"/>. Either going over budget or overflowing pauses the recv.
+        /// Returns true when the item went into the ring; the caller then wakes the reader.
+        /// </summary>
+        private bool DeliverRecv(Connection connection, byte* ptr, int res, ushort bid)
+        {
+            if (connection.Relay != null)
+            {
+                RelayReceived(connection, ptr, res, bid);
+                return false;
+            }
+            if (_bufferHolder != null)
+            {
+                _bufferHolder[bid] = PackUd(UdKind.Recv, connection.Slot, connection.SlotGeneration);
+                _bufferHeldBytes![bid] = res;
+                connection.RecvHeldBuffers++;
+                connection.RecvHeldBytes += res;
+            }
+
+            Queue<RingItem>? overflow = connection.RecvOverflow;
+            if ((overflow == null || overflow.Count == 0) && connection.QueueRingItem(ptr, res, bid))
+            {
+                if (_bufferHolder != null && OverRecvBudget(connection))
+                    PauseRecv(connection);
+                return true;
+            }
+
+            (connection.RecvOverflow ??= new Queue<RingItem>()).Enqueue(new RingItem(ptr, res, bid));
+            PauseRecv(connection);
+            return false;
+        }
+
+        private bool OverRecvBudget(Connection connection)
+            => (Config.RecvBudgetBuffers > 0 && connection.RecvHeldBuffers >= Config.RecvBudgetBuffers)
+            || (Config.RecvBudgetBytes > 0 && connection.RecvHeldBytes >= Config.RecvBudgetBytes);
+
+        /// <summary>Back under half of both budgets: enough has been returned to take more data.</summary>
+        private bool UnderRecvLowWater(Connection connection)
+            => _bufferHolder == null
+            || ((Config.RecvBudgetBuffers <= 0 || connection.RecvHeldBuffers * 2 <= Config.RecvBudgetBuffers)
+                && (Config.RecvBudgetBytes <= 0 || connection.RecvHeldBytes * 2 <= Config.RecvBudgetBytes));
+
+        /// <summary>
+        /// Marks the connection paused. <see cref="OnRecv"/> cancels a running multishot recv, and the
+        /// recv parks instead of re-arming when it terminates.
+        /// </summary>
+        private void PauseRecv(Connection connection)
+        {
+            if (connection.RecvPaused)
+                return;
+            connection.RecvPaused = true;
+            _recvPaused++;
+            _recvPauses++;
+        }
+
+        /// <summary>Re-arms a terminated recv, or parks it while the connection is paused.</summary>
+        private void ArmOrParkRecv(Connection connection)
+        {
+            if (connection.Relay != null && StopRelayRecv(connection))
+                return;
+            if (!connection.RecvPaused)
+            {
+                ArmRecv(connection);
+                return;
+            }
+            if (connection.RecvParked || TryResumeRecv(connection))
+                return; // the handler may have caught up while the cancel was in flight
+            connection.RecvParked = true;
+            _pausedRecvs.Add(PackUd(UdKind.Recv, connection.Slot, connection.SlotGeneration));
+        }
+
+        /// <summary>
+        /// Moves held-back items into the inbound ring and, once they all fit, the ring is at most half
+        /// full and the connection is back under its low-water mark, re-arms its recv.
+        /// </summary>
+        private bool TryResumeRecv(Connection connection)
+        {
+            Queue<RingItem>? overflow = connection.RecvOverflow;
+            if (overflow != null && overflow.Count != 0)
+            {
+                bool moved = false;
+                while (overflow.TryPeek(out RingItem item) && connection.QueueRingItem(item.Ptr, item.Length, item.BufferId))
+                {
+                    overflow.Dequeue();
+                    moved = true;
+                }
+                if (moved)
+                    connection.WakeReader();
+                if (overflow.Count != 0)
+                    return false;
+            }
+            if (connection.RecvCancelInFlight || connection.RecvQueued * 2 > connection.RecvCapacity
+                || !UnderRecvLowWater(connection) || (connection.Relay != null && !RelayUnderLowWater(connection)))
+                return false;
+
+            connection.RecvPaused = false;
+            connection.RecvParked = false;
+            _recvPaused--;
+            _recvResumes++;
+            ArmRecv(connection);
+            return true;
+        }
+
+        /// <summary>
+        /// Re-arms parked recvs whose handler has caught up. Entries of connections that closed in the
+        /// meantime are dropped.
+        /// </summary>
+        private void ResumePausedRecvs()
+        {
+            int kept = 0;
+            for (int i = 0; i < _pausedRecvs.Count; i++)
+            {
+                ulong key = _pausedRecvs[i];
+                Connection? connection = _connectionSlots.Get(UdSlotOf(key), UdGenerationOf(key));
+                if (connection == null || !connection.RecvParked)
+                    continue; // closed, or resumed by its cancel completion
+                if (!TryResumeRecv(connection))
+                    _pausedRecvs[kept++] = key;
+            }
+            _pausedRecvs.RemoveRange(kept, _pausedRecvs.Count - kept);
+        }
+
+        /// <summary>
+        /// Credits a returned buffer back to the connection it was charged to,
+        /// unless that connection has closed since.
+        /// </summary>
+        private void ReleaseRecvCharge(ushort bid)
+        {
+            ulong key = _bufferHolder![bid];
+            if (key == 0)
+                return;
+            _bufferHolder[bid] = 0;
+            Connection? connection = _connectionSlots.Get(UdSlotOf(key), UdGenerationOf(key));
+            if (connection == null)
+                return;
+            connection.RecvHeldBuffers--;
+            connection.RecvHeldBytes -= _bufferHeldBytes![bid];
+        }
+
+        /// <summary>
+        /// Drops the backpressure state of a closing connection: held-back items never reach the
+        /// handler, so their buffers go straight back to the ring.
+        /// </summary>
+        private void ReleaseRecvBackpressure(Connection connection)
+        {
+            Queue<RingItem>? overflow = connection.RecvOverflow;
+            if (overflow != null)
+            {
+                while (overflow.TryDequeue(out RingItem item))
+                    EnqueueReturnQ(item.BufferId);
+            }
+            if (connection.RecvPaused)
+                _recvPaused--;
+            connection.RecvPaused = false;
+            connection.RecvParked = false;
+        }
+
+        /// <summary>
+        /// Receive backpressure counters of this reactor.
+        /// Values are written by the reactor thread; reads from other threads are a best-effort snapshot.
+        /// </summary>
+        public RecvBackpressureStats GetRecvBackpressureStats()
+            => new(Volatile.Read(ref _recvPaused), Volatile.Read(ref _recvPauses), Volatile.Read(ref _recvResumes));
+    }
+}
@@ -0,0 +1,621 @@
+using System.Runtime.InteropServices;
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+using zerg.Utils;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>Buffers queued in one relay direction before its source's recv is paused.</summary>
+        private const int c_relayWindow = 64;
+        /// <summary>Upper bound on iovecs per relay sendmsg; the rest goes out from the send CQE.</summary>
+        private const int c_relayMaxIov = 64;
+        /// <summary>Bytes moved per splice into a relay pipe (the default pipe capacity).</summary>
+        private const int c_spliceChunk = 64 * 1024;
+
+        /// <summary>Operation a relay direction has in flight; one at a time keeps its bytes in order.</summary>
+        internal enum RelayOp : byte
+        {
+            None,
+            Send,
+            SpliceIn,
+            SpliceOut,
+            PollIn,
+            PollOut,
+            Shutdown
+        }
+
+        /// <summary>
+        /// One direction of a relay: bytes received on <see cref="Source"/> go out on <see cref="Sink"/>.
+        /// Reactor-owned.
+        /// </summary>
+        internal sealed class RelayDirection(Connection source, Connection sink)
+        {
+            public readonly Connection Source = source;
+            public readonly Connection Sink = sink;
+
+            /// <summary>Received buffers not yet fully sent, oldest at <see cref="Head"/> (power-of-two ring).</summary>
+            public RingItem[] Items = new RingItem[c_relayWindow];
+            public int Head;
+            public int Count;
+            /// <summary>Bytes of the item at <see cref="Head"/> already sent.</summary>
+            public int HeadOffset;
+
+            public RelayOp Op;
+            /// <summary>The source's multishot recv has ended; splice mode takes over from here.</summary>
+            public bool RecvStopped;
+            /// <summary>The source reached EOF; once the queue drains the sink's write side is shut down.</summary>
+            public bool Eof;
+            /// <summary>The sink's write side has been shut down: nothing more will flow this way.</summary>
+            public bool Done;
+            public long Bytes;
+
+            // Splice mode: socket -> pipe -> socket
+            public int PipeRead = -1;
+            public int PipeWrite = -1;
+            /// <summary>Bytes spliced into the pipe and not yet out of it.</summary>
+            public int PipeBytes;
+
+            /// <summary>Vectored-send header for queues of more than one buffer (native memory).</summary>
+            public iovec* Iov;
+            public msghdr* Msg;
+
+            public void Enqueue(in RingItem item)
+            {
+                if (Count == Items.Length)
+                {
+                    RingItem[] grown = new RingItem[Items.Length * 2];
+                    for (int i = 0; i < Count; i++)
+                        grown[i] = Items[(Head + i) & (Items.Length - 1)];
+                    Items = grown;
+                    Head = 0;
+                }
+                Items[(Head + Count) & (Items.Length - 1)] = item;
+                Count++;
+            }
+        }
+
+        /// <summary>
+        /// Two connections of this reactor paired by <see cref="Connection.ProxyAsync"/>.
+        /// Created on the calling thread, owned by the reactor from <see cref="BeginRelay"/> on.
+        /// </summary>
+        internal sealed class Relay
+        {
+            public Relay(Connection a, Connection b, RelayMode mode)
+            {
+                Mode = mode;
+                A = a;
+                B = b;
+                GenerationA = a.Generation;
+                GenerationB = b.Generation;
+                Directions = [new RelayDirection(a, b), new RelayDirection(b, a)];
+            }
+
+            public readonly RelayMode Mode;
+            public readonly Connection A;
+            public readonly Connection B;
+            public readonly int GenerationA;
+            public readonly int GenerationB;
+            /// <summary>[0]: A to B, [1]: B to A; a connection's <see cref="Connection.RelayDirection"/> is the one it feeds.</summary>
+            public readonly RelayDirection[] Directions;
+            public readonly TaskCompletionSource<RelayResult> Completion = new(TaskCreationOptions.RunContinuationsAsynchronously);
+
+            /// <summary>Slot in the reactor's relay table, packed into user_data with <see cref="Generation"/>.</summary>
+            public int Index = -1;
+            public uint Generation;
+            /// <summary>Ending: in-flight operations are being cancelled, then both connections close.</summary>
+            public bool Closing;
+            public int Error;
+
+            /// <summary>Creates the two pipes of splice mode and the vectored-send headers.</summary>
+            public void Allocate()
+            {
+                int* fds = stackalloc int[2];
+                foreach (RelayDirection d in Directions)
+                {
+                    d.Iov = (iovec*)NativeMemory.Alloc(c_relayMaxIov, (nuint)sizeof(iovec));
+                    d.Msg = (msghdr*)NativeMemory.AllocZeroed((nuint)sizeof(msghdr));
+                    d.Msg->msg_iov = d.Iov;
+                    if (Mode != RelayMode.Splice)
+                        continue;
+                    if (pipe2(fds, O_CLOEXEC) < 0)
+                    {
+                        int errno = Marshal.GetLastPInvokeError();
+                        Free();
+                        throw new InvalidOperationException($"pipe2 failed, errno={errno}");
+                    }
+                    d.PipeRead = fds[0];
+                    d.PipeWrite = fds[1];
+                }
+            }
+
+            public void Free()
+            {
+                foreach (RelayDirection d in Directions)
+                {
+                    if (d.PipeRead >= 0)
+                    {
+                        close(d.PipeRead);
+                        close(d.PipeWrite);
+                        d.PipeRead = d.PipeWrite = -1;
+                    }
+                    NativeMemory.Free(d.Iov);
+                    NativeMemory.Free(d.Msg);
+                    d.Iov = null;
+                    d.Msg = null;
+                }
+            }
+
+            public RelayResult Result => new(Mode, Directions[0].Bytes, Directions[1].Bytes, Error);
+        }
+
+        private static readonly SendOrPostCallback s_beginRelay = static state =>
+        {
+            Relay relay = (Relay)state!;
+            relay.A.Reactor.BeginRelay(relay);
+        };
+
+        /// <summary>Active relays, indexed by <see cref="Relay.Index"/>.</summary>
+        private readonly List<Relay?> _relays = [];
+        private readonly Stack<int> _freeRelays = new();
+        private uint _relayGeneration;
+
+        /// <summary>
+        /// Pairs two connections of this reactor (see <see cref="Connection.ProxyAsync"/>). Any thread.
+        /// </summary>
+        internal Task<RelayResult> StartRelay(Connection a, Connection b, RelayMode mode)
+        {
+            Relay relay = new(a, b, mode);
+            relay.Allocate();
+            Schedule(s_beginRelay, relay);
+            return relay.Completion.Task;
+        }
+
+        /// <summary>
+        /// Registers the relay and starts it: items the handlers have not read yet are relayed first,
+        /// then recvs feed the relay directly (or, in splice mode, are stopped so splices take over).
+        /// If either connection has closed meanwhile the relay ends right away and closes the other.
+        /// </summary>
+        private void BeginRelay(Relay relay)
+        {
+            Connection a = relay.A;
+            Connection b = relay.B;
+            bool aLive = IsLive(a, relay.GenerationA);
+            bool bLive = IsLive(b, relay.GenerationB);
+            if (!_engine.ServerRunning || !aLive || !bLive)
+            {
+                relay.Free();
+                if (aLive)
+                    CloseConnection(a, -ENOTCONN);
+                if (bLive)
+                    CloseConnection(b, -ENOTCONN);
+                relay.Completion.TrySetResult(new RelayResult(relay.Mode, 0, 0, -ENOTCONN));
+                return;
+            }
+
+            relay.Generation = ++_relayGeneration & UdGenerationMask;
+            if (_freeRelays.Count != 0)
+            {
+                relay.Index = _freeRelays.Pop();
+                _relays[relay.Index] = relay;
+            }
+            else
+            {
+                relay.Index = _relays.Count;
+                _relays.Add(relay);
+            }
+            a.Relay = relay;
+            a.RelayDirection = 0;
+            b.Relay = relay;
+            b.RelayDirection = 1;
+
+            for (int dir = 0; dir < 2; dir++)
+            {
+                RelayDirection d = relay.Directions[dir];
+                Connection source = d.Source;
+                while (source.TryTakeQueuedRecv(out RingItem item))
+                    d.Enqueue(item);
+                Queue<RingItem>? overflow = source.RecvOverflow;
+                if (overflow != null)
+                {
+                    while (overflow.TryDequeue(out RingItem item))
+                        d.Enqueue(item);
+                }
+
+                if (relay.Mode == RelayMode.Splice)
+                    StopRecvForSplice(source, d);
+                else if (source.RecvParked)
+                    TryResumeRecv(source);
+            }
+            PumpRelay(relay, 0);
+            PumpRelay(relay, 1);
+        }
+
+        private bool IsLive(Connection c, int generation)
+            => c.Generation == generation && c.Slot >= 0 && _connectionSlots.Get(c.Slot, c.SlotGeneration) == c
+            && c.Relay == null;
+
+        /// <summary>
+        /// Splice mode reads the socket itself, so the multishot recv has to end first: a parked recv already
+        /// has, a running one is cancelled and reports through <see cref="StopRelayRecv"/> when it terminates.
+        /// </summary>
+        private void StopRecvForSplice(Connection source, RelayDirection d)
+        {
+            bool parked = source.RecvParked;
+            if (source.RecvPaused)
+            {
+                source.RecvPaused = false;
+                source.RecvParked = false;
+                _recvPaused--;
+            }
+            if (parked)
+            {
+                d.RecvStopped = true;
+                return;
+            }
+            source.RecvCancelInFlight = true;
+            SubmitCancelRecv(io_uring_instance, source);
+        }
+
+        /// <summary>
+        /// Called where a terminated recv would be re-armed. Returns true (and does not re-arm) for the sources
+        /// of a splice-mode relay, whose splices can start once the queued items are out.
+        /// </summary>
+        private bool StopRelayRecv(Connection connection)
+        {
+            Relay? relay = connection.Relay;
+            if (relay == null || relay.Mode != RelayMode.Splice)
+                return false;
+            RelayDirection d = relay.Directions[connection.RelayDirection];
+            if (!d.RecvStopped)
+            {
+                d.RecvStopped = true;
+                PumpRelay(relay, connection.RelayDirection);
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// A received buffer of a relayed connection (from <see cref="DeliverRecv"/>): queued for the peer,
+        /// or straight back to the ring once the relay is ending. The recv CQE's handler pumps the relay.
+        /// </summary>
+        private void RelayReceived(Connection connection, byte* ptr, int length, ushort bid)
+        {
+            Relay relay = connection.Relay!;
+            if (relay.Closing)
+            {
+                RecycleBuffer(bid);
+                return;
+            }
+            RelayDirection d = relay.Directions[connection.RelayDirection];
+            d.Enqueue(new RingItem(ptr, length, bid));
+            if (relay.Mode == RelayMode.Buffers && d.Count >= c_relayWindow)
+                PauseRecv(connection);
+        }
+
+        /// <summary>
+        /// The recv of a relayed connection ended with EOF or an error (instead of <see cref="CloseConnection"/>).
+        /// EOF ends its direction once everything queued is out; an error ends the relay. A cancelled recv of
+        /// a splice-mode source just hands over to the splices.
+        /// </summary>
+        private void OnRelayRecvEnd(Connection connection, int res)
+        {
+            Relay relay = connection.Relay!;
+            // The cancel issued by StopRecvForSplice may complete before the recv it cancelled.
+            if (res == -ECANCELED && StopRelayRecv(connection))
+                return;
+            if (res < 0)
+            {
+                FailRelay(relay, res);
+                return;
+            }
+            RelayDirection d = relay.Directions[connection.RelayDirection];
+            d.Eof = true;
+            d.RecvStopped = true;
+            PumpRelay(relay, connection.RelayDirection);
+        }
+
+        /// <summary>Back under half the window: a paused source may take more data.</summary>
+        private static bool RelayUnderLowWater(Connection connection)
+            => connection.Relay!.Directions[connection.RelayDirection].Count * 2 <= c_relayWindow;
+
+        /// <summary>
+        /// Issues the next operation of a relay direction, if it has none in flight: queued buffers first,
+        /// then (splice mode) the pipe, then the shutdown that forwards an EOF. Waits while the sink's own
+        /// write chain is still sending what its handler flushed before the relay began.
+        /// </summary>
+        private void PumpRelay(Relay relay, int dir)
+        {
+            RelayDirection d = relay.Directions[dir];
+            if (d.Op != RelayOp.None || relay.Closing || d.Done || d.Sink.IsSending)
+                return;
+
+            if (d.Count != 0)
+                RelaySend(relay, dir, d);
+            else if (d.PipeBytes != 0)
+                RelaySplice(relay, dir, d, RelayOp.SpliceOut);
+            else if (d.Eof)
+                RelayShutdown(relay, dir, d);
+            else if (relay.Mode == RelayMode.Splice && d.RecvStopped)
+                RelaySplice(relay, dir, d, RelayOp.SpliceIn);
+        }
+
+        /// <summary>
+        /// Called when a connection's own send sequence ends: relay data towards it may go out now.
+        /// </summary>
+        private void OnRelaySinkIdle(Connection sink)
+        {
+            Relay? relay = sink.Relay;
+            if (relay != null)
+                PumpRelay(relay, sink.RelayDirection ^ 1);
+        }
+
+        private ulong RelayUd(Relay relay, int dir) => PackUd(UdKind.Relay, relay.Index * 2 + dir, relay.Generation);
+
+        /// <summary>Sends the queued buffers straight from the buf_ring memory: one send, or one sendmsg over several.</summary>
+        private void RelaySend(Relay relay, int dir, RelayDirection d)
+        {
+            d.Op = RelayOp.Send;
+            int mask = d.Items.Length - 1;
+            int count = Math.Min(d.Count, c_relayMaxIov);
+            io_uring_sqe* sqe = SqeGet();
+            RingItem first = d.Items[d.Head];
+            if (count == 1)
+            {
+                shim_prep_send(sqe, d.Sink.ClientFd, first.Ptr + d.HeadOffset, (uint)(first.Length - d.HeadOffset), 0);
+            }
+            else
+            {
+                for (int i = 0; i < count; i++)
+                {
+                    RingItem item = d.Items[(d.Head + i) & mask];
+                    int skip = i == 0 ? d.HeadOffset : 0;
+                    d.Iov[i].iov_base = item.Ptr + skip;
+                    d.Iov[i].iov_len = (nuint)(item.Length - skip);
+                }
+                d.Msg->msg_iovlen = (nuint)count;
+                shim_prep_sendmsg(sqe, d.Sink.ClientFd, d.Msg, 0);
+            }
+            if (d.Sink.IsDirectDescriptor)
+                shim_sqe_set_fixed_file(sqe);
+            shim_sqe_set_data64(sqe, RelayUd(relay, dir));
+        }
+
+        /// <summary>
+        /// Splices source → pipe (<see cref="RelayOp.SpliceIn"/>) or pipe → sink (<see cref="RelayOp.SpliceOut"/>).
+        /// </summary>
+        private void RelaySplice(Relay relay, int dir, RelayDirection d, RelayOp op)
+        {
+            d.Op = op;
+            io_uring_sqe* sqe = SqeGet();
+            if (op == RelayOp.SpliceIn)
+            {
+                uint flags = SPLICE_F_MOVE | (d.Source.IsDirectDescriptor ? SPLICE_F_FD_IN_FIXED : 0u);
+                shim_prep_splice(sqe, d.Source.ClientFd, d.PipeWrite, c_spliceChunk, flags);
+            }
+            else
+            {
+                shim_prep_splice(sqe, d.PipeRead, d.Sink.ClientFd, (uint)d.PipeBytes, SPLICE_F_MOVE);
+                if (d.Sink.IsDirectDescriptor)
+                    shim_sqe_set_fixed_file(sqe);
+            }
+            shim_sqe_set_data64(sqe, RelayUd(relay, dir));
+        }
+
+        /// <summary>A splice found its socket not ready (-EAGAIN): wait for readiness, then retry it.</summary>
+        private void RelayPoll(Relay relay, int dir, RelayDirection d, RelayOp op)
+        {
+            d.Op = op;
+            Connection c = op == RelayOp.PollIn ? d.Source : d.Sink;
+            io_uring_sqe* sqe = SqeGet();
+            shim_prep_poll_add(sqe, c.ClientFd, op == RelayOp.PollIn ? POLLIN : POLLOUT);
+            if (c.IsDirectDescriptor)
+                shim_sqe_set_fixed_file(sqe);
+            shim_sqe_set_data64(sqe, RelayUd(relay, dir));
+        }
+
+        /// <summary>Forwards the source's EOF: shuts down the sink's write side.</summary>
+        private void RelayShutdown(Relay relay, int dir, RelayDirection d)
+        {
+            d.Op = RelayOp.Shutdown;
+            io_uring_sqe* sqe = SqeGet();
+            shim_prep_shutdown(sqe, d.Sink.ClientFd, SHUT_WR);
+            if (d.Sink.IsDirectDescriptor)
+                shim_sqe_set_fixed_file(sqe);
+            shim_sqe_set_data64(sqe, RelayUd(relay, dir));
+        }
+
+        /// <summary>
+        /// Completion of a relay direction's operation. Stale CQEs (relay gone) are dropped; once the relay is
+        /// closing every completion only brings it closer to <see cref="FinishRelay"/>.
+        /// </summary>
+        private void OnRelay(int slot, uint generation, int res)
+        {
+            int index = slot >> 1;
+            int dir = slot & 1;
+            if ((uint)index >= (uint)_relays.Count)
+                return;
+            Relay? relay = _relays[index];
+            if (relay == null || relay.Generation != generation)
+                return;
+
+            RelayDirection d = relay.Directions[dir];
+            RelayOp op = d.Op;
+            d.Op = RelayOp.None;
+            if (relay.Closing)
+            {
+                FinishRelayIfIdle(relay);
+                return;
+            }
+
+            switch (op)
+            {
+                case RelayOp.Send:
+                    if (res <= 0)
+                    {
+                        FailRelay(relay, res == 0 ? -EPIPE : res);
+                        return;
+                    }
+                    OnRelaySent(d, res);
+                    break;
+                case RelayOp.SpliceIn:
+                    if (res == -EAGAIN)
+                    {
+                        RelayPoll(relay, dir, d, RelayOp.PollIn);
+                        return;
+                    }
+                    if (res < 0)
+                    {
+                        FailRelay(relay, res);
+                        return;
+                    }
+                    if (res == 0)
+                        d.Eof = true;
+                    d.PipeBytes = res;
+                    break;
+                case RelayOp.SpliceOut:
+                    if (res == -EAGAIN)
+                    {
+                        RelayPoll(relay, dir, d, RelayOp.PollOut);
+                        return;
+                    }
+                    if (res <= 0)
+                    {
+                        FailRelay(relay, res == 0 ? -EPIPE : res);
+                        return;
+                    }
+                    d.PipeBytes -= res;
+                    d.Bytes += res;
+                    break;
+                case RelayOp.PollIn:
+                case RelayOp.PollOut:
+                    if (res < 0)
+                    {
+                        FailRelay(relay, res);
+                        return;
+                    }
+                    break;
+                case RelayOp.Shutdown:
+                    // A failed shutdown (peer already gone) ends the direction all the same.
+                    d.Done = true;
+                    if (relay.Directions[dir ^ 1].Done)
+                    {
+                        FinishRelay(relay);
+                        return;
+                    }
+                    break;
+            }
+            PumpRelay(relay, dir);
+        }
+
+        /// <summary>
+        /// Retires the <paramref name="sent"/> bytes from the front of the queue, recycling every buffer that
+        /// went out completely, and resumes a paused source once the queue is back under half the window.
+        /// </summary>
+        private void OnRelaySent(RelayDirection d, int sent)
+        {
+            d.Bytes += sent;
+            int mask = d.Items.Length - 1;
+            int recycled = 0;
+            while (sent > 0)
+            {
+                RingItem item = d.Items[d.Head];
+                int left = item.Length - d.HeadOffset;
+                if (sent < left)
+                {
+                    d.HeadOffset += sent;
+                    break;
+                }
+                sent -= left;
+                d.HeadOffset = 0;
+                d.Head = (d.Head + 1) & mask;
+                d.Count--;
+                if (RecycleBuffer(item.BufferId))
+                    recycled++;
+            }
+            if (recycled != 0 && _starvedRecvs.Count != 0)
+                RearmStarvedRecvs();
+            if (d.Source.RecvParked && d.Count * 2 <= c_relayWindow)
+                TryResumeRecv(d.Source);
+        }
+
+        /// <summary>
+        /// Ends the relay with <paramref name="error"/>: cancels what is in flight and, once all of it has
+        /// completed, closes both connections.
+        /// </summary>
+        private void FailRelay(Relay relay, int error)
+        {
+            if (relay.Closing)
+                return;
+            relay.Closing = true;
+            relay.Error = error;
+            for (int dir = 0; dir < 2; dir++)
+            {
+                if (relay.Directions[dir].Op == RelayOp.None)
+                    continue;
+                io_uring_sqe* sqe = SqeGet();
+                shim_prep_cancel64(sqe, RelayUd(relay, dir), 0);
+                shim_sqe_set_data64(sqe, PackUd(UdKind.Cancel, -1, 0)); // resolves to no connection
+            }
+            FinishRelayIfIdle(relay);
+        }
+
+        private void FinishRelayIfIdle(Relay relay)
+        {
+            if (relay.Directions[0].Op == RelayOp.None && relay.Directions[1].Op == RelayOp.None)
+                FinishRelay(relay);
+        }
+
+        /// <summary>
+        /// Recycles whatever is still queued, closes both connections and completes <see cref="Connection.ProxyAsync"/>.
+        /// </summary>
+        private void FinishRelay(Relay relay)
+        {
+            foreach (RelayDirection d in relay.Directions)
+            {
+                while (d.Count != 0)
+                {
+                    RecycleBuffer(d.Items[d.Head].BufferId);
+                    d.Head = (d.Head + 1) & (d.Items.Length - 1);
+                    d.Count--;
+                }
+            }
+            _relays[relay.Index] = null;
+            _freeRelays.Push(relay.Index);
+            relay.A.Relay = null;
+            relay.B.Relay = null;
+            CloseConnection(relay.A, relay.Error);
+            CloseConnection(relay.B, relay.Error);
+            relay.Free();
+
+            if (relay.Error != 0 && IsLogEnabled(EngineLogLevel.Debug))
+                Log(EngineLogLevel.Debug, $"relay {relay.Index} ended: {relay.Error}");
+            relay.Completion.TrySetResult(relay.Result);
+        }
+
+        /// <summary>Completes the relays still running at shutdown; <see cref="CloseAll"/> closes their connections.</summary>
+        private void AbortRelays()
+        {
+            for (int i = 0; i < _relays.Count; i++)
+            {
+                Relay? relay = _relays[i];
+                if (relay == null)
+                    continue;
+                _relays[i] = null;
+                relay.A.Relay = null;
+                relay.B.Relay = null;
+                relay.Free();
+                relay.Error = -ECANCELED;
+                relay.Completion.TrySetResult(relay.Result);
+            }
+        }
+    }
+}
@@ -0,0 +1,116 @@
+using System.Collections.Concurrent;
+using System.Runtime.CompilerServices;
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>A callback queued to run on the reactor thread.</summary>
+        private readonly struct ScheduledWork(SendOrPostCallback callback, object? state)
+        {
+            public readonly SendOrPostCallback Callback = callback;
+            public readonly object? State = state;
+        }
+
+        /// <summary>Work posted from other threads (rings the doorbell).</summary>
+        private readonly ConcurrentQueue<ScheduledWork> _remoteWork = new();
+        /// <summary>Work posted from the reactor thread itself; plain queue, no atomics.</summary>
+        private readonly Queue<ScheduledWork> _localWork = new();
+        private ReactorSynchronizationContext? _context;
+        private ReactorTaskScheduler? _scheduler;
+
+        /// <summary>CPU this reactor's thread is pinned to, or -1 when not pinned.</summary>
+        public int Cpu { get; internal set; } = -1;
+
+        /// <summary>Synchronization context that posts to this reactor's thread.</summary>
+        public ReactorSynchronizationContext Context => _context ??= new ReactorSynchronizationContext(this);
+
+        /// <summary>Task scheduler that runs tasks on this reactor's thread.</summary>
+        public ReactorTaskScheduler Scheduler => _scheduler ??= new ReactorTaskScheduler(this);
+
+        /// <summary>True when called from this reactor's event loop thread.</summary>
+        public bool IsOnReactorThread
+        {
+            [MethodImpl(MethodImplOptions.AggressiveInlining)]
+            get => Environment.CurrentManagedThreadId == _loopThreadId;
+        }
+
+        /// <summary>The calling thread runs under this reactor's <see cref="Context"/>.</summary>
+        internal bool OwnsCurrentContext => _context != null && SynchronizationContext.Current == _context;
+
+        /// <summary>Local work is queued: the loop must not sleep in its CQ wait.</summary>
+        private bool HasLocalWork => _localWork.Count != 0;
+
+        /// <summary>
+        /// Prepares the calling thread to run this reactor: pins it to <see cref="Cpu"/> and, in
+        /// <see cref="ExecutionMode.ThreadPerCore"/> mode, installs <see cref="Context"/>.
+        /// Called on the reactor thread before <see cref="InitRing"/>.
+        /// </summary>
+        internal void EnterThread()
+        {
+            if (Cpu >= 0)
+            {
+                try
+                {
+                    Affinity.ImprovedPinCurrentThreadToCpu(Cpu);
+                }
+                catch (Exception ex) when (ex is InvalidOperationException or ArgumentOutOfRangeException or PlatformNotSupportedException)
+                {
+                    Log(EngineLogLevel.Warning, $"pinning to cpu {Cpu} failed, running unpinned: {ex.Message}");
+                    Cpu = -1;
+                }
+            }
+
+            if (_engine.Options.ExecutionMode == ExecutionMode.ThreadPerCore)
+                SynchronizationContext.SetSynchronizationContext(Context);
+        }
+
+        /// <summary>
+        /// Queues <paramref name="callback"/> to run on the reactor thread at the top of the next loop iteration.
+        /// From the reactor thread itself this is a plain enqueue; from other threads it also rings the doorbell.
+        /// </summary>
+        internal void Schedule(SendOrPostCallback callback, object? state)
+        {
+            if (IsOnReactorThread)
+            {
+                _localWork.Enqueue(new ScheduledWork(callback, state));
+                return;
+            }
+            _remoteWork.Enqueue(new ScheduledWork(callback, state));
+            Wake();
+        }
+
+        /// <summary>
+        /// Runs the work queued so far. Work queued while running waits for the next iteration,
+        /// so a continuation that keeps re-posting itself cannot starve completions.
+        /// </summary>
+        private void RunScheduledWork()
+        {
+            while (_remoteWork.TryDequeue(out ScheduledWork work))
+                _localWork.Enqueue(work);
+
+            int count = _localWork.Count;
+            for (int i = 0; i < count; i++)
+            {
+                ScheduledWork work = _localWork.Dequeue();
+                try
+                {
+                    work.Callback(work.State);
+                }
+                catch (Exception ex)
+                {
+                    Log(EngineLogLevel.Error, "scheduled work threw", ex);
+                }
+            }
+        }
+    }
+}
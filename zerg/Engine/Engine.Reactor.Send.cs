@@ -0,0 +1,102 @@
+using System.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>
+        /// Sends everything the connection has flushed and not sent yet, or ends its send sequence when
+        /// there is nothing left. Called with the sequence claimed (flush queue entry or send completion).
+        /// </summary>
+        private void StartSend(Connection c)
+        {
+            while (true)
+            {
+                long target = c.FlushPosition;
+                if (c.WriteHead < target)
+                {
+                    c.WriteInFlight = target;
+                    c.SendBatchStart = Stopwatch.GetTimestamp();
+                    Volatile.Write(ref c.SendInflight, 1);
+                    AddInFlightBytes(target - c.WriteHead);
+                    ArmFlushDeadline(c);
+
+                    if (UseZeroCopySend(c, c.WriteHead, target))
+                        SendZeroCopy(c, target);
+                    else
+                        Send(c, c.WriteHead, target);
+                    return;
+                }
+                if (c.TryEndSending())
+                {
+                    c.FlushDeadlineMs = 0;
+                    if (c.Relay != null)
+                        OnRelaySinkIdle(c);
+                    else if (c.FileSend != null)
+                        PumpFileSend(c.FileSend);
+                    return;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Enqueue a send SQE of the connection's staged range [off, end) on this reactor's ring:
+        /// a plain send when the range lies in one block of the write chain, one sendmsg over the chain otherwise.
+        /// </summary>
+        private void Send(Connection c, long off, long end)
+        {
+            CountSend();
+            io_uring_sqe* sqe = SqeGet();
+            byte* contiguous = c.ContiguousRange(off, end, out _);
+            if (contiguous != null)
+                shim_prep_send(sqe, c.ClientFd, contiguous, (uint)(end - off), 0);
+            else
+                shim_prep_sendmsg(sqe, c.ClientFd, c.PrepareSendMsg(off, end), 0);
+            if (c.IsDirectDescriptor)
+                shim_sqe_set_fixed_file(sqe);
+            shim_sqe_set_data64(sqe, PackUd(UdKind.Send, c.Slot, c.SlotGeneration));
+        }
+
+        /// <summary>
+        /// Send CQE: advances the connection's sent position, resubmits the rest of a partial send and, once the
+        /// batch is out, moves straight on to anything flushed while it was in flight.
+        /// <paramref name="c"/> is null when the CQE belongs to a closed lifetime of its slot.
+        /// </summary>
+        private void OnSend(Connection? c, int res)
+        {
+            if (c == null)
+                return;
+
+            CountSendResult(c, res);
+            if (res <= 0)
+            {
+                // error/close handling
+                AddInFlightBytes(-(c.WriteInFlight - c.WriteHead));
+                Volatile.Write(ref c.SendInflight, 0);
+                return;
+            }
+
+            AddInFlightBytes(-res);
+            c.AdvanceSent(res);
+
+            // Still flushing target snapshot
+            if (c.WriteHead < c.WriteInFlight)
+            {
+                ArmFlushDeadline(c);
+                Send(c, c.WriteHead, c.WriteInFlight);
+                return;
+            }
+
+            RecordFlushLatency(c);
+            Volatile.Write(ref c.SendInflight, 0);
+            StartSend(c);
+        }
+    }
+}
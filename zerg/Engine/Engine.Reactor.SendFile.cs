@@ -0,0 +1,443 @@
+using System.Runtime.InteropServices;
+using Microsoft.Win32.SafeHandles;
+using zerg.Engine.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>Bytes moved per step of a file send: the default pipe capacity, and the size of a read buffer.</summary>
+        private const int c_fileSendChunk = 64 * 1024;
+
+        /// <summary>Operation of a file send, packed into the low bits of its user_data slot.</summary>
+        internal enum FileSendOp
+        {
+            /// <summary>File to pipe (splice) or file to read buffer (read).</summary>
+            In = 0,
+            /// <summary>Pipe to socket (splice) or read buffer to socket (send).</summary>
+            Out = 1,
+            /// <summary>Waits for the socket to take more after a splice found it full.</summary>
+            Poll = 2
+        }
+
+        /// <summary>
+        /// A read buffer of the fallback path. Registered in the ring's fixed-buffer table when a slot is free,
+        /// so reads into it are <c>READ_FIXED</c>. Lives as long as the reactor.
+        /// </summary>
+        internal sealed class FileReadBuffer(byte* ptr, int fixedIndex)
+        {
+            public readonly byte* Ptr = ptr;
+            public readonly int FixedIndex = fixedIndex;
+        }
+
+        /// <summary>
+        /// A <see cref="Connection.SendFileAsync(SafeFileHandle, long, long)"/> in progress. Created on the calling
+        /// thread, owned by the reactor from <see cref="BeginFileSend"/> on.
+        /// </summary>
+        internal sealed class FileSend(Connection connection, SafeFileHandle? handle, int fd, long offset, long length)
+        {
+            public readonly Connection Connection = connection;
+            public readonly int ConnectionGeneration = connection.Generation;
+            /// <summary>The caller's handle, referenced (DangerousAddRef) until the send ends; null for a raw fd.</summary>
+            public readonly SafeFileHandle? Handle = handle;
+            public readonly int Fd = fd;
+
+            /// <summary>File offset of the next byte to take in.</summary>
+            public long Offset = offset;
+            /// <summary>Bytes still to take in from the file.</summary>
+            public long Remaining = length;
+            public long Sent;
+
+            /// <summary>Splicing through <see cref="PipeRead"/>/<see cref="PipeWrite"/>; otherwise reading into <see cref="Buffer"/>.</summary>
+            public bool UseSplice;
+            public int PipeRead = -1;
+            public int PipeWrite = -1;
+            public FileReadBuffer? Buffer;
+            /// <summary>Bytes taken in (in the pipe, or in the buffer from <see cref="StagedOffset"/>) and not sent yet.</summary>
+            public int Staged;
+            public int StagedOffset;
+
+            /// <summary>Bit (1 &lt;&lt; <see cref="FileSendOp"/>) per operation in flight.</summary>
+            public int Ops;
+            /// <summary>The last splice out found the socket full.</summary>
+            public bool NeedPoll;
+            /// <summary>The connection closed: in-flight operations are being cancelled, then the send is dropped.</summary>
+            public bool Closing;
+            public int Error;
+
+            /// <summary>Slot in the reactor's file-send table, packed into user_data with <see cref="Generation"/>.</summary>
+            public int Index = -1;
+            public uint Generation;
+        }
+
+        private static readonly SendOrPostCallback s_beginFileSend = static state =>
+        {
+            FileSend send = (FileSend)state!;
+            send.Connection.Reactor.BeginFileSend(send);
+        };
+
+        /// <summary>Active file sends, indexed by <see cref="FileSend.Index"/>.</summary>
+        private readonly List<FileSend?> _fileSends = [];
+        private readonly Stack<int> _freeFileSends = new();
+        private uint _fileSendGeneration;
+
+        /// <summary>Idle pipes of earlier file sends (empty, ready for reuse).</summary>
+        private readonly Stack<(int Read, int Write)> _fileSendPipes = new();
+        /// <summary>Idle read buffers, and every one ever allocated (freed once the ring is gone).</summary>
+        private readonly Stack<FileReadBuffer> _fileReadBuffers = new();
+        private readonly List<FileReadBuffer> _allFileReadBuffers = [];
+
+        /// <summary>
+        /// Queues a file send for <paramref name="c"/> (see <see cref="Connection.SendFileAsync(SafeFileHandle, long, long)"/>).
+        /// Any thread; completes the connection's flush waiter when done.
+        /// </summary>
+        internal void StartFileSend(Connection c, SafeFileHandle? handle, int fd, long offset, long length)
+            => Schedule(s_beginFileSend, new FileSend(c, handle, fd, offset, length));
+
+        /// <summary>
+        /// Registers the send and starts it once the connection's write chain is out. Splices through a pipe
+        /// when the kernel supports it, otherwise reads into a buffer and sends from there.
+        /// </summary>
+        private void BeginFileSend(FileSend send)
+        {
+            Connection c = send.Connection;
+            if (!_engine.ServerRunning || c.Generation != send.ConnectionGeneration || c.Slot < 0 ||
+                _connectionSlots.Get(c.Slot, c.SlotGeneration) != c)
+            {
+                send.Handle?.DangerousRelease();
+                if (c.Generation == send.ConnectionGeneration)
+                    c.CompleteFileSend(-ENOTCONN);
+                return;
+            }
+
+            send.Generation = ++_fileSendGeneration & UdGenerationMask;
+            if (_freeFileSends.Count != 0)
+            {
+                send.Index = _freeFileSends.Pop();
+                _fileSends[send.Index] = send;
+            }
+            else
+            {
+                send.Index = _fileSends.Count;
+                _fileSends.Add(send);
+            }
+            c.FileSend = send;
+
+            send.UseSplice = KernelCapabilities.Current.Splice && TryTakeFileSendPipe(send);
+            if (!send.UseSplice)
+                send.Buffer = TakeFileReadBuffer();
+            PumpFileSend(send);
+        }
+
+        private bool TryTakeFileSendPipe(FileSend send)
+        {
+            if (!_fileSendPipes.TryPop(out (int Read, int Write) pipe))
+            {
+                int* fds = stackalloc int[2];
+                if (pipe2(fds, O_CLOEXEC) < 0)
+                {
+                    Log(EngineLogLevel.Warning, $"pipe2 failed, errno={Marshal.GetLastPInvokeError()}: sending file by reads");
+                    return false;
+                }
+                pipe = (fds[0], fds[1]);
+            }
+            send.PipeRead = pipe.Read;
+            send.PipeWrite = pipe.Write;
+            return true;
+        }
+
+        /// <summary>Takes an idle read buffer or allocates one, registering it as a fixed buffer if a slot is free.</summary>
+        private FileReadBuffer TakeFileReadBuffer()
+        {
+            if (_fileReadBuffers.TryPop(out FileReadBuffer? buffer))
+                return buffer;
+
+            byte* ptr = (byte*)NativeMemory.AlignedAlloc(c_fileSendChunk, 4096);
+            int fixedIndex = -1;
+            if (_fixedWriteSlotCount != 0)
+            {
+                int slot = _fixedWriteSlots![--_fixedWriteSlotCount];
+                if (shim_register_buffer_slot(io_uring_instance, (uint)slot, ptr, c_fileSendChunk) >= 0)
+                    fixedIndex = slot;
+                else
+                    _fixedWriteSlots[_fixedWriteSlotCount++] = slot;
+            }
+            buffer = new FileReadBuffer(ptr, fixedIndex);
+            _allFileReadBuffers.Add(buffer);
+            return buffer;
+        }
+
+        /// <summary>
+        /// Issues the next step of a file send once nothing is in flight: anything taken in and not sent yet
+        /// goes out first, then the next chunk is taken in and sent by a linked pair of operations (a short
+        /// read or splice cancels its send, and the bytes it did take in go out on the next step).
+        /// Waits while the connection's write chain is still sending what its handler flushed before.
+        /// </summary>
+        private void PumpFileSend(FileSend send)
+        {
+            if (send.Ops != 0)
+                return;
+            if (send.Closing || send.Error != 0 || (send.Staged == 0 && send.Remaining == 0))
+            {
+                FinishFileSend(send);
+                return;
+            }
+            if (send.Connection.IsSending)
+                return;
+
+            if (send.NeedPoll)
+            {
+                send.NeedPoll = false;
+                FileSendPoll(send);
+            }
+            else if (send.Staged != 0)
+            {
+                FileSendOut(send, send.Staged);
+            }
+            else
+            {
+                int chunk = (int)Math.Min(send.Remaining, c_fileSendChunk);
+                send.StagedOffset = 0;
+                // Both halves of the link must go out in one submit: a link left open at its end is cut short.
+                if (shim_sq_ready(io_uring_instance) + 2 > Config.RingEntries)
+                    Submit();
+                FileSendIn(send, chunk);
+                FileSendOut(send, chunk);
+            }
+        }
+
+        private ulong FileSendUd(FileSend send, FileSendOp op)
+            => PackUd(UdKind.SendFile, (send.Index << 2) | (int)op, send.Generation);
+
+        /// <summary>
+        /// Splices the next <paramref name="count"/> file bytes into the pipe, or reads them into the buffer.
+        /// Linked to the <see cref="FileSendOut"/> issued right after it.
+        /// </summary>
+        private void FileSendIn(FileSend send, int count)
+        {
+            send.Ops |= 1 << (int)FileSendOp.In;
+            io_uring_sqe* sqe = SqeGet();
+            if (send.UseSplice)
+                shim_prep_splice_from(sqe, send.Fd, send.Offset, send.PipeWrite, (uint)count, SPLICE_F_MOVE);
+            else if (send.Buffer!.FixedIndex >= 0)
+                shim_prep_read_fixed(sqe, send.Fd, send.Buffer.Ptr, (uint)count, (ulong)send.Offset, (uint)send.Buffer.FixedIndex);
+            else
+                shim_prep_read(sqe, send.Fd, send.Buffer.Ptr, (uint)count, (ulong)send.Offset);
+            shim_sqe_set_link(sqe);
+            shim_sqe_set_data64(sqe, FileSendUd(send, FileSendOp.In));
+        }
+
+        /// <summary>Splices <paramref name="count"/> bytes from the pipe to the socket, or sends them from the buffer.</summary>
+        private void FileSendOut(FileSend send, int count)
+        {
+            send.Ops |= 1 << (int)FileSendOp.Out;
+            Connection c = send.Connection;
+            CountSend();
+            io_uring_sqe* sqe = SqeGet();
+            if (send.UseSplice)
+                shim_prep_splice(sqe, send.PipeRead, c.ClientFd, (uint)count, SPLICE_F_MOVE);
+            else
+                shim_prep_send(sqe, c.ClientFd, send.Buffer!.Ptr + send.StagedOffset, (uint)count, 0);
+            if (c.IsDirectDescriptor)
+                shim_sqe_set_fixed_file(sqe);
+            shim_sqe_set_data64(sqe, FileSendUd(send, FileSendOp.Out));
+        }
+
+        /// <summary>A splice found the socket full (-EAGAIN): wait until it takes more.</summary>
+        private void FileSendPoll(FileSend send)
+        {
+            send.Ops |= 1 << (int)FileSendOp.Poll;
+            Connection c = send.Connection;
+            io_uring_sqe* sqe = SqeGet();
+            shim_prep_poll_add(sqe, c.ClientFd, POLLOUT);
+            if (c.IsDirectDescriptor)
+                shim_sqe_set_fixed_file(sqe);
+            shim_sqe_set_data64(sqe, FileSendUd(send, FileSendOp.Poll));
+        }
+
+        /// <summary>
+        /// Completion of a file send's operation. Stale CQEs (send gone) are dropped. The results of a linked
+        /// pair are applied as they come; the next step is issued once both are in.
+        /// </summary>
+        private void OnFileSend(int slot, uint generation, int res)
+        {
+            int index = slot >> 2;
+            FileSendOp op = (FileSendOp)(slot & 3);
+            if ((uint)index >= (uint)_fileSends.Count)
+                return;
+            FileSend? send = _fileSends[index];
+            if (send == null || send.Generation != generation)
+                return;
+
+            send.Ops &= ~(1 << (int)op);
+            if (!send.Closing)
+            {
+                switch (op)
+                {
+                    case FileSendOp.In:
+                        OnFileSendIn(send, res);
+                        break;
+                    case FileSendOp.Out:
+                        OnFileSendOut(send, res);
+                        break;
+                    case FileSendOp.Poll:
+                        if (res < 0 && send.Error == 0)
+                            send.Error = res;
+                        break;
+                }
+            }
+            PumpFileSend(send);
+        }
+
+        private void OnFileSendIn(FileSend send, int res)
+        {
+            if (res > 0)
+            {
+                send.Staged += res;
+                send.Offset += res;
+                send.Remaining -= res;
+            }
+            else if (res == -EINVAL && send.UseSplice && send.Staged == 0)
+            {
+                // The file system cannot splice: carry on with reads (the linked splice out is cancelled).
+                ReturnFileSendPipe(send);
+                send.UseSplice = false;
+                send.Buffer = TakeFileReadBuffer();
+            }
+            else if (send.Error == 0)
+            {
+                // EOF before the requested length: the file is shorter than the caller said.
+                send.Error = res == 0 ? -EIO : res;
+            }
+        }
+
+        private void OnFileSendOut(FileSend send, int res)
+        {
+            if (res > 0)
+            {
+                send.Staged -= res;
+                send.StagedOffset += res;
+                send.Sent += res;
+                return;
+            }
+            switch (res)
+            {
+                case -ECANCELED:
+                    // Short or failed In: whatever it took in goes out on the next step.
+                    break;
+                case -EAGAIN:
+                    send.NeedPoll = true;
+                    break;
+                default:
+                    if (send.Error == 0)
+                        send.Error = res == 0 ? -EPIPE : res;
+                    break;
+            }
+        }
+
+        /// <summary>
+        /// The connection is closing (from <see cref="CloseConnection"/>): cancels what is in flight and drops
+        /// the send once all of it has completed. The flush waiter is failed by the connection's reset.
+        /// </summary>
+        private void AbortFileSend(Connection c)
+        {
+            FileSend send = c.FileSend!;
+            c.FileSend = null;
+            send.Closing = true;
+            for (int op = 0; op < 3; op++)
+            {
+                if ((send.Ops & (1 << op)) == 0)
+                    continue;
+                io_uring_sqe* sqe = SqeGet();
+                shim_prep_cancel64(sqe, FileSendUd(send, (FileSendOp)op), 0);
+                shim_sqe_set_data64(sqe, PackUd(UdKind.Cancel, -1, 0)); // resolves to no connection
+            }
+            PumpFileSend(send);
+        }
+
+        /// <summary>
+        /// Releases the send's pipe, buffer and file reference, and completes the connection's flush waiter
+        /// unless the connection closed meanwhile.
+        /// </summary>
+        private void FinishFileSend(FileSend send)
+        {
+            _fileSends[send.Index] = null;
+            _freeFileSends.Push(send.Index);
+
+            if (send.UseSplice)
+            {
+                if (send.Staged == 0)
+                    ReturnFileSendPipe(send);
+                else
+                    CloseFileSendPipe(send);
+            }
+            if (send.Buffer != null)
+            {
+                _fileReadBuffers.Push(send.Buffer);
+                send.Buffer = null;
+            }
+            send.Handle?.DangerousRelease();
+
+            if (send.Error != 0 && IsLogEnabled(EngineLogLevel.Debug))
+                Log(EngineLogLevel.Debug, $"file send {send.Index} ended after {send.Sent} bytes: {send.Error}");
+            if (send.Closing)
+                return;
+            send.Connection.FileSend = null;
+            send.Connection.CompleteFileSend(send.Error);
+        }
+
+        private void ReturnFileSendPipe(FileSend send)
+        {
+            _fileSendPipes.Push((send.PipeRead, send.PipeWrite));
+            send.PipeRead = send.PipeWrite = -1;
+        }
+
+        private static void CloseFileSendPipe(FileSend send)
+        {
+            close(send.PipeRead);
+            close(send.PipeWrite);
+            send.PipeRead = send.PipeWrite = -1;
+        }
+
+        /// <summary>
+        /// Ends the file sends still running at shutdown; <see cref="CloseAll"/> then fails their flush waiters
+        /// as it closes the connections. Read buffers are freed by <see cref="FreeFileSendBuffers"/> once the ring is gone.
+        /// </summary>
+        private void AbortFileSends()
+        {
+            for (int i = 0; i < _fileSends.Count; i++)
+            {
+                FileSend? send = _fileSends[i];
+                if (send == null)
+                    continue;
+                _fileSends[i] = null;
+                if (!send.Closing)
+                    send.Connection.FileSend = null;
+                if (send.PipeRead >= 0)
+                    CloseFileSendPipe(send);
+                send.Handle?.DangerousRelease();
+            }
+            while (_fileSendPipes.TryPop(out (int Read, int Write) pipe))
+            {
+                close(pipe.Read);
+                close(pipe.Write);
+            }
+        }
+
+        /// <summary>Frees the read buffers of file sends (after the ring is destroyed: a cancelled read may still target one).</summary>
+        private void FreeFileSendBuffers()
+        {
+            foreach (FileReadBuffer buffer in _allFileReadBuffers)
+                NativeMemory.AlignedFree(buffer.Ptr);
+            _allFileReadBuffers.Clear();
+            _fileReadBuffers.Clear();
+        }
+    }
+}
@@ -0,0 +1,280 @@
+using System.Runtime.CompilerServices;
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+using zerg.Utils.MultiProducerSingleConsumer;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>Buckets per wheel level (6 bits of the tick per level).</summary>
+        private const int c_timerBits = 6;
+        private const int c_timerBuckets = 1 << c_timerBits;
+        private const int c_timerMask = c_timerBuckets - 1;
+        /// <summary>Four levels of 1 ms ticks reach 2^24 ms (about 4.6 hours); later deadlines are re-checked then.</summary>
+        private const int c_timerLevels = 4;
+        private const long c_timerHorizon = 1L << (c_timerBits * c_timerLevels);
+
+        /// <summary>
+        /// Hierarchical timing wheel of connection deadlines, one intrusive list per bucket
+        /// (<see cref="Connection.TimerNext"/>). Level 0 buckets are single 1 ms ticks; level k buckets span
+        /// 64^k ticks and are cascaded into the level below when the wheel reaches them.
+        /// Each connection has at most one entry, at its earliest deadline.
+        /// </summary>
+        private readonly Connection?[] _timerWheel = new Connection?[c_timerLevels * c_timerBuckets];
+        /// <summary>Last tick (Environment.TickCount64 ms) the wheel has processed.</summary>
+        private long _timerTick;
+        /// <summary>Loop time of the current iteration, stamped on recvs and sends.</summary>
+        private long _timerNow;
+        private int _timerCount;
+
+        /// <summary>
+        /// Connections whose handler moved a deadline earlier than their wheel entry, as slots packed with
+        /// their generation (<see cref="PackUd(UdKind, int, uint)"/>).
+        /// </summary>
+        private readonly MpscUlongQueue _timerQ = new(capacityPow2: 4096);
+        /// <summary>Timer updates issued on the reactor thread itself (see <see cref="_localReturns"/>).</summary>
+        private readonly Queue<ulong> _localTimerUpdates = new();
+
+        private void InitTimers()
+        {
+            _timerNow = Environment.TickCount64;
+            _timerTick = _timerNow;
+        }
+
+        /// <summary>
+        /// Asks the reactor to re-evaluate the deadlines of <paramref name="connection"/>
+        /// (see <see cref="Connection.SetReadHeaderTimeout"/>). Dropped if its slot is reused first.
+        /// </summary>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        internal void EnqueueTimerUpdate(Connection connection)
+        {
+            ulong key = PackUd(UdKind.Recv, connection.Slot, connection.SlotGeneration);
+            if (IsOnReactorThread)
+            {
+                _localTimerUpdates.Enqueue(key);
+                return;
+            }
+            while (!_timerQ.TryEnqueue(key))
+                Thread.Yield();
+            Wake();
+        }
+
+        /// <summary>Starts the deadlines of a newly registered connection from the reactor defaults.</summary>
+        private void InitConnectionTimers(Connection connection)
+        {
+            connection.IdleTimeoutMs = Config.IdleTimeoutMs;
+            connection.FlushTimeoutMs = Config.FlushTimeoutMs;
+            connection.ReadHeaderDeadlineMs = 0;
+            connection.FlushDeadlineMs = 0;
+            connection.LastRecvMs = Environment.TickCount64;
+            if (connection.IdleTimeoutMs != 0)
+                ScheduleTimer(connection);
+        }
+
+        /// <summary>
+        /// Called once per loop iteration: applies handler deadline updates, then advances the wheel to
+        /// <paramref name="now"/>, cascading and expiring buckets tick by tick.
+        /// </summary>
+        private void AdvanceTimers(long now)
+        {
+            _timerNow = now;
+            while (_localTimerUpdates.TryDequeue(out ulong key) || _timerQ.TryDequeue(out key))
+            {
+                Connection? c = _connectionSlots.Get(UdSlotOf(key), UdGenerationOf(key));
+                if (c != null)
+                    ScheduleTimer(c);
+            }
+
+            if (_timerCount == 0)
+            {
+                _timerTick = now;
+                return;
+            }
+
+            while (_timerTick < now)
+            {
+                if (_timerCount == 0)
+                {
+                    _timerTick = now;
+                    break;
+                }
+
+                long tick = _timerTick + 1;
+                if ((tick & c_timerMask) == 0 && CascadeTimers(1, tick) && CascadeTimers(2, tick))
+                    CascadeTimers(3, tick);
+                _timerTick = tick;
+
+                ref Connection? bucket = ref _timerWheel[(int)(tick & c_timerMask)];
+                Connection? c = bucket;
+                bucket = null;
+                while (c != null)
+                {
+                    Connection? next = c.TimerNext;
+                    c.TimerNext = c.TimerPrev = null;
+                    c.TimerBucket = -1;
+                    _timerCount--;
+                    OnTimer(c, now);
+                    c = next;
+                }
+            }
+        }
+
+        /// <summary>Moves the entries of the level bucket the wheel just reached down a level. True if it was bucket 0.</summary>
+        private bool CascadeTimers(int level, long tick)
+        {
+            int index = (int)(tick >> (c_timerBits * level)) & c_timerMask;
+            ref Connection? bucket = ref _timerWheel[level * c_timerBuckets + index];
+            Connection? c = bucket;
+            bucket = null;
+            while (c != null)
+            {
+                Connection? next = c.TimerNext;
+                _timerCount--;
+                LinkTimer(c, c.TimerDueMs);
+                c = next;
+            }
+            return index == 0;
+        }
+
+        /// <summary>
+        /// A connection's entry fired: closes it if a deadline has passed, otherwise re-links it at its current
+        /// earliest deadline (deadlines pushed back since it was linked are picked up here).
+        /// </summary>
+        private void OnTimer(Connection c, long now)
+        {
+            Interlocked.Exchange(ref c.TimerDueMs, long.MaxValue);
+            if (c.Relay != null)
+                return; // a relayed connection ends through its relay
+
+            long readHeader = Volatile.Read(ref c.ReadHeaderDeadlineMs);
+            if (readHeader != 0 && readHeader <= now)
+            {
+                Volatile.Write(ref _counters.ReadHeaderTimeouts, _counters.ReadHeaderTimeouts + 1);
+                CloseOnTimeout(c, "read header");
+                return;
+            }
+
+            if (c.FlushDeadlineMs != 0 && c.FlushDeadlineMs <= now && c.WriteHead < c.FlushPosition)
+            {
+                Volatile.Write(ref _counters.FlushTimeouts, _counters.FlushTimeouts + 1);
+                CloseOnTimeout(c, "flush");
+                return;
+            }
+
+            long idle = Volatile.Read(ref c.IdleTimeoutMs);
+            if (idle != 0)
+            {
+                if (c.RecvPaused)
+                    c.LastRecvMs = now; // the handler is behind, not the peer
+                else if (c.LastRecvMs + idle <= now)
+                {
+                    Volatile.Write(ref _counters.IdleTimeouts, _counters.IdleTimeouts + 1);
+                    CloseOnTimeout(c, "idle");
+                    return;
+                }
+            }
+
+            ScheduleTimer(c);
+        }
+
+        private void CloseOnTimeout(Connection c, string deadline)
+        {
+            if (IsLogEnabled(EngineLogLevel.Debug))
+                Log(EngineLogLevel.Debug, $"closing connection in slot {c.Slot}: {deadline} timeout");
+            CloseConnection(c, -ETIMEDOUT);
+        }
+
+        /// <summary>(Re-)links the connection at its earliest deadline, or unlinks it when it has none. O(1).</summary>
+        private void ScheduleTimer(Connection c)
+        {
+            // Publish "no entry" before reading the deadlines, so a handler that sets an earlier one
+            // concurrently either is seen here or sees this and enqueues an update (see Connection.RequestTimer).
+            CancelTimer(c);
+            Interlocked.Exchange(ref c.TimerDueMs, long.MaxValue);
+
+            long due = long.MaxValue;
+            long idle = Volatile.Read(ref c.IdleTimeoutMs);
+            if (idle != 0)
+                due = c.LastRecvMs + idle;
+            long readHeader = Volatile.Read(ref c.ReadHeaderDeadlineMs);
+            if (readHeader != 0 && readHeader < due)
+                due = readHeader;
+            if (c.FlushDeadlineMs != 0 && c.FlushDeadlineMs < due)
+                due = c.FlushDeadlineMs;
+
+            if (due != long.MaxValue)
+                LinkTimer(c, due);
+        }
+
+        /// <summary>
+        /// Links the connection in the bucket for <paramref name="due"/>: level 0 within 64 ticks of the next one
+        /// to process, otherwise the level whose bucket span covers the distance.
+        /// </summary>
+        private void LinkTimer(Connection c, long due)
+        {
+            long next = _timerTick + 1;
+            long tick = Math.Max(due, next);
+            long delta = tick - next;
+            if (delta >= c_timerHorizon)
+            {
+                tick = next + c_timerHorizon - 1;
+                delta = c_timerHorizon - 1;
+            }
+
+            int level = 0;
+            while (delta >= 1L << (c_timerBits * (level + 1)))
+                level++;
+            int bucket = level * c_timerBuckets + ((int)(tick >> (c_timerBits * level)) & c_timerMask);
+
+            Connection? head = _timerWheel[bucket];
+            c.TimerPrev = null;
+            c.TimerNext = head;
+            if (head != null)
+                head.TimerPrev = c;
+            _timerWheel[bucket] = c;
+            c.TimerBucket = bucket;
+            Volatile.Write(ref c.TimerDueMs, tick);
+            _timerCount++;
+        }
+
+        /// <summary>Unlinks the connection's wheel entry, if any. O(1).</summary>
+        private void CancelTimer(Connection c)
+        {
+            if (c.TimerBucket < 0)
+                return;
+
+            if (c.TimerPrev != null)
+                c.TimerPrev.TimerNext = c.TimerNext;
+            else
+                _timerWheel[c.TimerBucket] = c.TimerNext;
+            if (c.TimerNext != null)
+                c.TimerNext.TimerPrev = c.TimerPrev;
+
+            c.TimerNext = c.TimerPrev = null;
+            c.TimerBucket = -1;
+            Volatile.Write(ref c.TimerDueMs, long.MaxValue);
+            _timerCount--;
+        }
+
+        /// <summary>Restarts the flush deadline of a connection whose send made progress (or just started).</summary>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private void ArmFlushDeadline(Connection c)
+        {
+            long timeout = Volatile.Read(ref c.FlushTimeoutMs);
+            if (timeout == 0)
+                return;
+            long deadline = _timerNow + timeout;
+            c.FlushDeadlineMs = deadline;
+            if (deadline < c.TimerDueMs)
+                ScheduleTimer(c);
+        }
+    }
+}
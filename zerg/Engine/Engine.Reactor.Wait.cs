@@ -0,0 +1,165 @@
+using System.Diagnostics;
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>Weight of a new idle-gap sample in the moving average (1/8).</summary>
+        private const int c_idleGapShift = 3;
+
+        /// <summary>True when the reactor spins before (or instead of) blocking.</summary>
+        private bool _spinWait;
+        /// <summary><see cref="WaitStrategy.Spin"/>: never block in the kernel.</summary>
+        private bool _spinOnly;
+        private bool _adaptiveSpin;
+        /// <summary>Longest spin, in Stopwatch ticks.</summary>
+        private long _spinBudgetTicks;
+        /// <summary>Length of the next spin, in Stopwatch ticks (0: go straight to the kernel).</summary>
+        private long _spinLimitTicks;
+        /// <summary>Moving average of the time from running out of completions to the next one.</summary>
+        private long _idleGapTicks;
+        /// <summary>Timestamp at which the current idle gap started.</summary>
+        private long _idleStart;
+
+        private long _spins;
+        private long _spinHits;
+        private long _spinTicks;
+        private long _wastedSpinTicks;
+        private long _kernelWaits;
+
+        /// <summary>True when NAPI busy polling is registered on the ring (see <see cref="ReactorConfig.NapiBusyPollTimeout"/>).</summary>
+        public bool NapiBusyPoll { get; private set; }
+
+        /// <summary>
+        /// Sets up the <see cref="ReactorConfig.WaitStrategy"/> and registers NAPI busy polling if configured.
+        /// </summary>
+        private void InitWait()
+        {
+            _spinWait = Config.WaitStrategy != WaitStrategy.Block;
+            _spinOnly = Config.WaitStrategy == WaitStrategy.Spin;
+            _adaptiveSpin = Config.WaitStrategy == WaitStrategy.Hybrid && Config.AdaptiveSpin;
+            long budgetNs = _spinOnly ? Config.CqTimeout : Math.Max(0, Config.SpinBudget);
+            _spinBudgetTicks = budgetNs * Stopwatch.Frequency / 1_000_000_000;
+            _spinLimitTicks = _spinBudgetTicks;
+
+            if (Config.NapiBusyPollTimeout == 0)
+                return;
+            int rc = shim_register_napi(io_uring_instance, Config.NapiBusyPollTimeout, Config.NapiPreferBusyPoll ? 1 : 0);
+            NapiBusyPoll = rc == 0;
+            if (!NapiBusyPoll)
+                Log(EngineLogLevel.Warning, $"register_napi failed: {rc}, NAPI busy polling disabled");
+        }
+
+        /// <summary>
+        /// Ring setup flags for the wait strategy: a spinning reactor on a COOP_TASKRUN / DEFER_TASKRUN ring
+        /// needs IORING_SETUP_TASKRUN_FLAG to learn, without a syscall, that completions wait to be posted.
+        /// </summary>
+        private uint WaitRingFlags(uint flags)
+        {
+            if (Config.WaitStrategy == WaitStrategy.Block
+                || (flags & IORING_SETUP_SQPOLL) != 0
+                || (flags & (IORING_SETUP_COOP_TASKRUN | IORING_SETUP_DEFER_TASKRUN)) == 0
+                || !KernelCapabilities.Current.TaskrunFlag)
+                return flags;
+            return flags | IORING_SETUP_TASKRUN_FLAG;
+        }
+
+        /// <summary>
+        /// Called by the loop when it finds no completions. Spins per the wait strategy, then returns the
+        /// timeout for the kernel wait, or null when the spin found completions or cross-thread work and the
+        /// loop should harvest without entering the kernel.
+        /// </summary>
+        private __kernel_timespec* BeginIdleWait(__kernel_timespec* timeout, __kernel_timespec* noWait)
+        {
+            if (HasLocalWork)
+            {
+                _idleStart = 0; // not idle: a poll, not a gap worth sampling
+                return noWait;
+            }
+            if (!_spinWait)
+                return timeout;
+
+            long start = Stopwatch.GetTimestamp();
+            _idleStart = start;
+            if (_spinLimitTicks == 0)
+                return timeout;
+
+            // Whatever the loop queued must be in flight before there is anything to wait for.
+            if (shim_sq_ready(io_uring_instance) > 0)
+                Submit();
+
+            long deadline = start + _spinLimitTicks;
+            long now;
+            bool hit;
+            do
+            {
+                hit = shim_poll_cqes(io_uring_instance) != 0 || Volatile.Read(ref _wakeRung.Value) != 0;
+                now = Stopwatch.GetTimestamp();
+            } while (!hit && now < deadline);
+
+            long spun = now - start;
+            Volatile.Write(ref _spins, _spins + 1);
+            Volatile.Write(ref _spinTicks, _spinTicks + spun);
+            if (!hit)
+            {
+                Volatile.Write(ref _wastedSpinTicks, _wastedSpinTicks + spun);
+                return _spinOnly ? noWait : timeout;
+            }
+            Volatile.Write(ref _spinHits, _spinHits + 1);
+            SampleIdleGap(spun);
+            return null;
+        }
+
+        /// <summary>Called by the loop after a kernel wait returns (completions, timeout or error).</summary>
+        private void EndKernelWait()
+        {
+            Volatile.Write(ref _kernelWaits, _kernelWaits + 1);
+            if (_adaptiveSpin && _idleStart != 0)
+                SampleIdleGap(Stopwatch.GetTimestamp() - _idleStart);
+        }
+
+        /// <summary>
+        /// Folds one idle gap into the moving average and sizes the next spin from it: twice the average gap
+        /// (at least 1/16 of the budget, at most the budget), or no spin while the average exceeds the budget.
+        /// A gap that ended in a timed-out kernel wait counts as 4x the budget, so one long idle period
+        /// switches spinning off without taking long to recover from.
+        /// </summary>
+        private void SampleIdleGap(long ticks)
+        {
+            if (!_adaptiveSpin)
+                return;
+            long budget = _spinBudgetTicks;
+            if (ticks > 4 * budget)
+                ticks = 4 * budget;
+            _idleGapTicks += (ticks - _idleGapTicks) >> c_idleGapShift;
+            long limit = _idleGapTicks < budget ? Math.Clamp(2 * _idleGapTicks, budget / 16, budget) : 0;
+            Volatile.Write(ref _spinLimitTicks, limit);
+        }
+
+        /// <summary>
+        /// Snapshot of this reactor's idle-wait counters: spins, their hit rate and time, and kernel waits.
+        /// Safe to call from any thread.
+        /// </summary>
+        public ReactorWaitStats GetWaitStats()
+            => new(Config.WaitStrategy,
+                Volatile.Read(ref _spins),
+                Volatile.Read(ref _spinHits),
+                TicksToNs(Volatile.Read(ref _spinTicks)),
+                TicksToNs(Volatile.Read(ref _wastedSpinTicks)),
+                Volatile.Read(ref _kernelWaits),
+                TicksToNs(Volatile.Read(ref _spinLimitTicks)),
+                NapiBusyPoll);
+
+        private static long TicksToNs(long ticks)
+            => Stopwatch.Frequency == 1_000_000_000 ? ticks : (long)(ticks * (1_000_000_000.0 / Stopwatch.Frequency));
+    }
+}
@@ -0,0 +1,121 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using zerg.Engine.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>
+        /// Flag kept on its own cache line: it is hammered by every producer thread
+        /// and must not false-share with reactor-owned state.
+        /// </summary>
+        [StructLayout(LayoutKind.Explicit, Size = 64)]
+        private struct PaddedInt
+        {
+            [FieldOffset(0)] public int Value;
+        }
+        /// <summary>
+        /// eventfd used as the cross-thread doorbell (-1 when disabled).
+        /// A multishot poll on it lives in this reactor's ring, so writing to it
+        /// completes the reactor's CQ wait right away.
+        /// </summary>
+        private int _wakeFd = -1;
+        /// <summary>
+        /// Managed thread id of the reactor loop. Enqueues issued from the loop itself
+        /// (handlers resumed inline by CQE processing) never need to ring.
+        /// </summary>
+        private int _loopThreadId;
+        /// <summary>
+        /// 1 while a ring is outstanding (set by the first enqueuer, cleared by the
+        /// reactor before it drains its queues), so a burst of enqueues rings once.
+        /// </summary>
+        private PaddedInt _wakeRung;
+
+        /// <summary>
+        /// Creates the doorbell eventfd and queues its multishot poll SQE.
+        /// The SQE is flushed by the first submit of the event loop.
+        /// </summary>
+        private void InitWakeup()
+        {
+            int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (fd < 0)
+            {
+                Log(EngineLogLevel.Warning, $"eventfd failed: errno={Marshal.GetLastPInvokeError()}, " +
+                                                 $"cross-thread wakeup disabled");
+                return;
+            }
+            _wakeFd = fd;
+            ArmWakeup();
+        }
+
+        private void ArmWakeup()
+        {
+            io_uring_sqe* sqe = SqeGet();
+            shim_prep_poll_multishot(sqe, _wakeFd, POLLIN);
+            shim_sqe_set_data64(sqe, PackUd(UdKind.Wakeup, _wakeFd));
+        }
+
+        /// <summary>
+        /// Rings the doorbell if the caller is not the reactor thread and nobody
+        /// has rung since the reactor last drained its queues.
+        /// Must be called after the item has been enqueued.
+        /// </summary>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        internal void Wake()
+        {
+            if (_wakeFd < 0 || Environment.CurrentManagedThreadId == _loopThreadId)
+                return;
+
+            // Pairs with the exchange in ResetWakeup(): either the reactor sees our
+            // enqueue when it drains, or we see the cleared flag and ring.
+            Interlocked.MemoryBarrier();
+            if (Volatile.Read(ref _wakeRung.Value) != 0)
+                return;
+            if (Interlocked.Exchange(ref _wakeRung.Value, 1) != 0)
+                return;
+
+            eventfd_write(_wakeFd, 1);
+        }
+
+        /// <summary>
+        /// Re-opens the doorbell. Called by the loop right before draining the
+        /// return/flush queues, so anything enqueued afterward rings again.
+        /// </summary>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private void ResetWakeup()
+        {
+            if (Volatile.Read(ref _wakeRung.Value) != 0)
+                Interlocked.Exchange(ref _wakeRung.Value, 0);
+        }
+
+        /// <summary>
+        /// Handles a doorbell CQE: resets the eventfd counter and re-arms the poll
+        /// if the kernel terminated the multishot request.
+        /// The queues themselves are drained at the top of the next loop iteration.
+        /// </summary>
+        private void OnWakeup(uint cqeFlags)
+        {
+            if (_wakeFd < 0)
+                return;
+            eventfd_read(_wakeFd, out _);
+            if ((cqeFlags & IORING_CQE_F_MORE) == 0)
+                ArmWakeup();
+        }
+
+        private void CloseWakeup()
+        {
+            if (_wakeFd < 0)
+                return;
+            close(_wakeFd);
+            _wakeFd = -1;
+        }
+    }
+}
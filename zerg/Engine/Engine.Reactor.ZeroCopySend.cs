@@ -0,0 +1,190 @@
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    public partial class Reactor
+    {
+        /// <summary>Kernel limit on the size of a fixed-buffer table (IORING_MAX_REG_BUFFERS).</summary>
+        private const int c_maxFixedBuffers = 1 << 14;
+        /// <summary>
+        /// True once the sparse fixed-buffer table is registered and SEND_ZC can be used.
+        /// </summary>
+        private bool _zeroCopySend;
+        /// <summary>
+        /// Stack of free fixed-buffer slots. Connection write slabs are registered into a slot
+        /// on their first zero-copy flush and give it back when returned to the pool.
+        /// </summary>
+        private int[]? _fixedWriteSlots;
+        private int _fixedWriteSlotCount;
+        /// <summary>
+        /// Closed connections the kernel may still read from, keyed by the SEND_ZC user_data of the lifetime that
+        /// issued the sends. Each goes back to the pool once its last zero-copy send is done with its memory.
+        /// </summary>
+        private readonly Dictionary<ulong, Connection> _zeroCopyParked = new();
+
+        /// <summary>
+        /// Registers this reactor's fixed-buffer table when sending zero-copy: empty slots for connection
+        /// write slabs. If the table cannot be registered the reactor keeps using copying sends.
+        /// Recv slabs are not registered: multishot recv picks provided buffers and never reads the table.
+        /// </summary>
+        private void InitFixedBuffers()
+        {
+            if (Config.SendMode != SendMode.ZeroCopy)
+                return;
+            int writeSlots = Math.Min(Config.MaxConnectionsPerReactor, c_maxFixedBuffers);
+
+            int rc = shim_register_buffers_sparse(io_uring_instance, (uint)writeSlots);
+            if (rc < 0)
+            {
+                Log(EngineLogLevel.Warning, $"register_buffers_sparse failed: {rc}, zero-copy send disabled");
+                return;
+            }
+
+            _fixedWriteSlots = new int[writeSlots];
+            for (int i = 0; i < writeSlots; i++)
+                _fixedWriteSlots[i] = writeSlots - 1 - i; // pop low slots first
+            _fixedWriteSlotCount = writeSlots;
+            _zeroCopySend = true;
+        }
+
+        /// <summary>
+        /// Returns a fixed-buffer slot to the free stack (called from <see cref="Connection.Clear"/> on the reactor thread).
+        /// The stale registration stays until the slot is reused; the slab it points at is pool-owned and outlives it.
+        /// </summary>
+        internal void ReleaseFixedWriteSlot(int slot)
+        {
+            if (_fixedWriteSlots != null)
+                _fixedWriteSlots[_fixedWriteSlotCount++] = slot;
+        }
+
+        /// <summary>
+        /// Decides whether staged bytes [<paramref name="from"/>, <paramref name="to"/>) go out zero-copy,
+        /// registering the connection's write slab on first use. Only ranges that lie in the slab qualify;
+        /// ranges in overflow segments or spanning blocks go out as a copying send/sendmsg.
+        /// </summary>
+        private bool UseZeroCopySend(Connection c, long from, long to)
+        {
+            if (!_zeroCopySend || to - from < Config.ZeroCopySendThreshold)
+                return false;
+            if (c.ContiguousRange(from, to, out bool inSlab) == null || !inSlab)
+                return false;
+            if (c.FixedWriteIndex >= 0)
+                return true;
+            if (_fixedWriteSlotCount == 0)
+                return false;
+
+            int slot = _fixedWriteSlots![--_fixedWriteSlotCount];
+            int rc = shim_register_buffer_slot(io_uring_instance, (uint)slot, c.WriteBuffer, (uint)c.WriteSlabSize);
+            if (rc < 0)
+            {
+                _fixedWriteSlots[_fixedWriteSlotCount++] = slot;
+                return false;
+            }
+            c.FixedWriteIndex = slot;
+            return true;
+        }
+
+        /// <summary>
+        /// Enqueue a zero-copy send of [WriteHead, target) from the connection's registered write slab.
+        /// </summary>
+        private void SendZeroCopy(Connection c, long target)
+        {
+            CountSend();
+            io_uring_sqe* sqe = SqeGet();
+            byte* start = c.ContiguousRange(c.WriteHead, target, out _);
+            shim_prep_send_zc_fixed(sqe, c.ClientFd, start, (uint)(target - c.WriteHead), 0, 0, (uint)c.FixedWriteIndex);
+            if (c.IsDirectDescriptor)
+                shim_sqe_set_fixed_file(sqe);
+            shim_sqe_set_data64(sqe, PackUd(UdKind.SendZc, c.Slot, c.SlotGeneration));
+            // Counted before the sent position can move, so the writer never sees the bytes as sent
+            // while the kernel may still read them.
+            Volatile.Write(ref c.ZeroCopyPending, c.ZeroCopyPending + 1);
+        }
+
+        /// <summary>
+        /// Handles both CQEs of a SEND_ZC: the result CQE (bytes sent, <see cref="IORING_CQE_F_MORE"/>
+        /// when a notification will follow) and the <see cref="IORING_CQE_F_NOTIF"/> CQE.
+        /// Sending moves on as soon as the bytes are out; the slab is only reused, and a waiting flush
+        /// only completed, once the kernel is done with the memory: at the notification, or at the
+        /// result when none follows.
+        /// CQEs of a closed lifetime of the slot go to its parked connection, if any.
+        /// </summary>
+        private void OnSendZeroCopy(ulong ud, int res, uint cqeFlags)
+        {
+            bool released = (cqeFlags & (IORING_CQE_F_NOTIF | IORING_CQE_F_MORE)) != IORING_CQE_F_MORE;
+            Connection? c = _connectionSlots.Get(UdSlotOf(ud), UdGenerationOf(ud));
+            if (c == null)
+            {
+                // The connection closed after the send was issued.
+                if (released && _zeroCopyParked.TryGetValue(ud, out c) && --c.ZeroCopyPending == 0)
+                {
+                    _zeroCopyParked.Remove(ud);
+                    _connectionPool.Return(c);
+                }
+                return;
+            }
+
+            if (released)
+                Volatile.Write(ref c.ZeroCopyPending, c.ZeroCopyPending - 1);
+
+            if ((cqeFlags & IORING_CQE_F_NOTIF) != 0)
+            {
+                if (c.ZeroCopyPending == 0)
+                    c.OnSentProgress();
+                return;
+            }
+
+            CountSendResult(c, res);
+            if (res <= 0)
+            {
+                // error/close handling (same as the copying path)
+                AddInFlightBytes(-(c.WriteInFlight - c.WriteHead));
+                Volatile.Write(ref c.SendInflight, 0);
+                return;
+            }
+
+            AddInFlightBytes(-res);
+            c.AdvanceSent(res);
+            if (c.WriteHead < c.WriteInFlight)
+            {
+                SendZeroCopy(c, c.WriteInFlight);
+                return;
+            }
+
+            RecordFlushLatency(c);
+            Volatile.Write(ref c.SendInflight, 0);
+            StartSend(c);
+        }
+
+        /// <summary>
+        /// Pools a closed connection, or parks it while zero-copy sends of it are pending: until they are done the
+        /// kernel may still read its write slab and segments, so neither they nor its fixed-buffer slot may be reused.
+        /// <paramref name="slot"/> is the slot the connection held in the lifetime that just ended.
+        /// </summary>
+        private void ReturnConnection(Connection connection, int slot)
+        {
+            if (connection.ZeroCopyPending != 0)
+                _zeroCopyParked[PackUd(UdKind.SendZc, slot, connection.SlotGeneration)] = connection;
+            else
+                _connectionPool.Return(connection);
+        }
+
+        /// <summary>
+        /// Pools the connections still parked at shutdown, once the ring is destroyed and no send can touch them.
+        /// </summary>
+        private void ReturnParkedConnections()
+        {
+            foreach (Connection connection in _zeroCopyParked.Values)
+                _connectionPool.Return(connection);
+            _zeroCopyParked.Clear();
+        }
+    }
+}
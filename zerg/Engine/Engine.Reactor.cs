@@ -3,6 +3,7 @@ using System.Runtime.InteropServices;
 using Microsoft.Extensions.ObjectPool;
 using zerg.Engine.Configs;
 using zerg.Utils.MultiProducerSingleConsumer;
+using zerg.Engine.Diagnostics;
 using static zerg.ABI.ABI;
 
 // ReSharper disable always CheckNamespace
@@ -41,27 +42,6 @@ public sealed unsafe partial class Engine
     /// </summary>
     public partial class Reactor 
     {
-        /// <summary>
-        /// Counter used for leak diagnostics of buf_ring usage.
-        /// </summary>
-        private int _ringCounter;
-        /// <summary>
-        /// Kernel-registered io_uring buffer ring for multishot recv.
-        /// </summary>
-        private io_uring_buf_ring* _bufferRing;
-        /// <summary>
-        /// Slab backing all provided recv buffers.
-        /// Each buffer is RecvBufferSize bytes.
-        /// </summary>
-        private byte* _bufferRingSlab;
-        /// <summary>
-        /// Next position in the buffer ring.
-        /// </summary>
-        private uint _bufferRingIndex;
-        /// <summary>
-        /// Mask for buffer ring indexing (power-of-two entries).
-        /// </summary>
-        private uint _bufferRingMask;
         /// <summary>Whether incremental buffer consumption is enabled for this reactor.</summary>
         private bool _incrementalBuffers;
         /// <summary>Per-buffer byte offset for incremental consumption (next CQE starts here).</summary>
@@ -78,16 +58,27 @@ public sealed unsafe partial class Engine
         /// Tracks which connections need flushing after batched writes.
         /// </summary>
         private readonly HashSet<int> _flushableFds = [];
+        /// <summary>
+        /// Live connections of this reactor, indexed by slot id (see <see cref="Connection.Slot"/>).
+        /// </summary>
+        private readonly ConnectionSlotTable _connectionSlots;
 
         public Reactor(int id, ReactorConfig config, Engine engine) 
         {
             Id = id; 
             Config = config; 
             _engine = engine;
+            _connectionSlots = new ConnectionSlotTable(config.MaxConnectionsPerReactor);
+            _recvBufferClasses = ResolveRecvBufferClasses(config);
+            _connectionPool = engine.ConnectionPool;
+            WriteSegments = new WriteSegmentPool(config.WriteSegmentSize);
         }
         
         public Reactor(int id, Engine engine) : this(id, new ReactorConfig(), engine) { }
         
+        /// <summary>Overflow segments for the write chains of this reactor's connections.</summary>
+        internal WriteSegmentPool WriteSegments { get; }
+
         /// <summary>Reactor ID (index into engine arrays).</summary>
         public int Id { get; }
         
@@ -98,78 +89,106 @@ public sealed unsafe partial class Engine
         public io_uring* io_uring_instance { get; private set; }
 
         /// <summary>
-        /// Creates the io_uring instance and registers the buffer ring.
+        /// True when the ring fd is registered with the reactor thread (see <see cref="ReactorConfig.RegisterRingFd"/>).
+        /// </summary>
+        public bool RingFdRegistered { get; private set; }
+
+        /// <summary>
+        /// Creates the io_uring instance and registers the recv buffer groups.
         /// Also allocates and registers all recv buffers.
         /// </summary>
         public void InitRing() 
         {
-            io_uring_instance = CreateRing(Config.RingFlags, Config.SqCpuThread, Config.SqThreadIdleMs, out int err, Config.RingEntries);
+            io_uring_instance = CreateReactorRing(out int err);
             if (io_uring_instance == null || err != 0) 
             {
-                Console.WriteLine($"create_ring failed: {err}");
+                Log(EngineLogLevel.Error, $"create_ring failed: {err}");
                 return; // or throw; but do NOT continue using ring
             }
 
             uint ringFlags = shim_get_ring_flags(io_uring_instance);
-            Console.WriteLine($"[w{Id}] ring flags = 0x{ringFlags:x} " +
-                              $"(SQPOLL={(ringFlags & IORING_SETUP_SQPOLL) != 0}, " +
-                              $"SQ_AFF={(ringFlags & IORING_SETUP_SQ_AFF) != 0})");
-            if (io_uring_instance == null || err < 0)
+            _deferTaskrun = (ringFlags & IORING_SETUP_DEFER_TASKRUN) != 0;
+            Log(EngineLogLevel.Debug, $"ring flags = 0x{ringFlags:x} " +
+                                      $"(SQPOLL={(ringFlags & IORING_SETUP_SQPOLL) != 0}, " +
+                                      $"SQ_AFF={(ringFlags & IORING_SETUP_SQ_AFF) != 0})");
+
+            if (Config.RegisterRingFd || Config.DirectDescriptors)
             {
-                Console.Error.WriteLine($"[w{Id}] create_ring failed: {err}"); 
-                return; 
+                int rc = shim_register_ring_fd(io_uring_instance);
+                RingFdRegistered = rc == 1;
+                if (!RingFdRegistered)
+                    Log(EngineLogLevel.Warning, $"register_ring_fd failed: {rc}, using the plain ring fd");
             }
             
+            InitWait();
+            InitTimers();
+            InitSlabMemory();
             _incrementalBuffers = Config.IncrementalBufferConsumption;
-            uint bufRingFlags = _incrementalBuffers ? IOU_PBUF_RING_INC : 0u;
-            _bufferRing = shim_setup_buf_ring(io_uring_instance, (uint)Config.BufferRingEntries, c_bufferRingGID, bufRingFlags, out var ret);
-            if (_bufferRing == null || ret < 0)
-                throw new Exception($"setup_buf_ring failed: ret={ret}");
-
-            _bufferRingMask = (uint)(Config.BufferRingEntries - 1);
-            nuint slabSize = (nuint)(Config.BufferRingEntries * Config.RecvBufferSize);
-            _bufferRingSlab = (byte*)NativeMemory.AlignedAlloc(slabSize, 64);
+            _recvBundles = ProbeRecvBundles();
+            InitBufferGroups(_incrementalBuffers ? IOU_PBUF_RING_INC : 0u);
 
             if (_incrementalBuffers)
             {
-                _bufferOffsets = new int[Config.BufferRingEntries];
-                _bufferRefCounts = new int[Config.BufferRingEntries];
-                _bufferKernelDone = new bool[Config.BufferRingEntries];
+                _bufferOffsets = new int[_bufferEntries];
+                _bufferRefCounts = new int[_bufferEntries];
+                _bufferKernelDone = new bool[_bufferEntries];
             }
+            InitRecvBudgets();
 
-            for (ushort bid = 0; bid < Config.BufferRingEntries; bid++)
-            {
-                byte* addr = _bufferRingSlab + (nuint)bid * (nuint)Config.RecvBufferSize;
-                shim_buf_ring_add(_bufferRing, addr, (uint)Config.RecvBufferSize, bid, (ushort)_bufferRingMask, _bufferRingIndex++);
-            }
-            shim_buf_ring_advance(_bufferRing, (uint)Config.BufferRingEntries);
+            InitFixedBuffers();
+            InitDirectDescriptors();
+
+            if (_listenFd >= 0)
+                ArmAccept();
+
+            _cqeWindowStart = Environment.TickCount64;
+            _loopThreadId = Environment.CurrentManagedThreadId;
+            if (Config.CrossThreadWakeup)
+                InitWakeup();
         }
         /// <summary>
-        /// Returns a previously used recv buffer back to the kernel buf_ring.
+        /// Returns a previously used recv buffer back to its group's kernel buf_ring.
         /// </summary>
-        private void ReturnBufferRing(byte* addr, ushort bid)
+        private void ReturnBufferRing(ushort bid)
         {
-            _ringCounter++;
             if (_incrementalBuffers)
             {
                 _bufferOffsets![bid] = 0;
                 _bufferRefCounts![bid] = 0;
                 _bufferKernelDone![bid] = false;
             }
-            shim_buf_ring_add(_bufferRing, addr, (uint)Config.RecvBufferSize, bid, (ushort)_bufferRingMask, _bufferRingIndex++);
-            shim_buf_ring_advance(_bufferRing, 1);
+            BufferGroup group = _bufferGroups[_bufferGroupOf[bid]];
+            _bufferTaken[bid] = false;
+            group.Outstanding--;
+            if (bid - group.FirstBid >= group.Target)
+            {
+                ParkBuffer(group, bid); // group is shrinking: keep it out of the ring
+                return;
+            }
+            group.Add(bid);
+            shim_buf_ring_advance(group.Ring, 1);
         }
         /// <summary>
         /// MPSC queue of buffer IDs waiting to be returned to buf_ring.
         /// </summary>
         private readonly MpscUshortQueue _returnQ = new(1 << 16); // 65536 slots (power-of-two)
         /// <summary>
+        /// Buffer returns issued on the reactor thread itself (handlers resumed by CQE processing or
+        /// scheduled work); drained with <see cref="_returnQ"/> without touching its atomics.
+        /// </summary>
+        private readonly Queue<ushort> _localReturns = new();
+        /// <summary>
         /// Enqueue a buffer ID to be returned to the buf_ring.
         /// May spin briefly under contention.
         /// </summary>
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public void EnqueueReturnQ(ushort bid) 
         {
+            if (IsOnReactorThread)
+            {
+                _localReturns.Enqueue(bid);
+                return;
+            }
             if (!_returnQ.TryEnqueue(bid)) 
             {
                 SpinWait sw = default;
@@ -185,23 +204,47 @@ public sealed unsafe partial class Engine
                     }
                 }
             }
+            Wake();
         }
         /// <summary>
-        /// Drains the return queue and re-adds buffers to the buf_ring.
+        /// Takes back one buffer handed out by a recv: credits its recv charge and re-adds it to its buf_ring,
+        /// unless (incremental mode) other RingItems or the kernel still use it. Returns true if it was re-added.
+        /// </summary>
+        private bool RecycleBuffer(ushort bid)
+        {
+            if (_bufferHolder != null)
+                ReleaseRecvCharge(bid);
+            if (_incrementalBuffers)
+            {
+                int rc = --_bufferRefCounts![bid];
+                if (rc > 0 || !_bufferKernelDone![bid])
+                    return false; // still in use by other RingItems or kernel
+            }
+            ReturnBufferRing(bid);
+            return true;
+        }
+        /// <summary>
+        /// Drains the return queue and re-adds buffers to the buf_ring,
+        /// then re-arms recvs that were starved of buffers or paused by their recv budget
+        /// and releases the pages of trimmed groups.
         /// </summary>
         private void DrainReturnQ()
         {
-            while (_returnQ.TryDequeue(out ushort bid))
+            int drained = 0;
+            while (_localReturns.TryDequeue(out ushort bid) || _returnQ.TryDequeue(out bid))
             {
-                if (_incrementalBuffers)
-                {
-                    int rc = --_bufferRefCounts![bid];
-                    if (rc > 0 || !_bufferKernelDone![bid])
-                        continue; // still in use by other RingItems or kernel
-                }
-                byte* addr = _bufferRingSlab + (nuint)bid * (nuint)Config.RecvBufferSize;
-                ReturnBufferRing(addr, bid);
+                drained++;
+                RecycleBuffer(bid);
             }
+            CountDrain(ref _counters.ReturnQDrained, ref _counters.ReturnQMaxDepth, drained);
+            if (drained != 0 && _starvedRecvs.Count != 0)
+                RearmStarvedRecvs();
+            if (drained != 0 && _starvedDatagrams.Count != 0)
+                RearmStarvedDatagrams();
+            if (drained != 0 && _pausedRecvs.Count != 0)
+                ResumePausedRecvs();
+            if (_trimPending)
+                ReleaseTrimmedPages();
         }
         /// <summary>
         /// Same as DrainReturnQ but returns how many buffers were recycled.
@@ -209,127 +252,157 @@ public sealed unsafe partial class Engine
         private int DrainReturnQCounted()
         {
             int count = 0;
-            while (_returnQ.TryDequeue(out ushort bid))
+            int drained = 0;
+            while (_localReturns.TryDequeue(out ushort bid) || _returnQ.TryDequeue(out bid))
             {
-                if (_incrementalBuffers)
-                {
-                    int rc = --_bufferRefCounts![bid];
-                    if (rc > 0 || !_bufferKernelDone![bid])
-                        continue; // still in use by other RingItems or kernel
-                }
-                byte* addr = _bufferRingSlab + (nuint)bid * (nuint)Config.RecvBufferSize;
-                ReturnBufferRing(addr, bid);
-                count++;
+                drained++;
+                if (RecycleBuffer(bid))
+                    count++;
             }
+            CountDrain(ref _counters.ReturnQDrained, ref _counters.ReturnQMaxDepth, drained);
+            if (count != 0 && _starvedRecvs.Count != 0)
+                RearmStarvedRecvs();
+            if (count != 0 && _starvedDatagrams.Count != 0)
+                RearmStarvedDatagrams();
+            if (count != 0 && _pausedRecvs.Count != 0)
+                ResumePausedRecvs();
+            if (_trimPending)
+                ReleaseTrimmedPages();
             return count;
         }
         
-        private readonly MpscIntQueue _flushQ = new(capacityPow2: 4096);
+        /// <summary>Flush requests: connection slots packed with their generation (<see cref="PackUd(UdKind, int, uint)"/>).</summary>
+        private readonly MpscUlongQueue _flushQ = new(capacityPow2: 4096);
+        /// <summary>Flush requests issued on the reactor thread itself (see <see cref="_localReturns"/>).</summary>
+        private readonly Queue<ulong> _localFlushes = new();
 
+        /// <summary>
+        /// Requests a flush of <paramref name="connection"/>. The request names its slot and slot generation,
+        /// so it is dropped if the connection closes and the slot is reused before the reactor gets to it.
+        /// </summary>
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        public void EnqueueFlush(int fd)
+        public void EnqueueFlush(Connection connection)
         {
-            while (!_flushQ.TryEnqueue(fd))
+            ulong key = PackUd(UdKind.Send, connection.Slot, connection.SlotGeneration);
+            if (IsOnReactorThread)
+            {
+                _localFlushes.Enqueue(key);
+                return;
+            }
+            while (!_flushQ.TryEnqueue(key))
                 Thread.Yield();
+            Wake();
         }
 
         private void DrainFlushQ()
         {
-            while (_flushQ.TryDequeue(out int fd))
+            int drained = 0;
+            while (_localFlushes.TryDequeue(out ulong key) || _flushQ.TryDequeue(out key))
             {
-                if (!_engine.Connections[Id].TryGetValue(fd, out var c))
+                drained++;
+                Connection? c = _connectionSlots.Get(UdSlotOf(key), UdGenerationOf(key));
+                if (c == null)
                     continue;
 
                 // If already have a send in flight, do nothing:
-                // the CQE path will continue draining to WriteInFlight.
+                // the CQE path continues with whatever was flushed meanwhile.
                 if (Volatile.Read(ref c.SendInflight) != 0)
                     continue;
 
-                // If nothing to flush (or flush target not set), do nothing.
-                // FlushAsync sets WriteInFlight = tail snapshot.
-                int target = c.WriteInFlight;
-                if (target <= 0)
-                    continue;
-
-                // Start sending from current head (should be 0 for slab reset model)
-                // If you ever keep head across flushes, this still works.
-                if (c.WriteHead >= target)
-                {
-                    // already satisfied
-                    if (c.IsFlushInProgress)
-                        c.CompleteFlush();
-                    continue;
-                }
-
-                Volatile.Write(ref c.SendInflight, 1);
-
-                Send(c.ClientFd, c.WriteBuffer, (uint)c.WriteHead, (uint)target);
+                StartSend(c);
             }
+            CountDrain(ref _counters.FlushQDrained, ref _counters.FlushQMaxDepth, drained);
         }
         
         /// <summary>
-        /// Enqueue a send SQE for this reactor's ring.
+        /// Cancels the outstanding multishot recv of a connection.
+        /// Must be called before its slot is freed, while <see cref="Connection.SlotGeneration"/> still matches the armed recv.
         /// </summary>
-        private void Send(int clientFd, byte* buf, nuint off, nuint len) 
+        private static void SubmitCancelRecv(io_uring* ring, Connection connection) 
         {
-            io_uring_sqe* sqe = SqeGet(io_uring_instance);
-            shim_prep_send(sqe, clientFd, buf + off, (uint)(len - off), 0);
-            shim_sqe_set_data64(sqe, PackUd(UdKind.Send, clientFd)); 
+            io_uring_sqe* sqe = shim_get_sqe(ring);
+            if (sqe == null) return; // or handle SQ full
+
+            ulong target = PackUd(UdKind.Recv, connection.Slot, connection.SlotGeneration);
+
+            shim_prep_cancel64(sqe, target, /*flags*/ 0 /* or IORING_ASYNC_CANCEL_ALL */);
+            shim_sqe_set_data64(sqe, PackUd(UdKind.Cancel, connection.Slot, connection.SlotGeneration));
         }
         /// <summary>
-        /// Static helper to enqueue a send on an arbitrary ring.
+        /// Tears down a connection whose recv reported EOF/error: cancels its recv, frees its slot
+        /// (late CQEs of this lifetime become stale), wakes the handler, pools it (see
+        /// <see cref="ReturnConnection"/>) and closes the fd.
         /// </summary>
-        private static void SubmitSend(io_uring* pring, int fd, byte* buf, nuint off, nuint len) 
+        private void CloseConnection(Connection connection, int res)
         {
-            io_uring_sqe* sqe = SqeGet(pring);
-            shim_prep_send(sqe, fd, buf + off, (uint)(len - off), 0);
-            shim_sqe_set_data64(sqe, PackUd(UdKind.Send, fd));
+            int fd = connection.ClientFd;
+            int slot = connection.Slot;
+            bool direct = connection.IsDirectDescriptor;
+            if (connection.FileSend != null)
+                AbortFileSend(connection);
+            SubmitCancelRecv(io_uring_instance, connection);
+            ReleaseRecvBackpressure(connection);
+            CancelTimer(connection);
+            _connectionSlots.Remove(connection);
+            ReleaseConnectionLoad(connection);
+            connection.MarkClosed(res);
+            ReturnConnection(connection, slot);
+            if (direct)
+                CloseDirectDescriptor(fd);
+            else
+                close(fd);
         }
         /// <summary>
-        /// Cancels an outstanding multishot recv for a given fd.
+        /// Buffers taken by the kernel and never returned to the buf_rings.
         /// </summary>
-        private static void SubmitCancelRecv(io_uring* ring, int fd) 
+        private long RingLeakage()
         {
-            io_uring_sqe* sqe = shim_get_sqe(ring);
-            if (sqe == null) return; // or handle SQ full
-
-            ulong target = PackUd(UdKind.Recv, fd);
-
-            shim_prep_cancel64(sqe, target, /*flags*/ 0 /* or IORING_ASYNC_CANCEL_ALL */);
-            shim_sqe_set_data64(sqe, PackUd(UdKind.Cancel, fd));
+            long outstanding = 0;
+            foreach (BufferGroup group in _bufferGroups)
+                outstanding += group.Outstanding;
+            return outstanding;
         }
         /// <summary>
         /// Closes all remaining connections during shutdown and
         /// returns them to the pool.
         /// </summary>
-        private void CloseAll(Dictionary<int, Connection> connections) 
+        private void CloseAll(ConnectionSlotTable connections) 
         {
-            Console.WriteLine($"Reactor[{Id}] Connection leakage -- [{connections.Count}] " +
-                              $"Ring leakage -- [{_ringCounter + Config.BufferRingEntries - _bufferRingIndex}]");
+            AbortConnects();
+            AbortRelays();
+            AbortDatagrams();
+            AbortFileSends();
+            Log(EngineLogLevel.Debug, $"closing {connections.Count} open connections, " +
+                                      $"{RingLeakage()} recv buffers still held");
             
-            foreach (var kv in connections) 
+            for (int slot = 0; slot < connections.Capacity; slot++) 
             {
-                var conn = kv.Value;
+                Connection? conn = connections.Get(slot);
+                if (conn == null)
+                    continue;
 
                 // Mark closed to wake any waiter.
                 conn.MarkClosed(error: 0);
 
-                // Remove mapping first (so late CQEs won't find it).
-                // Already doing remove on res<=0 path; doing same here if needed.
+                // Free the slot (so late CQEs won't find it).
+                ReleaseRecvBackpressure(conn);
+                CancelTimer(conn);
+                connections.Remove(conn);
+
+                ReleaseConnectionLoad(conn);
 
-                // Close fd
+                // Close fd (direct descriptors go away with the ring's file table)
                 try
                 {
-                    close(conn.ClientFd); 
+                    if (!conn.IsDirectDescriptor)
+                        close(conn.ClientFd); 
                 } catch { /* ignore */ }
 
                 // Pool it. Safe only because:
                 //   - ReadAsync uses generation/closed => will return Closed for stale handlers
                 //   - We did NOT return any recv buffers here
-                _engine.ConnectionPool.Return(conn);
+                ReturnConnection(conn, slot);
             }
-
-            connections.Clear();
         }
     }
 }
\ No newline at end of file
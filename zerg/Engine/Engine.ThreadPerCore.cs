@@ -0,0 +1,193 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.ExceptionServices;
+using System.Threading.Tasks.Sources;
+using zerg.Engine.Configs;
+using zerg.Engine.Diagnostics;
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+public sealed unsafe partial class Engine
+{
+    /// <summary>
+    /// Ring fd of reactor 0, published once its ring exists, for reactors that attach their SQPOLL
+    /// ring to it (<see cref="EngineOptions.ShareSqPollThread"/>); -1 when there is nothing to attach to.
+    /// </summary>
+    private TaskCompletionSource<int>? _sharedSqPollRing;
+
+    /// <summary>
+    /// CPU reactor <paramref name="id"/> is pinned to: from <see cref="EngineOptions.ReactorCpus"/>, or one CPU
+    /// per reactor in <see cref="ExecutionMode.ThreadPerCore"/> mode; -1 when it is not pinned.
+    /// </summary>
+    private int ResolveReactorCpu(int id)
+    {
+        int[]? cpus = Options.ReactorCpus;
+        if (cpus != null && cpus.Length > 0)
+            return cpus[id % cpus.Length];
+        return Options.ExecutionMode == ExecutionMode.ThreadPerCore ? id % Environment.ProcessorCount : -1;
+    }
+
+    /// <summary>
+    /// Thread-per-core accept: waits for the next connection like the shared path, then resumes the
+    /// caller on the thread of the reactor that owns it, so a handler started right after the await
+    /// runs on that reactor.
+    /// </summary>
+    private ValueTask<Connection?> AcceptOnReactorAsync(CancellationToken cancellationToken)
+    {
+        ValueTask<Connection?> next = AcceptFromQueueAsync(cancellationToken);
+        if (next.IsCompletedSuccessfully)
+        {
+            Connection? connection = next.Result;
+            if (connection == null || connection.Reactor.IsOnReactorThread)
+                return new ValueTask<Connection?>(connection);
+        }
+
+        ReactorAcceptSource source = new();
+        source.Complete(next);
+        return new ValueTask<Connection?>(source, 0);
+    }
+
+    /// <summary>
+    /// Single-use completion for <see cref="AcceptOnReactorAsync"/>. Unlike a regular awaitable it ignores the
+    /// awaiter's captured context and runs the continuation on the reactor of the accepted connection
+    /// (the thread pool when there is none, e.g. on cancellation).
+    /// </summary>
+    private sealed class ReactorAcceptSource : IValueTaskSource<Connection?>
+    {
+        private static readonly Action<object?> s_completed = static _ => { };
+
+        private Action<object?>? _continuation;
+        private object? _continuationState;
+        private ExecutionContext? _executionContext;
+        private Connection? _result;
+        private ExceptionDispatchInfo? _error;
+        private volatile bool _done;
+
+        public void Complete(ValueTask<Connection?> next)
+        {
+            if (next.IsCompleted)
+            {
+                SetResult(next);
+                return;
+            }
+            ConfiguredValueTaskAwaitable<Connection?>.ConfiguredValueTaskAwaiter awaiter = next.ConfigureAwait(false).GetAwaiter();
+            awaiter.UnsafeOnCompleted(() => SetResult(next));
+        }
+
+        private void SetResult(ValueTask<Connection?> next)
+        {
+            try
+            {
+                _result = next.GetAwaiter().GetResult();
+            }
+            catch (Exception ex)
+            {
+                _error = ExceptionDispatchInfo.Capture(ex);
+            }
+            _done = true;
+
+            Action<object?>? continuation = Interlocked.Exchange(ref _continuation, s_completed);
+            if (continuation != null)
+                Dispatch(continuation);
+        }
+
+        public ValueTaskSourceStatus GetStatus(short token)
+        {
+            // A connection accepted off its reactor's thread still reports Pending so that the
+            // awaiter registers a continuation, which is then run on the reactor.
+            if (!_done || (_result != null && !_result.Reactor.IsOnReactorThread))
+                return ValueTaskSourceStatus.Pending;
+            if (_error == null)
+                return ValueTaskSourceStatus.Succeeded;
+            return _error.SourceException is OperationCanceledException
+                ? ValueTaskSourceStatus.Canceled
+                : ValueTaskSourceStatus.Faulted;
+        }
+
+        public Connection? GetResult(short token)
+        {
+            _error?.Throw();
+            return _result;
+        }
+
+        public void OnCompleted(Action<object?> continuation, object? state, short token, ValueTaskSourceOnCompletedFlags flags)
+        {
+            _continuationState = state;
+            if ((flags & ValueTaskSourceOnCompletedFlags.FlowExecutionContext) != 0)
+                _executionContext = ExecutionContext.Capture();
+
+            if (Interlocked.CompareExchange(ref _continuation, continuation, null) != null)
+                Dispatch(continuation); // already completed
+        }
+
+        private void Dispatch(Action<object?> continuation)
+        {
+            SendOrPostCallback run = _executionContext == null
+                ? state => continuation(state)
+                : state => ExecutionContext.Run(_executionContext, s => continuation(s), state);
+
+            if (_result != null)
+                _result.Reactor.Schedule(run, _continuationState);
+            else
+                ThreadPool.UnsafeQueueUserWorkItem(s => run(s), _continuationState, preferLocal: false);
+        }
+    }
+
+    public partial class Reactor
+    {
+        /// <summary>
+        /// Creates this reactor's ring. For SQPOLL rings it applies <see cref="EngineOptions.SqPollOnSiblingCpu"/>
+        /// and, with <see cref="EngineOptions.ShareSqPollThread"/>, attaches reactors 1..N to reactor 0's ring
+        /// (falling back to a standalone ring if the kernel refuses).
+        /// </summary>
+        private io_uring* CreateReactorRing(out int err)
+        {
+            uint flags = WaitRingFlags(Config.RingFlags);
+            int sqCpu = Config.SqCpuThread;
+            bool sqPoll = (flags & IORING_SETUP_SQPOLL) != 0;
+
+            if (sqPoll && sqCpu < 0 && Cpu >= 0 && _engine.Options.SqPollOnSiblingCpu)
+            {
+                int sibling = Affinity.SiblingOf(Cpu);
+                if (sibling >= 0)
+                {
+                    sqCpu = sibling;
+                    flags |= IORING_SETUP_SQ_AFF;
+                }
+            }
+
+            TaskCompletionSource<int>? shared = _engine._sharedSqPollRing;
+            if (shared == null)
+                return CreateRing(flags, sqCpu, Config.SqThreadIdleMs, out err, Config.RingEntries);
+
+            if (Id == 0)
+            {
+                io_uring* ring = null;
+                err = 0;
+                try
+                {
+                    ring = CreateRing(flags, sqCpu, Config.SqThreadIdleMs, out err, Config.RingEntries);
+                }
+                finally
+                {
+                    shared.TrySetResult(sqPoll && ring != null ? shim_ring_fd(ring) : -1);
+                }
+                return ring;
+            }
+
+            int wqFd = sqPoll ? shared.Task.GetAwaiter().GetResult() : -1;
+            if (wqFd >= 0)
+            {
+                io_uring* attached = shim_create_ring_attach(Config.RingEntries, flags, sqCpu, Config.SqThreadIdleMs, wqFd, out err);
+                if (attached != null && err == 0)
+                    return attached;
+                Log(EngineLogLevel.Warning, $"attaching to reactor 0's SQPOLL ring failed: {err}, using a standalone ring");
+            }
+            return CreateRing(flags, sqCpu, Config.SqThreadIdleMs, out err, Config.RingEntries);
+        }
+    }
+}
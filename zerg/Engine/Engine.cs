@@ -16,17 +16,9 @@ public sealed unsafe partial class Engine
     {
         io_uring_sqe* sqe = shim_get_sqe(pring);
         if (sqe == null) {
-            Console.WriteLine("S4");
             shim_submit(pring); 
             sqe = shim_get_sqe(pring); 
         }
         return sqe;
     }
-
-    private static void ArmRecvMultishot(io_uring* pring, int fd, uint bgid) 
-    {
-        io_uring_sqe* sqe = SqeGet(pring);
-        shim_prep_recv_multishot_select(sqe, fd, bgid, 0);
-        shim_sqe_set_data64(sqe, PackUd(UdKind.Recv, fd));
-    }
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+using static zerg.ABI.ABI;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+/// <summary>
+/// Maps slabs backed by 2 MB pages for <see cref="Configs.SlabMemory.HugePages"/>.
+///
+/// The hugetlb pool is tried first; when it has no free pages the slab is mapped 2 MB aligned
+/// and advised with MADV_HUGEPAGE so transparent huge pages can back it. Either way the mapping
+/// gets a preferred-node memory policy before any page is touched.
+/// </summary>
+internal static unsafe class HugePageSlab
+{
+    /// <summary>
+    /// Maps at least <paramref name="length"/> bytes (rounded up to whole huge pages) with pages preferably
+    /// on <paramref name="numaNode"/> (-1: no preference). Returns null when the address space cannot be mapped.
+    /// </summary>
+    /// <param name="mappedLength">Length actually mapped; pass it to <see cref="Unmap"/>.</param>
+    /// <param name="hugeTlb">True when the slab came from the hugetlb pool, false for the THP fallback.</param>
+    public static byte* Map(nuint length, int numaNode, out nuint mappedLength, out bool hugeTlb)
+    {
+        nuint size = AlignUp(length);
+        mappedLength = size;
+
+        void* slab = mmap(null, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+        hugeTlb = slab != MAP_FAILED;
+        if (!hugeTlb)
+        {
+            // Over-map by one huge page and trim to a 2 MB aligned window, so the slab spans whole huge pages.
+            void* raw = mmap(null, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED)
+                return null;
+
+            nuint head = AlignUp((nuint)raw) - (nuint)raw;
+            if (head > 0)
+                munmap(raw, head);
+            munmap((byte*)raw + head + size, HUGE_PAGE_SIZE - head);
+            slab = (byte*)raw + head;
+            madvise(slab, size, MADV_HUGEPAGE);
+        }
+
+        Numa.PreferNode(slab, size, numaNode);
+        return (byte*)slab;
+    }
+
+    /// <summary>
+    /// Faults every page of a slab in now, so the first recv into it does not take the page faults.
+    /// Touches one byte per base page on kernels without <see cref="MADV_POPULATE_WRITE"/>.
+    /// </summary>
+    public static void Populate(byte* slab, nuint length)
+    {
+        if (madvise(slab, length, MADV_POPULATE_WRITE) == 0)
+            return;
+        for (nuint offset = 0; offset < length; offset += PAGE_SIZE)
+            slab[offset] = 0;
+    }
+
+    /// <summary>Unmaps a slab returned by <see cref="Map"/>.</summary>
+    public static void Unmap(byte* slab, nuint mappedLength) => munmap(slab, mappedLength);
+
+    private static nuint AlignUp(nuint value) => (value + HUGE_PAGE_SIZE - 1) & ~(nuint)(HUGE_PAGE_SIZE - 1);
+}
@@ -0,0 +1,109 @@
+using static zerg.ABI.ABI;
+
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+/// <summary>
+/// What the running kernel's io_uring supports, as reported by <c>shim_probe</c>: opcodes, feature bits,
+/// the setup flags trial rings accepted, and registrations that only a live ring can tell.
+/// <see cref="Current"/> probes once per process; <see cref="Configs.EngineOptions.AutoTune"/> builds
+/// each reactor's ring setup from it.
+/// </summary>
+public sealed unsafe class KernelCapabilities
+{
+    private static readonly Lazy<KernelCapabilities> s_current = new(Probe);
+
+    private readonly ulong[] _ops = new ulong[4];
+
+    /// <summary>Capabilities of the running kernel, probed on first use.</summary>
+    public static KernelCapabilities Current => s_current.Value;
+
+    /// <summary>
+    /// Probes the kernel. Sets up and tears down a handful of small rings; prefer <see cref="Current"/>.
+    /// </summary>
+    public static KernelCapabilities Probe()
+    {
+        shim_probe_result result;
+        int rc = shim_probe(&result);
+        return new KernelCapabilities(rc, result);
+    }
+
+    private KernelCapabilities(int error, shim_probe_result result)
+    {
+        Error = error;
+        if (error < 0)
+            return;
+        SetupFlags = result.setup_flags;
+        Features = result.features;
+        LastOpcode = (int)result.last_op;
+        for (int i = 0; i < _ops.Length; i++)
+            _ops[i] = result.ops[i];
+        IncrementalBuffers = (result.caps & SHIM_CAP_PBUF_RING_INC) != 0;
+        RegisterRingFd = (result.caps & SHIM_CAP_REGISTER_RING_FD) != 0;
+        Napi = (result.caps & SHIM_CAP_NAPI) != 0;
+    }
+
+    /// <summary>0, or the negative errno of a failed plain ring setup (io_uring missing or disabled).</summary>
+    public int Error { get; }
+
+    /// <summary>Whether io_uring can be used at all.</summary>
+    public bool Available => Error == 0;
+
+    /// <summary>
+    /// IORING_SETUP_* bits a trial setup accepted. Only the flags the probe tries are reported:
+    /// SQPOLL, SUBMIT_ALL, COOP_TASKRUN, TASKRUN_FLAG, SINGLE_ISSUER, DEFER_TASKRUN and NO_SQARRAY.
+    /// </summary>
+    public uint SetupFlags { get; }
+
+    /// <summary>IORING_FEAT_* bits reported at ring setup.</summary>
+    public uint Features { get; }
+
+    /// <summary>Highest opcode the kernel knows (IORING_OP_LAST - 1).</summary>
+    public int LastOpcode { get; }
+
+    /// <summary>Buffer rings accept IOU_PBUF_RING_INC (Linux 6.12+).</summary>
+    public bool IncrementalBuffers { get; }
+
+    /// <summary>The ring fd can be registered with io_uring_register_ring_fd (Linux 5.18+).</summary>
+    public bool RegisterRingFd { get; }
+
+    /// <summary>NAPI busy polling can be registered with io_uring_register_napi (Linux 6.9+).</summary>
+    public bool Napi { get; }
+
+    /// <summary>IORING_SETUP_TASKRUN_FLAG (Linux 5.19+).</summary>
+    public bool TaskrunFlag => (SetupFlags & IORING_SETUP_TASKRUN_FLAG) != 0;
+
+    /// <summary>IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN (Linux 6.1+).</summary>
+    public bool DeferTaskrun => (SetupFlags & IORING_SETUP_DEFER_TASKRUN) != 0;
+
+    /// <summary>IORING_SETUP_COOP_TASKRUN (Linux 5.19+).</summary>
+    public bool CoopTaskrun => (SetupFlags & IORING_SETUP_COOP_TASKRUN) != 0;
+
+    /// <summary>IORING_SETUP_SINGLE_ISSUER (Linux 6.0+).</summary>
+    public bool SingleIssuer => (SetupFlags & IORING_SETUP_SINGLE_ISSUER) != 0;
+
+    /// <summary>IORING_SETUP_SQPOLL is allowed for this process.</summary>
+    public bool SqPoll => (SetupFlags & IORING_SETUP_SQPOLL) != 0;
+
+    /// <summary>Recv/send bundles (IORING_FEAT_RECVSEND_BUNDLE, Linux 6.10+).</summary>
+    public bool RecvBundles => (Features & IORING_FEAT_RECVSEND_BUNDLE) != 0;
+
+    /// <summary>IORING_OP_SEND_ZC (Linux 6.0+).</summary>
+    public bool ZeroCopySend => SupportsOpcode(IORING_OP_SEND_ZC);
+
+    /// <summary>IORING_OP_SPLICE (Linux 5.7+), used by <see cref="Configs.RelayMode.Splice"/> relays.</summary>
+    public bool Splice => SupportsOpcode(IORING_OP_SPLICE);
+
+    /// <summary>Whether the kernel supports the given IORING_OP_* opcode.</summary>
+    public bool SupportsOpcode(int opcode)
+        => opcode >= 0 && opcode <= LastOpcode && opcode < 256 && (_ops[opcode >> 6] & (1UL << (opcode & 63))) != 0;
+
+    public override string ToString()
+        => Available
+            ? $"setup=0x{SetupFlags:x} features=0x{Features:x} last_op={LastOpcode} " +
+              $"defer_taskrun={DeferTaskrun} coop_taskrun={CoopTaskrun} inc_buffers={IncrementalBuffers} " +
+              $"bundles={RecvBundles} send_zc={ZeroCopySend} splice={Splice} register_ring_fd={RegisterRingFd} napi={Napi}"
+            : $"io_uring unavailable ({Error})";
+}
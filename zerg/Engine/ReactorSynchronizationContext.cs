@@ -0,0 +1,54 @@
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+/// <summary>
+/// Single-threaded <see cref="SynchronizationContext"/> of a reactor: posted callbacks run on the
+/// reactor thread, between completion batches of its event loop.
+///
+/// Installed on the reactor thread in <see cref="Configs.ExecutionMode.ThreadPerCore"/> mode, so
+/// continuations of handlers started there (including awaits of timers, channels or other tasks)
+/// come back to the reactor instead of the thread pool.
+/// </summary>
+public sealed class ReactorSynchronizationContext : SynchronizationContext
+{
+    private readonly Engine.Reactor _reactor;
+
+    internal ReactorSynchronizationContext(Engine.Reactor reactor) => _reactor = reactor;
+
+    /// <summary>The reactor this context schedules onto.</summary>
+    public Engine.Reactor Reactor => _reactor;
+
+    /// <summary>Queues <paramref name="d"/> to run on the reactor thread.</summary>
+    public override void Post(SendOrPostCallback d, object? state) => _reactor.Schedule(d, state);
+
+    /// <summary>
+    /// Runs <paramref name="d"/> on the reactor thread and waits for it: inline when already there,
+    /// otherwise blocks the caller until the reactor has run it.
+    /// </summary>
+    public override void Send(SendOrPostCallback d, object? state)
+    {
+        if (_reactor.IsOnReactorThread)
+        {
+            d(state);
+            return;
+        }
+
+        using ManualResetEventSlim done = new();
+        Exception? error = null;
+        _reactor.Schedule(_ =>
+        {
+            try { d(state); }
+            catch (Exception ex) { error = ex; }
+            finally { done.Set(); }
+        }, null);
+        done.Wait();
+        if (error != null)
+            throw new AggregateException(error);
+    }
+
+    /// <summary>The context is bound to its reactor; copies are the same context.</summary>
+    public override SynchronizationContext CreateCopy() => this;
+}
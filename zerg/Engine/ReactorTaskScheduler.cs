@@ -0,0 +1,34 @@
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+/// <summary>
+/// Single-threaded <see cref="TaskScheduler"/> that runs tasks on a reactor thread, through the same
+/// queue as <see cref="ReactorSynchronizationContext"/>. Use it to start work on a specific reactor,
+/// e.g. <c>Task.Factory.StartNew(work, token, TaskCreationOptions.None, reactor.Scheduler)</c>.
+/// </summary>
+public sealed class ReactorTaskScheduler : TaskScheduler
+{
+    private readonly Engine.Reactor _reactor;
+    private readonly SendOrPostCallback _execute;
+
+    internal ReactorTaskScheduler(Engine.Reactor reactor)
+    {
+        _reactor = reactor;
+        _execute = state => TryExecuteTask((Task)state!);
+    }
+
+    /// <summary>One reactor thread.</summary>
+    public override int MaximumConcurrencyLevel => 1;
+
+    protected override void QueueTask(Task task) => _reactor.Schedule(_execute, task);
+
+    /// <summary>Inlines only on the reactor thread.</summary>
+    protected override bool TryExecuteTaskInline(Task task, bool taskWasPreviouslyQueued)
+        => _reactor.IsOnReactorThread && TryExecuteTask(task);
+
+    /// <summary>Queued tasks are not tracked (debugger support only).</summary>
+    protected override IEnumerable<Task>? GetScheduledTasks() => null;
+}
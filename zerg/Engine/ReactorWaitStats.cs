@@ -0,0 +1,33 @@
+using zerg.Engine.Configs;
+
+namespace zerg.Engine;
+
+/// <summary>
+/// Idle-wait counters of a reactor (see <see cref="Engine.Reactor.GetWaitStats"/>).
+/// Compare <see cref="WastedSpinTimeRatio"/> across <see cref="ReactorConfig.SpinBudget"/> values to see how
+/// much CPU the spin costs, and the latency of the workload to see what it buys.
+/// </summary>
+/// <param name="Strategy">The <see cref="ReactorConfig.WaitStrategy"/> in effect.</param>
+/// <param name="Spins">Idle gaps the reactor spun through before (or instead of) blocking.</param>
+/// <param name="SpinHits">Spins that ended with completions or cross-thread work, skipping the kernel wait.</param>
+/// <param name="SpinTimeNs">Total time spent spinning.</param>
+/// <param name="WastedSpinTimeNs">Part of <paramref name="SpinTimeNs"/> spent in spins that found nothing.</param>
+/// <param name="KernelWaits">Waits that entered the kernel.</param>
+/// <param name="SpinLimitNs">Current spin length (adapted from recent idle gaps in <see cref="WaitStrategy.Hybrid"/>).</param>
+/// <param name="NapiBusyPoll">Whether NAPI busy polling is registered on the ring.</param>
+public readonly record struct ReactorWaitStats(
+    WaitStrategy Strategy,
+    long Spins,
+    long SpinHits,
+    long SpinTimeNs,
+    long WastedSpinTimeNs,
+    long KernelWaits,
+    long SpinLimitNs,
+    bool NapiBusyPoll)
+{
+    /// <summary>Fraction of spins that found nothing and fell through to a kernel wait.</summary>
+    public double WastedSpinRatio => Spins == 0 ? 0 : (double)(Spins - SpinHits) / Spins;
+
+    /// <summary>Fraction of spin time spent in spins that found nothing.</summary>
+    public double WastedSpinTimeRatio => SpinTimeNs == 0 ? 0 : (double)WastedSpinTimeNs / SpinTimeNs;
+}
@@ -0,0 +1,15 @@
+namespace zerg.Engine;
+
+/// <summary>
+/// Receive backpressure counters of a reactor (see <see cref="Engine.Reactor.GetRecvBackpressureStats"/>).
+/// A steadily growing <see cref="Pauses"/> count points at handlers that hold on to received buffers;
+/// raise <see cref="Configs.ReactorConfig.RecvBudgetBuffers"/> / <see cref="Configs.ReactorConfig.RecvBudgetBytes"/>
+/// only if they legitimately buffer that much.
+/// </summary>
+/// <param name="Paused">Connections whose recv is currently paused.</param>
+/// <param name="Pauses">Recvs paused since the reactor started (over budget or inbound ring full).</param>
+/// <param name="Resumes">Paused recvs re-armed after their handler caught up.</param>
+public readonly record struct RecvBackpressureStats(
+    int Paused,
+    long Pauses,
+    long Resumes);
@@ -0,0 +1,20 @@
+namespace zerg.Engine;
+
+/// <summary>
+/// Occupancy snapshot of one recv buffer group of a reactor (see <see cref="Engine.Reactor.GetRecvBufferStats"/>).
+/// Use <see cref="HighWater"/> to size <see cref="Configs.ReactorConfig.BufferRingEntries"/> /
+/// <see cref="Configs.RecvBufferClass.Entries"/> from real traffic.
+/// </summary>
+/// <param name="BufferSize">Size in bytes of each buffer in the group.</param>
+/// <param name="Entries">Capacity of the group (buffers reserved).</param>
+/// <param name="Published">Buffers currently in circulation (handed to the kernel at least once and not withdrawn).</param>
+/// <param name="Outstanding">Buffers holding received data: filled by the kernel and not yet returned.</param>
+/// <param name="HighWater">Peak of <paramref name="Outstanding"/> since the reactor started.</param>
+/// <param name="Starvations">Multishot recvs that ran the group dry (-ENOBUFS) and had to wait for buffers.</param>
+public readonly record struct RecvBufferGroupStats(
+    int BufferSize,
+    int Entries,
+    int Published,
+    int Outstanding,
+    int HighWater,
+    long Starvations);
@@ -0,0 +1,16 @@
+using zerg.Engine.Configs;
+
+namespace zerg.Engine;
+
+/// <summary>
+/// Outcome of a relay between two connections (see <see cref="Connection.ProxyAsync"/>).
+/// </summary>
+/// <param name="Mode">The <see cref="RelayMode"/> the relay ran in.</param>
+/// <param name="BytesToPeer">Bytes received on the connection <c>ProxyAsync</c> was called on and sent to the peer.</param>
+/// <param name="BytesFromPeer">Bytes received on the peer and sent to the connection.</param>
+/// <param name="Error">0 when both sides finished with an orderly shutdown, else the negative errno that ended the relay.</param>
+public readonly record struct RelayResult(
+    RelayMode Mode,
+    long BytesToPeer,
+    long BytesFromPeer,
+    int Error);
@@ -0,0 +1,114 @@
+using System.Collections.Concurrent;
+using System.Runtime.InteropServices;
+using zerg.Utils.UnmanagedMemoryManager;
+
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+/// <summary>
+/// One block of a connection's write chain: a 64-byte aligned unmanaged buffer holding the chain's bytes
+/// [<see cref="Base"/>, Base + <see cref="Length"/>). Either the connection's own write slab
+/// (<see cref="IsSlab"/>) or an overflow segment rented from a <see cref="WriteSegmentPool"/>.
+/// </summary>
+internal sealed unsafe class WriteSegment
+{
+    /// <summary>Allocates a pooled overflow segment.</summary>
+    public WriteSegment(int capacity)
+    {
+        Capacity = capacity;
+        Ptr = (byte*)NativeMemory.AlignedAlloc((nuint)capacity, 64);
+        Manager = new UnmanagedMemoryManager(Ptr, capacity);
+    }
+
+    /// <summary>Wraps a connection's write slab; its memory belongs to the connection.</summary>
+    public WriteSegment(UnmanagedMemoryManager slab)
+    {
+        Capacity = slab.Length;
+        Ptr = slab.Ptr;
+        Manager = slab;
+        IsSlab = true;
+    }
+
+    public readonly byte* Ptr;
+    public readonly int Capacity;
+    /// <summary><see cref="System.Memory{T}"/> view over the block for the IBufferWriter APIs.</summary>
+    public readonly UnmanagedMemoryManager Manager;
+    /// <summary>The connection's write slab rather than a pooled segment.</summary>
+    public readonly bool IsSlab;
+    /// <summary>Chain position of the block's first byte.</summary>
+    public long Base;
+    /// <summary>Bytes written into the block.</summary>
+    public int Length;
+    /// <summary>Next block of the chain; set once by the writer when it moves on (published with a volatile write).</summary>
+    public WriteSegment? Next;
+
+    public void Free() => Manager.Free();
+}
+
+/// <summary>
+/// Per-reactor pool of <see cref="WriteSegment"/>s that connections chain after their write slab once it fills.
+///
+/// Handlers rent on whatever thread they write from; the reactor returns segments once their bytes
+/// have been sent, so both ends are thread-safe. Segments of the standard size are retained up to
+/// a bound; larger ones (a single <c>GetSpan</c> hint above the segment size) are freed on return.
+/// </summary>
+internal sealed class WriteSegmentPool
+{
+    /// <summary>Upper bound on idle segments kept for reuse.</summary>
+    private const int c_maxRetained = 1024;
+
+    private readonly ConcurrentQueue<WriteSegment> _free = new();
+    private int _retained;
+
+    /// <param name="segmentSize">Capacity of pooled segments; rounded up to a cache line.</param>
+    public WriteSegmentPool(int segmentSize)
+    {
+        SegmentSize = (Math.Max(segmentSize, 64) + 63) & ~63;
+    }
+
+    /// <summary>Capacity of pooled segments.</summary>
+    public int SegmentSize { get; }
+
+    /// <summary>Returns an empty segment of at least <paramref name="minSize"/> bytes.</summary>
+    public WriteSegment Rent(int minSize)
+    {
+        if (minSize <= SegmentSize)
+        {
+            if (_free.TryDequeue(out WriteSegment? segment))
+            {
+                Interlocked.Decrement(ref _retained);
+                return segment;
+            }
+            return new WriteSegment(SegmentSize);
+        }
+        return new WriteSegment((minSize + 63) & ~63);
+    }
+
+    /// <summary>Gives a segment back; its contents are discarded.</summary>
+    public void Return(WriteSegment segment)
+    {
+        segment.Length = 0;
+        segment.Next = null;
+        if (segment.Capacity == SegmentSize && Interlocked.Increment(ref _retained) <= c_maxRetained)
+        {
+            _free.Enqueue(segment);
+            return;
+        }
+        if (segment.Capacity == SegmentSize)
+            Interlocked.Decrement(ref _retained);
+        segment.Free();
+    }
+
+    /// <summary>Frees every idle segment (reactor shutdown).</summary>
+    public void Clear()
+    {
+        while (_free.TryDequeue(out WriteSegment? segment))
+        {
+            Interlocked.Decrement(ref _retained);
+            segment.Free();
+        }
+    }
+}
@@ -0,0 +1,70 @@
+// ReSharper disable always CheckNamespace
+// ReSharper disable always SuggestVarOrType_BuiltInTypes
+// (var is avoided intentionally in this project so that concrete types are visible at call sites.)
+
+namespace zerg.Engine;
+
+/// <summary>
+/// Carves connection write slabs out of huge-page chunks (see <see cref="HugePageSlab"/>) placed on one NUMA node.
+///
+/// A slab is owned by its <see cref="Connection"/> for as long as the reactor pools that connection. Slabs of
+/// connections the pool drops come back through <see cref="Return"/> and are handed out again before the
+/// current chunk is bumped further; a new chunk is mapped only when both are used up.
+/// <see cref="Dispose"/> unmaps every chunk at reactor shutdown.
+/// Owned by one reactor thread; not thread-safe.
+/// </summary>
+internal sealed unsafe class WriteSlabArena : IDisposable
+{
+    private readonly int _slabSize;
+    private readonly int _numaNode;
+    private readonly List<(nint Chunk, nuint Length)> _chunks = [];
+    private readonly Stack<nint> _free = new();
+    private byte* _chunk;
+    private nuint _chunkLength;
+    private nuint _chunkUsed;
+
+    /// <param name="slabSize">Size of each write slab; rounded up to a cache line.</param>
+    /// <param name="numaNode">Node the chunks prefer (-1: no preference).</param>
+    public WriteSlabArena(int slabSize, int numaNode)
+    {
+        _slabSize = (slabSize + 63) & ~63;
+        _numaNode = numaNode;
+    }
+
+    /// <summary>Size in bytes of the slabs this arena hands out.</summary>
+    public int SlabSize => _slabSize;
+
+    /// <summary>Returns a 64-byte aligned write slab of <see cref="SlabSize"/> bytes, reusing a returned one first.</summary>
+    public byte* Rent()
+    {
+        if (_free.TryPop(out nint returned))
+            return (byte*)returned;
+
+        if (_chunk == null || _chunkUsed + (nuint)_slabSize > _chunkLength)
+        {
+            _chunk = HugePageSlab.Map((nuint)_slabSize, _numaNode, out _chunkLength, out _);
+            if (_chunk == null)
+                throw new OutOfMemoryException($"mmap of {_chunkLength} byte write slab chunk failed");
+            _chunks.Add(((nint)_chunk, _chunkLength));
+            _chunkUsed = 0;
+        }
+
+        byte* slab = _chunk + _chunkUsed;
+        _chunkUsed += (nuint)_slabSize;
+        return slab;
+    }
+
+    /// <summary>Takes back a slab from <see cref="Rent"/> whose connection is no longer pooled.</summary>
+    public void Return(byte* slab) => _free.Push((nint)slab);
+
+    /// <summary>Unmaps every chunk. Slabs handed out before are invalid afterwards.</summary>
+    public void Dispose()
+    {
+        foreach ((nint chunk, nuint length) in _chunks)
+            HugePageSlab.Unmap((byte*)chunk, length);
+        _chunks.Clear();
+        _free.Clear();
+        _chunk = null;
+        _chunkLength = _chunkUsed = 0;
+    }
+}
@@ -0,0 +1,51 @@
+using Microsoft.Win32.SafeHandles;
+
+namespace zerg;
+
+/// <summary>
+/// A file held by a <see cref="FileCache"/>: its contents when it is small, otherwise an open handle that
+/// <see cref="Connection.SendFileAsync(CachedFile)"/> sends from. Use an entry right after looking it up;
+/// once the cache drops it, its handle is closed as soon as no send is using it, and a send started after
+/// that goes through the cache again.
+/// </summary>
+public sealed class CachedFile
+{
+    internal CachedFile(FileCache cache, string path, long length, DateTime lastWriteTimeUtc, SafeFileHandle? handle, byte[]? contents)
+    {
+        Cache = cache;
+        Path = path;
+        Length = length;
+        LastWriteTimeUtc = lastWriteTimeUtc;
+        Handle = handle;
+        _contents = contents;
+    }
+
+    private readonly byte[]? _contents;
+
+    /// <summary>Path the file was looked up by.</summary>
+    public string Path { get; }
+
+    /// <summary>Size of the file in bytes when it was loaded.</summary>
+    public long Length { get; }
+
+    /// <summary>Modification time of the file when it was loaded.</summary>
+    public DateTime LastWriteTimeUtc { get; }
+
+    /// <summary>The open file, or null when the file is held in memory (<see cref="IsInMemory"/>).</summary>
+    public SafeFileHandle? Handle { get; }
+
+    /// <summary>True when the whole file is held in <see cref="Contents"/>.</summary>
+    public bool IsInMemory => _contents != null;
+
+    /// <summary>The file's bytes when <see cref="IsInMemory"/>, otherwise empty.</summary>
+    public ReadOnlyMemory<byte> Contents => _contents;
+
+    /// <summary>The cache that loaded the entry.</summary>
+    internal FileCache Cache { get; }
+
+    /// <summary>Environment.TickCount64 until which the entry is served without a stat.</summary>
+    internal long ValidUntil;
+
+    /// <summary>Environment.TickCount64 of the last lookup (least-recently-used eviction).</summary>
+    internal long LastUsed;
+}
@@ -0,0 +1,181 @@
+using System.Collections.Concurrent;
+using Microsoft.Win32.SafeHandles;
+using zerg.Engine.Configs;
+
+namespace zerg;
+
+/// <summary>
+/// Open files and small file contents shared by an engine's handlers (see <see cref="EngineOptions.FileCache"/>),
+/// so serving a hot path costs a dictionary lookup instead of an <c>openat</c> and a <c>statx</c> per request.
+///
+/// Entries are revalidated with a stat once <see cref="FileCacheOptions.RevalidateAfterMs"/> has passed, and
+/// reloaded when the file's size or modification time changed. Thread-safe.
+/// </summary>
+public sealed class FileCache : IDisposable
+{
+    private readonly ConcurrentDictionary<string, CachedFile> _entries = new(StringComparer.Ordinal);
+    private readonly object _trimLock = new();
+    private long _memoryBytes;
+    private long _hits;
+    private long _misses;
+
+    public FileCache(FileCacheOptions? options = null)
+    {
+        Options = options ?? new FileCacheOptions();
+        if (Options.MaxEntries <= 0)
+            throw new ArgumentOutOfRangeException(nameof(options), "MaxEntries must be positive.");
+    }
+
+    public FileCacheOptions Options { get; }
+
+    /// <summary>Files currently cached.</summary>
+    public int Count => _entries.Count;
+
+    /// <summary>Bytes of file contents held in memory.</summary>
+    public long MemoryBytes => Volatile.Read(ref _memoryBytes);
+
+    /// <summary>Lookups served from the cache (including those that only needed a stat).</summary>
+    public long Hits => Volatile.Read(ref _hits);
+
+    /// <summary>Lookups that opened the file.</summary>
+    public long Misses => Volatile.Read(ref _misses);
+
+    /// <summary>
+    /// Returns the cached file at <paramref name="path"/>, opening (and, if small, reading) it on a miss.
+    /// Throws like <see cref="File.OpenHandle"/> when the file cannot be opened.
+    /// </summary>
+    public CachedFile Open(string path)
+    {
+        ArgumentNullException.ThrowIfNull(path);
+        long now = Environment.TickCount64;
+
+        if (_entries.TryGetValue(path, out CachedFile? file))
+        {
+            if (now < Volatile.Read(ref file.ValidUntil) || IsUnchanged(file))
+            {
+                Volatile.Write(ref file.ValidUntil, Math.Max(Volatile.Read(ref file.ValidUntil), now + Options.RevalidateAfterMs));
+                file.LastUsed = now;
+                Interlocked.Increment(ref _hits);
+                return file;
+            }
+            Remove(path, file);
+        }
+
+        Interlocked.Increment(ref _misses);
+        file = Load(path, now);
+        if (!_entries.TryAdd(path, file))
+        {
+            // Another handler loaded it first: keep theirs.
+            Release(file);
+            return Open(path);
+        }
+        if (_entries.Count > Options.MaxEntries)
+            Trim();
+        return file;
+    }
+
+    /// <summary>Drops the entry for <paramref name="path"/>, if any; the next <see cref="Open"/> reloads it.</summary>
+    public void Invalidate(string path)
+    {
+        if (_entries.TryGetValue(path, out CachedFile? file))
+            Remove(path, file);
+    }
+
+    /// <summary>Drops every entry.</summary>
+    public void Clear()
+    {
+        foreach (KeyValuePair<string, CachedFile> entry in _entries)
+            Remove(entry.Key, entry.Value);
+    }
+
+    public void Dispose() => Clear();
+
+    private CachedFile Load(string path, long now)
+    {
+        SafeFileHandle handle = File.OpenHandle(path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite | FileShare.Delete);
+        try
+        {
+            long length = RandomAccess.GetLength(handle);
+            DateTime lastWrite = File.GetLastWriteTimeUtc(handle);
+            CachedFile file;
+            if (length <= Options.SmallFileThreshold &&
+                Interlocked.Add(ref _memoryBytes, length) <= Options.MaxSmallFileBytes)
+            {
+                byte[] contents = new byte[length];
+                int read = 0;
+                while (read < contents.Length)
+                {
+                    int n = RandomAccess.Read(handle, contents.AsSpan(read), read);
+                    if (n == 0)
+                        break;
+                    read += n;
+                }
+                if (read < contents.Length)
+                    Array.Resize(ref contents, read); // truncated while we read it
+                Interlocked.Add(ref _memoryBytes, contents.Length - length);
+                handle.Dispose();
+                file = new CachedFile(this, path, contents.Length, lastWrite, null, contents);
+            }
+            else
+            {
+                if (length <= Options.SmallFileThreshold)
+                    Interlocked.Add(ref _memoryBytes, -length); // over the memory budget: keep the handle
+                file = new CachedFile(this, path, length, lastWrite, handle, null);
+            }
+            file.ValidUntil = now + Options.RevalidateAfterMs;
+            file.LastUsed = now;
+            return file;
+        }
+        catch
+        {
+            handle.Dispose();
+            throw;
+        }
+    }
+
+    /// <summary>Stats the path: true when the file still has the size and modification time it was loaded with.</summary>
+    private static bool IsUnchanged(CachedFile file)
+    {
+        FileInfo info = new(file.Path);
+        return info.Exists && info.Length == file.Length && info.LastWriteTimeUtc == file.LastWriteTimeUtc;
+    }
+
+    private void Remove(string path, CachedFile file)
+    {
+        if (_entries.TryRemove(new KeyValuePair<string, CachedFile>(path, file)))
+            Release(file);
+    }
+
+    /// <summary>
+    /// Gives back an entry's memory and handle. A send still using the handle holds a reference to it,
+    /// so the file is only closed once that send ends; a send of the entry that has not started yet
+    /// finds the handle disposed and looks the path up again (see <see cref="Connection.SendFileAsync(CachedFile)"/>).
+    /// </summary>
+    private void Release(CachedFile file)
+    {
+        if (file.IsInMemory)
+            Interlocked.Add(ref _memoryBytes, -file.Length);
+        file.Handle?.Dispose();
+    }
+
+    /// <summary>Drops the least recently used entries down to 7/8 of the capacity.</summary>
+    private void Trim()
+    {
+        if (!Monitor.TryEnter(_trimLock))
+            return; // another handler is already trimming
+        try
+        {
+            int excess = _entries.Count - Options.MaxEntries * 7 / 8;
+            if (excess <= 0)
+                return;
+            KeyValuePair<string, CachedFile>[] entries = _entries.ToArray();
+            Array.Sort(entries, static (a, b) => a.Value.LastUsed.CompareTo(b.Value.LastUsed));
+            for (int i = 0; i < excess && i < entries.Length; i++)
+                Remove(entries[i].Key, entries[i].Value);
+        }
+        finally
+        {
+            Monitor.Exit(_trimLock);
+        }
+    }
+}
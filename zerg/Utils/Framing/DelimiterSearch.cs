@@ -0,0 +1,73 @@
+using System.Numerics;
+using System.Runtime.CompilerServices;
+using System.Runtime.Intrinsics;
+
+namespace zerg.Utils.Framing;
+
+/// <summary>
+/// Vectorized delimiter search over raw (unmanaged) receive buffers.
+///
+/// Candidates are found by comparing the first and the last delimiter byte at once, 64 or 32 positions per step
+/// (<see cref="Vector512{T}"/>/<see cref="Vector256{T}"/>); only positions where both match are verified.
+/// Whatever is left after the last full vector goes through <see cref="MemoryExtensions.IndexOf{T}(ReadOnlySpan{T}, ReadOnlySpan{T})"/>.
+/// </summary>
+internal static unsafe class DelimiterSearch
+{
+    /// <summary>Index of the first occurrence of <paramref name="delimiter"/> in the buffer, or -1.</summary>
+    public static int IndexOf(byte* buffer, int length, ReadOnlySpan<byte> delimiter)
+    {
+        int last = delimiter.Length - 1;
+        if (length <= last)
+            return -1;
+
+        int i = 0;
+        int positions = length - last;
+
+        if (Vector512.IsHardwareAccelerated && positions >= Vector512<byte>.Count)
+        {
+            Vector512<byte> first = Vector512.Create(delimiter[0]);
+            Vector512<byte> final = Vector512.Create(delimiter[last]);
+            for (; i <= positions - Vector512<byte>.Count; i += Vector512<byte>.Count)
+            {
+                Vector512<byte> hits = Vector512.Equals(Vector512.Load(buffer + i), first)
+                                     & Vector512.Equals(Vector512.Load(buffer + i + last), final);
+                ulong mask = hits.ExtractMostSignificantBits();
+                while (mask != 0)
+                {
+                    int candidate = i + BitOperations.TrailingZeroCount(mask);
+                    if (Matches(buffer + candidate, delimiter))
+                        return candidate;
+                    mask &= mask - 1;
+                }
+            }
+        }
+
+        if (Vector256.IsHardwareAccelerated && positions - i >= Vector256<byte>.Count)
+        {
+            Vector256<byte> first = Vector256.Create(delimiter[0]);
+            Vector256<byte> final = Vector256.Create(delimiter[last]);
+            for (; i <= positions - Vector256<byte>.Count; i += Vector256<byte>.Count)
+            {
+                Vector256<byte> hits = Vector256.Equals(Vector256.Load(buffer + i), first)
+                                     & Vector256.Equals(Vector256.Load(buffer + i + last), final);
+                uint mask = hits.ExtractMostSignificantBits();
+                while (mask != 0)
+                {
+                    int candidate = i + BitOperations.TrailingZeroCount(mask);
+                    if (Matches(buffer + candidate, delimiter))
+                        return candidate;
+                    mask &= mask - 1;
+                }
+            }
+        }
+
+        int rest = new ReadOnlySpan<byte>(buffer + i, length - i).IndexOf(delimiter);
+        return rest < 0 ? -1 : i + rest;
+    }
+
+    /// <summary>The first and last byte already matched; compares the ones in between.</summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static bool Matches(byte* candidate, ReadOnlySpan<byte> delimiter)
+        => delimiter.Length <= 2
+        || new ReadOnlySpan<byte>(candidate + 1, delimiter.Length - 2).SequenceEqual(delimiter[1..^1]);
+}
@@ -0,0 +1,115 @@
+using System.Buffers.Binary;
+
+namespace zerg.Utils.Framing;
+
+/// <summary>
+/// Returns the length of the complete frame at the start of <paramref name="data"/>, 0 when more data is
+/// needed, or a negative value when the data cannot be framed (the framer throws <see cref="InvalidDataException"/>).
+/// </summary>
+public delegate int FrameLengthDecoder(ReadOnlySpan<byte> data);
+
+/// <summary>
+/// How a <see cref="ConnectionFramer"/> splits the received byte stream into frames.
+/// Frames always cover the exact wire bytes: delimiter frames end with the delimiter,
+/// length-prefixed frames start with the prefix.
+/// </summary>
+public sealed class FrameDecoder
+{
+    /// <summary>Default cap on a single frame (and on the bytes scanned for a delimiter).</summary>
+    public const int DefaultMaxFrameLength = 64 * 1024;
+
+    internal enum FrameKind : byte { Delimiter, LengthPrefix, Custom }
+
+    internal readonly FrameKind Kind;
+
+    /// <summary>Largest frame accepted; a longer one throws <see cref="InvalidDataException"/>.</summary>
+    public int MaxFrameLength { get; }
+
+    /// <summary>Delimiter bytes and their KMP failure table (delimiter framing).</summary>
+    internal readonly byte[] DelimiterBytes = [];
+    private readonly int[] _failure = [];
+
+    /// <summary>Size of the length prefix in bytes (1, 2 or 4) and its byte order (length-prefix framing).</summary>
+    internal readonly int PrefixLength;
+    internal readonly bool BigEndian;
+
+    internal readonly FrameLengthDecoder? Custom;
+
+    private FrameDecoder(FrameKind kind, int maxFrameLength)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegativeOrZero(maxFrameLength);
+        Kind = kind;
+        MaxFrameLength = maxFrameLength;
+    }
+
+    private FrameDecoder(byte[] delimiter, int maxFrameLength) : this(FrameKind.Delimiter, maxFrameLength)
+    {
+        DelimiterBytes = delimiter;
+        _failure = new int[delimiter.Length];
+        for (int i = 1, k = 0; i < delimiter.Length; i++)
+        {
+            while (k > 0 && delimiter[i] != delimiter[k])
+                k = _failure[k - 1];
+            if (delimiter[i] == delimiter[k])
+                k++;
+            _failure[i] = k;
+        }
+    }
+
+    private FrameDecoder(int prefixLength, bool bigEndian, int maxFrameLength) : this(FrameKind.LengthPrefix, maxFrameLength)
+    {
+        PrefixLength = prefixLength;
+        BigEndian = bigEndian;
+    }
+
+    private FrameDecoder(FrameLengthDecoder decoder, int maxFrameLength) : this(FrameKind.Custom, maxFrameLength)
+    {
+        Custom = decoder;
+    }
+
+    /// <summary>Frames end with <paramref name="delimiter"/> (for example <c>"\r\n\r\n"u8</c>).</summary>
+    public static FrameDecoder Delimiter(ReadOnlySpan<byte> delimiter, int maxFrameLength = DefaultMaxFrameLength)
+    {
+        if (delimiter.IsEmpty)
+            throw new ArgumentException("The delimiter must not be empty.", nameof(delimiter));
+        return new FrameDecoder(delimiter.ToArray(), maxFrameLength);
+    }
+
+    /// <summary>
+    /// Frames start with a <paramref name="prefixLength"/>-byte unsigned length of the payload that follows.
+    /// </summary>
+    public static FrameDecoder LengthPrefix(int prefixLength = 4, bool bigEndian = true,
+        int maxFrameLength = DefaultMaxFrameLength)
+    {
+        if (prefixLength is not (1 or 2 or 4))
+            throw new ArgumentOutOfRangeException(nameof(prefixLength), "The length prefix must be 1, 2 or 4 bytes.");
+        return new FrameDecoder(prefixLength, bigEndian, maxFrameLength);
+    }
+
+    /// <summary>
+    /// Frames are measured by <paramref name="decoder"/>. It sees the unconsumed bytes as one span, which is
+    /// copied into the connection's scratch area only when they straddle receive buffers.
+    /// </summary>
+    public static FrameDecoder FromPredicate(FrameLengthDecoder decoder, int maxFrameLength = DefaultMaxFrameLength)
+    {
+        ArgumentNullException.ThrowIfNull(decoder);
+        return new FrameDecoder(decoder, maxFrameLength);
+    }
+
+    /// <summary>Advances the delimiter match state (bytes matched so far) by one input byte.</summary>
+    internal int Step(int matched, byte b)
+    {
+        byte[] delimiter = DelimiterBytes;
+        while (matched > 0 && delimiter[matched] != b)
+            matched = _failure[matched - 1];
+        return delimiter[matched] == b ? matched + 1 : 0;
+    }
+
+    /// <summary>Payload length encoded in a complete prefix.</summary>
+    internal uint ReadPrefix(ReadOnlySpan<byte> prefix) => PrefixLength switch
+    {
+        1 => prefix[0],
+        2 => BigEndian ? BinaryPrimitives.ReadUInt16BigEndian(prefix) : BinaryPrimitives.ReadUInt16LittleEndian(prefix),
+        _ => BigEndian ? BinaryPrimitives.ReadUInt32BigEndian(prefix) : BinaryPrimitives.ReadUInt32LittleEndian(prefix)
+    };
+}
@@ -34,26 +34,37 @@ public sealed class MpscUshortQueue {
 
     /// <summary>
     /// Try to enqueue. Returns false if full right now.
-    /// Multi-producer safe.
+    /// Multi-producer safe. A ticket is only taken once its slot is known to be free,
+    /// so a failed attempt leaves the queue intact.
     /// </summary>
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
     public bool TryEnqueue(ushort value) {
-        // Reserve a ticket (unique position) among all producers
-        long ticket = Interlocked.Increment(ref _tail) - 1;
-        int  idx    = (int)(ticket & _mask);
-
-        // Slot is free when seq[idx] == ticket
-        long seq = Volatile.Read(ref _seq[idx]);
-        if (seq != ticket)
+        while (true)
         {
-            // Queue is full (or producer is too far ahead) -> fail fast
-            return false;
+            long ticket = Volatile.Read(ref _tail);
+            int  idx    = (int)(ticket & _mask);
+
+            // Slot is free when seq[idx] == ticket
+            long seq = Volatile.Read(ref _seq[idx]);
+            long dif = seq - ticket;
+            if (dif == 0)
+            {
+                // Claim the ticket; another producer may have taken it first
+                if (Interlocked.CompareExchange(ref _tail, ticket + 1, ticket) != ticket)
+                    continue;
+
+                _data[idx] = value;
+                // Publish: mark slot as ready for consumer (seq = ticket + 1)
+                Volatile.Write(ref _seq[idx], ticket + 1);
+                return true;
+            }
+
+            // Slot not consumed yet -> full
+            if (dif < 0)
+                return false;
+
+            // Another producer is ahead; retry with a fresh tail
         }
-
-        _data[idx] = value;
-        // Publish: mark slot as ready for consumer (seq = ticket + 1)
-        Volatile.Write(ref _seq[idx], ticket + 1);
-        return true;
     }
 
     /// <summary>
@@ -2,16 +2,31 @@ using System.Buffers;
 
 namespace zerg.Utils;
 
-public sealed class RingSegment : ReadOnlySequenceSegment<byte>
+public sealed unsafe class RingSegment : ReadOnlySequenceSegment<byte>
 {
     public ushort BufferId { get; set; }
 
+    /// <summary>
+    /// Backing memory of a pooled segment (see <see cref="Connection.RentSegment"/>), re-pointed at each
+    /// receive buffer the segment carries. Null for segments built over caller-provided memory.
+    /// </summary>
+    private readonly UnmanagedMemoryManager.UnmanagedMemoryManager? _manager;
+
+    /// <summary>Link in the owning connection's free list while the segment is pooled.</summary>
+    internal RingSegment? NextFree;
+
     public RingSegment(ReadOnlyMemory<byte> memory, ushort bufferId)
     {
         Memory = memory; 
         BufferId = bufferId;
     }
 
+    /// <summary>Creates an empty poolable segment with its own reusable memory manager.</summary>
+    internal RingSegment()
+    {
+        _manager = new UnmanagedMemoryManager.UnmanagedMemoryManager(null, 0, 0, freeable: false);
+    }
+
     public RingSegment Append(ReadOnlyMemory<byte> memory, ushort bufferId) 
     {
         var next = new RingSegment(memory, bufferId) 
@@ -22,4 +37,35 @@ public sealed class RingSegment : ReadOnlySequenceSegment<byte>
         Next = next;
         return next;
     }
-}
\ No newline at end of file
+
+    /// <summary>The segment after this one, as a <see cref="RingSegment"/>.</summary>
+    internal RingSegment? NextSegment => (RingSegment?)Next;
+
+    /// <summary>Points a pooled segment at <paramref name="item"/>, unlinked.</summary>
+    internal void Reset(in RingItem item)
+    {
+        _manager!.Reset(item.Ptr, item.Length, item.BufferId);
+        Memory = _manager.Memory;
+        BufferId = item.BufferId;
+        RunningIndex = 0;
+        Next = null;
+    }
+
+    /// <summary>Drops the buffer reference of a segment going back to the pool.</summary>
+    internal void Clear()
+    {
+        _manager!.Reset(null, 0, 0);
+        Memory = default;
+        Next = null;
+        NextFree = null;
+    }
+
+    /// <summary>Skips the first <paramref name="count"/> bytes (partially consumed buffer).</summary>
+    internal void Consume(int count) => Memory = Memory.Slice(count);
+
+    /// <summary>Links <paramref name="next"/> after this segment.</summary>
+    internal void SetNext(RingSegment? next) => Next = next;
+
+    /// <summary>Re-bases the segment inside a new sequence.</summary>
+    internal void SetRunningIndex(long runningIndex) => RunningIndex = runningIndex;
+}
@@ -15,6 +15,8 @@ public sealed class SpscRecvRing
 
     public long Head => Volatile.Read(ref _head);
 
+    public int Capacity => _items.Length;
+
     public SpscRecvRing(int capacityPow2)
     {
         if (capacityPow2 <= 0 || (capacityPow2 & (capacityPow2 - 1)) != 0)
@@ -19,10 +19,10 @@ public sealed unsafe class UnmanagedMemoryManager : MemoryManager<byte>
 {
     private readonly bool _freeable = true;
     
-    private readonly byte* _ptr;
-    private readonly int _length;
+    private byte* _ptr;
+    private int _length;
     
-    public ushort BufferId { get; }
+    public ushort BufferId { get; private set; }
     
     public byte* Ptr => _ptr;
     
@@ -56,6 +56,18 @@ public sealed unsafe class UnmanagedMemoryManager : MemoryManager<byte>
         BufferId = bufferId; 
     }
 
+    /// <summary>
+    /// Points a reused (non-freeable) manager at another region, e.g. a pooled <see cref="RingSegment"/>
+    /// moving on to the next receive buffer. <see cref="System.Memory{T}"/> instances created before still
+    /// describe the old region's length but read through the new pointer, so they must not outlive the reset.
+    /// </summary>
+    internal void Reset(byte* ptr, int length, ushort bufferId)
+    {
+        _ptr = ptr;
+        _length = length;
+        BufferId = bufferId;
+    }
+
     public override Span<byte> GetSpan() => new Span<byte>(_ptr, _length);
 
     public override MemoryHandle Pin(int elementIndex = 0) => new MemoryHandle(_ptr + elementIndex);
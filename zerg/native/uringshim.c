@@ -5,10 +5,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
-#include <stdio.h>
 #include <unistd.h>         // syscall()
 #include <sys/syscall.h>    // __NR_io_uring_enter
 #include <liburing.h>
+#include "uringshim.h"
 
 // Build (using system liburing):
 //   gcc -O2 -fPIC -shared -o liburingshim.so uringshim.c -luring
@@ -70,6 +70,16 @@ unsigned shim_get_ring_flags(struct io_uring* ring)
     return ring->flags;
 }
 
+/**
+ * Returns the IORING_FEAT_* bits the kernel reported at ring setup
+ * (e.g. IORING_FEAT_RECVSEND_BUNDLE).
+ */
+unsigned shim_get_ring_features(struct io_uring* ring)
+{
+    if (!ring) return 0;
+    return ring->features;
+}
+
 /**
  * Create ring with io_uring_queue_init_params.
  *
@@ -87,6 +97,21 @@ struct io_uring* shim_create_ring_ex(unsigned entries,
                                      int      sq_thread_cpu,
                                      unsigned sq_thread_idle_ms,
                                      int*     err_out)
+{
+    return shim_create_ring_attach(entries, flags, sq_thread_cpu, sq_thread_idle_ms, -1, err_out);
+}
+
+/**
+ * Same as shim_create_ring_ex, and when wq_fd >= 0 the ring is set up with
+ * IORING_SETUP_ATTACH_WQ against the ring behind wq_fd (see shim_ring_fd):
+ * with SQPOLL both rings are served by that ring's SQ thread and its worker pool.
+ */
+struct io_uring* shim_create_ring_attach(unsigned entries,
+                                         unsigned flags,
+                                         int      sq_thread_cpu,
+                                         unsigned sq_thread_idle_ms,
+                                         int      wq_fd,
+                                         int*     err_out)
 {
     struct io_uring* ring = (struct io_uring*)malloc(sizeof(struct io_uring));
     if (!ring)
@@ -114,10 +139,12 @@ struct io_uring* shim_create_ring_ex(unsigned entries,
         }
     }
 
-    fprintf(stderr, "shim_create_ring_ex: flags=0x%x sq_cpu=%d idle=%u\n",
-        flags, sq_thread_cpu, sq_thread_idle_ms);
-    fprintf(stderr, "params: p.flags=0x%x p.wq_fd=%u\n", p.flags, p.wq_fd);
-    
+    if (wq_fd >= 0)
+    {
+        p.flags |= IORING_SETUP_ATTACH_WQ;
+        p.wq_fd = (unsigned)wq_fd;
+    }
+
     int rc = io_uring_queue_init_params(entries, ring, &p);
     if (rc < 0)
     {
@@ -130,6 +157,15 @@ struct io_uring* shim_create_ring_ex(unsigned entries,
     return ring;
 }
 
+/**
+ * File descriptor of the ring (for IORING_SETUP_ATTACH_WQ), or -1.
+ */
+int shim_ring_fd(struct io_uring* ring)
+{
+    if (!ring) return -1;
+    return ring->ring_fd;
+}
+
 /**
  * Create ring with default parameters (single issuer; no SQPOLL).
  */
@@ -166,6 +202,140 @@ void shim_destroy_ring(struct io_uring* ring)
     free(ring);
 }
 
+// -----------------------------------------------------------------------------
+// Capability probing
+// -----------------------------------------------------------------------------
+
+#ifndef IOU_PBUF_RING_INC
+#define IOU_PBUF_RING_INC 2
+#endif
+
+/**
+ * Tries to set up (and immediately tears down) a small ring with the given flags.
+ * Returns 1 if the kernel accepted them.
+ */
+static int shim_try_setup(unsigned flags)
+{
+    struct io_uring ring;
+    struct io_uring_params p;
+    memset(&ring, 0, sizeof(ring));
+    memset(&p, 0, sizeof(p));
+    p.flags = flags;
+    if (flags & IORING_SETUP_SQPOLL)
+        p.sq_thread_idle = 1;
+
+    if (io_uring_queue_init_params(8, &ring, &p) < 0)
+        return 0;
+    io_uring_queue_exit(&ring);
+    return 1;
+}
+
+/**
+ * Reports what the running kernel supports (see shim_probe_result).
+ *
+ * - setup_flags: each IORING_SETUP_* flag of interest that a trial setup accepted.
+ *   DEFER_TASKRUN is tried together with SINGLE_ISSUER and TASKRUN_FLAG with
+ *   COOP_TASKRUN, which they require.
+ * - features / ops: IORING_FEAT_* bits and io_uring_get_probe_ring() of a plain ring.
+ * - caps: SHIM_CAP_* bits for things only a registration on a live ring can tell.
+ *   NAPI is registered with a 0 us timeout, then unregistered.
+ *
+ * Returns 0, or -errno if not even a plain ring can be set up (io_uring missing or disabled).
+ */
+int shim_probe(shim_probe_result* out)
+{
+    if (!out) return -EINVAL;
+    memset(out, 0, sizeof(*out));
+
+    struct io_uring ring;
+    struct io_uring_params p;
+    memset(&ring, 0, sizeof(ring));
+    memset(&p, 0, sizeof(p));
+
+    int rc = io_uring_queue_init_params(8, &ring, &p);
+    if (rc < 0)
+        return rc;
+
+    out->features = p.features;
+
+    struct io_uring_probe* probe = io_uring_get_probe_ring(&ring);
+    if (probe)
+    {
+        out->last_op = probe->last_op;
+        for (unsigned op = 0; op <= probe->last_op && op < 256; op++)
+        {
+            if (io_uring_opcode_supported(probe, (int)op))
+                out->ops[op >> 6] |= 1ull << (op & 63);
+        }
+        io_uring_free_probe(probe);
+    }
+
+    int ret = 0;
+    struct io_uring_buf_ring* br = io_uring_setup_buf_ring(&ring, 1, 0, IOU_PBUF_RING_INC, &ret);
+    if (br)
+    {
+        out->caps |= SHIM_CAP_PBUF_RING_INC;
+        io_uring_free_buf_ring(&ring, br, 1, 0);
+    }
+
+    if (io_uring_register_ring_fd(&ring) == 1)
+        out->caps |= SHIM_CAP_REGISTER_RING_FD;
+
+    struct io_uring_napi napi;
+    memset(&napi, 0, sizeof(napi));
+    if (io_uring_register_napi(&ring, &napi) == 0)
+    {
+        out->caps |= SHIM_CAP_NAPI;
+        io_uring_unregister_napi(&ring, &napi);
+    }
+
+    io_uring_queue_exit(&ring);
+
+    static const unsigned trials[] = {
+        IORING_SETUP_SQPOLL,
+        IORING_SETUP_SUBMIT_ALL,
+        IORING_SETUP_COOP_TASKRUN,
+        IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG,
+        IORING_SETUP_SINGLE_ISSUER,
+        IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN,
+        IORING_SETUP_NO_SQARRAY,
+    };
+    for (unsigned i = 0; i < sizeof(trials) / sizeof(trials[0]); i++)
+    {
+        if (shim_try_setup(trials[i]))
+            out->setup_flags |= trials[i];
+    }
+    return 0;
+}
+
+/**
+ * Registers the ring fd with the calling task (io_uring_register_ring_fd), so
+ * liburing's io_uring_enter calls on this ring skip the fd table lookup.
+ * Registration is per thread: call it from the thread that submits and waits.
+ * Returns 1 on success, or -errno.
+ */
+int shim_register_ring_fd(struct io_uring* ring)
+{
+    if (!ring) return -EINVAL;
+    return io_uring_register_ring_fd(ring);
+}
+
+/**
+ * Enables NAPI busy polling on the ring (io_uring_register_napi, Linux 6.9+): while
+ * the task waits for completions, the kernel busy-polls the NAPI contexts of the
+ * sockets the ring receives on for up to busy_poll_us microseconds before sleeping.
+ * Returns 0, or -errno (-EINVAL on kernels without NAPI support in io_uring).
+ */
+int shim_register_napi(struct io_uring* ring, unsigned busy_poll_us, int prefer_busy_poll)
+{
+    if (!ring) return -EINVAL;
+    struct io_uring_napi napi;
+    memset(&napi, 0, sizeof(napi));
+    napi.busy_poll_to = busy_poll_us;
+    napi.prefer_busy_poll = prefer_busy_poll ? 1 : 0;
+    return io_uring_register_napi(ring, &napi);
+}
+
 // -----------------------------------------------------------------------------
 // SQ / CQ core operations
 // -----------------------------------------------------------------------------
@@ -262,6 +432,56 @@ void shim_cq_advance(struct io_uring* ring, unsigned count)
     io_uring_cq_advance(ring, count);
 }
 
+/**
+ * Copy up to 'max' ready CQEs into 'out' as compact {user_data, res, flags}
+ * records and advance the CQ head past them, in a single call.
+ *
+ * Userspace only: never enters the kernel, never blocks. If nothing is ready
+ * it returns 0 and the caller is expected to submit/wait (which also flushes
+ * deferred task_work and CQ overflow).
+ * Returns the number of records written (0..max).
+ */
+int shim_harvest_cqes(struct io_uring* ring, shim_cqe* out, unsigned max)
+{
+    struct io_uring_cqe* cqe;
+    unsigned head;
+    unsigned n = 0;
+
+    io_uring_for_each_cqe(ring, head, cqe) {
+        if (n == max)
+            break;
+        out[n].user_data = cqe->user_data;
+        out[n].res       = cqe->res;
+        out[n].flags     = cqe->flags;
+        n++;
+    }
+    if (n)
+        io_uring_cq_advance(ring, n);
+    return (int)n;
+}
+
+/**
+ * One poll of a busy-waiting reactor. Returns the number of CQEs ready.
+ *
+ * With COOP_TASKRUN / DEFER_TASKRUN, finished requests sit in task work until the
+ * task enters the kernel, so the CQ tail alone never moves while userspace spins.
+ * If the kernel has flagged pending task work (IORING_SQ_TASKRUN, needs
+ * IORING_SETUP_TASKRUN_FLAG) or a CQ overflow, a non-blocking
+ * io_uring_get_events() posts it first. Otherwise this never enters the kernel.
+ */
+unsigned shim_poll_cqes(struct io_uring* ring)
+{
+    unsigned ready = io_uring_cq_ready(ring);
+    if (ready)
+        return ready;
+    if (IO_URING_READ_ONCE(*ring->sq.kflags) & (IORING_SQ_TASKRUN | IORING_SQ_CQ_OVERFLOW))
+    {
+        io_uring_get_events(ring);
+        ready = io_uring_cq_ready(ring);
+    }
+    return ready;
+}
+
 /**
  * Combined submit + wait (single enter). No timeout.
  * Returns number submitted or -errno.
@@ -315,6 +535,17 @@ void shim_prep_multishot_accept(struct io_uring_sqe* sqe, int lfd, int flags)
     io_uring_prep_multishot_accept(sqe, lfd, NULL, NULL, flags);
 }
 
+/**
+ * Same as shim_prep_multishot_accept, but each accepted socket is installed as a
+ * direct descriptor in a free slot of the ring's fixed-file table
+ * (IORING_FILE_INDEX_ALLOC) instead of the process fd table. cqe->res is the slot.
+ * Requires a table registered with shim_register_files_sparse().
+ */
+void shim_prep_multishot_accept_direct(struct io_uring_sqe* sqe, int lfd, int flags)
+{
+    io_uring_prep_multishot_accept_direct(sqe, lfd, NULL, NULL, flags);
+}
+
 /**
  * Prepare multishot recv that selects buffers from a registered buf-ring group.
  * buf_group must match the bgid used in setup_buf_ring.
@@ -330,6 +561,45 @@ void shim_prep_recv_multishot_select(struct io_uring_sqe* sqe, int fd, unsigned
     sqe->buf_group = (uint16_t)buf_group;
 }
 
+/**
+ * Same as shim_prep_recv_multishot_select, in bundle mode (IORING_RECVSEND_BUNDLE):
+ * each completion may fill several buffers, taken in order from consecutive
+ * buf-ring entries starting at the buffer id reported in the CQE.
+ * Needs IORING_FEAT_RECVSEND_BUNDLE (Linux 6.10+).
+ */
+void shim_prep_recv_multishot_bundle(struct io_uring_sqe* sqe, int fd, unsigned buf_group, int flags)
+{
+    shim_prep_recv_multishot_select(sqe, fd, buf_group, flags);
+    sqe->ioprio |= IORING_RECVSEND_BUNDLE;
+}
+
+/**
+ * Prepare multishot recvmsg (IORING_OP_RECVMSG + IORING_RECV_MULTISHOT) that selects
+ * buffers from buf-ring group 'buf_group'. Only msg_namelen and msg_controllen of 'msg'
+ * are used: every selected buffer starts with a struct io_uring_recvmsg_out, followed by
+ * msg_namelen bytes of source address, msg_controllen bytes of control data and then
+ * the payload. Used for datagram sockets (Linux 6.0+).
+ */
+void shim_prep_recvmsg_multishot_select(struct io_uring_sqe* sqe, int fd, struct msghdr* msg, unsigned buf_group, unsigned flags)
+{
+    io_uring_prep_recvmsg_multishot(sqe, fd, msg, flags);
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = (uint16_t)buf_group;
+}
+
+/**
+ * Prepare multishot poll. Each readiness event on fd yields one CQE (IORING_CQE_F_MORE set)
+ * until the kernel terminates the request.
+ * poll_mask: POLLIN / POLLOUT / ... bits as in poll(2).
+ *
+ * Used by reactors to watch their wakeup eventfd, so cross-thread enqueues can
+ * interrupt an in-progress wait without a timeout.
+ */
+void shim_prep_poll_multishot(struct io_uring_sqe* sqe, int fd, unsigned poll_mask)
+{
+    io_uring_prep_poll_multishot(sqe, fd, poll_mask);
+}
+
 // -----------------------------------------------------------------------------
 // Buf-ring helpers
 // -----------------------------------------------------------------------------
@@ -374,6 +644,8 @@ void shim_free_buf_ring(struct io_uring* ring,
  *
  * mask: usually entries - 1 (entries should be power-of-two).
  * idx : monotonically increasing producer index (you handle wrap via mask).
+ *       liburing takes an offset from the current tail, so convert; passing idx
+ *       through would stage returns past the tail and leave stale bids behind.
  */
 void shim_buf_ring_add(struct io_uring_buf_ring* br,
                        void* addr,
@@ -382,7 +654,7 @@ void shim_buf_ring_add(struct io_uring_buf_ring* br,
                        unsigned short mask,
                        unsigned idx)
 {
-    io_uring_buf_ring_add(br, addr, len, bid, mask, idx);
+    io_uring_buf_ring_add(br, addr, len, bid, mask, (int)(unsigned short)(idx - br->tail));
 }
 
 /** Publish 'count' staged buffers to the kernel. */
@@ -410,6 +682,79 @@ unsigned shim_cqe_buffer_id(const struct io_uring_cqe* cqe)
     return cqe->flags >> IORING_CQE_BUFFER_SHIFT;
 }
 
+// -----------------------------------------------------------------------------
+// Fixed (registered) buffers
+// -----------------------------------------------------------------------------
+
+/**
+ * Register an empty fixed-buffer table with 'nr' slots.
+ * Slots are filled later with shim_register_buffer_slot().
+ * Returns 0 or -errno.
+ */
+int shim_register_buffers_sparse(struct io_uring* ring, unsigned nr)
+{
+    return io_uring_register_buffers_sparse(ring, nr);
+}
+
+/**
+ * Point fixed-buffer slot 'slot' at [addr, addr+len). Pass addr=NULL/len=0 to clear it.
+ * Requests already in flight keep their reference to the previous buffer.
+ * Returns 1 (slots updated) or -errno.
+ */
+int shim_register_buffer_slot(struct io_uring* ring, unsigned slot, void* addr, unsigned len)
+{
+    struct iovec iov;
+    __u64 tag = 0;
+
+    iov.iov_base = addr;
+    iov.iov_len  = len;
+    return io_uring_register_buffers_update_tag(ring, slot, &iov, &tag, 1);
+}
+
+/** Drop the whole fixed-buffer table. Returns 0 or -errno. */
+int shim_unregister_buffers(struct io_uring* ring)
+{
+    return io_uring_unregister_buffers(ring);
+}
+
+// -----------------------------------------------------------------------------
+// Fixed (registered) files
+// -----------------------------------------------------------------------------
+
+/**
+ * Register an empty fixed-file table with 'nr' slots. Slots are filled by direct
+ * accepts or shim_register_file_slot(). Returns 0 or -errno.
+ */
+int shim_register_files_sparse(struct io_uring* ring, unsigned nr)
+{
+    return io_uring_register_files_sparse(ring, nr);
+}
+
+/**
+ * Install fd in fixed-file slot 'slot' (-1 clears it). The table takes its own
+ * reference, so the caller may close fd afterwards.
+ * Returns 1 (slots updated) or -errno.
+ */
+int shim_register_file_slot(struct io_uring* ring, unsigned slot, int fd)
+{
+    return io_uring_register_files_update(ring, slot, &fd, 1);
+}
+
+/**
+ * Mark the SQE's fd as an index into the fixed-file table (IOSQE_FIXED_FILE).
+ * Call after the prep helper, which sets the fd field but resets the flags.
+ */
+void shim_sqe_set_fixed_file(struct io_uring_sqe* sqe)
+{
+    sqe->flags |= IOSQE_FIXED_FILE;
+}
+
+/** Prepare close of fixed-file slot 'file_index' (IORING_OP_CLOSE). */
+void shim_prep_close_direct(struct io_uring_sqe* sqe, unsigned file_index)
+{
+    io_uring_prep_close_direct(sqe, file_index);
+}
+
 // -----------------------------------------------------------------------------
 // Send / cancel
 // -----------------------------------------------------------------------------
@@ -424,6 +769,32 @@ void shim_prep_send(struct io_uring_sqe* sqe,
     io_uring_prep_send(sqe, fd, buf, nbytes, flags);
 }
 
+void shim_prep_sendmsg(struct io_uring_sqe* sqe,
+                       int fd,
+                       const struct msghdr* msg,
+                       unsigned flags)
+{
+    io_uring_prep_sendmsg(sqe, fd, msg, flags);
+}
+
+/**
+ * Prepare zero-copy send (IORING_OP_SEND_ZC) from a registered buffer.
+ * 'buf' must lie inside the fixed buffer registered at 'buf_index'.
+ *
+ * Produces a result CQE and, when that CQE carries IORING_CQE_F_MORE, a later
+ * IORING_CQE_F_NOTIF CQE once the kernel no longer references the pages.
+ */
+void shim_prep_send_zc_fixed(struct io_uring_sqe* sqe,
+                             int fd,
+                             const void* buf,
+                             unsigned nbytes,
+                             int flags,
+                             unsigned zc_flags,
+                             unsigned buf_index)
+{
+    io_uring_prep_send_zc_fixed(sqe, fd, buf, nbytes, flags, zc_flags, buf_index);
+}
+
 /**
  * Prepare cancel by user-data (64-bit).
  * Useful to cancel in-flight multishot recv when closing a connection.
@@ -435,6 +806,84 @@ void shim_prep_cancel64(struct io_uring_sqe* sqe,
     io_uring_prep_cancel64(sqe, user_data, flags);
 }
 
+// -----------------------------------------------------------------------------
+// Outbound connections / relays
+// -----------------------------------------------------------------------------
+
+/**
+ * Prepare connect(2) (IORING_OP_CONNECT). 'addr' must stay valid until the CQE:
+ * older kernels only copy it when the request is issued.
+ * A non-blocking socket is fine; the kernel waits for the handshake itself.
+ */
+void shim_prep_connect(struct io_uring_sqe* sqe, int fd, const void* addr, unsigned addrlen)
+{
+    io_uring_prep_connect(sqe, fd, (const struct sockaddr*)addr, (socklen_t)addrlen);
+}
+
+/**
+ * Prepare splice(2) (IORING_OP_SPLICE) of up to 'nbytes' from fd_in to fd_out,
+ * both at their current position (one of them must be a pipe).
+ * IOSQE_FIXED_FILE applies to fd_out only; a fixed fd_in needs SPLICE_F_FD_IN_FIXED
+ * in splice_flags. A socket end opened O_NONBLOCK completes with -EAGAIN when it
+ * is not ready rather than blocking an io-wq worker.
+ */
+void shim_prep_splice(struct io_uring_sqe* sqe, int fd_in, int fd_out, unsigned nbytes, unsigned splice_flags)
+{
+    io_uring_prep_splice(sqe, fd_in, -1, fd_out, -1, nbytes, splice_flags);
+}
+
+/** Prepare shutdown(2) (IORING_OP_SHUTDOWN); 'how' is SHUT_RD / SHUT_WR / SHUT_RDWR. */
+void shim_prep_shutdown(struct io_uring_sqe* sqe, int fd, int how)
+{
+    io_uring_prep_shutdown(sqe, fd, how);
+}
+
+/** Prepare a single-shot poll (IORING_OP_POLL_ADD); cqe->res is the ready mask. */
+void shim_prep_poll_add(struct io_uring_sqe* sqe, int fd, unsigned poll_mask)
+{
+    io_uring_prep_poll_add(sqe, fd, poll_mask);
+}
+
+// -----------------------------------------------------------------------------
+// File sends
+// -----------------------------------------------------------------------------
+
+/**
+ * Prepare splice(2) (IORING_OP_SPLICE) of up to 'nbytes' from fd_in at offset 'off_in'
+ * into fd_out at its current position. fd_in is a regular file and fd_out a pipe; the
+ * file position of fd_in is neither used nor moved, so one file can feed many sends.
+ */
+void shim_prep_splice_from(struct io_uring_sqe* sqe, int fd_in, long long off_in, int fd_out,
+                           unsigned nbytes, unsigned splice_flags)
+{
+    io_uring_prep_splice(sqe, fd_in, (int64_t)off_in, fd_out, -1, nbytes, splice_flags);
+}
+
+/** Prepare pread(2) (IORING_OP_READ) of up to 'nbytes' at 'offset' into 'buf'. */
+void shim_prep_read(struct io_uring_sqe* sqe, int fd, void* buf, unsigned nbytes, unsigned long long offset)
+{
+    io_uring_prep_read(sqe, fd, buf, nbytes, offset);
+}
+
+/**
+ * Prepare IORING_OP_READ_FIXED of up to 'nbytes' at 'offset' into 'buf', which must lie
+ * inside the fixed buffer registered at 'buf_index'.
+ */
+void shim_prep_read_fixed(struct io_uring_sqe* sqe, int fd, void* buf, unsigned nbytes,
+                          unsigned long long offset, unsigned buf_index)
+{
+    io_uring_prep_read_fixed(sqe, fd, buf, nbytes, offset, (int)buf_index);
+}
+
+/**
+ * Set IOSQE_IO_LINK: the next SQE starts only once this one completes in full. A failed
+ * or short operation completes the rest of the chain with -ECANCELED.
+ */
+void shim_sqe_set_link(struct io_uring_sqe* sqe)
+{
+    sqe->flags |= IOSQE_IO_LINK;
+}
+
 // -----------------------------------------------------------------------------
 // Direct io_uring_enter wrapper (single syscall path with optional timeout)
 // -----------------------------------------------------------------------------
@@ -456,6 +905,10 @@ void shim_prep_cancel64(struct io_uring_sqe* sqe,
  * - flags        : IORING_ENTER_* flags (GETEVENTS, SQ_WAKEUP, etc.)
  * - ts           : optional timeout (relative). If NULL, no timeout is applied.
  *
+ * If the ring fd was registered (shim_register_ring_fd) on the calling thread,
+ * the registered index is passed with IORING_ENTER_REGISTERED_RING so the kernel
+ * skips the fd table lookup, the same way liburing's own enter calls do.
+ *
  * Returns: >=0 on success (kernel return), or -errno on failure.
  */
 int shim_enter(struct io_uring* ring,
@@ -466,11 +919,16 @@ int shim_enter(struct io_uring* ring,
 {
     if (!ring) return -EINVAL;
 
+    // liburing keeps the registered index in enter_ring_fd (ring_fd otherwise)
+    // and IORING_ENTER_REGISTERED_RING in int_flags once registered.
+    int fd = ring->enter_ring_fd;
+    flags |= ring->int_flags & IORING_ENTER_REGISTERED_RING;
+
     // Simple ABI: no timeout, arg=NULL and argsz=0.
     if (ts == NULL)
     {
         return (int)syscall(__NR_io_uring_enter,
-                            ring->ring_fd,
+                            fd,
                             to_submit,
                             min_complete,
                             flags,
@@ -485,7 +943,7 @@ int shim_enter(struct io_uring* ring,
     arg.ts = (uint64_t)(uintptr_t)ts;
 
     return (int)syscall(__NR_io_uring_enter,
-                        ring->ring_fd,
+                        fd,
                         to_submit,
                         min_complete,
                         flags | IORING_ENTER_EXT_ARG,
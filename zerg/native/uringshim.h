@@ -13,6 +13,7 @@ extern "C" {
 // -----------------------------------------------------------------------------
 
 unsigned shim_get_ring_flags(struct io_uring* ring);
+unsigned shim_get_ring_features(struct io_uring* ring);
 
 struct io_uring* shim_create_ring_ex(unsigned entries,
                                      unsigned flags,
@@ -20,10 +21,41 @@ struct io_uring* shim_create_ring_ex(unsigned entries,
                                      unsigned sq_thread_idle_ms,
                                      int*     err_out);
 
+struct io_uring* shim_create_ring_attach(unsigned entries,
+                                         unsigned flags,
+                                         int      sq_thread_cpu,
+                                         unsigned sq_thread_idle_ms,
+                                         int      wq_fd,
+                                         int*     err_out);
+
+int shim_ring_fd(struct io_uring* ring);
+
 struct io_uring* shim_create_ring(unsigned entries, int* err_out);
 
 void shim_destroy_ring(struct io_uring* ring);
 
+// -----------------------------------------------------------------------------
+// Capability probing
+// -----------------------------------------------------------------------------
+
+// shim_probe_result.caps bits.
+#define SHIM_CAP_PBUF_RING_INC     (1u << 0)  // buf rings accept IOU_PBUF_RING_INC
+#define SHIM_CAP_REGISTER_RING_FD  (1u << 1)  // io_uring_register_ring_fd works
+#define SHIM_CAP_NAPI              (1u << 2)  // io_uring_register_napi works
+
+// Layout is mirrored by ABI.shim_probe_result on the managed side.
+typedef struct shim_probe_result {
+    uint32_t setup_flags;  // IORING_SETUP_* bits accepted by trial setups
+    uint32_t features;     // IORING_FEAT_* bits of a plain ring
+    uint32_t caps;         // SHIM_CAP_* bits
+    uint32_t last_op;      // highest opcode the kernel knows
+    uint64_t ops[4];       // bit n set: IORING_OP n is supported
+} shim_probe_result;
+
+int shim_probe(shim_probe_result* out);
+int shim_register_ring_fd(struct io_uring* ring);
+int shim_register_napi(struct io_uring* ring, unsigned busy_poll_us, int prefer_busy_poll);
+
 // -----------------------------------------------------------------------------
 // Core ring ops (SQ/CQ)
 // -----------------------------------------------------------------------------
@@ -59,17 +91,44 @@ int shim_submit_and_wait_timeout(struct io_uring* ring,
                                  unsigned int wait_nr,
                                  struct __kernel_timespec* ts);
 
+// Batched CQE harvest: one call copies a batch of completions out of the CQ
+// ring and advances its head. Layout is mirrored by ABI.shim_cqe on the managed side.
+typedef struct shim_cqe {
+    uint64_t user_data;
+    int32_t  res;
+    uint32_t flags;
+} shim_cqe;
+
+int shim_harvest_cqes(struct io_uring* ring, shim_cqe* out, unsigned max);
+
+// Busy-wait helper: CQEs ready, after flushing pending task work if the kernel flagged any.
+unsigned shim_poll_cqes(struct io_uring* ring);
+
 // -----------------------------------------------------------------------------
 // Multishot ops
 // -----------------------------------------------------------------------------
 
 void shim_prep_multishot_accept(struct io_uring_sqe* sqe, int lfd, int flags);
+void shim_prep_multishot_accept_direct(struct io_uring_sqe* sqe, int lfd, int flags);
 
 void shim_prep_recv_multishot_select(struct io_uring_sqe* sqe,
                                      int fd,
                                      unsigned buf_group,
                                      int flags);
 
+void shim_prep_recv_multishot_bundle(struct io_uring_sqe* sqe,
+                                     int fd,
+                                     unsigned buf_group,
+                                     int flags);
+
+void shim_prep_poll_multishot(struct io_uring_sqe* sqe, int fd, unsigned poll_mask);
+
+void shim_prep_recvmsg_multishot_select(struct io_uring_sqe* sqe,
+                                        int fd,
+                                        struct msghdr* msg,
+                                        unsigned buf_group,
+                                        unsigned flags);
+
 // -----------------------------------------------------------------------------
 // User-data helpers
 // -----------------------------------------------------------------------------
@@ -108,6 +167,23 @@ void shim_buf_ring_advance(struct io_uring_buf_ring* br, unsigned count);
 int      shim_cqe_has_buffer(const struct io_uring_cqe* cqe);
 unsigned shim_cqe_buffer_id(const struct io_uring_cqe* cqe);
 
+// -----------------------------------------------------------------------------
+// Fixed (registered) buffers
+// -----------------------------------------------------------------------------
+
+int shim_register_buffers_sparse(struct io_uring* ring, unsigned nr);
+int shim_register_buffer_slot(struct io_uring* ring, unsigned slot, void* addr, unsigned len);
+int shim_unregister_buffers(struct io_uring* ring);
+
+// -----------------------------------------------------------------------------
+// Fixed (registered) files
+// -----------------------------------------------------------------------------
+
+int  shim_register_files_sparse(struct io_uring* ring, unsigned nr);
+int  shim_register_file_slot(struct io_uring* ring, unsigned slot, int fd);
+void shim_sqe_set_fixed_file(struct io_uring_sqe* sqe);
+void shim_prep_close_direct(struct io_uring_sqe* sqe, unsigned file_index);
+
 // -----------------------------------------------------------------------------
 // Send / cancel
 // -----------------------------------------------------------------------------
@@ -118,25 +194,57 @@ void shim_prep_send(struct io_uring_sqe* sqe,
                     unsigned nbytes,
                     int flags);
 
+void shim_prep_sendmsg(struct io_uring_sqe* sqe,
+                       int fd,
+                       const struct msghdr* msg,
+                       unsigned flags);
+
+void shim_prep_send_zc_fixed(struct io_uring_sqe* sqe,
+                             int fd,
+                             const void* buf,
+                             unsigned nbytes,
+                             int flags,
+                             unsigned zc_flags,
+                             unsigned buf_index);
+
 void shim_prep_cancel64(struct io_uring_sqe* sqe,
                         unsigned long long user_data,
                         int flags);
 
 // -----------------------------------------------------------------------------
-// Direct enter wrappers 
+// Outbound connections / relays
 // -----------------------------------------------------------------------------
 
-int shim_enter2(struct io_uring* ring,
-                unsigned to_submit,
-                unsigned min_complete,
-                unsigned flags,
-                struct __kernel_timespec* ts);
+void shim_prep_connect(struct io_uring_sqe* sqe, int fd, const void* addr, unsigned addrlen);
+void shim_prep_splice(struct io_uring_sqe* sqe, int fd_in, int fd_out, unsigned nbytes, unsigned splice_flags);
+void shim_prep_shutdown(struct io_uring_sqe* sqe, int fd, int how);
+void shim_prep_poll_add(struct io_uring_sqe* sqe, int fd, unsigned poll_mask);
 
-int shim_enter4(struct io_uring* ring,
-                unsigned to_submit,
-                unsigned min_complete,
-                unsigned flags,
-                struct __kernel_timespec* ts);
+// -----------------------------------------------------------------------------
+// File sends
+// -----------------------------------------------------------------------------
+
+void shim_prep_splice_from(struct io_uring_sqe* sqe,
+                           int fd_in,
+                           long long off_in,
+                           int fd_out,
+                           unsigned nbytes,
+                           unsigned splice_flags);
+
+void shim_prep_read(struct io_uring_sqe* sqe, int fd, void* buf, unsigned nbytes, unsigned long long offset);
+
+void shim_prep_read_fixed(struct io_uring_sqe* sqe,
+                          int fd,
+                          void* buf,
+                          unsigned nbytes,
+                          unsigned long long offset,
+                          unsigned buf_index);
+
+void shim_sqe_set_link(struct io_uring_sqe* sqe);
+
+// -----------------------------------------------------------------------------
+// Direct enter wrapper
+// -----------------------------------------------------------------------------
 
 int shim_enter(struct io_uring* ring,
                unsigned to_submit,